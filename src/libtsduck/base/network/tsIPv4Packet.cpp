@@ -122,6 +122,39 @@ bool ts::IPv4Packet::reset(const void* data, size_t size)
 }
 
 
+//----------------------------------------------------------------------------
+// Locate the payload of a UDP datagram in a raw IPv4 packet, without copy.
+//----------------------------------------------------------------------------
+
+bool ts::IPv4Packet::LocateUDP(const void* data, size_t size, IPv4SocketAddress& source, IPv4SocketAddress& destination, const uint8_t*& udp_data, size_t& udp_size)
+{
+    udp_data = nullptr;
+    udp_size = 0;
+
+    // Same checks as reset(), without copy.
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(data);
+    const size_t ip_header_size = IPHeaderSize(ip, size);
+    if (ip_header_size == 0 || GetUInt16BE(ip + IPv4_CHECKSUM_OFFSET) != IPHeaderChecksum(ip, ip_header_size) || ip[IPv4_PROTOCOL_OFFSET] != IPv4_PROTO_UDP) {
+        return false;
+    }
+    size = std::min<size_t>(size, GetUInt16(ip + IPv4_LENGTH_OFFSET));
+    if (size < ip_header_size + UDP_HEADER_SIZE) {
+        return false; // packet too short
+    }
+    const uint8_t* udp = ip + ip_header_size;
+    const size_t udp_length = GetUInt16BE(udp + UDP_LENGTH_OFFSET);
+    if (udp_length < UDP_HEADER_SIZE || size < ip_header_size + udp_length) {
+        return false; // packet too short
+    }
+
+    source.set(GetUInt32BE(ip + IPv4_SRC_ADDR_OFFSET), GetUInt16BE(udp + UDP_SRC_PORT_OFFSET));
+    destination.set(GetUInt32BE(ip + IPv4_DEST_ADDR_OFFSET), GetUInt16BE(udp + UDP_DEST_PORT_OFFSET));
+    udp_data = udp + UDP_HEADER_SIZE;
+    udp_size = udp_length - UDP_HEADER_SIZE;
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Check if the IPv4 packet is fragmented.
 //----------------------------------------------------------------------------
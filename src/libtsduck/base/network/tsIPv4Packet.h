@@ -228,6 +228,19 @@ namespace ts {
         //!
         static size_t IPHeaderSize(const void* data, size_t size);
 
+        //!
+        //! Locate the payload of a UDP datagram in a raw IPv4 packet, without copy.
+        //! The IPv4 and UDP headers are validated in the same way as reset().
+        //! @param [in] data Address of the IP packet.
+        //! @param [in] size Size of the IP packet.
+        //! @param [out] source Source socket address of the UDP datagram.
+        //! @param [out] destination Destination socket address of the UDP datagram.
+        //! @param [out] udp_data Address of the UDP payload, inside @a data.
+        //! @param [out] udp_size Size in bytes of the UDP payload.
+        //! @return True on success, false if the packet is invalid or not a UDP datagram.
+        //!
+        static bool LocateUDP(const void* data, size_t size, IPv4SocketAddress& source, IPv4SocketAddress& destination, const uint8_t*& udp_data, size_t& udp_size);
+
         //!
         //! Compute the checksum of an IPv4 header from raw data.
         //! @param [in] data Address of the IP packet.
@@ -0,0 +1,539 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketRing.h"
+#include "tsIPProtocols.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+#include "tsMemory.h"
+#include "tsTime.h"
+
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <linux/if_packet.h>
+    #include <linux/if_ether.h>
+    #include <linux/filter.h>
+    #include <net/if.h>
+    #include <sys/mman.h>
+    #include <poll.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::PacketRing::DEFAULT_BLOCK_SIZE;
+constexpr size_t ts::PacketRing::DEFAULT_BLOCK_COUNT;
+constexpr ts::MilliSecond ts::PacketRing::DEFAULT_BLOCK_TIMEOUT;
+#endif
+
+#if defined(TS_LINUX)
+namespace {
+    // Maximum interval in milliseconds between two checks for abort while waiting for a block.
+    constexpr int ABORT_CHECK_INTERVAL = 100;
+
+    // Build a classic BPF program which selects UDP datagrams. The socket is of type
+    // SOCK_DGRAM, meaning that the offsets are relative to the IP header.
+    void BuildFilter(std::vector<::sock_filter>& prog, const ts::IPv4SocketAddress& source, const ts::IPv4SocketAddress& destination, bool multicast_only)
+    {
+        // Conditional jumps to the final "reject" instruction: index in program and true if the jump is on the "true" branch.
+        std::vector<std::pair<size_t, bool>> rejects;
+        const auto load = [&prog](uint16_t code, uint32_t k) {
+            prog.push_back(::sock_filter{code, 0, 0, k});
+        };
+        const auto reject_if_not = [&prog, &rejects](uint32_t value) {
+            rejects.push_back(std::make_pair(prog.size(), false));
+            prog.push_back(::sock_filter{BPF_JMP | BPF_JEQ | BPF_K, 0, 0, value});
+        };
+
+        prog.clear();
+
+        // UDP datagrams only.
+        load(BPF_LD | BPF_B | BPF_ABS, ts::IPv4_PROTOCOL_OFFSET);
+        reject_if_not(ts::IPv4_PROTO_UDP);
+
+        // Reject non-first fragments, they have no UDP header.
+        load(BPF_LD | BPF_H | BPF_ABS, ts::IPv4_FRAGMENT_OFFSET);
+        rejects.push_back(std::make_pair(prog.size(), true));
+        prog.push_back(::sock_filter{BPF_JMP | BPF_JSET | BPF_K, 0, 0, 0x1FFF});
+
+        // IP addresses.
+        if (source.hasAddress()) {
+            load(BPF_LD | BPF_W | BPF_ABS, ts::IPv4_SRC_ADDR_OFFSET);
+            reject_if_not(source.address());
+        }
+        if (destination.hasAddress()) {
+            load(BPF_LD | BPF_W | BPF_ABS, ts::IPv4_DEST_ADDR_OFFSET);
+            reject_if_not(destination.address());
+        }
+        else if (multicast_only) {
+            // Multicast addresses are 224.0.0.0/4.
+            load(BPF_LD | BPF_W | BPF_ABS, ts::IPv4_DEST_ADDR_OFFSET);
+            load(BPF_ALU | BPF_AND | BPF_K, 0xF0000000);
+            reject_if_not(0xE0000000);
+        }
+
+        // UDP ports, after an IP header of variable size.
+        if (source.hasPort() || destination.hasPort()) {
+            load(BPF_LDX | BPF_B | BPF_MSH, 0);
+            if (source.hasPort()) {
+                load(BPF_LD | BPF_H | BPF_IND, ts::UDP_SRC_PORT_OFFSET);
+                reject_if_not(source.port());
+            }
+            if (destination.hasPort()) {
+                load(BPF_LD | BPF_H | BPF_IND, ts::UDP_DEST_PORT_OFFSET);
+                reject_if_not(destination.port());
+            }
+        }
+
+        // Accept the complete packet.
+        load(BPF_RET | BPF_K, 0x0000FFFF);
+
+        // Reject the packet. Now that its index is known, patch all jumps to this instruction.
+        const size_t reject = prog.size();
+        load(BPF_RET | BPF_K, 0);
+        for (const auto& it : rejects) {
+            const uint8_t offset = uint8_t(reject - it.first - 1);
+            if (it.second) {
+                prog[it.first].jt = offset;
+            }
+            else {
+                prog[it.first].jf = offset;
+            }
+        }
+    }
+
+    // Atomic access to the status of a block, shared with the kernel.
+    inline uint32_t GetBlockStatus(const uint8_t* block)
+    {
+        return __atomic_load_n(&reinterpret_cast<const ::tpacket_block_desc*>(block)->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+    }
+    inline void SetBlockStatus(uint8_t* block, uint32_t status)
+    {
+        __atomic_store_n(&reinterpret_cast<::tpacket_block_desc*>(block)->hdr.bh1.block_status, status, __ATOMIC_RELEASE);
+    }
+}
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::PacketRing::PacketRing() :
+    _block_size(DEFAULT_BLOCK_SIZE),
+    _block_count(DEFAULT_BLOCK_COUNT),
+    _block_timeout(DEFAULT_BLOCK_TIMEOUT),
+    _receive_timeout(0),
+    _source(),
+    _destination(),
+    _multicast_only(false),
+    _aborted(false),
+    _fd(-1),
+    _ring(nullptr),
+    _ring_size(0),
+    _block_index(0),
+    _next_packet(nullptr),
+    _remain_packets(0)
+{
+}
+
+ts::PacketRing::~PacketRing()
+{
+    close(NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Configuration, before open().
+//----------------------------------------------------------------------------
+
+void ts::PacketRing::setRingSize(size_t block_size, size_t block_count)
+{
+    _block_size = block_size == 0 ? DEFAULT_BLOCK_SIZE : block_size;
+    _block_count = block_count == 0 ? DEFAULT_BLOCK_COUNT : block_count;
+}
+
+void ts::PacketRing::setBlockTimeout(MilliSecond timeout)
+{
+    _block_timeout = timeout <= 0 ? DEFAULT_BLOCK_TIMEOUT : timeout;
+}
+
+void ts::PacketRing::setUDPFilter(const IPv4SocketAddress& source, const IPv4SocketAddress& destination, bool multicast_only)
+{
+    _source = source;
+    _destination = destination;
+    _multicast_only = multicast_only;
+}
+
+
+//----------------------------------------------------------------------------
+// Open the packet ring on a network interface.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::open(const UString& if_name, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"packet ring already open");
+        return false;
+    }
+
+#if defined(TS_LINUX)
+
+    _aborted = false;
+    _block_index = 0;
+    _next_packet = nullptr;
+    _remain_packets = 0;
+
+    // The block size must be a power of two, multiple of the page size.
+    const size_t page_size = size_t(::sysconf(_SC_PAGESIZE));
+    size_t block_size = page_size;
+    while (block_size < _block_size) {
+        block_size *= 2;
+    }
+    _block_size = block_size;
+    _ring_size = _block_size * _block_count;
+
+    // Locate the network interface.
+    const unsigned int if_index = ::if_nametoindex(if_name.toUTF8().c_str());
+    if (if_index == 0) {
+        report.error(u"network interface %s not found: %s", {if_name, SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Create the packet socket. Use a zero protocol to receive nothing until bind(),
+    // after the filter is attached.
+    if ((_fd = ::socket(AF_PACKET, SOCK_DGRAM, 0)) < 0) {
+        report.error(u"error creating packet socket: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Attach the filter program.
+    std::vector<::sock_filter> prog;
+    BuildFilter(prog, _source, _destination, _multicast_only);
+    ::sock_fprog fprog;
+    fprog.len = uint16_t(prog.size());
+    fprog.filter = prog.data();
+    const int version = TPACKET_V3;
+    bool success = true;
+    if (::setsockopt(_fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) < 0) {
+        report.error(u"error attaching filter to packet socket: %s", {SysErrorCodeMessage()});
+        success = false;
+    }
+    else if (::setsockopt(_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        report.error(u"error setting TPACKET_V3 on packet socket: %s", {SysErrorCodeMessage()});
+        success = false;
+    }
+
+#if defined(PACKET_IGNORE_OUTGOING)
+    // Ignore packets which are sent by the local system (Linux 4.20 and higher).
+    // With older kernels, outgoing packets are ignored when read from the ring.
+    const int ignore_outgoing = 1;
+    if (success) {
+        ::setsockopt(_fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore_outgoing, sizeof(ignore_outgoing));
+    }
+#endif
+
+    // Create and map the ring. The frame size is meaningless with TPACKET_V3 where
+    // packets have variable sizes but the kernel still checks its consistency.
+    ::tpacket_req3 req;
+    TS_ZERO(req);
+    req.tp_block_size = unsigned(_block_size);
+    req.tp_block_nr = unsigned(_block_count);
+    req.tp_frame_size = TPACKET_ALIGNMENT << 7;
+    req.tp_frame_nr = unsigned(_ring_size / req.tp_frame_size);
+    req.tp_retire_blk_tov = unsigned(_block_timeout);
+    if (success && ::setsockopt(_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        report.error(u"error creating packet ring (%d blocks of %'d bytes): %s", {_block_count, _block_size, SysErrorCodeMessage()});
+        success = false;
+    }
+    if (success) {
+        void* mem = ::mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if (mem == MAP_FAILED) {
+            report.error(u"error mapping packet ring: %s", {SysErrorCodeMessage()});
+            success = false;
+        }
+        else {
+            _ring = reinterpret_cast<uint8_t*>(mem);
+        }
+    }
+
+    // Start receiving IPv4 packets from the interface.
+    ::sockaddr_ll sll;
+    TS_ZERO(sll);
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_IP);
+    sll.sll_ifindex = int(if_index);
+    if (success && ::bind(_fd, reinterpret_cast<::sockaddr*>(&sll), sizeof(sll)) < 0) {
+        report.error(u"error binding packet socket to %s: %s", {if_name, SysErrorCodeMessage()});
+        success = false;
+    }
+
+    if (!success) {
+        close(NULLREP);
+        return false;
+    }
+    report.debug(u"packet ring open on %s, %d blocks of %'d bytes", {if_name, _block_count, _block_size});
+    return true;
+
+#else
+
+    report.error(u"packet rings are not supported on this operating system");
+    return false;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Close the packet ring.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::close(Report& report)
+{
+#if defined(TS_LINUX)
+    if (_fd >= 0) {
+        report.debug(u"closing packet ring");
+    }
+    if (_ring != nullptr) {
+        ::munmap(_ring, _ring_size);
+        _ring = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    _next_packet = nullptr;
+    _remain_packets = 0;
+#endif
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Release the current block to the kernel and move to the next one.
+//----------------------------------------------------------------------------
+
+void ts::PacketRing::releaseBlock()
+{
+#if defined(TS_LINUX)
+    SetBlockStatus(block(_block_index), TP_STATUS_KERNEL);
+    _block_index = (_block_index + 1) % _block_count;
+    _next_packet = nullptr;
+    _remain_packets = 0;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for the current block to be available.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::waitBlock(const AbortInterface* abort, Report& report)
+{
+#if defined(TS_LINUX)
+
+    uint8_t* const base = block(_block_index);
+    const Time deadline(_receive_timeout > 0 ? Time::CurrentUTC() + _receive_timeout : Time::Apocalypse);
+
+    while ((GetBlockStatus(base) & TP_STATUS_USER) == 0) {
+        if (_aborted || (abort != nullptr && abort->aborting())) {
+            // Aborting, no error message.
+            return false;
+        }
+        const MilliSecond remain = deadline - Time::CurrentUTC();
+        if (remain <= 0) {
+            report.error(u"receive timeout on packet ring");
+            return false;
+        }
+        // Wait for the kernel to pass a block. Periodically wake up to check abort.
+        ::pollfd pfd;
+        TS_ZERO(pfd);
+        pfd.fd = _fd;
+        pfd.events = POLLIN | POLLERR;
+        if (::poll(&pfd, 1, int(std::min<MilliSecond>(remain, ABORT_CHECK_INTERVAL))) < 0 && errno != EINTR) {
+            report.error(u"error waiting for packet ring: %s", {SysErrorCodeMessage()});
+            return false;
+        }
+    }
+
+    const ::tpacket_block_desc* desc = reinterpret_cast<const ::tpacket_block_desc*>(base);
+    _next_packet = base + desc->hdr.bh1.offset_to_first_pkt;
+    _remain_packets = desc->hdr.bh1.num_pkts;
+    return true;
+
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a packet is immediately available in the ring.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::available() const
+{
+#if defined(TS_LINUX)
+    if (!isOpen()) {
+        return false;
+    }
+    else if (_remain_packets > 0) {
+        return true;
+    }
+    else {
+        // Check the current block if not yet available, the next one if the current block is fully read.
+        const size_t index = _next_packet == nullptr ? _block_index : (_block_index + 1) % _block_count;
+        return (GetBlockStatus(block(index)) & TP_STATUS_USER) != 0;
+    }
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next packet in place.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::nextPacket(const uint8_t*& data, size_t& size, MicroSecond& timestamp, const AbortInterface* abort, Report& report)
+{
+#if defined(TS_LINUX)
+    for (;;) {
+        // Return the previous block to the kernel when all its packets were read.
+        if (_next_packet != nullptr && _remain_packets == 0) {
+            releaseBlock();
+        }
+
+        // Wait for the current block.
+        if (_next_packet == nullptr && !waitBlock(abort, report)) {
+            return false;
+        }
+
+        // Decode the next packet, the data start at the network header. A block may be empty after a timeout.
+        if (_remain_packets > 0) {
+            const uint8_t* const base = _next_packet;
+            const ::tpacket3_hdr* hdr = reinterpret_cast<const ::tpacket3_hdr*>(base);
+            const ::sockaddr_ll* sll = reinterpret_cast<const ::sockaddr_ll*>(base + TPACKET_ALIGN(sizeof(::tpacket3_hdr)));
+            _next_packet += hdr->tp_next_offset;
+            _remain_packets--;
+            // Ignore packets which are sent by the local system (when PACKET_IGNORE_OUTGOING is not supported).
+            if (sll->sll_pkttype != PACKET_OUTGOING) {
+                data = base + hdr->tp_net;
+                size = hdr->tp_snaplen;
+                timestamp = MicroSecond(hdr->tp_sec) * MicroSecPerSec + MicroSecond(hdr->tp_nsec) / NanoSecPerMicroSec;
+                return true;
+            }
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Receive the next IPv4 packet from the ring.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::receive(IPv4Packet& packet, MicroSecond& timestamp, const AbortInterface* abort, Report& report)
+{
+    if (!isOpen()) {
+        report.error(u"packet ring not open");
+        timestamp = -1;
+        return false;
+    }
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    while (nextPacket(data, size, timestamp, abort, report)) {
+        const bool valid = packet.reset(data, size);
+        // The packet was copied, the block can be returned to the kernel as soon as possible.
+        if (_remain_packets == 0) {
+            releaseBlock();
+        }
+        if (valid) {
+            return true;
+        }
+    }
+    timestamp = -1;
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive the next UDP datagram from the ring, without copy.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::receiveUDP(const uint8_t*& data, size_t& size, IPv4SocketAddress& source, IPv4SocketAddress& destination, MicroSecond& timestamp, const AbortInterface* abort, Report& report)
+{
+    if (!isOpen()) {
+        report.error(u"packet ring not open");
+        timestamp = -1;
+        return false;
+    }
+
+    const uint8_t* ip = nullptr;
+    size_t ip_size = 0;
+    while (nextPacket(ip, ip_size, timestamp, abort, report)) {
+        // The headers are parsed in place, the block is released during the next call.
+        if (IPv4Packet::LocateUDP(ip, ip_size, source, destination, data, size)) {
+            return true;
+        }
+    }
+    timestamp = -1;
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of received and dropped packets since the last call.
+//----------------------------------------------------------------------------
+
+bool ts::PacketRing::getStatistics(uint64_t& received, uint64_t& dropped, Report& report)
+{
+    received = dropped = 0;
+    if (!isOpen()) {
+        report.error(u"packet ring not open");
+        return false;
+    }
+
+#if defined(TS_LINUX)
+    ::tpacket_stats_v3 stats;
+    TS_ZERO(stats);
+    ::socklen_t len = sizeof(stats);
+    if (::getsockopt(_fd, SOL_PACKET, PACKET_STATISTICS, &stats, &len) < 0) {
+        report.error(u"error getting packet ring statistics: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+    received = stats.tp_packets;
+    dropped = stats.tp_drops;
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,224 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Receive IPv4 packets from a network interface using a memory-mapped packet ring.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIPv4Packet.h"
+#include "tsIPv4SocketAddress.h"
+#include "tsAbortInterface.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Receive IPv4 packets from a network interface using a memory-mapped packet ring.
+    //! @ingroup net
+    //!
+    //! The packets are captured at link level, before the IP stack, using a socket of the
+    //! AF_PACKET family with a TPACKET_V3 ring which is shared between the kernel and the
+    //! application. The kernel fills blocks of the ring with packets and the application
+    //! reads them in place. A system call is needed only when the application has read
+    //! all packets of the ring, to wait for the next block.
+    //!
+    //! A filter program is attached to the socket so that the kernel copies only the
+    //! selected UDP datagrams into the ring. Unrelated traffic on the same interface is
+    //! not copied. Packets which are sent by the local system are ignored.
+    //!
+    //! This class is implemented on Linux only. On other systems, open() always fails.
+    //!
+    class TSDUCKDLL PacketRing
+    {
+        TS_NOCOPY(PacketRing);
+    public:
+        //!
+        //! Default size in bytes of each block in the ring.
+        //!
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+        //!
+        //! Default number of blocks in the ring.
+        //!
+        static constexpr size_t DEFAULT_BLOCK_COUNT = 16;
+        //!
+        //! Default timeout in milliseconds after which a partially filled block is passed to the application.
+        //!
+        static constexpr MilliSecond DEFAULT_BLOCK_TIMEOUT = 10;
+
+        //!
+        //! Default constructor.
+        //!
+        PacketRing();
+
+        //!
+        //! Destructor.
+        //!
+        ~PacketRing();
+
+        //!
+        //! Set the size of the ring.
+        //! Must be called before open().
+        //! @param [in] block_size Size in bytes of each block. It is rounded up to a power of two,
+        //! at least the size of a memory page. Zero means default.
+        //! @param [in] block_count Number of blocks in the ring. Zero means default.
+        //!
+        void setRingSize(size_t block_size, size_t block_count);
+
+        //!
+        //! Set the block timeout.
+        //! Must be called before open().
+        //! @param [in] timeout Timeout in milliseconds after which a partially filled block is passed
+        //! to the application. This is the maximum reception latency at low bitrates. Zero means default.
+        //!
+        void setBlockTimeout(MilliSecond timeout);
+
+        //!
+        //! Set the receive timeout.
+        //! @param [in] timeout Maximum time in milliseconds to wait for a packet in receive().
+        //! Zero or negative means infinite.
+        //!
+        void setReceiveTimeout(MilliSecond timeout) { _receive_timeout = timeout; }
+
+        //!
+        //! Set the UDP datagrams to select.
+        //! Must be called before open(). Only UDP datagrams are selected. Fragments of
+        //! UDP datagrams, except the first one, are not selected.
+        //! @param [in] source Source socket address to filter. If the address or the port is
+        //! unspecified, it acts as a wildcard.
+        //! @param [in] destination Destination socket address to filter. If the address or the port
+        //! is unspecified, it acts as a wildcard.
+        //! @param [in] multicast_only When the destination address is unspecified, select multicast
+        //! destination addresses only.
+        //!
+        void setUDPFilter(const IPv4SocketAddress& source, const IPv4SocketAddress& destination, bool multicast_only = false);
+
+        //!
+        //! Open the packet ring on a network interface.
+        //! This operation requires the CAP_NET_RAW capability.
+        //! @param [in] if_name Name of the network interface, for instance "eth0" or "lo".
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& if_name, Report& report);
+
+        //!
+        //! Close the packet ring.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
+        //!
+        //! Check if the packet ring is open.
+        //! @return True if the packet ring is open.
+        //!
+        bool isOpen() const { return _fd >= 0; }
+
+        //!
+        //! Receive the next IPv4 packet from the ring.
+        //! Wait for the next block of the ring when all packets of the current block have been read.
+        //! @param [out] packet Received IPv4 packet.
+        //! @param [out] timestamp Kernel reception time stamp in micro-seconds since the UNIX epoch.
+        //! @param [in] abort If non-zero, invoked when the reception is interrupted.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error, abort or receive timeout.
+        //! @see abort()
+        //!
+        bool receive(IPv4Packet& packet, MicroSecond& timestamp, const AbortInterface* abort, Report& report);
+
+        //!
+        //! Receive the next UDP datagram from the ring, without copy.
+        //! The IPv4 and UDP headers are parsed in place, in the ring. The returned payload is
+        //! located in the ring. It remains valid until the next call to receive(), receiveUDP()
+        //! or close(). Its block is returned to the kernel during the next call.
+        //! @param [out] data Address of the UDP payload in the ring.
+        //! @param [out] size Size in bytes of the UDP payload.
+        //! @param [out] source Source socket address of the datagram.
+        //! @param [out] destination Destination socket address of the datagram.
+        //! @param [out] timestamp Kernel reception time stamp in micro-seconds since the UNIX epoch.
+        //! @param [in] abort If non-zero, invoked when the reception is interrupted.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error, abort or receive timeout.
+        //! @see abort()
+        //!
+        bool receiveUDP(const uint8_t*& data, size_t& size, IPv4SocketAddress& source, IPv4SocketAddress& destination, MicroSecond& timestamp, const AbortInterface* abort, Report& report);
+
+        //!
+        //! Check if a packet is immediately available in the ring.
+        //! @return True if the next call to receive() will not wait.
+        //!
+        bool available() const;
+
+        //!
+        //! Abort a pending receive() from another thread.
+        //! After this call, receive() always fails. The packet ring can only be closed.
+        //!
+        void abort() { _aborted = true; }
+
+        //!
+        //! Get the number of received and dropped packets since the last call.
+        //! The dropped packets could not be stored in the ring because it was full.
+        //! @param [out] received Number of packets which were received by the kernel.
+        //! @param [out] dropped Number of packets which were dropped by the kernel.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool getStatistics(uint64_t& received, uint64_t& dropped, Report& report);
+
+    private:
+        size_t            _block_size;       // Size in bytes of each block.
+        size_t            _block_count;      // Number of blocks in the ring.
+        MilliSecond       _block_timeout;    // Block retire timeout.
+        MilliSecond       _receive_timeout;  // Receive timeout.
+        IPv4SocketAddress _source;           // Source filter.
+        IPv4SocketAddress _destination;      // Destination filter.
+        bool              _multicast_only;   // Select multicast destinations only.
+        volatile bool     _aborted;          // Pending receive() aborted.
+        int               _fd;               // Packet socket.
+        uint8_t*          _ring;             // Memory-mapped ring.
+        size_t            _ring_size;        // Size in bytes of the ring.
+        size_t            _block_index;      // Index of current block.
+        const uint8_t*    _next_packet;      // Next packet to read in current block, null if current block not yet available.
+        size_t            _remain_packets;   // Number of packets to read in current block, block to release when zero.
+
+        // Address of a block in the ring.
+        uint8_t* block(size_t index) const { return _ring + index * _block_size; }
+
+        // Release the current block to the kernel and move to the next one.
+        void releaseBlock();
+
+        // Wait for the current block to be available. Return false on error, abort or timeout.
+        bool waitBlock(const AbortInterface* abort, Report& report);
+
+        // Get the next packet in place, starting at the network header. Release the previous block first
+        // when all its packets were read. Return false on error, abort or timeout.
+        bool nextPacket(const uint8_t*& data, size_t& size, MicroSecond& timestamp, const AbortInterface* abort, Report& report);
+    };
+}
@@ -35,6 +35,16 @@
 #include "tsIntegerUtils.h"
 #include "tsSysUtils.h"
 
+#if !defined(TS_WINDOWS)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -56,7 +66,19 @@ ts::PcapFile::PcapFile() :
     _ipv4_packets_size(0),
     _first_timestamp(-1),
     _last_timestamp(-1),
-    _if()
+    _if(),
+    _position(0),
+    _mmap(false),
+    _map_data(nullptr),
+    _map_size(0),
+    _use_index(false),
+    _index_file(),
+    _index(),
+    _indexing(nullptr),
+    _section(NPOS),
+    _view_active(false),
+    _view_next(0),
+    _view()
 {
 }
 
@@ -108,6 +130,12 @@ bool ts::PcapFile::open(const UString& filename, Report& report)
     _ipv4_packets_size = 0;
     _first_timestamp = -1;
     _last_timestamp = -1;
+    _position = 0;
+    _section = NPOS;
+    _view_active = false;
+    _view_next = 0;
+    _view.clear();
+    _index.clear();
 
     // Open the file.
     if (filename.empty() || filename == u"-") {
@@ -126,6 +154,31 @@ bool ts::PcapFile::open(const UString& filename, Report& report)
         }
         _in = &_file;
         _name = filename;
+
+        // Map the complete file in memory when possible, silently fall back to read operations.
+#if !defined(TS_WINDOWS)
+        if (_mmap) {
+            const int fd = ::open(filename.toUTF8().c_str(), O_RDONLY);
+            struct stat st;
+            if (fd >= 0 && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && uint64_t(st.st_size) <= uint64_t(std::numeric_limits<size_t>::max())) {
+                void* const addr = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED) {
+                    const SysErrorCode err = LastSysErrorCode();
+                    report.verbose(u"cannot map %s in memory, using read operations: %s", {_name, SysErrorCodeMessage(err)});
+                }
+                else {
+                    report.debug(u"mapped %s in memory, %'d bytes", {_name, st.st_size});
+                    _map_data = reinterpret_cast<uint8_t*>(addr);
+                    _map_size = size_t(st.st_size);
+                    // Without index, the file is read sequentially.
+                    ::madvise(addr, _map_size, _use_index ? MADV_RANDOM : MADV_SEQUENTIAL);
+                }
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+#endif
     }
 
     // Read the file header, starting with a 4-byte "magic" number.
@@ -136,6 +189,52 @@ bool ts::PcapFile::open(const UString& filename, Report& report)
     }
 
     report.debug(u"opened %s, %s format version %d.%d, %s endian", {_name, _ng ? u"pcap-ng" : u"pcap", _major, _minor, _be ? u"big" : u"little"});
+
+    // Load or build the index.
+    if (_use_index) {
+        if (_in == &std::cin) {
+            report.warning(u"cannot use an index on standard input");
+        }
+        else if (!loadIndex(report)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Use an index of the file.
+//----------------------------------------------------------------------------
+
+void ts::PcapFile::setIndexed(bool on, const UString& index_file)
+{
+    _use_index = on;
+    _index_file = index_file;
+}
+
+
+//----------------------------------------------------------------------------
+// Load the index, build it if necessary.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::loadIndex(Report& report)
+{
+    const UString index_file(_index_file.empty() ? _name + PcapIndex::DEFAULT_SUFFIX : _index_file);
+    if (!_index.load(index_file, _name, report)) {
+        report.verbose(u"building index of %s", {_name});
+        if (!_index.build(_name, report)) {
+            return false;
+        }
+        // Failing to save the index is not an error, it is only lost for subsequent uses.
+        if (!_index.save(index_file, report)) {
+            report.warning(u"cannot save index of %s, using the index for this session only", {_name});
+        }
+    }
+
+    // We may now jump to any packet, the first timestamp is known in advance.
+    _first_timestamp = _index.firstTimestamp();
     return true;
 }
 
@@ -149,7 +248,17 @@ void ts::PcapFile::close()
     if (_file.is_open()) {
         _file.close();
     }
+#if !defined(TS_WINDOWS)
+    if (_map_data != nullptr) {
+        ::munmap(_map_data, _map_size);
+    }
+#endif
+    _map_data = nullptr;
+    _map_size = 0;
     _in = nullptr;
+    _index.clear();
+    _view.clear();
+    _view_active = false;
 }
 
 
@@ -159,6 +268,17 @@ void ts::PcapFile::close()
 
 bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 {
+    // In memory-mapped mode, simply copy from the mapped file.
+    if (_map_data != nullptr) {
+        const uint8_t* addr = nullptr;
+        ByteBlock unused;
+        if (!readData(addr, size, unused, report)) {
+            return false;
+        }
+        ::memcpy(data, addr, size);
+        return true;
+    }
+
     // Repeatedly read until all requested bytes are read.
     while (size > 0) {
         // Read at most "size" bytes.
@@ -170,27 +290,158 @@ bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
             return error(report);
         }
 
-        // Get file size so far.
-        const std::ios::pos_type fpos = _in->tellg();
-        if (fpos != std::ios::pos_type(-1)) {
-            _file_size = size_t(fpos);
-        }
-
-        // Actual number of bytes.
+        // Actual number of bytes, get file size so far.
         const size_t insize = std::min(size_t(_in->gcount()), size);
         size -= insize;
         data += insize;
+        _position += insize;
+        _file_size = std::max(_file_size, size_t(_position));
     }
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Read "size" bytes, in place in the mapped file or in the buffer.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::readData(const uint8_t*& data, size_t size, ByteBlock& buffer, Report& report)
+{
+    if (_map_data != nullptr) {
+        if (_position > _map_size || size > _map_size - _position) {
+            // End of file, no error message.
+            _position = _map_size;
+            data = nullptr;
+            return error(report);
+        }
+        data = _map_data + _position;
+        _position += size;
+        _file_size = std::max(_file_size, size_t(_position));
+        return true;
+    }
+    else {
+        buffer.resize(size);
+        data = buffer.data();
+        return readall(buffer.data(), size, report);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Move to a position in the file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::seekTo(uint64_t offset, Report& report)
+{
+    if (_map_data == nullptr) {
+        _file.clear();
+        if (_position != offset && !_file.seekg(std::streamoff(offset))) {
+            return error(report, u"error seeking %s", {_name});
+        }
+    }
+    _position = offset;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Reload the characteristics of a section from the index.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::loadSection(size_t section, Report& report)
+{
+    assert(section < _index._sections.size());
+    const PcapIndex::Section& sec(_index._sections[section]);
+
+    // Read the file or section header.
+    uint8_t magic[4];
+    if (!seekTo(sec.offset, report) || !readall(magic, sizeof(magic), report) || !readHeader(GetUInt32BE(magic), report)) {
+        return false;
+    }
+
+    // Read all interface descriptions of the section.
+    for (auto offset : sec.interfaces) {
+        uint8_t type_field[4];
+        const uint8_t* body = nullptr;
+        size_t body_size = 0;
+        ByteBlock buffer;
+        if (!seekTo(offset, report) ||
+            !readall(type_field, sizeof(type_field), report) ||
+            get32(type_field) != PCAPNG_INTERFACE_DESC ||
+            !readNgBlockBody(PCAPNG_INTERFACE_DESC, body, body_size, buffer, report) ||
+            !analyzeNgInterface(body, body_size, report))
+        {
+            return error(report, u"invalid index for %s, interface description not found at offset %'d", {_name, offset});
+        }
+    }
+    _section = section;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Move to a given captured packet in an indexed file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::seekPacket(size_t number, Report& report)
+{
+    if (_in == nullptr || !_index.isValid()) {
+        report.error(u"no indexed pcap file open");
+        return false;
+    }
+    if (number == 0) {
+        number = 1;
+    }
+    if (number > _index._packets.size()) {
+        // Beyond end of file.
+        _packet_count = _index._packets.size();
+        return error(report);
+    }
+
+    // Reload the section characteristics when moving to another section.
+    const size_t section = _index.sectionOf(number);
+    if (section != _section && !loadSection(section, report)) {
+        return false;
+    }
+
+    // Move to the packet, it will be counted when read.
+    _packet_count = number - 1;
+    _error = false;
+    return seekTo(_index._packets[number - 1], report);
+}
+
+
+//----------------------------------------------------------------------------
+// Restrict the reading of an indexed file to a subset of the captured packets.
+//----------------------------------------------------------------------------
+
+void ts::PcapFile::setPacketView(const PcapIndex::PacketNumbers& numbers)
+{
+    _view = numbers;
+    _view_next = std::upper_bound(_view.begin(), _view.end(), uint32_t(std::min<size_t>(_packet_count, std::numeric_limits<uint32_t>::max()))) - _view.begin();
+    _view_active = true;
+}
+
+void ts::PcapFile::clearPacketView()
+{
+    _view.clear();
+    _view_next = 0;
+    _view_active = false;
+}
+
+
 //----------------------------------------------------------------------------
 // Read a file header, starting from a magic which was read as big endian.
 //----------------------------------------------------------------------------
 
 bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
 {
+    // Offset of the file or section header, the magic number has already been read.
+    const uint64_t offset = _position - 4;
+
+    // Entering a new section, its interfaces are not yet known.
+    _section = NPOS;
+
     switch (magic) {
         case PCAP_MAGIC_BE:
         case PCAP_MAGIC_LE:
@@ -214,15 +465,17 @@ bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
         case PCAPNG_MAGIC: {
             // This is a pcap-ng file. Read the complete section header, compute endianness.
             _ng = true;
-            ByteBlock header;
-            if (!readNgBlockBody(magic, header, report)) {
+            ByteBlock buffer;
+            const uint8_t* header = nullptr;
+            size_t header_size = 0;
+            if (!readNgBlockBody(magic, header, header_size, buffer, report)) {
                 return error(report);
             }
-            if (header.size() < 16) {
+            if (header_size < 16) {
                 return error(report, u"invalid pcap-ng file, truncated section header in %s", {_name});
             }
-            _major = get16(header.data() + 4);
-            _minor = get16(header.data() + 6);
+            _major = get16(header + 4);
+            _minor = get16(header + 6);
             _if.clear(); // will read interface descriptions in dedicated blocks.
             break;
         }
@@ -230,6 +483,11 @@ bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
             return error(report, u"invalid pcap file, unknown magic number 0x%X", {magic});
         }
     }
+
+    // Record the new section when building an index.
+    if (_indexing != nullptr) {
+        _indexing->_sections.push_back(PcapIndex::Section(offset, _packet_count + 1));
+    }
     return true;
 }
 
@@ -293,9 +551,11 @@ bool ts::PcapFile::analyzeNgInterface(const uint8_t* data, size_t size, Report&
 // Read a pcap-ng block. The 32-bit block type has already been read.
 //----------------------------------------------------------------------------
 
-bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report)
+bool ts::PcapFile::readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, ByteBlock& buffer, Report& report)
 {
-    body.clear();
+    body = nullptr;
+    body_size = 0;
+    buffer.clear();
 
     // Read the first "Block Total Length" field.
     uint8_t lenfield[4];
@@ -307,14 +567,14 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     if (block_type == PCAPNG_SECTION_HEADER) {
         // Pcap-ng files have an endian-neutral block-type value for section header.
         // The byte order is defined by the 'byte-order magic' at the beginning of the section header block body.
-        body.resize(4);
-        if (!readall(body.data(), body.size(), report)) {
-            body.clear();
+        buffer.resize(4);
+        if (!readall(buffer.data(), buffer.size(), report)) {
+            buffer.clear();
             return error(report);
         }
-        const uint32_t order_magic = GetUInt32BE(body.data());
+        const uint32_t order_magic = GetUInt32BE(buffer.data());
         if (order_magic != PCAPNG_ORDER_BE && order_magic != PCAPNG_ORDER_LE) {
-            body.clear();
+            buffer.clear();
             return error(report, u"invalid pcap-ng file, unknown 'byte-order magic' 0x%X in %s", {order_magic, _name});
         }
         _be = order_magic == PCAPNG_ORDER_BE;
@@ -323,17 +583,29 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     // Interpret the packet size. The packet size include 12 additional bytes
     // for the block type and the two block length fields.
     const size_t size = get32(lenfield);
-    if (size % 4 != 0 || size < 12 + body.size()) {
-        body.clear();
+    if (size % 4 != 0 || size < 12 + buffer.size()) {
+        buffer.clear();
         return error(report, u"invalid pcap-ng block length %d in %s", {size, _name});
     }
 
-    // Read the rest of the block body.
-    const size_t start = body.size();
-    body.resize(size - 12);
-    if (!readall(body.data() + start, body.size() - start, report)) {
-        body.clear();
-        return error(report);
+    // Read the rest of the block body. In memory-mapped mode, the body of
+    // most blocks is left in place. Section headers are always copied.
+    const size_t start = buffer.size();
+    body_size = size - 12;
+    if (start == 0) {
+        if (!readData(body, body_size, buffer, report)) {
+            body_size = 0;
+            return error(report);
+        }
+    }
+    else {
+        buffer.resize(body_size);
+        if (!readall(buffer.data() + start, buffer.size() - start, report)) {
+            buffer.clear();
+            body_size = 0;
+            return error(report);
+        }
+        body = buffer.data();
     }
 
     // Read and check the last "Block Total Length" field.
@@ -342,7 +614,9 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
     }
     const size_t last_size = get32(lenfield);
     if (size != last_size) {
-        body.clear();
+        body = nullptr;
+        body_size = 0;
+        buffer.clear();
         return error(report, u"inconsistent pcap-ng block length in %s, leading length: %d, trailing length: %d", {_name, size, last_size});
     }
     return true;
@@ -369,18 +643,29 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
         return false;
     }
 
+    // The captured packet will go there, unless it is used in place in the mapped file.
+    ByteBlock buffer;
+
     // Loop on file blocks until an IPv4 packet is found.
     for (;;) {
 
-        // The captured packet will go there.
-        ByteBlock buffer;
-        size_t cap_start = 0;  // captured packet start index in buffer
-        size_t cap_size = 0;   // captured packet size
-        size_t orig_size = 0;  // original packet size (on network)
-        size_t if_index = 0;   // interface index
+        const uint8_t* data = nullptr;  // captured block data
+        size_t data_size = 0;           // captured block size
+        size_t cap_start = 0;           // captured packet start index in data
+        size_t cap_size = 0;            // captured packet size
+        size_t orig_size = 0;           // original packet size (on network)
+        size_t if_index = 0;            // interface index
         timestamp = -1;
 
+        // With a packet view, directly move to the next selected packet.
+        if (_view_active && _index.isValid()) {
+            if (_view_next >= _view.size() || !seekPacket(_view[_view_next++], report)) {
+                return error(report);
+            }
+        }
+
         // We are at the beginning of a data block.
+        const uint64_t block_offset = _position;
         if (_ng) {
             // Pcap-ng file, read block type value.
             uint8_t type_field[4];
@@ -396,25 +681,29 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
                 continue; // loop to next packet block
             }
             // Read one data block.
-            if (!readNgBlockBody(type, buffer, report)) {
+            if (!readNgBlockBody(type, data, data_size, buffer, report)) {
                 return error(report);
             }
             if (type == PCAPNG_INTERFACE_DESC) {
-                // Process an interface description.
-                if (!analyzeNgInterface(buffer.data(), buffer.size(), report)) {
+                // Process an interface description. When the section was loaded
+                // from the index, all its interfaces are already known.
+                if (_section == NPOS && !analyzeNgInterface(data, data_size, report)) {
                     return error(report);
                 }
+                if (_indexing != nullptr && !_indexing->_sections.empty()) {
+                    _indexing->_sections.back().interfaces.push_back(block_offset);
+                }
                 continue; // loop to next packet block
             }
-            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && buffer.size() >= 20) {
+            else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && data_size >= 20) {
                 _packet_count++;
                 cap_start = 20;
-                cap_size = std::min<size_t>(get32(buffer.data() + 12), buffer.size() - 20);
-                orig_size = get32(buffer.data() + 16);
-                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(buffer.data()) : get32(buffer.data());
+                cap_size = std::min<size_t>(get32(data + 12), data_size - 20);
+                orig_size = get32(data + 16);
+                if_index = type == PCAPNG_OBSOLETE_PACKET ? get16(data) : get32(data);
                 if (if_index < _if.size() && _if[if_index].time_units != 0) {
                     const SubSecond units = _if[if_index].time_units;
-                    const SubSecond tstamp = SubSecond(uint64_t(get32(buffer.data() + 4)) << 32) + SubSecond(get32(buffer.data() + 8));
+                    const SubSecond tstamp = SubSecond(uint64_t(get32(data + 4)) << 32) + SubSecond(get32(data + 8));
                     // Take care to overflow in tstamp * MilliSecPerSec. Sometimes, the timestamp is a full time
                     // since 1970 with time unit being 1,000,000,000. The value is close to the 64-bit max.
                     if (units == MicroSecPerSec) {
@@ -434,11 +723,11 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
                     }
                 }
             }
-            else if (type == PCAPNG_SIMPLE_PACKET && buffer.size() >= 4) {
+            else if (type == PCAPNG_SIMPLE_PACKET && data_size >= 4) {
                 _packet_count++;
                 cap_start = 4;
-                orig_size = get32(buffer.data());
-                cap_size = std::min(orig_size, buffer.size() - 4);
+                orig_size = get32(data);
+                cap_size = std::min(orig_size, data_size - 4);
             }
             else {
                 // This data block does not contain a captured packet, ignore it.
@@ -461,12 +750,17 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
             timestamp = (MicroSecond(tstamp) * MicroSecPerSec) + (SubSecond(sub_tstamp) * MicroSecPerSec) / _if[0].time_units;
 
             // Read packet data.
-            buffer.resize(cap_size);
-            if (!readall(buffer.data(), buffer.size(), report)) {
+            data_size = cap_size;
+            if (!readData(data, data_size, buffer, report)) {
                 return error(report);
             }
         }
 
+        // Record the position of the captured packet when building an index.
+        if (_indexing != nullptr) {
+            _indexing->_packets.push_back(block_offset);
+        }
+
         // Now process the captured packet.
         _packets_size += cap_size;
         if (orig_size > cap_size) {
@@ -488,21 +782,21 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
         }
 
         report.log(2, u"pcap data block: %d bytes, captured packet at offset %d, %d bytes (original: %d bytes), link type: %d",
-                   {buffer.size(), cap_start, cap_size, orig_size, ifd.link_type});
+                   {data_size, cap_start, cap_size, orig_size, ifd.link_type});
 
         // Analyze the captured packet, trying to find an IPv4 datagram.
-        if (ifd.link_type == LINKTYPE_NULL && cap_size > 4 && get32(buffer.data() + cap_start) == 2) {
+        if (ifd.link_type == LINKTYPE_NULL && cap_size > 4 && get32(data + cap_start) == 2) {
             // BSD loopback encapsulation; the link layer header is a 4-byte field, in host byte order, containing 2 for IPv4 packets.
             cap_start += 4;
             cap_size -= 4;
         }
-        else if (ifd.link_type == LINKTYPE_LOOP && cap_size > 4 && GetUInt32BE(buffer.data() + cap_start) == 2) {
+        else if (ifd.link_type == LINKTYPE_LOOP && cap_size > 4 && GetUInt32BE(data + cap_start) == 2) {
             // OpenBSD loopback encapsulation; the link-layer header is a 4-byte field, in network byte order, containing 2 for IPv4 packets/
             cap_start += 4;
             cap_size -= 4;
         }
         else if ((ifd.link_type == LINKTYPE_ETHERNET || ifd.link_type == LINKTYPE_NULL || ifd.link_type == LINKTYPE_LOOP) &&
-                 cap_size > ETHER_HEADER_SIZE + ifd.fcs_size && GetUInt16BE(buffer.data() + cap_start + ETHER_TYPE_OFFSET) == ETHERTYPE_IPv4)
+                 cap_size > ETHER_HEADER_SIZE + ifd.fcs_size && GetUInt16BE(data + cap_start + ETHER_TYPE_OFFSET) == ETHERTYPE_IPv4)
         {
             // Ethernet frame: 14-byte header: destination MAC (6 bytes), source MAC (6 bytes), ether type (2 bytes, 0x0800 for IPv4).
             // This should apply to LINKTYPE_ETHERNET only. However, in some pcap files (not pcap-ng), it has been noticed that
@@ -510,7 +804,7 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
             cap_start += ETHER_HEADER_SIZE;
             cap_size -= ETHER_HEADER_SIZE + ifd.fcs_size;
         }
-        else if (ifd.link_type == LINKTYPE_RAW && cap_size >= IPv4_MIN_HEADER_SIZE && (buffer[cap_start] >> 4) == 4) {
+        else if (ifd.link_type == LINKTYPE_RAW && cap_size >= IPv4_MIN_HEADER_SIZE && (data[cap_start] >> 4) == 4) {
             // Raw IPv4 or IPv6 header (version in first byte), no encopsulation.
         }
         else {
@@ -520,7 +814,7 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report&
 
         // A possible IPv4 datagram was found.
         if (cap_size > 0) {
-            if (packet.reset(buffer.data() + cap_start, cap_size)) {
+            if (packet.reset(data + cap_start, cap_size)) {
                 _ipv4_packet_count++;
                 _ipv4_packets_size += cap_size;
                 return true;
@@ -37,6 +37,7 @@
 #include "tsMemory.h"
 #include "tsTime.h"
 #include "tsIPv4Packet.h"
+#include "tsPcapIndex.h"
 
 namespace ts {
     //!
@@ -47,6 +48,14 @@ namespace ts {
     //! This class reads a pcap or pcapng file and extracts IPv4 frames.
     //! All metadata and all other types of frames are ignored.
     //!
+    //! The file can be read in memory-mapped mode, see setMemoryMapped(). In that mode, the
+    //! captured packets are analyzed in place in the mapped file, without intermediate copy.
+    //!
+    //! The file can be read with an index, see setIndexed() and PcapIndex. In that mode, the
+    //! application can directly jump to a given packet (see seekPacket()) or restrict the
+    //! reading to a subset of the captured packets (see setPacketView()), typically the packets
+    //! of a selected flow, without reading the rest of the file.
+    //!
     //! @see https://tools.ietf.org/pdf/draft-gharris-opsawg-pcap-02.pdf (PCAP)
     //! @see https://datatracker.ietf.org/doc/draft-gharris-opsawg-pcap/ (PCAP tracker)
     //! @see https://tools.ietf.org/pdf/draft-tuexen-opsawg-pcapng-04.pdf (PCAP-ng)
@@ -74,6 +83,68 @@ namespace ts {
         //!
         virtual bool open(const UString& filename, Report& report);
 
+        //!
+        //! Set memory-mapped read mode.
+        //! Must be called before open(). The file is mapped in memory when it is a named regular
+        //! file. If the file cannot be mapped, it is silently read using read operations.
+        //! Memory-mapped mode is currently implemented on UNIX systems only.
+        //! @param [in] on If true, map the file in memory.
+        //!
+        void setMemoryMapped(bool on) { _mmap = on; }
+
+        //!
+        //! Check if the file is currently mapped in memory.
+        //! @return True if the file is open and mapped in memory.
+        //!
+        bool isMemoryMapped() const { return _map_data != nullptr; }
+
+        //!
+        //! Use an index of the file.
+        //! Must be called before open(). When the file is opened, the index is loaded from a
+        //! sidecar file. If the index file does not exist or is obsolete, the capture file is
+        //! completely read to build the index and the index file is saved for subsequent uses.
+        //! The standard input cannot be indexed.
+        //! @param [in] on If true, use an index.
+        //! @param [in] index_file Name of the sidecar index file. If empty, use the name of the
+        //! capture file, followed by PcapIndex::DEFAULT_SUFFIX.
+        //!
+        void setIndexed(bool on, const UString& index_file = UString());
+
+        //!
+        //! Check if the file has an index.
+        //! @return True if the file is open and has a valid index.
+        //!
+        bool isIndexed() const { return _index.isValid(); }
+
+        //!
+        //! Get the index of the file.
+        //! @return A constant reference to the index of the file, empty if isIndexed() is false.
+        //!
+        const PcapIndex& index() const { return _index; }
+
+        //!
+        //! Move to a given captured packet in an indexed file.
+        //! The next read operations start at this packet.
+        //! @param [in] number Number of the captured packet, starting at 1.
+        //! If the number is beyond the last packet, the end of file is reached.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error, end of file or if the file is not indexed.
+        //!
+        bool seekPacket(size_t number, Report& report);
+
+        //!
+        //! Restrict the reading of an indexed file to a subset of the captured packets.
+        //! This is typically used to read the packets of a selected flow, see PcapIndex::getFlowPackets().
+        //! The next packet to read is the first packet in the list after the last packet which was read.
+        //! @param [in] numbers List of captured packet numbers to read, in increasing order.
+        //!
+        void setPacketView(const PcapIndex::PacketNumbers& numbers);
+
+        //!
+        //! Read all captured packets, cancel a previous call to setPacketView().
+        //!
+        void clearPacketView();
+
         //!
         //! Check if the file is open.
         //! @return True if the file is open, false otherwise.
@@ -120,6 +191,7 @@ namespace ts {
 
         //!
         //! Get the total file size in bytes so far.
+        //! With an index, this is the position of the last read packet.
         //! @return The total file size in bytes so far.
         //!
         size_t fileSize() const { return _file_size; }
@@ -140,6 +212,7 @@ namespace ts {
 
         //!
         //! Get the capture timestamp of the first packet in the file.
+        //! Without index, this is the first packet which was read.
         //! @return Capture timestamp in microseconds since Unix epoch or -1 if none is available.
         //!
         MicroSecond firstTimestamp() const { return _first_timestamp; }
@@ -171,6 +244,8 @@ namespace ts {
         void close();
 
     private:
+        friend class PcapIndex;
+
         // Descriptioon of one capture interface.
         // Pcap files have only one interface, pcap-ng files may have more.
         class InterfaceDesc
@@ -199,6 +274,18 @@ namespace ts {
         MicroSecond   _first_timestamp;    // Timestamp of first packet in file.
         MicroSecond   _last_timestamp;     // Timestamp of last packet in file.
         std::vector<InterfaceDesc> _if;    // Capture interfaces by index, only one in pcap files.
+        uint64_t      _position;           // Current position in the file.
+        bool          _mmap;               // Memory-mapped read mode is enabled.
+        uint8_t*      _map_data;           // Address of mapped file, null when not mapped.
+        size_t        _map_size;           // Size of the mapped file.
+        bool          _use_index;          // Use an index file.
+        UString       _index_file;         // Name of the index file, empty for default name.
+        PcapIndex     _index;              // Index of the file.
+        PcapIndex*    _indexing;           // When not null, the index which is being built from this file.
+        size_t        _section;            // Index of current section in _index, NPOS if not loaded from the index.
+        bool          _view_active;        // Read only the packets in _view.
+        size_t        _view_next;          // Index in _view of the next packet to read.
+        PcapIndex::PacketNumbers _view;    // Captured packet numbers to read.
 
         // Report an error (if fmt is not empty), set error indicator, return false.
         bool error(Report& report, const UString& fmt = UString(), std::initializer_list<ArgMixIn> args = {});
@@ -206,6 +293,18 @@ namespace ts {
         // Read exactly "size" bytes. Return false if not enough bytes before eof.
         bool readall(uint8_t* data, size_t size, Report& report);
 
+        // Read "size" bytes, in place in the mapped file or in the buffer.
+        bool readData(const uint8_t*& data, size_t size, ByteBlock& buffer, Report& report);
+
+        // Move to a position in the file.
+        bool seekTo(uint64_t offset, Report& report);
+
+        // Load the index, build it if necessary.
+        bool loadIndex(Report& report);
+
+        // Reload the characteristics of a section from the index.
+        bool loadSection(size_t section, Report& report);
+
         // Read a file / section header, starting from a magic number which was read as big endian.
         bool readHeader(uint32_t magic, Report& report);
 
@@ -214,8 +313,8 @@ namespace ts {
 
         // Read a pcap-ng block. The 32-bit block type has already been read.
         // Start at "Block total length". Read complete block, including the two length fields.
-        // Return only the block body.
-        bool readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report);
+        // Return only the block body, in place in the mapped file or in the buffer.
+        bool readNgBlockBody(uint32_t block_type, const uint8_t*& body, size_t& body_size, ByteBlock& buffer, Report& report);
 
         // Read 32 or 16 bits using the endianness.
         uint16_t get16(const void* addr) const { return _be ? GetUInt16BE(addr) : GetUInt16LE(addr); }
@@ -55,7 +55,8 @@ ts::PcapFilter::PcapFilter() :
     _opt_first_time_offset(0),
     _opt_last_time_offset(std::numeric_limits<ts::MicroSecond>::max()),
     _opt_first_time(0),
-    _opt_last_time(std::numeric_limits<ts::MicroSecond>::max())
+    _opt_last_time(std::numeric_limits<ts::MicroSecond>::max()),
+    _view_dirty(true)
 {
 }
 
@@ -95,6 +96,16 @@ void ts::PcapFilter::defineArgs(Args& args)
     args.option(u"last-date", 0, Args::STRING);
     args.help(u"last-date", u"date-time",
          u"Filter packets up to the specified date. Use format YYYY/MM/DD:hh:mm:ss.mmm.");
+
+    args.option(u"index", 0, Args::FILENAME, 0, 1, 0, 0, true);
+    args.help(u"index", u"index-file",
+         u"Use an index of the capture file. "
+         u"With an index, the first selected packet is directly located, without reading the beginning of the file. "
+         u"When addresses or protocols are filtered, only the packets of the corresponding flows are read from the file. "
+         u"By default, the index file is named after the capture file with an additional '.tsidx' suffix. "
+         u"If the index file does not exist or is older than the capture file, "
+         u"the capture file is completely read once to build the index. "
+         u"The standard input cannot be indexed.");
 }
 
 
@@ -135,6 +146,7 @@ bool ts::PcapFilter::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(_opt_last_time_offset, u"last-timestamp", std::numeric_limits<ts::MicroSecond>::max());
     _opt_first_time = getDate(args, u"first-date", 0);
     _opt_last_time = getDate(args, u"last-date", std::numeric_limits<ts::MicroSecond>::max());
+    setIndexed(args.present(u"index"), args.value(u"index"));
     return true;
 }
 
@@ -147,22 +159,26 @@ void ts::PcapFilter::setProtocolFilterTCP()
 {
     _protocols.clear();
     _protocols.insert(IPv4_PROTO_TCP);
+    _view_dirty = true;
 }
 
 void ts::PcapFilter::setProtocolFilterUDP()
 {
     _protocols.clear();
     _protocols.insert(IPv4_PROTO_UDP);
+    _view_dirty = true;
 }
 
 void ts::PcapFilter::setProtocolFilter(const std::set<uint8_t>& protocols)
 {
     _protocols = protocols;
+    _view_dirty = true;
 }
 
 void ts::PcapFilter::clearProtocolFilter()
 {
     _protocols.clear();
+    _view_dirty = true;
 }
 
 
@@ -174,12 +190,14 @@ void ts::PcapFilter::setSourceFilter(const IPv4SocketAddress& addr)
 {
     _source = addr;
     _bidirectional_filter = false;
+    _view_dirty = true;
 }
 
 void ts::PcapFilter::setDestinationFilter(const IPv4SocketAddress& addr)
 {
     _destination = addr;
     _bidirectional_filter = false;
+    _view_dirty = true;
 }
 
 void ts::PcapFilter::setBidirectionalFilter(const IPv4SocketAddress& addr1, const IPv4SocketAddress& addr2)
@@ -187,6 +205,7 @@ void ts::PcapFilter::setBidirectionalFilter(const IPv4SocketAddress& addr1, cons
     _source = addr1;
     _destination = addr2;
     _bidirectional_filter = true;
+    _view_dirty = true;
 }
 
 void ts::PcapFilter::setWildcardFilter(bool on)
@@ -238,17 +257,64 @@ bool ts::PcapFilter::open(const UString& filename, Report& report)
         _last_time_offset = _opt_last_time_offset;
         _first_time = _opt_first_time;
         _last_time = _opt_last_time;
+        _view_dirty = true;
     }
     return ok;
 }
 
 
+//----------------------------------------------------------------------------
+// With an index, move to the first packet and restrict to matching flows.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFilter::updateView(Report& report)
+{
+    // Before the first packet, directly move to the first one which may pass the packet number and time filters.
+    if (packetCount() == 0) {
+        size_t first = std::max<size_t>(_first_packet, 1);
+        if (_first_time > 0) {
+            first = std::max(first, index().firstPacketAtTime(_first_time));
+        }
+        const MicroSecond origin = index().firstTimestamp();
+        if (_first_time_offset > 0 && origin >= 0 && _first_time_offset < std::numeric_limits<MicroSecond>::max() - origin) {
+            first = std::max(first, index().firstPacketAtTime(origin + _first_time_offset));
+        }
+        if (first > 1) {
+            report.debug(u"moving to captured packet #%'d", {first});
+            if (!seekPacket(first, report)) {
+                return false;
+            }
+        }
+    }
+
+    // Restrict the reading to the flows which may pass the protocol and address filters.
+    if (_protocols.empty() && !_source.hasAddress() && !_source.hasPort() && !_destination.hasAddress() && !_destination.hasPort()) {
+        clearPacketView();
+    }
+    else {
+        PcapIndex::PacketNumbers numbers;
+        index().getFlowPackets(numbers, _protocols, _source, _destination, _bidirectional_filter);
+        report.debug(u"reading %'d packets out of %'d from the index", {numbers.size(), index().packetCount()});
+        setPacketView(numbers);
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Read an IPv4 packet, inherited method.
 //----------------------------------------------------------------------------
 
 bool ts::PcapFilter::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report& report)
 {
+    // With an index, directly move to the packets which may match the filters.
+    if (_view_dirty) {
+        _view_dirty = false;
+        if (isIndexed() && !updateView(report)) {
+            return false;
+        }
+    }
+
     // Read packets until one which matches all filters.
     for (;;) {
         // Invoke superclass to read next packet.
@@ -302,6 +368,8 @@ bool ts::PcapFilter::readIPv4(IPv4Packet& packet, MicroSecond& timestamp, Report
         }
 
         if (display_filter) {
+            // The selected stream is now fully specified, restrict the view of the index to that stream.
+            _view_dirty = true;
             report.log(_display_addresses_severity, u"selected stream %s %s %s", {_source, _bidirectional_filter ? u"<->" : u"->", _destination});
         }
 
@@ -45,7 +45,12 @@ namespace ts {
     //!
     //! This class also implements ArgsSupplierInterface to set filtering options
     //! from the command line: @c -\-first-packet, @c -\-first-timestamp,
-    //! @c -\-first-date, @c -\-last-packet, @c -\-last-timestamp, @c -\-last-date.
+    //! @c -\-first-date, @c -\-last-packet, @c -\-last-timestamp, @c -\-last-date,
+    //! @c -\-index.
+    //!
+    //! When the file is indexed, the first packet to read is directly located using the
+    //! packet number and time filters. When protocol or address filters are set, only
+    //! the packets from the matching flows are read from the file.
     //!
     //! @ingroup net
     //!
@@ -261,6 +266,10 @@ namespace ts {
         MicroSecond       _opt_last_time_offset;
         MicroSecond       _opt_first_time;
         MicroSecond       _opt_last_time;
+        bool              _view_dirty;
+
+        // With an index, move to the first packet and restrict reading to the matching flows.
+        bool updateView(Report& report);
 
         // Get a date option and return it as micro-seconds since Unix epoch.
         ts::MicroSecond getDate(Args& args, const ts::UChar* arg_name, ts::MicroSecond def_value);
@@ -0,0 +1,404 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapIndex.h"
+#include "tsPcapFile.h"
+#include "tsIPv4Packet.h"
+#include "tsByteBlock.h"
+#include "tsBuffer.h"
+#include "tsFileUtils.h"
+#include "tsAlgorithm.h"
+
+const ts::UChar* const ts::PcapIndex::DEFAULT_SUFFIX = u".tsidx";
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::PcapIndex::TIME_SAMPLE_INTERVAL;
+#endif
+
+// Identification of an index file.
+namespace {
+    constexpr uint8_t  INDEX_MAGIC[8] = {'T', 'S', 'P', 'C', 'A', 'P', 'I', 'X'};
+    constexpr uint32_t INDEX_VERSION = 1;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PcapIndex::PcapIndex() :
+    _valid(false),
+    _file_size(0),
+    _file_time(0),
+    _first_timestamp(-1),
+    _sections(),
+    _packets(),
+    _max_times(),
+    _flows()
+{
+}
+
+ts::PcapIndex::Section::Section(uint64_t off, size_t first) :
+    offset(off),
+    first_packet(first),
+    interfaces()
+{
+}
+
+ts::PcapIndex::Flow::Flow(uint8_t proto, const IPv4SocketAddress& src, const IPv4SocketAddress& dst) :
+    protocol(proto),
+    source(src),
+    destination(dst)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Comparison operator for flows.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::Flow::operator<(const Flow& other) const
+{
+    if (protocol != other.protocol) {
+        return protocol < other.protocol;
+    }
+    else if (source != other.source) {
+        return source < other.source;
+    }
+    else {
+        return destination < other.destination;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the content of the index.
+//----------------------------------------------------------------------------
+
+void ts::PcapIndex::clear()
+{
+    _valid = false;
+    _file_size = 0;
+    _file_time = 0;
+    _first_timestamp = -1;
+    _sections.clear();
+    _packets.clear();
+    _max_times.clear();
+    _flows.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the size and modification time of a file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::GetFileIdentity(const UString& filename, uint64_t& size, int64_t& time, Report& report)
+{
+    const int64_t fsize = GetFileSize(filename);
+    if (fsize < 0) {
+        report.error(u"cannot get size of %s", {filename});
+        return false;
+    }
+    size = uint64_t(fsize);
+    time = GetFileModificationTimeUTC(filename) - Time::Epoch;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Build the index of a capture file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::build(const UString& filename, Report& report)
+{
+    clear();
+    uint64_t size = 0;
+    int64_t time = 0;
+    if (!GetFileIdentity(filename, size, time, report)) {
+        return false;
+    }
+
+    // Read the complete file. The PcapFile object records the position of all blocks in this index.
+    PcapFile file;
+    file.setMemoryMapped(true);
+    file._indexing = this;
+    if (!file.open(filename, report)) {
+        clear();
+        return false;
+    }
+
+    IPv4Packet pkt;
+    MicroSecond timestamp = -1;
+    while (file.readIPv4(pkt, timestamp, report)) {
+        const size_t number = file.packetCount();
+        if (number > size_t(std::numeric_limits<uint32_t>::max())) {
+            report.error(u"too many packets in %s, cannot build an index", {filename});
+            file.close();
+            clear();
+            return false;
+        }
+        _flows[Flow(pkt.protocol(), pkt.sourceSocketAddress(), pkt.destinationSocketAddress())].push_back(uint32_t(number));
+        if (timestamp >= 0) {
+            // Keep the maximum timestamp up to each interval of packets, this is a non-decreasing sequence.
+            const size_t sample = (number - 1) / TIME_SAMPLE_INTERVAL;
+            while (_max_times.size() <= sample) {
+                _max_times.push_back(_max_times.empty() ? -1 : _max_times.back());
+            }
+            _max_times[sample] = std::max(_max_times[sample], timestamp);
+        }
+    }
+
+    // Extend the table of timestamps to all packets, including non-IPv4 packets at end of file.
+    while (_max_times.size() < (_packets.size() + TIME_SAMPLE_INTERVAL - 1) / TIME_SAMPLE_INTERVAL) {
+        _max_times.push_back(_max_times.empty() ? -1 : _max_times.back());
+    }
+
+    _first_timestamp = file.firstTimestamp();
+    _file_size = size;
+    _file_time = time;
+    _valid = true;
+    file.close();
+
+    report.debug(u"indexed %s, %'d packets, %'d flows, %d sections", {filename, _packets.size(), _flows.size(), _sections.size()});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Save the index in a sidecar file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::save(const UString& index_file, Report& report) const
+{
+    if (!_valid) {
+        report.error(u"no valid pcap index to save");
+        return false;
+    }
+
+    // All values are stored in big endian format.
+    ByteBlock data(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    data.appendUInt32(INDEX_VERSION);
+    data.appendUInt64(_file_size);
+    data.appendInt64(_file_time);
+    data.appendInt64(_first_timestamp);
+    data.appendUInt32(uint32_t(_sections.size()));
+    data.appendUInt64(_packets.size());
+    data.appendUInt32(uint32_t(TIME_SAMPLE_INTERVAL));
+    data.appendUInt64(_max_times.size());
+    data.appendUInt64(_flows.size());
+
+    for (const auto& sec : _sections) {
+        data.appendUInt64(sec.offset);
+        data.appendUInt64(sec.first_packet);
+        data.appendUInt32(uint32_t(sec.interfaces.size()));
+        for (auto off : sec.interfaces) {
+            data.appendUInt64(off);
+        }
+    }
+    for (auto off : _packets) {
+        data.appendUInt64(off);
+    }
+    for (auto time : _max_times) {
+        data.appendInt64(time);
+    }
+    for (const auto& it : _flows) {
+        data.appendUInt8(it.first.protocol);
+        data.appendUInt32(it.first.source.address());
+        data.appendUInt16(it.first.source.port());
+        data.appendUInt32(it.first.destination.address());
+        data.appendUInt16(it.first.destination.port());
+        data.appendUInt64(it.second.size());
+        for (auto num : it.second) {
+            data.appendUInt32(num);
+        }
+    }
+
+    const bool ok = data.saveToFile(index_file, &report);
+    if (ok) {
+        report.debug(u"saved pcap index %s, %'d bytes", {index_file, data.size()});
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Load the index of a capture file from a sidecar file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::load(const UString& index_file, const UString& filename, Report& report)
+{
+    clear();
+
+    uint64_t size = 0;
+    int64_t time = 0;
+    ByteBlock data;
+    if (!GetFileIdentity(filename, size, time, report) || !FileExists(index_file) || !data.loadFromFile(index_file, std::numeric_limits<size_t>::max(), &report)) {
+        return false;
+    }
+
+    // Check the header. The index is silently rejected when obsolete. Use a read-only buffer on the data.
+    Buffer buf(static_cast<const uint8_t*>(data.data()), data.size());
+    if (data.size() < 64 || ::memcmp(data.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        report.error(u"invalid pcap index file %s", {index_file});
+        return false;
+    }
+    buf.skipBytes(sizeof(INDEX_MAGIC));
+    if (buf.getUInt32() != INDEX_VERSION) {
+        report.verbose(u"unsupported pcap index version in %s", {index_file});
+        return false;
+    }
+    _file_size = buf.getUInt64();
+    _file_time = buf.getInt64();
+    if (_file_size != size || _file_time != time) {
+        report.verbose(u"pcap index %s is obsolete, %s was modified", {index_file, filename});
+        clear();
+        return false;
+    }
+    _first_timestamp = buf.getInt64();
+    const size_t sections_count = buf.getUInt32();
+    const uint64_t packets_count = buf.getUInt64();
+    const size_t interval = buf.getUInt32();
+    const uint64_t times_count = buf.getUInt64();
+    const uint64_t flows_count = buf.getUInt64();
+
+    // Check the size of the fixed tables before allocating them.
+    if (interval != TIME_SAMPLE_INTERVAL || packets_count > buf.remainingReadBytes() / 8 || times_count > buf.remainingReadBytes() / 8) {
+        report.error(u"invalid pcap index file %s", {index_file});
+        clear();
+        return false;
+    }
+
+    for (size_t i = 0; !buf.error() && i < sections_count; ++i) {
+        const uint64_t offset = buf.getUInt64();
+        const size_t first_packet = size_t(buf.getUInt64());
+        _sections.push_back(Section(offset, first_packet));
+        const size_t if_count = buf.getUInt32();
+        for (size_t j = 0; !buf.error() && j < if_count; ++j) {
+            _sections.back().interfaces.push_back(buf.getUInt64());
+        }
+    }
+    _packets.resize(size_t(packets_count));
+    for (size_t i = 0; !buf.error() && i < _packets.size(); ++i) {
+        _packets[i] = buf.getUInt64();
+    }
+    _max_times.resize(size_t(times_count));
+    for (size_t i = 0; !buf.error() && i < _max_times.size(); ++i) {
+        _max_times[i] = buf.getInt64();
+    }
+    for (uint64_t i = 0; !buf.error() && i < flows_count; ++i) {
+        Flow flow;
+        flow.protocol = buf.getUInt8();
+        flow.source.setAddress(buf.getUInt32());
+        flow.source.setPort(buf.getUInt16());
+        flow.destination.setAddress(buf.getUInt32());
+        flow.destination.setPort(buf.getUInt16());
+        const uint64_t count = buf.getUInt64();
+        if (count > buf.remainingReadBytes() / 4) {
+            break;
+        }
+        PacketNumbers& numbers(_flows[flow]);
+        numbers.resize(size_t(count));
+        for (size_t j = 0; j < numbers.size(); ++j) {
+            numbers[j] = buf.getUInt32();
+        }
+    }
+
+    if (buf.error() || !buf.endOfRead() || _flows.size() != flows_count || _sections.empty()) {
+        report.error(u"invalid pcap index file %s", {index_file});
+        clear();
+        return false;
+    }
+
+    _valid = true;
+    report.debug(u"loaded pcap index %s, %'d packets, %'d flows, %d sections", {index_file, _packets.size(), _flows.size(), _sections.size()});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the section which contains a given packet number.
+//----------------------------------------------------------------------------
+
+size_t ts::PcapIndex::sectionOf(size_t number) const
+{
+    // Find the last section starting at or before the packet.
+    size_t index = 0;
+    size_t end = _sections.size();
+    while (index + 1 < end) {
+        const size_t mid = (index + end) / 2;
+        if (_sections[mid].first_packet <= number) {
+            index = mid;
+        }
+        else {
+            end = mid;
+        }
+    }
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the first captured packet which may have a given timestamp or later.
+//----------------------------------------------------------------------------
+
+size_t ts::PcapIndex::firstPacketAtTime(MicroSecond timestamp) const
+{
+    // The table of max timestamps is non-decreasing.
+    const auto it = std::lower_bound(_max_times.begin(), _max_times.end(), timestamp);
+    return it == _max_times.end() ? _packets.size() + 1 : size_t(it - _max_times.begin()) * TIME_SAMPLE_INTERVAL + 1;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the captured packet numbers of all flows matching some criteria.
+//----------------------------------------------------------------------------
+
+void ts::PcapIndex::getFlowPackets(PacketNumbers& numbers,
+                                   const std::set<uint8_t>& protocols,
+                                   const IPv4SocketAddress& source,
+                                   const IPv4SocketAddress& destination,
+                                   bool bidirectional) const
+{
+    numbers.clear();
+    size_t count = 0;
+    for (const auto& it : _flows) {
+        const Flow& flow(it.first);
+        if ((protocols.empty() || Contains(protocols, flow.protocol)) &&
+            ((flow.source.match(source) && flow.destination.match(destination)) ||
+             (bidirectional && flow.source.match(destination) && flow.destination.match(source))))
+        {
+            numbers.insert(numbers.end(), it.second.begin(), it.second.end());
+            count++;
+        }
+    }
+    // Merge the packets from several flows.
+    if (count > 1) {
+        std::sort(numbers.begin(), numbers.end());
+    }
+}
@@ -0,0 +1,224 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Index of a pcap or pcapng file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+#include "tsIPv4SocketAddress.h"
+
+namespace ts {
+
+    class PcapFile;
+
+    //!
+    //! Index of a pcap or pcapng capture file.
+    //! @ingroup net
+    //!
+    //! The index is built in one pass over the capture file. It contains the position in
+    //! the file of all captured packets, a sparse table of capture timestamps and, for each
+    //! IPv4 flow (protocol, source and destination), the list of captured packets in that flow.
+    //! With the index, a PcapFile can directly jump to a given packet number or capture time
+    //! and read the packets of selected flows only, without reading the rest of the file.
+    //!
+    //! The index can be saved in a sidecar file and reloaded later. The sidecar file records
+    //! the size and modification time of the capture file. It is ignored when the capture file
+    //! has changed.
+    //!
+    //! Captured packets are numbered from 1, as in the leftmost column in Wireshark interface.
+    //!
+    //! @see PcapFile::setIndexed()
+    //!
+    class TSDUCKDLL PcapIndex
+    {
+        TS_NOCOPY(PcapIndex);
+    public:
+        //!
+        //! Default suffix of a sidecar index file, after the name of the capture file.
+        //!
+        static const UChar* const DEFAULT_SUFFIX;
+
+        //!
+        //! Number of captured packets between two entries in the table of timestamps.
+        //!
+        static constexpr size_t TIME_SAMPLE_INTERVAL = 1024;
+
+        //!
+        //! Identification of an IPv4 flow in a capture file.
+        //! The ports are meaningful only with TCP and UDP.
+        //!
+        class TSDUCKDLL Flow
+        {
+        public:
+            uint8_t           protocol;     //!< IPv4 protocol (IPv4_PROTO_UDP, IPv4_PROTO_TCP, etc.)
+            IPv4SocketAddress source;       //!< Source socket address.
+            IPv4SocketAddress destination;  //!< Destination socket address.
+
+            //!
+            //! Constructor.
+            //! @param [in] proto IPv4 protocol.
+            //! @param [in] src Source socket address.
+            //! @param [in] dst Destination socket address.
+            //!
+            Flow(uint8_t proto = 0, const IPv4SocketAddress& src = IPv4SocketAddress(), const IPv4SocketAddress& dst = IPv4SocketAddress());
+
+            //!
+            //! Comparison operator for use as index in maps.
+            //! @param [in] other Other instance to compare.
+            //! @return True is this object is logically less than @a other.
+            //!
+            bool operator<(const Flow& other) const;
+        };
+
+        //!
+        //! List of captured packet numbers, in increasing order.
+        //!
+        typedef std::vector<uint32_t> PacketNumbers;
+
+        //!
+        //! Map of flows, indexed by flow identification.
+        //!
+        typedef std::map<Flow, PacketNumbers> FlowMap;
+
+        //!
+        //! Default constructor.
+        //!
+        PcapIndex();
+
+        //!
+        //! Clear the content of the index.
+        //!
+        void clear();
+
+        //!
+        //! Check if the index contains a valid description of a capture file.
+        //! @return True if the index was successfully built or loaded.
+        //!
+        bool isValid() const { return _valid; }
+
+        //!
+        //! Build the index of a capture file.
+        //! @param [in] filename Name of the pcap or pcapng file to index.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool build(const UString& filename, Report& report);
+
+        //!
+        //! Load the index of a capture file from a sidecar file.
+        //! @param [in] index_file Name of the index file.
+        //! @param [in] filename Name of the pcap or pcapng file. The index is rejected if the
+        //! file size or modification time of this file do not match the index.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool load(const UString& index_file, const UString& filename, Report& report);
+
+        //!
+        //! Save the index in a sidecar file.
+        //! @param [in] index_file Name of the index file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool save(const UString& index_file, Report& report) const;
+
+        //!
+        //! Get the total number of captured packets in the file.
+        //! @return The total number of captured packets in the file.
+        //!
+        size_t packetCount() const { return _packets.size(); }
+
+        //!
+        //! Get the capture timestamp of the first packet in the file.
+        //! @return Capture timestamp in microseconds since Unix epoch or -1 if none is available.
+        //!
+        MicroSecond firstTimestamp() const { return _first_timestamp; }
+
+        //!
+        //! Get the first captured packet in the file which may have a given capture timestamp or later.
+        //! All IPv4 packets before the returned packet have an earlier capture timestamp.
+        //! @param [in] timestamp Capture timestamp in microseconds since Unix epoch.
+        //! @return The number of the captured packet, starting at 1. This is packetCount() + 1
+        //! when all packets in the file have an earlier capture timestamp.
+        //!
+        size_t firstPacketAtTime(MicroSecond timestamp) const;
+
+        //!
+        //! Get all IPv4 flows in the capture file.
+        //! @return A constant reference to the map of all flows with their captured packet numbers.
+        //!
+        const FlowMap& flows() const { return _flows; }
+
+        //!
+        //! Get the captured packet numbers of all flows matching some criteria.
+        //! @param [out] numbers Merged captured packet numbers of all matching flows, in increasing order.
+        //! @param [in] protocols A set of IPv4 protocols to select. If empty, all protocols are selected.
+        //! @param [in] source Source socket address to match. Unspecified address or port act as wildcard.
+        //! @param [in] destination Destination socket address to match. Unspecified address or port act as wildcard.
+        //! @param [in] bidirectional If true, also select the flows from @a destination to @a source.
+        //!
+        void getFlowPackets(PacketNumbers& numbers,
+                            const std::set<uint8_t>& protocols,
+                            const IPv4SocketAddress& source,
+                            const IPv4SocketAddress& destination,
+                            bool bidirectional = false) const;
+
+    private:
+        friend class PcapFile;
+
+        // Description of one section in the file.
+        // Pcap files have only one section, pcap-ng files may have more.
+        class Section
+        {
+        public:
+            Section(uint64_t off = 0, size_t first = 0);
+            uint64_t              offset;        // Offset of the file header or section header block.
+            size_t                first_packet;  // Number of first captured packet in the section.
+            std::vector<uint64_t> interfaces;    // Offsets of the interface description blocks of the section.
+        };
+
+        bool                     _valid;            // The index is usable.
+        uint64_t                 _file_size;        // Size of the indexed capture file.
+        int64_t                  _file_time;        // Modification time of the indexed capture file (milliseconds since Unix epoch).
+        MicroSecond              _first_timestamp;  // Timestamp of first packet in file.
+        std::vector<Section>     _sections;         // All sections in the file.
+        std::vector<uint64_t>    _packets;          // Offsets of all captured packets, packet number N at index N-1.
+        std::vector<MicroSecond> _max_times;        // Max timestamp of all IPv4 packets up to each interval of TIME_SAMPLE_INTERVAL packets.
+        FlowMap                  _flows;            // All IPv4 flows.
+
+        // Get the section which contains a given packet number.
+        size_t sectionOf(size_t number) const;
+
+        // Get the size and modification time of a file.
+        static bool GetFileIdentity(const UString& filename, uint64_t& size, int64_t& time, Report& report);
+    };
+}
@@ -59,6 +59,9 @@ namespace ts {
     //!
     //! Use addressFilterIsSet() to check if the peers are fully specified.
     //!
+    //! When the file is indexed (see PcapFile::setIndexed()), only the packets of the
+    //! selected TCP session are read from the file. The reassembly runs on this per-flow view.
+    //!
     //! Some effort is made to reassemble repeated or re-ordered TCP packets.
     //! Fragmented IP packets are ignored. It is not possible to rebuild a
     //! TCP session with fragmented packets.
@@ -50,6 +50,7 @@ ts::UDPReceiver::UDPReceiver(ts::Report& report) :
     _recv_timestamps(true), // currently hardcoded, is there a reason to disable it?
     _recv_bufsize(0),
     _recv_timeout(-1),
+    _busy_poll(0),
     _use_source(),
     _first_source(),
     _sources()
@@ -89,6 +90,13 @@ void ts::UDPReceiver::defineArgs(ts::Args& args, bool with_short_options, bool d
     args.option(u"buffer-size", with_short_options ? 'b' : 0, Args::UNSIGNED);
     args.help(u"buffer-size", u"Specify the UDP socket receive buffer size (socket option).");
 
+    args.option(u"busy-poll", 0, Args::UNSIGNED);
+    args.help(u"busy-poll", u"microseconds",
+              u"Linux only: set the busy poll socket option. While waiting for datagrams, the kernel "
+              u"polls the network device queue during the specified duration before sleeping. "
+              u"This reduces the reception latency and jitter at the expense of CPU usage. "
+              u"Ignored on other systems.");
+
     args.option(u"default-interface");
     args.help(u"default-interface",
               u"Let the system find the appropriate local interface on which to listen. "
@@ -178,6 +186,7 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args, size_t index)
     _use_first_source = args.present(u"first-source");
     args.getIntValue(_recv_bufsize, u"buffer-size", 0);
     args.getIntValue(_recv_timeout, u"receive-timeout", _recv_timeout); // preserve previous value
+    args.getIntValue(_busy_poll, u"busy-poll", 0);
 
     // Check the presence of the '@' indicating a source address.
     const size_t sep = destination.find(u'@');
@@ -345,6 +354,7 @@ bool ts::UDPReceiver::open(ts::Report& report)
         setReceiveTimestamps(_recv_timestamps, report) &&
         (_recv_bufsize <= 0 || setReceiveBufferSize(_recv_bufsize, report)) &&
         (_recv_timeout < 0 || setReceiveTimeout(_recv_timeout, report)) &&
+        (_busy_poll <= 0 || setBusyPoll(_busy_poll, report)) &&
         bind(local_addr, report);
 
     // Optional SSM source address.
@@ -395,75 +405,120 @@ bool ts::UDPReceiver::receive(void* data,
             return false;
         }
 
-        // Debug (level 2) message for each message.
-        if (report.maxSeverity() >= 2) {
-            // Prior report level checking to avoid evaluating parameters when not necessary.
-            report.log(2, u"received UDP packet, source: %s, destination: %s, timestamp: %'d", {sender, destination, timestamp != nullptr ? *timestamp : -1});
+        // Check the message against filtering criteria.
+        if (checkMessage(sender, destination, timestamp != nullptr ? *timestamp : -1, report)) {
+            return true;
         }
+    }
+}
 
-        // Check the destination address to exclude packets from other streams.
-        // When several multicast streams use the same destination port and several
-        // applications on the same system listen to these distinct streams,
-        // the multicast MAC address management is such that any socket which
-        // is bound to the common port will receive the traffic for all streams.
-        // This is why we need to check the destination address and exclude
-        // packets which are not from the intended stream.
-        //
-        // We accept a packet in any of:
-        // 1) Actual packet destination is unknown. Probably, the system cannot
-        //    report the destination address.
-        // 2) We listen to a multicast address and the actual destination is the same.
-        // 3) If we listen to unicast traffic and the actual destination is unicast.
-        //    In that case, unicast is by definition sent to us.
-
-        if (destination.hasAddress() && ((_dest_addr.hasAddress() && destination != _dest_addr) || (!_dest_addr.hasAddress() && destination.isMulticast()))) {
-            // This is a spurious packet.
-            if (report.maxSeverity() >= Severity::Debug) {
-                // Prior report level checking to avoid evaluating parameters when not necessary.
-                report.debug(u"rejecting packet, destination: %s, expecting: %s", {destination, _dest_addr});
-            }
-            continue;
+
+//----------------------------------------------------------------------------
+// Receive several messages. Override UDPSocket::receiveMultiple().
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::receiveMultiple(ReceivedMessage* messages, size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    // Loop on packet reception until at least one matching filtering criteria is found.
+    for (;;) {
+
+        // Wait for UDP messages from the superclass.
+        if (!UDPSocket::receiveMultiple(messages, max_count, ret_count, abort, report)) {
+            return false;
         }
 
-        // Keep track of the first sender address.
-        if (!_first_source.hasAddress()) {
-            // First packet, keep address of the sender.
-            _first_source = sender;
-            _sources.insert(sender);
-
-            // With option --first-source, use this one to filter packets.
-            if (_use_first_source) {
-                assert(!_use_source.hasAddress());
-                _use_source = sender;
-                report.verbose(u"now filtering on source address %s", {sender});
+        // Keep messages matching the filtering criteria, in order, at the beginning of the array.
+        size_t count = 0;
+        for (size_t i = 0; i < ret_count; ++i) {
+            if (checkMessage(messages[i].sender, messages[i].destination, messages[i].timestamp, report)) {
+                if (i != count) {
+                    std::swap(messages[i], messages[count]);
+                }
+                count++;
             }
         }
+        ret_count = count;
+        if (ret_count > 0) {
+            return true;
+        }
+    }
+}
 
-        // Keep track of senders (sources) to detect or filter multiple sources.
-        if (_sources.count(sender) == 0) {
-            // Detected an additional source, warn the user that distinct streams are potentially mixed.
-            // If no source filtering is applied, this is a warning since this may affect the resulting stream.
-            // With source filtering, this is just an informational verbose-level message.
-            const int level = _use_source.hasAddress() ? Severity::Verbose : Severity::Warning;
-            if (_sources.size() == 1) {
-                report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination});
-                report.log(level, u"detected source: %s", {_first_source});
-            }
-            report.log(level, u"detected source: %s", {sender});
-            _sources.insert(sender);
+
+//----------------------------------------------------------------------------
+// Check if a received message matches the filtering criteria.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::checkMessage(const IPv4SocketAddress& sender, const IPv4SocketAddress& destination, MicroSecond timestamp, Report& report)
+{
+    // Debug (level 2) message for each message.
+    if (report.maxSeverity() >= 2) {
+        // Prior report level checking to avoid evaluating parameters when not necessary.
+        report.log(2, u"received UDP packet, source: %s, destination: %s, timestamp: %'d", {sender, destination, timestamp});
+    }
+
+    // Check the destination address to exclude packets from other streams.
+    // When several multicast streams use the same destination port and several
+    // applications on the same system listen to these distinct streams,
+    // the multicast MAC address management is such that any socket which
+    // is bound to the common port will receive the traffic for all streams.
+    // This is why we need to check the destination address and exclude
+    // packets which are not from the intended stream.
+    //
+    // We accept a packet in any of:
+    // 1) Actual packet destination is unknown. Probably, the system cannot
+    //    report the destination address.
+    // 2) We listen to a multicast address and the actual destination is the same.
+    // 3) If we listen to unicast traffic and the actual destination is unicast.
+    //    In that case, unicast is by definition sent to us.
+
+    if (destination.hasAddress() && ((_dest_addr.hasAddress() && destination != _dest_addr) || (!_dest_addr.hasAddress() && destination.isMulticast()))) {
+        // This is a spurious packet.
+        if (report.maxSeverity() >= Severity::Debug) {
+            // Prior report level checking to avoid evaluating parameters when not necessary.
+            report.debug(u"rejecting packet, destination: %s, expecting: %s", {destination, _dest_addr});
         }
+        return false;
+    }
 
-        // Filter packets based on source address if requested.
-        if (!sender.match(_use_source)) {
-            // Not the expected source, this is a spurious packet.
-            if (report.maxSeverity() >= Severity::Debug) {
-                // Prior report level checking to avoid evaluating parameters when not necessary.
-                report.debug(u"rejecting packet, source: %s, expecting: %s", {sender, _use_source});
-            }
-            continue;
+    // Keep track of the first sender address.
+    if (!_first_source.hasAddress()) {
+        // First packet, keep address of the sender.
+        _first_source = sender;
+        _sources.insert(sender);
+
+        // With option --first-source, use this one to filter packets.
+        if (_use_first_source) {
+            assert(!_use_source.hasAddress());
+            _use_source = sender;
+            report.verbose(u"now filtering on source address %s", {sender});
         }
+    }
 
-        // Now found a packet matching all criteria.
-        return true;
+    // Keep track of senders (sources) to detect or filter multiple sources.
+    if (_sources.count(sender) == 0) {
+        // Detected an additional source, warn the user that distinct streams are potentially mixed.
+        // If no source filtering is applied, this is a warning since this may affect the resulting stream.
+        // With source filtering, this is just an informational verbose-level message.
+        const int level = _use_source.hasAddress() ? Severity::Verbose : Severity::Warning;
+        if (_sources.size() == 1) {
+            report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination});
+            report.log(level, u"detected source: %s", {_first_source});
+        }
+        report.log(level, u"detected source: %s", {sender});
+        _sources.insert(sender);
     }
+
+    // Filter packets based on source address if requested.
+    if (!sender.match(_use_source)) {
+        // Not the expected source, this is a spurious packet.
+        if (report.maxSeverity() >= Severity::Debug) {
+            // Prior report level checking to avoid evaluating parameters when not necessary.
+            report.debug(u"rejecting packet, source: %s, expecting: %s", {sender, _use_source});
+        }
+        return false;
+    }
+
+    // Now found a packet matching all criteria.
+    return true;
 }
@@ -139,6 +139,11 @@ namespace ts {
                              const AbortInterface* abort = nullptr,
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr) override;
+        virtual bool receiveMultiple(ReceivedMessage* messages,
+                                     size_t max_count,
+                                     size_t& ret_count,
+                                     const AbortInterface* abort = nullptr,
+                                     Report& report = CERR) override;
 
     private:
         bool              _dest_is_parameter;  // Destination address is a command line parameter, not an option.
@@ -154,11 +159,15 @@ namespace ts {
         bool              _recv_timestamps;    // Get receive timestamps.
         size_t            _recv_bufsize;       // Socket receive buffer size.
         MilliSecond       _recv_timeout;       // Receive timeout.
+        MicroSecond       _busy_poll;          // Busy poll duration (Linux only).
         IPv4SocketAddress _use_source;         // Filter on this socket address of sender (can be a simple filter of an SSM source).
         IPv4SocketAddress _first_source;       // Socket address of first received packet.
         IPv4SocketAddressSet _sources;         // Set of all detected packet sources.
 
         // Get the command line argument for the destination parameter.
         const UChar* destinationOptionName() const { return _dest_is_parameter ? u"" : u"ip-udp"; }
+
+        // Check if a received message matches the filtering criteria, update the list of sources.
+        bool checkMessage(const IPv4SocketAddress& sender, const IPv4SocketAddress& destination, MicroSecond timestamp, Report& report);
     };
 }
@@ -30,9 +30,10 @@
 #include "tsUDPSocket.h"
 #include "tsNullReport.h"
 
-// Network timestampting feature in Linux.
+// Network timestampting and UDP segmentation offload features in Linux.
 #if defined(TS_LINUX)
 #include <linux/net_tstamp.h>
+#include <netinet/udp.h>
 #endif
 
 // Furiously idiotic Windows feature, see comment in receiveOne()
@@ -40,6 +41,60 @@
 volatile ::LPFN_WSARECVMSG ts::UDPSocket::_wsaRevcMsg = 0;
 #endif
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::UDPSocket::MAX_RECEIVE_BATCH;
+constexpr size_t ts::UDPSocket::MAX_SEND_BATCH;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Analyze the ancillary data of a received message (UNIX only).
+//----------------------------------------------------------------------------
+
+#if !defined(TS_WINDOWS)
+namespace {
+    void GetAncillaryData(::msghdr& hdr, uint16_t port, ts::IPv4SocketAddress& destination, ts::MicroSecond* timestamp)
+    {
+        // Because of invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
+        TS_PUSH_WARNING()
+        TS_GCC_NOWARNING(zero-as-null-pointer-constant)
+
+        // Browse returned ancillary data.
+        for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+
+            // Look for destination IP address.
+            // IP_PKTINFO is used on all Unix, except FreeBSD.
+#if defined(IP_PKTINFO)
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
+                const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
+                destination = ts::IPv4SocketAddress(info->ipi_addr, port);
+            }
+#elif defined(IP_RECVDSTADDR)
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVDSTADDR && cmsg->cmsg_len >= sizeof(::in_addr)) {
+                const ::in_addr* info = reinterpret_cast<const ::in_addr*>(CMSG_DATA(cmsg));
+                destination = ts::IPv4SocketAddress(*info, port);
+            }
+#endif
+
+            // On Linux, look for receive timestamp.
+#if defined(TS_LINUX)
+            else if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS && cmsg->cmsg_len >= sizeof(::timespec)) {
+                // System time stamp in nanosecond.
+                const ::timespec* tspec = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
+                const ts::NanoSecond nano = ts::NanoSecond(tspec->tv_sec) * ts::NanoSecPerSec + ts::NanoSecond(tspec->tv_nsec);
+                // System time stamp is valid when not zero, convert it to micro-seconds.
+                if (nano != 0) {
+                    *timestamp = nano / ts::NanoSecPerMicroSec;
+                }
+            }
+#endif
+        }
+
+        TS_POP_WARNING()
+    }
+}
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -50,7 +105,8 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     _local_address(),
     _default_destination(),
     _mcast(),
-    _ssmcast()
+    _ssmcast(),
+    _gso(false)
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -252,6 +308,26 @@ bool ts::UDPSocket::setReceiveTimestamps(bool on, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Set the busy polling duration on reception.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setBusyPoll(MicroSecond duration, Report& report)
+{
+    // The option exists only on Linux and is silently ignored on other systems.
+#if defined(TS_LINUX) && defined(SO_BUSY_POLL)
+    int usecs = int(std::max<MicroSecond>(0, duration));
+    report.debug(u"setting socket busy poll to %'d micro-seconds", {usecs});
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)) != 0) {
+        report.error(u"socket option SO_BUSY_POLL: " + SysSocketErrorCodeMessage());
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Enable or disable the broadcast option.
 //----------------------------------------------------------------------------
@@ -432,6 +508,150 @@ bool ts::UDPSocket::send(const void* data, size_t size, const IPv4SocketAddress&
 }
 
 
+//----------------------------------------------------------------------------
+// Enable or disable UDP segmentation offload in sendMultiple().
+//----------------------------------------------------------------------------
+
+void ts::UDPSocket::setSegmentationOffload(bool on, Report& report)
+{
+#if defined(TS_LINUX) && defined(UDP_SEGMENT)
+    _gso = on;
+#else
+    if (on) {
+        report.warning(u"UDP segmentation offload is not supported on this system");
+    }
+    _gso = false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Description of one message in a multiple transmission.
+//----------------------------------------------------------------------------
+
+ts::UDPSocket::OutgoingMessage::OutgoingMessage(const void* data_, size_t size_) :
+    data(data_),
+    size(size_)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Send several messages to the default destination address and port.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendMultiple(const OutgoingMessage* messages, size_t count, Report& report)
+{
+#if defined(TS_LINUX)
+
+    // Limits of UDP segmentation offload in the Linux kernel: max number
+    // of segments per buffer and max UDP payload size of the buffer.
+    constexpr size_t GSO_MAX_SEGMENTS = 64;
+    constexpr size_t GSO_MAX_SIZE = 65507;
+
+    ::sockaddr addr;
+    _default_destination.copy(addr);
+
+    while (count > 0) {
+
+        // Build the system message headers, grouping segmented messages when possible.
+        ::mmsghdr hdrs[MAX_SEND_BATCH];
+        ::iovec iov[MAX_SEND_BATCH];
+        size_t segments[MAX_SEND_BATCH];
+#if defined(UDP_SEGMENT)
+        uint8_t ancil_data[MAX_SEND_BATCH][CMSG_SPACE(sizeof(uint16_t))];
+#endif
+        TS_ZERO(hdrs);
+        size_t hcount = 0;
+        size_t index = 0;
+
+        while (index < count && hcount < MAX_SEND_BATCH) {
+            const OutgoingMessage& first(messages[index]);
+            size_t seg_count = 1;
+            size_t total_size = first.size;
+
+            // With segmentation offload, group subsequent messages which are contiguous in memory.
+            // All segments but the last one must have the same size as the first one.
+            while (_gso &&
+                   index + seg_count < count &&
+                   seg_count < GSO_MAX_SEGMENTS &&
+                   messages[index + seg_count - 1].size == first.size &&
+                   messages[index + seg_count].size <= first.size &&
+                   total_size + messages[index + seg_count].size <= GSO_MAX_SIZE &&
+                   messages[index + seg_count].data == reinterpret_cast<const uint8_t*>(first.data) + total_size)
+            {
+                total_size += messages[index + seg_count].size;
+                seg_count++;
+            }
+
+            iov[hcount].iov_base = const_cast<void*>(first.data);
+            iov[hcount].iov_len = total_size;
+            ::msghdr& hdr(hdrs[hcount].msg_hdr);
+            hdr.msg_name = &addr;
+            hdr.msg_namelen = sizeof(addr);
+            hdr.msg_iov = &iov[hcount];
+            hdr.msg_iovlen = 1;
+
+#if defined(UDP_SEGMENT)
+            if (seg_count > 1) {
+                // Specify the segment size in ancillary data.
+                hdr.msg_control = ancil_data[hcount];
+                hdr.msg_controllen = sizeof(ancil_data[hcount]);
+                ::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                const uint16_t seg_size = uint16_t(first.size);
+                ::memcpy(CMSG_DATA(cmsg), &seg_size, sizeof(seg_size));
+            }
+#endif
+
+            segments[hcount++] = seg_count;
+            index += seg_count;
+        }
+
+        // Send all messages in one system call.
+        const int ret = ::sendmmsg(getSocket(), hdrs, (unsigned int)(hcount), 0);
+        if (ret < 0) {
+            const SysSocketErrorCode err = LastSysSocketErrorCode();
+            if (err == EINTR) {
+                // Interrupted by a signal, retry.
+                continue;
+            }
+            else if (_gso && (err == EIO || err == EINVAL || err == ENOPROTOOPT)) {
+                // Segmentation offload not supported by the network interface, retry without.
+                report.verbose(u"UDP segmentation offload not supported, disabling it: %s", {SysSocketErrorCodeMessage(err)});
+                _gso = false;
+                continue;
+            }
+            else {
+                report.error(u"error sending UDP messages: " + SysSocketErrorCodeMessage(err));
+                return false;
+            }
+        }
+
+        // Skip all sent messages.
+        for (size_t i = 0; i < size_t(ret); ++i) {
+            messages += segments[i];
+            count -= segments[i];
+        }
+    }
+    return true;
+
+#else
+
+    // Other systems: send messages one by one.
+    for (size_t i = 0; i < count; ++i) {
+        if (!send(messages[i].data, messages[i].size, report)) {
+            return false;
+        }
+    }
+    return true;
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 // If abort interface is non-zero, invoke it when I/O is interrupted
@@ -491,6 +711,76 @@ bool ts::UDPSocket::receive(void* data,
 }
 
 
+//----------------------------------------------------------------------------
+// Receive several messages.
+//----------------------------------------------------------------------------
+
+ts::UDPSocket::ReceivedMessage::ReceivedMessage(void* data_, size_t max_size_) :
+    data(data_),
+    max_size(max_size_),
+    size(0),
+    sender(),
+    destination(),
+    timestamp(-1)
+{
+}
+
+bool ts::UDPSocket::receiveMultiple(ReceivedMessage* messages, size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    ret_count = 0;
+    if (messages == nullptr || max_count == 0) {
+        return true;
+    }
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+
+        // Wait for messages.
+        const SysSocketErrorCode err = receiveBatch(messages, max_count, ret_count, report);
+
+        if (abort != nullptr && abort->aborting()) {
+            // Aborting, no error message.
+            ret_count = 0;
+            return false;
+        }
+        else if (err == SYS_SUCCESS) {
+            // Sometimes, we get "successful" empty message coming from nowhere. Ignore them.
+            size_t count = 0;
+            for (size_t i = 0; i < ret_count; ++i) {
+                if (messages[i].size > 0 || messages[i].sender.hasAddress()) {
+                    if (i != count) {
+                        std::swap(messages[i], messages[count]);
+                    }
+                    count++;
+                }
+            }
+            ret_count = count;
+            if (ret_count > 0) {
+                return true;
+            }
+        }
+        else if (abort != nullptr && abort->aborting()) {
+            // User-interrupt, end of processing but no error message
+            return false;
+        }
+#if !defined(TS_WINDOWS)
+        else if (err == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+#endif
+        else {
+            // Abort on non-interrupt errors.
+            if (isOpen()) {
+                // Report the error only if the error does not result from a close in another thread.
+                report.error(u"error receiving from UDP socket: %s", {SysSocketErrorCodeMessage(err)});
+            }
+            return false;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Perform one receive operation. Hide the system mud.
 //----------------------------------------------------------------------------
@@ -606,48 +896,84 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
         return LastSysSocketErrorCode();
     }
 
-    // Because of invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
-    TS_PUSH_WARNING()
-    TS_GCC_NOWARNING(zero-as-null-pointer-constant)
+    // Analyze ancillary data: destination address, receive timestamp.
+    GetAncillaryData(hdr, _local_address.port(), destination, timestamp);
 
-    // Browse returned ancillary data.
-    for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+#endif // Windows vs. UNIX
 
-        // Look for destination IP address.
-        // IP_PKTINFO is used on all Unix, except FreeBSD.
-#if defined(IP_PKTINFO)
-        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
-            const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
-            destination = IPv4SocketAddress(info->ipi_addr, _local_address.port());
-        }
-#elif defined(IP_RECVDSTADDR)
-        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVDSTADDR && cmsg->cmsg_len >= sizeof(::in_addr)) {
-            const ::in_addr* info = reinterpret_cast<const ::in_addr*>(CMSG_DATA(cmsg));
-            destination = IPv4SocketAddress(*info, _local_address.port());
-        }
-#endif
+    // Successfully received a message
+    ret_size = size_t(insize);
+    sender = IPv4SocketAddress(sender_sock);
 
-        // On Linux, look for receive timestamp.
-#if defined(TS_LINUX)
-        else if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS && cmsg->cmsg_len >= sizeof(::timespec)) {
-            // System time stamp in nanosecond.
-            const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
-            const NanoSecond nano = NanoSecond(ts->tv_sec) * NanoSecPerSec + NanoSecond(ts->tv_nsec);
-            // System time stamp is valid when not zero, convert it to micro-seconds.
-            if (nano != 0) {
-                *timestamp = nano / NanoSecPerMicroSec;
-            }
-        }
-#endif
+    return SYS_SUCCESS;
+}
+
+
+//----------------------------------------------------------------------------
+// Perform one receive operation for several messages.
+//----------------------------------------------------------------------------
+
+ts::SysSocketErrorCode ts::UDPSocket::receiveBatch(ReceivedMessage* messages, size_t max_count, size_t& ret_count, Report& report)
+{
+    ret_count = 0;
+    max_count = std::min(max_count, MAX_RECEIVE_BATCH);
+
+    // Clear returned values
+    for (size_t i = 0; i < max_count; ++i) {
+        messages[i].size = 0;
+        messages[i].sender.clear();
+        messages[i].destination.clear();
+        messages[i].timestamp = -1;
     }
 
-    TS_POP_WARNING()
+#if defined(TS_LINUX)
 
-#endif // Windows vs. UNIX
+    // Reserve message headers, socket addresses and ancillary data for all messages.
+    // Ancillary data contain the destination address and the receive timestamp only.
+    constexpr size_t ANCIL_SIZE = 256;
+    ::mmsghdr hdr[MAX_RECEIVE_BATCH];
+    ::iovec vec[MAX_RECEIVE_BATCH];
+    ::sockaddr sender_sock[MAX_RECEIVE_BATCH];
+    uint8_t ancil_data[MAX_RECEIVE_BATCH][ANCIL_SIZE];
+    TS_ZERO(hdr);
+    TS_ZERO(sender_sock);
 
-    // Successfully received a message
-    ret_size = size_t(insize);
-    sender = IPv4SocketAddress(sender_sock);
+    for (size_t i = 0; i < max_count; ++i) {
+        vec[i].iov_base = messages[i].data;
+        vec[i].iov_len = messages[i].max_size;
+        hdr[i].msg_hdr.msg_name = &sender_sock[i];
+        hdr[i].msg_hdr.msg_namelen = sizeof(sender_sock[i]);
+        hdr[i].msg_hdr.msg_iov = &vec[i];
+        hdr[i].msg_hdr.msg_iovlen = 1; // number of iovec structures
+        hdr[i].msg_hdr.msg_control = ancil_data[i];
+        hdr[i].msg_hdr.msg_controllen = ANCIL_SIZE;
+    }
 
+    // Wait for the first message, then get all messages which are already there.
+    const int count = ::recvmmsg(getSocket(), hdr, ::uint(max_count), MSG_WAITFORONE, nullptr);
+
+    if (count < 0) {
+        return LastSysSocketErrorCode();
+    }
+
+    // Successfully received messages
+    ret_count = size_t(count);
+    for (size_t i = 0; i < ret_count; ++i) {
+        messages[i].size = size_t(hdr[i].msg_len);
+        messages[i].sender = IPv4SocketAddress(sender_sock[i]);
+        GetAncillaryData(hdr[i].msg_hdr, _local_address.port(), messages[i].destination, &messages[i].timestamp);
+    }
     return SYS_SUCCESS;
+
+#else
+
+    // Without recvmmsg, receive one message only.
+    ReceivedMessage& msg(messages[0]);
+    const SysSocketErrorCode err = receiveOne(msg.data, msg.max_size, msg.size, msg.sender, msg.destination, report, &msg.timestamp);
+    if (err == SYS_SUCCESS) {
+        ret_count = 1;
+    }
+    return err;
+
+#endif
 }
@@ -203,6 +203,20 @@ namespace ts {
         //!
         bool setReceiveTimestamps(bool on, Report& report = CERR);
 
+        //!
+        //! Set the busy polling duration on reception (Linux only).
+        //!
+        //! When set, a blocking receive operation first polls the network device queue for the
+        //! specified duration before sleeping. This reduces the latency and the jitter of the
+        //! reception at the expense of CPU usage. On systems other than Linux, the option is
+        //! silently ignored.
+        //!
+        //! @param [in] duration Busy polling duration in micro-seconds. Zero disables busy polling.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setBusyPoll(MicroSecond duration, Report& report = CERR);
+
         //!
         //! Enable or disable the broadcast option.
         //!
@@ -303,6 +317,66 @@ namespace ts {
         //!
         virtual bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Description of one message in a multiple transmission (see sendMultiple()).
+        //!
+        class TSDUCKDLL OutgoingMessage
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data_ Address of the message to send.
+            //! @param [in] size_ Size in bytes of the message to send.
+            //!
+            OutgoingMessage(const void* data_ = nullptr, size_t size_ = 0);
+
+            //!
+            //! Copy constructor.
+            //! @param [in] other Other instance to copy.
+            //!
+            OutgoingMessage(const OutgoingMessage& other) = default;
+
+            //!
+            //! Assignment operator.
+            //! @param [in] other Other instance to copy.
+            //! @return A reference to this object.
+            //!
+            OutgoingMessage& operator=(const OutgoingMessage& other) = default;
+
+            const void* data;  //!< Address of the message to send.
+            size_t      size;  //!< Size in bytes of the message to send.
+        };
+
+        //!
+        //! Maximum number of messages which are sent in one system call by sendMultiple().
+        //!
+        static constexpr size_t MAX_SEND_BATCH = 64;
+
+        //!
+        //! Enable or disable UDP segmentation offload (GSO) in sendMultiple().
+        //! This feature is available on Linux only. When enabled, consecutive messages of the same
+        //! size which are contiguous in memory are passed to the kernel as one single large buffer
+        //! which is split into individual UDP datagrams by the kernel or the network interface.
+        //! On other systems, a warning is reported and the feature remains disabled.
+        //! @param [in] on If true, enable segmentation offload when possible.
+        //! @param [in,out] report Where to report error.
+        //!
+        void setSegmentationOffload(bool on, Report& report = CERR);
+
+        //!
+        //! Send several messages to the default destination address and port.
+        //!
+        //! Each message is sent as one UDP datagram, in order. On Linux, up to MAX_SEND_BATCH messages
+        //! are sent in one single system call (@c sendmmsg). On other systems, one message is sent
+        //! at a time.
+        //!
+        //! @param [in] messages Address of an array of @a count message descriptions.
+        //! @param [in] count Number of messages to send.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendMultiple(const OutgoingMessage* messages, size_t count, Report& report = CERR);
+
         //!
         //! Receive a message.
         //!
@@ -330,6 +404,70 @@ namespace ts {
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr);
 
+        //!
+        //! Description of one message in a multiple reception (see receiveMultiple()).
+        //!
+        class TSDUCKDLL ReceivedMessage
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data_ Address of the buffer for the received message.
+            //! @param [in] max_size_ Size in bytes of the reception buffer.
+            //!
+            ReceivedMessage(void* data_ = nullptr, size_t max_size_ = 0);
+
+            //!
+            //! Copy constructor.
+            //! @param [in] other Other instance to copy.
+            //!
+            ReceivedMessage(const ReceivedMessage& other) = default;
+
+            //!
+            //! Assignment operator.
+            //! @param [in] other Other instance to copy.
+            //! @return A reference to this object.
+            //!
+            ReceivedMessage& operator=(const ReceivedMessage& other) = default;
+
+            void*             data;         //!< [in] Address of the buffer for the received message.
+            size_t            max_size;     //!< [in] Size in bytes of the reception buffer.
+            size_t            size;         //!< [out] Size in bytes of the received message, never larger than @a max_size.
+            IPv4SocketAddress sender;       //!< [out] Socket address of the sender.
+            IPv4SocketAddress destination;  //!< [out] Socket address of the packet destination.
+            MicroSecond       timestamp;    //!< [out] Receive timestamp in micro-seconds, negative if not available.
+        };
+
+        //!
+        //! Maximum number of messages which are received in one system call by receiveMultiple().
+        //!
+        static constexpr size_t MAX_RECEIVE_BATCH = 64;
+
+        //!
+        //! Receive several messages.
+        //!
+        //! The method waits for at least one message and then returns all messages which are
+        //! immediately available, up to @a max_count and MAX_RECEIVE_BATCH. On Linux, all messages
+        //! are received in one single system call (@c recvmmsg). On other systems, one message is
+        //! received at a time.
+        //!
+        //! @param [in,out] messages Address of an array of @a max_count message descriptions.
+        //! On input, the fields @a data and @a max_size describe the reception buffers. On output,
+        //! the received messages are in the first @a ret_count elements of the array. The elements
+        //! of the array may have been swapped, always use the field @a data of each element.
+        //! @param [in] max_count Maximum number of messages to receive.
+        //! @param [out] ret_count Number of received messages.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted
+        //! (in case of user-interrupt, return, otherwise retry).
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool receiveMultiple(ReceivedMessage* messages,
+                                     size_t max_count,
+                                     size_t& ret_count,
+                                     const AbortInterface* abort = nullptr,
+                                     Report& report = CERR);
+
         // Implementation of Socket interface.
         virtual bool open(Report& report = CERR) override;
         virtual bool close(Report& report = CERR) override;
@@ -389,10 +527,14 @@ namespace ts {
         IPv4SocketAddress _default_destination;
         MReqSet           _mcast;    // Current set of multicast memberships
         SSMReqSet         _ssmcast;  // Current set of source-specific multicast memberships
+        bool              _gso;      // Use UDP segmentation offload in sendMultiple()
 
         // Perform one receive operation. Hide the system mud.
         SysSocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, IPv4SocketAddress& sender, IPv4SocketAddress& destination, Report& report, MicroSecond* timestamp);
 
+        // Perform one receive operation for several messages.
+        SysSocketErrorCode receiveBatch(ReceivedMessage* messages, size_t max_count, size_t& ret_count, Report& report);
+
         // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
         static volatile ::LPFN_WSARECVMSG _wsaRevcMsg;
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsUDPStreamSelector.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::UDPStreamSelector::UDPStreamSelector(const IPv4SocketAddress& source, const IPv4SocketAddress& destination, bool multicast_only) :
+    _source(source),
+    _destination(destination),
+    _multicast_only(multicast_only),
+    _all_sources()
+{
+}
+
+void ts::UDPStreamSelector::reset(const IPv4SocketAddress& source, const IPv4SocketAddress& destination, bool multicast_only)
+{
+    _source = source;
+    _destination = destination;
+    _multicast_only = multicast_only;
+    _all_sources.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the addresses of a datagram match the current filters.
+//----------------------------------------------------------------------------
+
+bool ts::UDPStreamSelector::match(const IPv4SocketAddress& source, const IPv4SocketAddress& destination) const
+{
+    // If the destination is not yet found, filter multicast addresses if required.
+    return source.match(_source) &&
+           destination.match(_destination) &&
+           (_destination.hasAddress() || !_multicast_only || destination.isMulticast());
+}
+
+
+//----------------------------------------------------------------------------
+// Select the destination of the stream.
+//----------------------------------------------------------------------------
+
+void ts::UDPStreamSelector::setDestination(const IPv4SocketAddress& destination, Report& report)
+{
+    _destination = destination;
+    report.verbose(u"using UDP destination address %s", {destination});
+}
+
+
+//----------------------------------------------------------------------------
+// Register the source of a selected datagram.
+//----------------------------------------------------------------------------
+
+void ts::UDPStreamSelector::addSource(const IPv4SocketAddress& source, Report& report)
+{
+    if (_all_sources.find(source) == _all_sources.end()) {
+        // This is a new source address.
+        report.verbose(u"%s UDP source address %s", {_all_sources.empty() ? u"using" : u"adding", source});
+        _all_sources.insert(source);
+    }
+}
@@ -0,0 +1,117 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Select one UDP stream from captured IPv4 packets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsIPv4SocketAddress.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Select one UDP stream from captured IPv4 packets.
+    //! @ingroup net
+    //!
+    //! This class is used by input plugins which capture raw IPv4 packets, from a
+    //! pcap file or from a network interface, and extract one UDP stream.
+    //!
+    //! The source and destination socket addresses may be partially specified. The
+    //! unspecified parts act as wildcards for the source. For the destination, the
+    //! first datagram which matches the wildcard and contains the expected type of
+    //! data (as checked by the application) selects the destination of the stream.
+    //! Then, only the datagrams with this destination are selected.
+    //!
+    class TSDUCKDLL UDPStreamSelector
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] source Source socket address to filter.
+        //! @param [in] destination Destination socket address to filter.
+        //! @param [in] multicast_only While the destination address is unknown, select multicast addresses only.
+        //!
+        UDPStreamSelector(const IPv4SocketAddress& source = IPv4SocketAddress(),
+                          const IPv4SocketAddress& destination = IPv4SocketAddress(),
+                          bool multicast_only = false);
+
+        //!
+        //! Reset the selector with new filters.
+        //! @param [in] source Source socket address to filter.
+        //! @param [in] destination Destination socket address to filter.
+        //! @param [in] multicast_only While the destination address is unknown, select multicast addresses only.
+        //!
+        void reset(const IPv4SocketAddress& source, const IPv4SocketAddress& destination, bool multicast_only);
+
+        //!
+        //! Check if the addresses of a datagram match the current filters.
+        //! @param [in] source Source socket address of the datagram.
+        //! @param [in] destination Destination socket address of the datagram.
+        //! @return True if the datagram matches the filters.
+        //!
+        bool match(const IPv4SocketAddress& source, const IPv4SocketAddress& destination) const;
+
+        //!
+        //! Check if the destination of the stream is fully known (address and port).
+        //! @return True if the destination of the stream is fully known.
+        //!
+        bool hasDestination() const { return _destination.hasAddress() && _destination.hasPort(); }
+
+        //!
+        //! Get the current destination filter.
+        //! @return A constant reference to the current destination filter.
+        //!
+        const IPv4SocketAddress& destination() const { return _destination; }
+
+        //!
+        //! Select the destination of the stream.
+        //! Typically called on the first matching datagram which contains the expected type of data.
+        //! All subsequent datagrams must have this destination.
+        //! @param [in] destination Destination socket address of the datagram.
+        //! @param [in,out] report Where to report the selected address (verbose level).
+        //!
+        void setDestination(const IPv4SocketAddress& destination, Report& report);
+
+        //!
+        //! Register the source of a selected datagram.
+        //! New source addresses are reported as they appear.
+        //! @param [in] source Source socket address of the datagram.
+        //! @param [in,out] report Where to report new source addresses (verbose level).
+        //!
+        void addSource(const IPv4SocketAddress& source, Report& report);
+
+    private:
+        IPv4SocketAddress    _source;          // Source filter.
+        IPv4SocketAddress    _destination;     // Destination filter, fully set after selection.
+        bool                 _multicast_only;  // Select multicast destinations only, before selection.
+        IPv4SocketAddressSet _all_sources;     // All source addresses.
+    };
+}
@@ -0,0 +1,76 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Runtime selection of hardware-accelerated engines (internal).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSysInfo.h"
+
+namespace ts {
+    //!
+    //! Runtime selection of a hardware-accelerated engine (internal).
+    //! @ingroup cpp
+    //!
+    //! The engine is selected once, on first use, according to the features of the CPU.
+    //! The Intel engine is used if the library was compiled with the corresponding instructions,
+    //! otherwise the Arm engine, if any.
+    //!
+    //! @tparam ENGINE Description of the engine, typically a structure of function pointers.
+    //! @tparam CPU_SUPPORT Method of SysInfo which indicates if the CPU supports the required instructions.
+    //! @tparam INTEL Function returning the Intel engine or a null pointer if not compiled.
+    //! @tparam ARM Function returning the Arm engine or a null pointer if not compiled.
+    //!
+    template <typename ENGINE, bool (SysInfo::*CPU_SUPPORT)() const, const ENGINE* (*INTEL)(), const ENGINE* (*ARM)()>
+    class AcceleratedEngineSelector
+    {
+    public:
+        //!
+        //! Get the hardware-accelerated engine.
+        //! @return Address of the engine description or a null pointer if there is no hardware acceleration.
+        //!
+        static const ENGINE* Get()
+        {
+            static const ENGINE* const engine = Select();
+            return engine;
+        }
+
+    private:
+        static const ENGINE* Select()
+        {
+            if ((SysInfo::Instance()->*CPU_SUPPORT)()) {
+                const ENGINE* engine = INTEL();
+                return engine != nullptr ? engine : ARM();
+            }
+            return nullptr;
+        }
+    };
+}
@@ -0,0 +1,656 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAsyncFileIO.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+#include "tsMemory.h"
+#include "tsIntegerUtils.h"
+
+// The io_uring interface is used on Linux when the kernel headers provide it.
+#if defined(TS_LINUX) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #define TS_IO_URING 1
+    #endif
+#endif
+
+#if defined(TS_IO_URING)
+    #include "tsBeforeStandardHeaders.h"
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    #include <sys/mman.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::AsyncFileIO::DEFAULT_QUEUE_DEPTH;
+constexpr size_t ts::AsyncFileIO::MAX_QUEUE_DEPTH;
+constexpr size_t ts::AsyncFileIO::DEFAULT_BUFFER_SIZE;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Description of an io_uring (Linux only).
+//----------------------------------------------------------------------------
+
+#if defined(TS_IO_URING)
+
+class ts::AsyncFileIO::Ring
+{
+    TS_NOCOPY(Ring);
+public:
+    Ring();
+    ~Ring() { release(); }
+
+    // Create and release the io_uring.
+    bool setup(unsigned int entries, Report& report);
+    void release();
+
+    // Register buffers in the kernel.
+    bool registerBuffers(const std::vector<Slot>& slots, size_t buffer_size, Report& report);
+
+    // Get the next free submission queue entry, cleared. Return null if the queue is full.
+    ::io_uring_sqe* getSQE();
+
+    // Submit all new entries and wait for at least min_complete completions.
+    bool enter(unsigned int min_complete, Report& report);
+
+    // Get next completion, if any. Return false if there is none.
+    bool getCQE(uint64_t& user_data, int& result);
+
+private:
+    int             _fd;
+    void*           _sq_ptr;
+    size_t          _sq_size;
+    void*           _cq_ptr;
+    size_t          _cq_size;
+    ::io_uring_sqe* _sqes;
+    size_t          _sqes_size;
+    unsigned int*   _sq_head;
+    unsigned int*   _sq_tail;
+    unsigned int*   _sq_mask;
+    unsigned int*   _sq_array;
+    unsigned int*   _cq_head;
+    unsigned int*   _cq_tail;
+    unsigned int*   _cq_mask;
+    ::io_uring_cqe* _cqes;
+    unsigned int    _sq_local_tail;  // Submission queue tail, including unpublished entries.
+    unsigned int    _to_submit;      // Number of entries which were not yet submitted.
+};
+
+ts::AsyncFileIO::Ring::Ring() :
+    _fd(-1),
+    _sq_ptr(MAP_FAILED),
+    _sq_size(0),
+    _cq_ptr(MAP_FAILED),
+    _cq_size(0),
+    _sqes(nullptr),
+    _sqes_size(0),
+    _sq_head(nullptr),
+    _sq_tail(nullptr),
+    _sq_mask(nullptr),
+    _sq_array(nullptr),
+    _cq_head(nullptr),
+    _cq_tail(nullptr),
+    _cq_mask(nullptr),
+    _cqes(nullptr),
+    _sq_local_tail(0),
+    _to_submit(0)
+{
+}
+
+bool ts::AsyncFileIO::Ring::setup(unsigned int entries, Report& report)
+{
+    ::io_uring_params params;
+    TS_ZERO(params);
+
+    _fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+    if (_fd < 0) {
+        report.debug(u"io_uring_setup error: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+
+    // IORING_OP_READ and IORING_OP_WRITE appeared in the same kernel version as this feature.
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        report.debug(u"io_uring read and write operations not supported by kernel");
+        release();
+        return false;
+    }
+
+    // Map the submission and completion queues, possibly in one single mapping.
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+    }
+    _sq_ptr = ::mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_sq_ptr != MAP_FAILED) {
+        _cq_ptr = single_mmap ? _sq_ptr : ::mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+    }
+    if (_cq_ptr != MAP_FAILED) {
+        _sqes_size = params.sq_entries * sizeof(::io_uring_sqe);
+        void* sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+        _sqes = sqes == MAP_FAILED ? nullptr : reinterpret_cast<::io_uring_sqe*>(sqes);
+    }
+    if (_sqes == nullptr) {
+        report.debug(u"io_uring mmap error: %s", {SysErrorCodeMessage()});
+        release();
+        return false;
+    }
+
+    uint8_t* const sq = reinterpret_cast<uint8_t*>(_sq_ptr);
+    uint8_t* const cq = reinterpret_cast<uint8_t*>(_cq_ptr);
+    _sq_head = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+    _sq_mask = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+    _cq_head = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+    _cq_mask = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+    _sq_local_tail = *_sq_tail;
+    _to_submit = 0;
+    return true;
+}
+
+void ts::AsyncFileIO::Ring::release()
+{
+    if (_sqes != nullptr) {
+        ::munmap(_sqes, _sqes_size);
+        _sqes = nullptr;
+    }
+    if (_cq_ptr != MAP_FAILED && _cq_ptr != _sq_ptr) {
+        ::munmap(_cq_ptr, _cq_size);
+    }
+    if (_sq_ptr != MAP_FAILED) {
+        ::munmap(_sq_ptr, _sq_size);
+    }
+    _sq_ptr = _cq_ptr = MAP_FAILED;
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool ts::AsyncFileIO::Ring::registerBuffers(const std::vector<Slot>& slots, size_t buffer_size, Report& report)
+{
+    std::vector<::iovec> iov(slots.size());
+    for (size_t i = 0; i < slots.size(); ++i) {
+        iov[i].iov_base = slots[i].data;
+        iov[i].iov_len = buffer_size;
+    }
+    if (::syscall(__NR_io_uring_register, _fd, IORING_REGISTER_BUFFERS, iov.data(), unsigned(iov.size())) < 0) {
+        // Typically a locked memory limit, this is not an error, use unregistered buffers.
+        report.debug(u"cannot register io_uring buffers: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+    return true;
+}
+
+::io_uring_sqe* ts::AsyncFileIO::Ring::getSQE()
+{
+    const unsigned int head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+    if (_sq_local_tail - head > *_sq_mask) {
+        return nullptr; // queue full
+    }
+    const unsigned int index = _sq_local_tail & *_sq_mask;
+    ::io_uring_sqe* sqe = &_sqes[index];
+    TS_ZERO(*sqe);
+    _sq_array[index] = index;
+    _sq_local_tail++;
+    _to_submit++;
+    return sqe;
+}
+
+bool ts::AsyncFileIO::Ring::enter(unsigned int min_complete, Report& report)
+{
+    // Publish the new submission queue entries.
+    __atomic_store_n(_sq_tail, _sq_local_tail, __ATOMIC_RELEASE);
+    const unsigned int flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        const long ret = ::syscall(__NR_io_uring_enter, _fd, _to_submit, min_complete, flags, nullptr, 0);
+        if (ret >= 0) {
+            _to_submit -= std::min<unsigned int>(_to_submit, unsigned(ret));
+            return true;
+        }
+        const SysErrorCode err = LastSysErrorCode();
+        if (err != EINTR && err != EAGAIN) {
+            report.error(u"io_uring_enter error: %s", {SysErrorCodeMessage(err)});
+            return false;
+        }
+    }
+}
+
+bool ts::AsyncFileIO::Ring::getCQE(uint64_t& user_data, int& result)
+{
+    const unsigned int head = *_cq_head;
+    if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+        return false; // no completion
+    }
+    const ::io_uring_cqe& cqe(_cqes[head & *_cq_mask]);
+    user_data = cqe.user_data;
+    result = cqe.res;
+    __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::AsyncFileIO::AsyncFileIO() :
+    _is_open(false),
+    _write(false),
+    _registered(false),
+    _fd(-1),
+    _buffer_size(0),
+    _next_offset(0),
+    _current(0),
+    _buffers(nullptr),
+    _slots(),
+    _ring(nullptr)
+{
+}
+
+ts::AsyncFileIO::~AsyncFileIO()
+{
+    cleanup();
+}
+
+
+//----------------------------------------------------------------------------
+// Check if asynchronous I/O is supported on this system.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::IsSupported()
+{
+#if defined(TS_IO_URING)
+    // Try once to create an io_uring. It can be disabled by the kernel configuration or a sandbox.
+    static const bool supported = Ring().setup(2, NULLREP);
+    return supported;
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Start asynchronous I/O on an open file.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::open(int fd, bool write, uint64_t offset, size_t queue_depth, size_t buffer_size, Report& report)
+{
+    if (_is_open) {
+        report.error(u"asynchronous I/O already started");
+        return false;
+    }
+
+#if defined(TS_IO_URING)
+
+    _write = write;
+    _fd = fd;
+    _current = 0;
+    _next_offset = offset;
+
+    // Round the buffer size to a multiple of the page size.
+    const size_t page_size = size_t(::sysconf(_SC_PAGESIZE));
+    _buffer_size = round_up(std::max<size_t>(buffer_size, page_size), page_size);
+    queue_depth = std::max<size_t>(2, std::min(queue_depth, MAX_QUEUE_DEPTH));
+
+    // Allocate all buffers, aligned on memory pages.
+    void* mem = nullptr;
+    if (::posix_memalign(&mem, page_size, queue_depth * _buffer_size) != 0) {
+        report.error(u"cannot allocate %'d bytes for asynchronous I/O", {queue_depth * _buffer_size});
+        return false;
+    }
+    _buffers = reinterpret_cast<uint8_t*>(mem);
+    _slots.resize(queue_depth);
+    for (size_t i = 0; i < queue_depth; ++i) {
+        _slots[i].data = _buffers + i * _buffer_size;
+        _slots[i].offset = 0;
+        _slots[i].size = _slots[i].done = 0;
+        _slots[i].error = 0;
+        _slots[i].pending = false;
+    }
+
+    // Create the io_uring. Failing to register the buffers is not an error.
+    _ring = new Ring;
+    if (!_ring->setup(unsigned(queue_depth), report)) {
+        cleanup();
+        return false;
+    }
+    _registered = _ring->registerBuffers(_slots, _buffer_size, report);
+    _is_open = true;
+
+    report.debug(u"asynchronous %s, %d buffers of %'d bytes%s", {write ? u"write" : u"read", queue_depth, _buffer_size, _registered ? u", registered" : u""});
+
+    // In read mode, immediately start reading ahead.
+    return write || seek(offset, report);
+
+#else
+
+    report.debug(u"asynchronous I/O not supported on this system");
+    return false;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Stop asynchronous I/O.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::close(Report& report)
+{
+    if (!_is_open) {
+        return true;
+    }
+
+    bool ok = true;
+    if (_write) {
+        // Write the last incomplete buffer.
+        Slot& slot(_slots[_current]);
+        if (!slot.pending && slot.size > 0) {
+#if defined(TS_IO_URING)
+            // With direct I/O (O_DIRECT), an incomplete block cannot be written.
+            // Wait for all previous writes and write the last buffer through the page cache.
+            const int flags = ::fcntl(_fd, F_GETFL);
+            if (flags >= 0 && (flags & O_DIRECT) != 0 && slot.size % size_t(::sysconf(_SC_PAGESIZE)) != 0) {
+                ok = waitAll(report);
+                ::fcntl(_fd, F_SETFL, flags & ~O_DIRECT);
+            }
+#endif
+            slot.offset = _next_offset;
+            _next_offset += slot.size;
+            ok = startIO(_current, report) && ok;
+        }
+        // Wait for all writes and report errors.
+        ok = waitAll(report) && ok;
+        for (auto& it : _slots) {
+            if (it.error != 0) {
+                report.error(u"error writing file: %s", {SysErrorCodeMessage(it.error)});
+                ok = false;
+            }
+        }
+    }
+    else {
+        // Wait for all pending reads, ignore errors.
+        waitAll(NULLREP);
+    }
+
+    cleanup();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Release all resources.
+//----------------------------------------------------------------------------
+
+void ts::AsyncFileIO::cleanup()
+{
+#if defined(TS_IO_URING)
+    // Releasing the io_uring waits for all I/O in progress.
+    delete _ring;
+    _ring = nullptr;
+    ::free(_buffers);
+#endif
+    _buffers = nullptr;
+    _slots.clear();
+    _is_open = false;
+    _registered = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Start an I/O on a buffer.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::startIO(size_t index, Report& report)
+{
+#if defined(TS_IO_URING)
+    Slot& slot(_slots[index]);
+    ::io_uring_sqe* sqe = _ring->getSQE();
+    if (sqe == nullptr) {
+        report.error(u"internal error, io_uring submission queue full");
+        return false;
+    }
+
+    // In write mode, write the remaining part of the buffer.
+    // In read mode, read a complete buffer.
+    sqe->opcode = uint8_t(_write ? (_registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE) : (_registered ? IORING_OP_READ_FIXED : IORING_OP_READ));
+    sqe->fd = _fd;
+    sqe->off = slot.offset + (_write ? slot.done : 0);
+    sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(slot.data + (_write ? slot.done : 0)));
+    sqe->len = uint32_t(_write ? slot.size - slot.done : _buffer_size);
+    sqe->buf_index = uint16_t(_registered ? index : 0);
+    sqe->user_data = index;
+    slot.error = 0;
+    slot.pending = true;
+
+    // Submit immediately to overlap the I/O with the processing of the application.
+    return _ring->enter(0, report);
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for the completion of an I/O on a buffer.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::waitIO(size_t index, Report& report)
+{
+#if defined(TS_IO_URING)
+    while (_slots[index].pending) {
+        // Process all available completions, wait for more if necessary.
+        uint64_t user_data = 0;
+        int result = 0;
+        if (!_ring->getCQE(user_data, result)) {
+            if (!_ring->enter(1, report)) {
+                return false;
+            }
+            continue;
+        }
+        if (user_data >= _slots.size()) {
+            continue; // should not happen
+        }
+        Slot& slot(_slots[user_data]);
+        slot.pending = false;
+        if (result < 0) {
+            slot.error = -result;
+        }
+        else if (!_write) {
+            // A short read means end of file.
+            slot.size = size_t(result);
+            slot.done = 0;
+        }
+        else if (result == 0) {
+            slot.error = EIO;
+        }
+        else {
+            slot.done += size_t(result);
+            if (slot.done < slot.size) {
+                // Short write, write the rest.
+                if (!startIO(size_t(user_data), report)) {
+                    return false;
+                }
+            }
+            else {
+                // Complete write, the buffer is free.
+                slot.size = slot.done = 0;
+            }
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ts::AsyncFileIO::waitAll(Report& report)
+{
+    bool ok = true;
+    for (size_t i = 0; ok && i < _slots.size(); ++i) {
+        ok = waitIO(i, report);
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Restart reading at a given position in the file.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::seek(uint64_t offset, Report& report)
+{
+    if (!_is_open || _write) {
+        report.error(u"asynchronous I/O not started in read mode");
+        return false;
+    }
+
+    // Discard all read-ahead data.
+    if (!waitAll(report)) {
+        return false;
+    }
+
+    // Start reading all buffers, in sequence.
+    _current = 0;
+    _next_offset = offset;
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        _slots[i].offset = _next_offset;
+        _slots[i].size = _slots[i].done = 0;
+        _next_offset += _buffer_size;
+        if (!startIO(i, report)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read data in read mode.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::read(void* addr, size_t max_size, size_t& ret_size, bool& eof, Report& report)
+{
+    ret_size = 0;
+    eof = false;
+
+    if (!_is_open || _write) {
+        report.error(u"asynchronous I/O not started in read mode");
+        return false;
+    }
+
+    while (max_size > 0) {
+        Slot& slot(_slots[_current]);
+        if (slot.pending && !waitIO(_current, report)) {
+            return false;
+        }
+        if (slot.error != 0) {
+            report.error(u"error reading file: %s", {SysErrorCodeMessage(slot.error)});
+            return false;
+        }
+        if (slot.done < slot.size) {
+            // Return data from the current buffer.
+            ret_size = std::min(max_size, slot.size - slot.done);
+            ::memcpy(addr, slot.data + slot.done, ret_size);
+            slot.done += ret_size;
+            return true;
+        }
+        if (slot.size < _buffer_size) {
+            // The current buffer is completely used and was partially read, this is the end of file.
+            eof = true;
+            return false;
+        }
+        // The current buffer is completely used, read the next buffer ahead and use the next one.
+        slot.offset = _next_offset;
+        slot.size = slot.done = 0;
+        _next_offset += _buffer_size;
+        if (!startIO(_current, report)) {
+            return false;
+        }
+        _current = (_current + 1) % _slots.size();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Write data in write mode.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncFileIO::write(const void* addr, size_t size, Report& report)
+{
+    if (!_is_open || !_write) {
+        report.error(u"asynchronous I/O not started in write mode");
+        return false;
+    }
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(addr);
+    while (size > 0) {
+        Slot& slot(_slots[_current]);
+        if (slot.pending && !waitIO(_current, report)) {
+            return false;
+        }
+        if (slot.error != 0) {
+            report.error(u"error writing file: %s", {SysErrorCodeMessage(slot.error)});
+            slot.error = 0;
+            return false;
+        }
+
+        // Fill the current buffer.
+        const size_t count = std::min(size, _buffer_size - slot.size);
+        ::memcpy(slot.data + slot.size, data, count);
+        slot.size += count;
+        data += count;
+        size -= count;
+
+        // Write the buffer when full and use the next one.
+        if (slot.size == _buffer_size) {
+            slot.offset = _next_offset;
+            slot.done = 0;
+            _next_offset += slot.size;
+            if (!startIO(_current, report)) {
+                return false;
+            }
+            _current = (_current + 1) % _slots.size();
+        }
+    }
+    return true;
+}
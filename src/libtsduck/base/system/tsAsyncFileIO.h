@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Asynchronous sequential file I/O.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Asynchronous sequential file I/O.
+    //! @ingroup system
+    //!
+    //! This class reads or writes a regular file sequentially while keeping several I/O operations
+    //! in flight. In read mode, the next buffers are read ahead while the application processes
+    //! the previous ones. In write mode, full buffers are written behind while the application
+    //! fills the next ones. The buffers are aligned on memory pages and, when possible, registered
+    //! in the kernel.
+    //!
+    //! In write mode, the file descriptor may use direct I/O (O_DIRECT) when the initial offset is
+    //! aligned on a memory page. All buffers are written at aligned offsets, except the last one,
+    //! which is written through the page cache when its size is not a multiple of the page size.
+    //!
+    //! The implementation uses io_uring on Linux, using direct system calls (no dependency on liburing).
+    //! On other systems or when io_uring is not available, open() fails and the application shall
+    //! fall back to synchronous I/O.
+    //!
+    //! An instance is not thread-safe and shall be used by one single thread.
+    //!
+    class TSDUCKDLL AsyncFileIO
+    {
+        TS_NOCOPY(AsyncFileIO);
+    public:
+        //!
+        //! Default number of I/O operations in flight.
+        //!
+        static constexpr size_t DEFAULT_QUEUE_DEPTH = 4;
+        //!
+        //! Maximum number of I/O operations in flight.
+        //!
+        static constexpr size_t MAX_QUEUE_DEPTH = 64;
+        //!
+        //! Default size in bytes of each I/O buffer.
+        //!
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+        //!
+        //! Constructor.
+        //!
+        AsyncFileIO();
+
+        //!
+        //! Destructor.
+        //!
+        ~AsyncFileIO();
+
+        //!
+        //! Check if asynchronous I/O is supported on this system.
+        //! @return True if asynchronous I/O is supported.
+        //!
+        static bool IsSupported();
+
+        //!
+        //! Start asynchronous I/O on an open file.
+        //! The file descriptor remains owned by the application. It shall not be closed before close().
+        //! @param [in] fd File descriptor of a regular file (UNIX systems only).
+        //! @param [in] write If true, the file is sequentially written. Otherwise, it is sequentially read.
+        //! @param [in] offset Initial offset in the file.
+        //! @param [in] queue_depth Maximum number of I/O operations in flight, from 2 to MAX_QUEUE_DEPTH.
+        //! @param [in] buffer_size Size in bytes of each I/O buffer. Rounded up to a multiple of the page size.
+        //! @param [in,out] report Where to report errors. If asynchronous I/O is not available, the error is
+        //! reported at debug level since the application is expected to fall back to synchronous I/O.
+        //! @return True on success, false on error.
+        //!
+        bool open(int fd, bool write, uint64_t offset, size_t queue_depth, size_t buffer_size, Report& report);
+
+        //!
+        //! Check if asynchronous I/O is started.
+        //! @return True if asynchronous I/O is started.
+        //!
+        bool isOpen() const { return _is_open; }
+
+        //!
+        //! Stop asynchronous I/O.
+        //! In write mode, all pending data are written first.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
+        //!
+        //! Read data in read mode.
+        //! The method waits for the next data if they were not yet read.
+        //! @param [out] addr Address of the buffer for the returned data.
+        //! @param [in] max_size Maximum size in bytes of the returned data.
+        //! @param [out] ret_size Returned size in bytes. Can be lower than @a max_size.
+        //! @param [out] eof Set to true when the end of file is reached.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error or end of file.
+        //!
+        bool read(void* addr, size_t max_size, size_t& ret_size, bool& eof, Report& report);
+
+        //!
+        //! Write data in write mode.
+        //! The data are copied in the I/O buffers and written later.
+        //! A write error may be reported by a subsequent call or by close().
+        //! @param [in] addr Address of the data to write.
+        //! @param [in] size Size in bytes of the data to write.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool write(const void* addr, size_t size, Report& report);
+
+        //!
+        //! Restart reading at a given position in the file, in read mode.
+        //! All data which were read ahead are discarded.
+        //! @param [in] offset New offset in the file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool seek(uint64_t offset, Report& report);
+
+    private:
+        // Description of an I/O buffer.
+        struct Slot
+        {
+            uint8_t* data;     // Address of the buffer.
+            uint64_t offset;   // Offset in file of the buffer content.
+            size_t   size;     // Read mode: size of valid data. Write mode: size of data to write.
+            size_t   done;     // Read mode: size of data which were returned. Write mode: size of written data.
+            int      error;    // Error code of last I/O (0 on success).
+            bool     pending;  // An I/O is in progress on the buffer.
+        };
+
+        bool              _is_open;      // Asynchronous I/O is started.
+        bool              _write;        // Write mode (read mode otherwise).
+        bool              _registered;   // The buffers are registered in the kernel.
+        int               _fd;           // File descriptor.
+        size_t            _buffer_size;  // Size of each buffer.
+        uint64_t          _next_offset;  // Offset in file of the next I/O to start.
+        size_t            _current;      // Index of current buffer in _slots.
+        uint8_t*          _buffers;      // Base address of all buffers.
+        std::vector<Slot> _slots;        // Description of all buffers.
+
+        // Description of the io_uring (Linux only, opaque here).
+        class Ring;
+        Ring* _ring;
+
+        // Start an I/O on a buffer. Wait for the completion of an I/O on a buffer.
+        bool startIO(size_t index, Report& report);
+        bool waitIO(size_t index, Report& report);
+        bool waitAll(Report& report);
+
+        // Release all resources.
+        void cleanup();
+    };
+}
@@ -0,0 +1,332 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsCPUTopology.h"
+
+#include "tsBeforeStandardHeaders.h"
+#include <thread>
+#if defined(TS_LINUX)
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+#include "tsAfterStandardHeaders.h"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::CPUTopology::MAX_CPUS;
+#endif
+
+#if defined(TS_LINUX)
+static_assert(ts::CPUTopology::MAX_CPUS <= CPU_SETSIZE, "MAX_CPUS must not exceed CPU_SETSIZE");
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::CPUTopology::CPUTopology() :
+    _cpu_set(),
+    _cpus()
+{
+    reload();
+}
+
+ts::CPUTopology::CPUInfo::CPUInfo(size_t index) :
+    cpu(index),
+    package(0),
+    core(index),
+    l2(index),
+    l3(0),
+    primary(true)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Placement order of CPU's: same package, same L3, same L2, core, CPU index.
+//----------------------------------------------------------------------------
+
+bool ts::CPUTopology::CPUInfo::operator<(const CPUInfo& other) const
+{
+    if (primary != other.primary) {
+        return primary;
+    }
+    else if (package != other.package) {
+        return package < other.package;
+    }
+    else if (l3 != other.l3) {
+        return l3 < other.l3;
+    }
+    else if (l2 != other.l2) {
+        return l2 < other.l2;
+    }
+    else if (core != other.core) {
+        return core < other.core;
+    }
+    else {
+        return cpu < other.cpu;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Load the topology of the system.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+namespace {
+    // Read the first line of a text file in /sys/devices/system/cpu.
+    bool ReadCPUFile(ts::UString& line, size_t cpu, const ts::UString& file)
+    {
+        ts::UStringList lines;
+        line.clear();
+        if (!ts::UString::Load(lines, ts::UString::Format(u"/sys/devices/system/cpu/cpu%d/%s", {cpu, file})) || lines.empty()) {
+            return false;
+        }
+        line = lines.front();
+        line.trim();
+        return true;
+    }
+}
+#endif
+
+void ts::CPUTopology::reload()
+{
+    _cpu_set.clear();
+    _cpus.clear();
+
+#if defined(TS_LINUX)
+
+    // Get the list of online CPU's.
+    UStringList lines;
+    if (!UString::Load(lines, u"/sys/devices/system/cpu/online") || lines.empty() || !ParseCPUList(_cpu_set, lines.front())) {
+        _cpu_set.clear();
+    }
+
+    // Keep only the CPU's which are allowed for the current process.
+    ::cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        if (_cpu_set.empty()) {
+            for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    _cpu_set.insert(cpu);
+                }
+            }
+        }
+        else {
+            for (auto it = _cpu_set.begin(); it != _cpu_set.end(); ) {
+                if (*it < CPU_SETSIZE && CPU_ISSET(*it, &allowed)) {
+                    ++it;
+                }
+                else {
+                    it = _cpu_set.erase(it);
+                }
+            }
+        }
+    }
+
+    // Load the topology of each usable CPU.
+    for (auto cpu : _cpu_set) {
+        CPUInfo info(cpu);
+        UString line;
+        CPUSet siblings;
+        if (ReadCPUFile(line, cpu, u"topology/physical_package_id")) {
+            line.toInteger(info.package);
+        }
+        if (ReadCPUFile(line, cpu, u"topology/core_id")) {
+            line.toInteger(info.core);
+        }
+        if (ReadCPUFile(line, cpu, u"topology/thread_siblings_list") && ParseCPUList(siblings, line) && !siblings.empty()) {
+            info.primary = *siblings.begin() == cpu;
+        }
+        // Explore all caches of the CPU, ignore instruction caches.
+        for (size_t index = 0; ReadCPUFile(line, cpu, UString::Format(u"cache/index%d/level", {index})); ++index) {
+            size_t level = 0;
+            UString type;
+            CPUSet shared;
+            if (line.toInteger(level) &&
+                (level == 2 || level == 3) &&
+                ReadCPUFile(type, cpu, UString::Format(u"cache/index%d/type", {index})) &&
+                !type.similar(u"Instruction") &&
+                ReadCPUFile(line, cpu, UString::Format(u"cache/index%d/shared_cpu_list", {index})) &&
+                ParseCPUList(shared, line) &&
+                !shared.empty())
+            {
+                (level == 2 ? info.l2 : info.l3) = *shared.begin();
+            }
+        }
+        _cpus.push_back(info);
+    }
+
+#endif
+
+    // Default topology: independent CPU's.
+    if (_cpus.empty()) {
+        _cpu_set.clear();
+        const size_t count = std::max<size_t>(1, std::thread::hardware_concurrency());
+        for (size_t cpu = 0; cpu < count; ++cpu) {
+            _cpu_set.insert(cpu);
+            _cpus.push_back(CPUInfo(cpu));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the description of one CPU.
+//----------------------------------------------------------------------------
+
+const ts::CPUTopology::CPUInfo* ts::CPUTopology::getInfo(size_t cpu) const
+{
+    for (const auto& info : _cpus) {
+        if (info.cpu == cpu) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if two logical CPU's share a cache of a given level.
+//----------------------------------------------------------------------------
+
+bool ts::CPUTopology::shareCache(size_t cpu1, size_t cpu2, size_t level) const
+{
+    const CPUInfo* const info1 = getInfo(cpu1);
+    const CPUInfo* const info2 = getInfo(cpu2);
+    if (info1 == nullptr || info2 == nullptr) {
+        return false;
+    }
+    else if (cpu1 == cpu2) {
+        return true;
+    }
+    else if (level == 2) {
+        return info1->l2 == info2->l2;
+    }
+    else if (level == 3) {
+        return info1->package == info2->package && info1->l3 == info2->l3;
+    }
+    else {
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get an ordered list of logical CPU's to place a chain of cooperating threads.
+//----------------------------------------------------------------------------
+
+std::vector<size_t> ts::CPUTopology::placementOrder() const
+{
+    std::vector<CPUInfo> sorted(_cpus);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<size_t> order;
+    order.reserve(sorted.size());
+    for (const auto& info : sorted) {
+        order.push_back(info.cpu);
+    }
+    return order;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a list of CPU's.
+//----------------------------------------------------------------------------
+
+bool ts::CPUTopology::ParseCPUList(CPUSet& cpus, const UString& list, size_t max_cpus)
+{
+    cpus.clear();
+    if (max_cpus > MAX_CPUS) {
+        max_cpus = MAX_CPUS;
+    }
+    UStringVector items;
+    list.split(items, u',', true, true);
+    for (const auto& item : items) {
+        size_t first = 0;
+        size_t last = 0;
+        const size_t dash = item.find(u'-');
+        if (dash == NPOS) {
+            if (!item.toInteger(first)) {
+                return false;
+            }
+            last = first;
+        }
+        else if (!item.substr(0, dash).toInteger(first) || !item.substr(dash + 1).toInteger(last) || last < first) {
+            return false;
+        }
+        if (last >= max_cpus) {
+            cpus.clear();
+            return false;
+        }
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of configured logical CPU's.
+//----------------------------------------------------------------------------
+
+size_t ts::CPUTopology::ConfiguredCPUCount()
+{
+#if defined(TS_LINUX)
+    const long count = ::sysconf(_SC_NPROCESSORS_CONF);
+#else
+    const long count = long(std::thread::hardware_concurrency());
+#endif
+    return count <= 0 ? 1 : (size_t(count) > MAX_CPUS ? MAX_CPUS : size_t(count));
+}
+
+
+//----------------------------------------------------------------------------
+// Format a list of CPU's.
+//----------------------------------------------------------------------------
+
+ts::UString ts::CPUTopology::FormatCPUList(const CPUSet& cpus)
+{
+    UString list;
+    for (auto it = cpus.begin(); it != cpus.end(); ) {
+        // Find the end of a range of consecutive CPU's.
+        const size_t first = *it;
+        size_t last = first;
+        while (++it != cpus.end() && *it == last + 1) {
+            last = *it;
+        }
+        if (!list.empty()) {
+            list.append(u',');
+        }
+        list.append(first == last ? UString::Decimal(first, 0, true, UString()) : UString::Format(u"%d-%d", {first, last}));
+    }
+    return list;
+}
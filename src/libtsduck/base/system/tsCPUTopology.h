@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Description of the CPU and cache topology of the system.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsThreadAttributes.h"
+
+namespace ts {
+    //!
+    //! Description of the CPU and cache topology of the system.
+    //! @ingroup system
+    //!
+    //! This class is used to place cooperating threads on logical CPU's which share
+    //! caches. On Linux, the topology is read from /sys/devices/system/cpu and only
+    //! the CPU's which are allowed for the current process are used. On other systems,
+    //! all CPU's are considered as independent and sharing the same caches.
+    //!
+    class TSDUCKDLL CPUTopology
+    {
+    public:
+        //!
+        //! Maximum number of logical CPU's which can be used in a CPU affinity.
+        //! This is the same value as CPU_SETSIZE on Linux.
+        //!
+        static constexpr size_t MAX_CPUS = 1024;
+
+        //!
+        //! Constructor, load the topology of the system.
+        //!
+        CPUTopology();
+
+        //!
+        //! Reload the topology of the system.
+        //!
+        void reload();
+
+        //!
+        //! Get the set of logical CPU's which can be used by the current process.
+        //! @return A constant reference to the set of usable logical CPU indexes.
+        //!
+        const CPUSet& cpus() const { return _cpu_set; }
+
+        //!
+        //! Check if two logical CPU's share a cache of a given level.
+        //! @param [in] cpu1 First logical CPU index.
+        //! @param [in] cpu2 Second logical CPU index.
+        //! @param [in] level Cache level, typically 2 or 3.
+        //! @return True if @a cpu1 and @a cpu2 share a cache of level @a level.
+        //!
+        bool shareCache(size_t cpu1, size_t cpu2, size_t level) const;
+
+        //!
+        //! Get an ordered list of logical CPU's to place a chain of cooperating threads.
+        //! Threads which exchange data should be placed on consecutive CPU's in this list.
+        //! Consecutive CPU's share the largest possible part of the cache hierarchy
+        //! (same L3 cache, then same L2 cache). The first hardware thread of each physical
+        //! core is listed first, the other hardware threads of the cores (hyper-threading)
+        //! are listed at the end.
+        //! @return The ordered list of usable logical CPU indexes.
+        //!
+        std::vector<size_t> placementOrder() const;
+
+        //!
+        //! Parse a list of CPU's.
+        //! The syntax is the same as the Linux @e cpuset format: a comma-separated list of
+        //! CPU indexes or ranges of CPU indexes, for instance "0-3,8,10-11".
+        //! @param [out] cpus Set of logical CPU indexes.
+        //! @param [in] list List of CPU's.
+        //! @param [in] max_cpus All CPU indexes must be lower than this value.
+        //! This value is always limited to MAX_CPUS.
+        //! @return True on success, false on syntax error or out-of-range CPU index.
+        //!
+        static bool ParseCPUList(CPUSet& cpus, const UString& list, size_t max_cpus = MAX_CPUS);
+
+        //!
+        //! Get the number of logical CPU's which are configured in the system.
+        //! This includes the offline CPU's and the CPU's which are not allowed for
+        //! the current process. All logical CPU indexes are lower than this value.
+        //! @return The number of configured logical CPU's, never more than MAX_CPUS.
+        //!
+        static size_t ConfiguredCPUCount();
+
+        //!
+        //! Format a list of CPU's.
+        //! @param [in] cpus Set of logical CPU indexes.
+        //! @return A list in @e cpuset format, for instance "0-3,8,10-11".
+        //! @see ParseCPUList()
+        //!
+        static UString FormatCPUList(const CPUSet& cpus);
+
+    private:
+        // Description of one logical CPU.
+        class CPUInfo
+        {
+        public:
+            CPUInfo(size_t index = 0);
+            size_t cpu;      // Logical CPU index.
+            size_t package;  // Physical package (socket) index.
+            size_t core;     // Physical core index in the package.
+            size_t l2;       // Identification of the L2 cache (smallest CPU index which shares it).
+            size_t l3;       // Identification of the L3 cache (smallest CPU index which shares it).
+            bool   primary;  // First hardware thread of the physical core.
+            bool operator<(const CPUInfo& other) const;  // Placement order.
+        };
+
+        CPUSet               _cpu_set;  // Usable logical CPU's.
+        std::vector<CPUInfo> _cpus;     // Description of usable logical CPU's, in CPU index order.
+
+        // Get the description of one CPU, null if not found.
+        const CPUInfo* getInfo(size_t cpu) const;
+    };
+}
@@ -33,6 +33,18 @@
 #include "tsSysUtils.h"
 #include "tsIntegerUtils.h"
 
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/uio.h>
+    #include <sys/ioctl.h>
+    #include <poll.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::ForkPipe::ZERO_COPY_MIN_SIZE;
+#endif
+
 // Index of pipe file descriptors on UNIX.
 #define PIPE_READFD  0
 #define PIPE_WRITEFD 1
@@ -64,6 +76,8 @@ ts::ForkPipe::ForkPipe() :
     _ignore_abort(false),
     _broken_pipe(false),
     _eof(false),
+    _zc_request(false),
+    _zc_active(false),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE),
     _process(INVALID_HANDLE_VALUE)
@@ -134,6 +148,7 @@ bool ts::ForkPipe::open(const UString& command, WaitMode wait_mode, size_t buffe
     _in_mode = in_mode;
     _out_mode = out_mode;
     _broken_pipe = false;
+    _zc_active = false;
     _wait_mode = wait_mode;
     _eof = !_out_pipe;
 
@@ -317,6 +332,13 @@ bool ts::ForkPipe::open(const UString& command, WaitMode wait_mode, size_t buffe
         return false;
     }
 
+#if defined(TS_LINUX)
+    // Resize the pipe buffer. The maximum size for unprivileged processes is /proc/sys/fs/pipe-max-size.
+    if (_use_pipe && buffer_size > 0 && ::fcntl(filedes[PIPE_WRITEFD], F_SETPIPE_SZ, int(std::min<size_t>(buffer_size, 0x7FFFFFFF))) < 0) {
+        report.verbose(u"cannot set pipe buffer size to %'d bytes: %s", {buffer_size, SysErrorCodeMessage()});
+    }
+#endif
+
     // Create the forked process
     if (_wait_mode == EXIT_PROCESS) {
         // Don't fork, the parent process will directly call exec().
@@ -365,6 +387,14 @@ bool ts::ForkPipe::open(const UString& command, WaitMode wait_mode, size_t buffe
             ::fcntl(_fd, F_SETFD, FD_CLOEXEC);
             // Close the reading end-point of pipe.
             ::close(filedes[PIPE_READFD]);
+#if defined(TS_LINUX)
+            // Zero-copy transmission needs to check the amount of unread data in the pipe.
+            int unread = 0;
+            _zc_active = _zc_request && ::ioctl(_fd, FIONREAD, &unread) == 0;
+            if (_zc_request && !_zc_active) {
+                report.verbose(u"zero-copy transmission not available on pipe, using standard write");
+            }
+#endif
         }
         else if (_out_pipe) {
             // Do the opposite.
@@ -545,6 +575,7 @@ bool ts::ForkPipe::close(Report& report)
 
 #endif
 
+    _zc_active = false;
     _is_open = false;
     return result;
 }
@@ -628,6 +659,12 @@ bool ts::ForkPipe::writeStream(const void* addr, size_t size, size_t& written_si
     const char *data = reinterpret_cast<const char*>(addr);
     size_t remain = size;
 
+#if defined(TS_LINUX)
+    if (_zc_active && size >= ZERO_COPY_MIN_SIZE) {
+        error = !spliceStream(data, remain, written_size, error_code, report);
+    }
+#endif
+
     while (remain > 0 && !error) {
         ssize_t outsize = ::write(_fd, data, remain);
         if (outsize > 0) {
@@ -669,6 +706,68 @@ bool ts::ForkPipe::writeStream(const void* addr, size_t size, size_t& written_si
 }
 
 
+//----------------------------------------------------------------------------
+// Zero-copy transmission of data to the pipe.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+bool ts::ForkPipe::spliceStream(const char*& data, size_t& remain, size_t& written_size, SysErrorCode& error_code, Report& report)
+{
+    // Map the pages of the caller's buffer into the pipe. Without SPLICE_F_GIFT, the pages remain
+    // owned by the caller but the pipe references them until the created process reads them.
+    bool spliced = false;
+    while (remain > 0) {
+        ::iovec iov;
+        iov.iov_base = const_cast<char*>(data);
+        iov.iov_len = remain;
+        const ssize_t outsize = ::vmsplice(_fd, &iov, 1, 0);
+        if (outsize > 0) {
+            assert(size_t(outsize) <= remain);
+            data += outsize;
+            remain -= size_t(outsize);
+            written_size += size_t(outsize);
+            spliced = true;
+        }
+        else if ((error_code = LastSysErrorCode()) == EINVAL || error_code == ENOSYS) {
+            // Not supported on this pipe, the remaining data are written.
+            report.verbose(u"vmsplice not supported on pipe, using standard write: %s", {SysErrorCodeMessage(error_code)});
+            _zc_active = false;
+            break;
+        }
+        else if (error_code != EINTR) {
+            _broken_pipe = error_code == EPIPE;
+            return false;
+        }
+    }
+
+    // Wait until the created process has read all data from the pipe. The caller may then reuse its buffer.
+    // Because the pipe may contain other data before ours, waiting for an empty pipe is a safe bound.
+    int unread = 0;
+    while (spliced && !_broken_pipe && ::ioctl(_fd, FIONREAD, &unread) == 0 && unread > 0) {
+        // On the writing end, POLLERR means that there is no more reader, the data will never be read.
+        ::pollfd pfd;
+        pfd.fd = _fd;
+        pfd.events = 0;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLERR) != 0) {
+            error_code = EPIPE;
+            _broken_pipe = true;
+            return false;
+        }
+        // Let the created process read the pipe.
+        static const ::timespec delay = {0, 50000}; // 50 microseconds
+        ::nanosleep(&delay, nullptr);
+    }
+    if (_broken_pipe) {
+        // Pipe aborted by abortPipeReadWrite() while waiting.
+        error_code = EPIPE;
+        return false;
+    }
+    return true;
+}
+#endif
+
+
 //----------------------------------------------------------------------------
 // Read data from the pipe (sent from process' standard output or error).
 // Implementation of AbstractReadStreamInterface
@@ -37,6 +37,7 @@
 #include "tsAbstractReadStreamInterface.h"
 #include "tsAbstractWriteStreamInterface.h"
 #include "tsReport.h"
+#include "tsSysUtils.h"
 
 namespace ts {
     //!
@@ -101,7 +102,8 @@ namespace ts {
         //! Create the process, open the optional pipe.
         //! @param [in] command The command to execute.
         //! @param [in] wait_mode How to wait for process termination in close().
-        //! @param [in] buffer_size The pipe buffer size in bytes. Used on Windows only. Zero means default.
+        //! @param [in] buffer_size The pipe buffer size in bytes. Used on Windows and Linux only. Zero means default.
+        //! On Linux, sizes above /proc/sys/fs/pipe-max-size require privileges.
         //! @param [in,out] report Where to report errors.
         //! @param [in] out_mode How to handle stdout and stderr.
         //! @param [in] in_mode How to handle stdin. Use the pipe by default.
@@ -165,6 +167,42 @@ namespace ts {
             return _ignore_abort;
         }
 
+        //!
+        //! Set zero-copy transmission on the input pipe of the created process.
+        //! Must be called before open(). Supported on Linux only, ignored on other systems.
+        //!
+        //! In zero-copy mode, the pages of the caller's buffer are mapped into the pipe using
+        //! vmsplice() instead of being copied by the kernel. Since the pipe then references the
+        //! memory of the caller, writeStream() returns only when the created process has read
+        //! all data from the pipe and the buffer can be reused. Write operations which are smaller
+        //! than ZERO_COPY_MIN_SIZE, or on a pipe which does not support vmsplice(), use write().
+        //!
+        //! Do not use zero-copy transmission when the created process forwards its standard
+        //! input using splice(), to another pipe for instance. The forwarded data would still
+        //! reference the caller's buffer after they were read from the pipe.
+        //!
+        //! @param [in] on True to request zero-copy transmission.
+        //!
+        void setZeroCopy(bool on)
+        {
+            _zc_request = on;
+        }
+
+        //!
+        //! Check if zero-copy transmission is active on the input pipe.
+        //! @return True if zero-copy transmission is active.
+        //!
+        bool isZeroCopy() const
+        {
+            return _zc_active;
+        }
+
+        //!
+        //! Minimum size in bytes of a write operation which uses vmsplice() in zero-copy mode.
+        //! Smaller data are copied into the pipe using write().
+        //!
+        static constexpr size_t ZERO_COPY_MIN_SIZE = 4096;
+
         //!
         //! Abort any currenly input/output operation in the pipe.
         //! The pipe is left in a broken state and can be only closed.
@@ -205,6 +243,8 @@ namespace ts {
         bool          _ignore_abort;  // Ignore early termination of child process.
         volatile bool _broken_pipe;   // Pipe is broken, do not attempt to write.
         volatile bool _eof;           // Got end of file on input pipe.
+        bool          _zc_request;    // Zero-copy transmission requested.
+        bool          _zc_active;     // Zero-copy transmission active.
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle;        // Pipe output handle.
         ::HANDLE      _process;       // Handle to child process.
@@ -212,5 +252,12 @@ namespace ts {
         ::pid_t       _fpid;          // Forked process id (UNIX PID, not MPEG PID!)
         int           _fd;            // Pipe output file descriptor.
 #endif
+
+#if defined(TS_LINUX)
+        // Map the caller's data into the pipe using vmsplice(), then wait until they are read.
+        // Update data, remain and written_size with the data which were spliced. When vmsplice()
+        // is not supported, zero-copy is deactivated and the remaining data shall be written.
+        bool spliceStream(const char*& data, size_t& remain, size_t& written_size, SysErrorCode& error_code, Report& report);
+#endif
     };
 }
@@ -36,6 +36,10 @@
 #include "tsSysUtils.h"
 
 namespace ts {
+
+    constexpr int NUMA_NODE_NONE  = -1;  //!< NUMA node for ResidentBuffer: no NUMA binding.
+    constexpr int NUMA_NODE_LOCAL = -2;  //!< NUMA node for ResidentBuffer: NUMA node of the calling thread.
+
     //!
     //! Implementation of memory buffer locked in physical memory.
     //! @tparam T Type of the buffer element.
@@ -54,6 +58,21 @@ namespace ts {
         //!
         ResidentBuffer(size_t elem_count);
 
+        //!
+        //! Constructor with memory placement options.
+        //! Abort application if memory allocation fails.
+        //! Do not abort if memory locking, huge pages allocation or NUMA binding fails.
+        //! The huge pages and NUMA options are currently implemented on Linux only.
+        //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] huge_pages If true, try to allocate the buffer in explicit huge pages
+        //! (see /proc/sys/vm/nr_hugepages). If none is available, try transparent huge pages.
+        //! If transparent huge pages are not available either, use regular pages.
+        //! @param [in] numa_node Preferred NUMA node for the physical memory of the buffer.
+        //! Can be NUMA_NODE_NONE (the default system policy) or NUMA_NODE_LOCAL (NUMA node
+        //! of the CPU which executes the calling thread).
+        //!
+        ResidentBuffer(size_t elem_count, bool huge_pages, int numa_node);
+
         //!
         //! Destructor.
         //!
@@ -95,6 +114,24 @@ namespace ts {
             return _elem_count;
         }
 
+        //!
+        //! Check if the buffer is allocated in huge pages (explicit or transparent).
+        //! @return True if the buffer is allocated in huge pages.
+        //!
+        bool hugePages() const
+        {
+            return _huge_pages;
+        }
+
+        //!
+        //! Get the NUMA node on which the buffer was bound.
+        //! @return The NUMA node on which the buffer was bound or NUMA_NODE_NONE if not bound.
+        //!
+        int numaNode() const
+        {
+            return _numa_node;
+        }
+
     private:
         char*     _allocated_base;   // First allocated address
         char*     _locked_base;      // First locked address (mlock, page boundary)
@@ -103,7 +140,13 @@ namespace ts {
         size_t    _locked_size;      // Locked size (mlock, multiple of page size)
         size_t    _elem_count;       // Element count in locked region
         bool      _is_locked;        // False if mlock failed.
-        SysErrorCode _error_code;       // Lock error code
+        bool      _is_mapped;        // Allocated with mmap() instead of new.
+        bool      _huge_pages;       // Allocated in huge pages.
+        int       _numa_node;        // Bound to this NUMA node.
+        SysErrorCode _error_code;    // Lock error code
+
+        // Allocate the memory using regular pages, huge pages, NUMA binding.
+        void allocate(size_t requested_size, bool huge_pages, int numa_node);
     };
 }
 
@@ -36,6 +36,7 @@
 #include "tsIntegerUtils.h"
 #include "tsSysInfo.h"
 #include "tsFatal.h"
+#include "tsMemory.h"
 
 #if defined(TS_UNIX)
     #include "tsBeforeStandardHeaders.h"
@@ -43,15 +44,27 @@
     #include "tsAfterStandardHeaders.h"
 #endif
 
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/syscall.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 
 //----------------------------------------------------------------------------
-// Constructor, based on required amount of T elements.
+// Constructors, based on required amount of T elements.
 // Abort application is memory allocation fails.
 // Do not abort is memory locking fails.
 //----------------------------------------------------------------------------
 
 template <typename T>
 ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
+    ResidentBuffer(elem_count, false, NUMA_NODE_NONE)
+{
+}
+
+template <typename T>
+ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count, bool huge_pages, int numa_node) :
     _allocated_base(nullptr),
     _locked_base(nullptr),
     _base(nullptr),
@@ -59,31 +72,22 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_size(0),
     _elem_count(elem_count),
     _is_locked(false),
+    _is_mapped(false),
+    _huge_pages(false),
+    _numa_node(NUMA_NODE_NONE),
     _error_code(SYS_SUCCESS)
 {
     const size_t requested_size = elem_count * sizeof(T);
     const size_t page_size = SysInfo::Instance()->memoryPageSize();
 
-    // Allocate enough space to include memory pages around the requested size
-
-    _allocated_size = requested_size + 2 * page_size;
-    _allocated_base = new char[_allocated_size];
-
-    // Locked space starts at next page boundary after allocated base:
-    // Its size is the next multiple of page size after requested_size:
-    // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
-    // to perform arithmetics on pointers because we use modulo operations.
-
-    assert(sizeof(size_t) == sizeof(char_ptr));
-    _locked_base = char_ptr(round_up(size_t(_allocated_base), page_size));
-    _locked_size = round_up(requested_size, page_size);
+    // Allocate memory, set _allocated_base/size and _locked_base/size.
+    allocate(requested_size, huge_pages, numa_node);
 
     _base = new (_locked_base) T[elem_count];
 
     // Integrity checks
 
     assert(_allocated_base <= _locked_base);
-    assert(_locked_base < _allocated_base + page_size);
     assert(_locked_base + _locked_size <= _allocated_base + _allocated_size);
     assert(requested_size <= _locked_size);
     assert(_locked_size <= _allocated_size);
@@ -127,6 +131,89 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
 }
 
 
+//----------------------------------------------------------------------------
+// Allocate the memory using regular pages, huge pages, NUMA binding.
+//----------------------------------------------------------------------------
+
+template <typename T>
+void ts::ResidentBuffer<T>::allocate(size_t requested_size, bool huge_pages, int numa_node)
+{
+    const size_t page_size = SysInfo::Instance()->memoryPageSize();
+
+#if defined(TS_LINUX)
+
+    // On Linux, use an anonymous memory mapping when huge pages or NUMA binding are requested.
+    const size_t huge_size = SysInfo::Instance()->hugeMemoryPageSize();
+    huge_pages = huge_pages && huge_size > page_size && huge_size % page_size == 0;
+
+    if (huge_pages || numa_node != NUMA_NODE_NONE) {
+
+        const size_t align = huge_pages ? huge_size : page_size;
+        void* addr = MAP_FAILED;
+
+        // First, try explicit huge pages (need free pages in /proc/sys/vm/nr_hugepages).
+        if (huge_pages) {
+            _allocated_size = round_up(requested_size, huge_size);
+            addr = ::mmap(nullptr, _allocated_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            _huge_pages = addr != MAP_FAILED;
+        }
+
+        // Otherwise, use regular pages, aligned on huge page boundaries to allow transparent huge pages.
+        if (addr == MAP_FAILED) {
+            _allocated_size = round_up(requested_size, align) + (align > page_size ? align : 0);
+            addr = ::mmap(nullptr, _allocated_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+
+        if (addr != MAP_FAILED) {
+            _is_mapped = true;
+            _allocated_base = reinterpret_cast<char*>(addr);
+            _locked_base = char_ptr(round_up(size_t(_allocated_base), align));
+            _locked_size = round_up(requested_size, align);
+
+            // Request transparent huge pages if explicit ones were not available.
+            if (huge_pages && !_huge_pages) {
+                _huge_pages = ::madvise(_locked_base, _locked_size, MADV_HUGEPAGE) == 0;
+            }
+
+            // Bind to a NUMA node before the first access to the memory, using the "preferred" policy
+            // to avoid allocation failures when the node has no more free memory. The system call is
+            // directly used to avoid a dependency on libnuma.
+            if (numa_node == NUMA_NODE_LOCAL) {
+                unsigned int cpu = 0;
+                unsigned int node = 0;
+                numa_node = ::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? int(node) : NUMA_NODE_NONE;
+            }
+            unsigned long node_mask[16];
+            constexpr int max_nodes = int(8 * sizeof(node_mask));
+            if (numa_node >= 0 && numa_node < max_nodes - 1) {
+                TS_ZERO(node_mask);
+                node_mask[numa_node / (8 * sizeof(unsigned long))] |= 1UL << (numa_node % (8 * sizeof(unsigned long)));
+                constexpr int mpol_preferred = 1; // MPOL_PREFERRED in <linux/mempolicy.h>
+                if (::syscall(SYS_mbind, _locked_base, _locked_size, mpol_preferred, node_mask, max_nodes, 0) == 0) {
+                    _numa_node = numa_node;
+                }
+            }
+            return;
+        }
+    }
+
+#endif
+
+    // Default allocation: allocate enough space to include memory pages around the requested size.
+    // Locked space starts at next page boundary after allocated base:
+    // Its size is the next multiple of page size after requested_size:
+    // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
+    // to perform arithmetics on pointers because we use modulo operations.
+
+    _allocated_size = requested_size + 2 * page_size;
+    _allocated_base = new char[_allocated_size];
+
+    assert(sizeof(size_t) == sizeof(char_ptr));
+    _locked_base = char_ptr(round_up(size_t(_allocated_base), page_size));
+    _locked_size = round_up(requested_size, page_size);
+}
+
+
 //----------------------------------------------------------------------------
 // Destructor
 //----------------------------------------------------------------------------
@@ -147,6 +234,12 @@ ts::ResidentBuffer<T>::~ResidentBuffer()
 
     // Free memory
     if (_allocated_base != nullptr) {
+#if defined(TS_LINUX)
+        if (_is_mapped) {
+            ::munmap(_allocated_base, _allocated_size);
+        }
+        else
+#endif
         delete[] _allocated_base;
     }
 
@@ -158,5 +251,8 @@ ts::ResidentBuffer<T>::~ResidentBuffer()
     _locked_size = 0;
     _elem_count = 0;
     _is_locked = false;
+    _is_mapped = false;
+    _huge_pages = false;
+    _numa_node = NUMA_NODE_NONE;
 }
 TS_POP_WARNING()
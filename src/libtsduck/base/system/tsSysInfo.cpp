@@ -39,6 +39,22 @@
     #include "tsSysCtl.h"
 #endif
 
+#if defined(TS_MSC) && (defined(TS_I386) || defined(TS_X86_64))
+    #include "tsBeforeStandardHeaders.h"
+    #include <intrin.h>
+    #include <immintrin.h>
+    #include "tsAfterStandardHeaders.h"
+#elif defined(TS_GCC) && (defined(TS_I386) || defined(TS_X86_64))
+    #include "tsBeforeStandardHeaders.h"
+    #include <cpuid.h>
+    #include "tsAfterStandardHeaders.h"
+#elif defined(TS_LINUX) && defined(TS_ARM64)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 // Define singleton instance
 TS_DEFINE_SINGLETON(ts::SysInfo);
 
@@ -117,7 +133,18 @@ ts::SysInfo::SysInfo() :
 #else
     _cpuName(u"unknown CPU"),
 #endif
-    _memoryPageSize(0)
+    _memoryPageSize(0),
+    _hugeMemoryPageSize(0),
+    _sse2Instructions(false),
+    _avx2Instructions(false),
+#if defined(TS_ARM64) || defined(__ARM_NEON)
+    _neonInstructions(true),
+#else
+    _neonInstructions(false),
+#endif
+    _aesInstructions(false),
+    _pclmulInstructions(false),
+    _shaInstructions(false)
 {
     //
     // Get operating system name and version.
@@ -263,5 +290,82 @@ ts::SysInfo::SysInfo() :
         _memoryPageSize = size_t(pageSize);
     }
 
+#endif
+
+    //
+    // Get system huge memory page size (Linux only).
+    //
+#if defined(TS_LINUX)
+
+    // Look for a line "Hugepagesize:    2048 kB".
+    UStringList meminfo;
+    if (UString::Load(meminfo, u"/proc/meminfo")) {
+        for (const auto& line : meminfo) {
+            size_t kb = 0;
+            if (line.startWith(u"Hugepagesize:") && line.substr(13).toTrimmed().scan(u"%d kB", {&kb})) {
+                _hugeMemoryPageSize = kb * 1024;
+                break;
+            }
+        }
+    }
+
+#endif
+
+    //
+    // Get supported instruction sets (NEON is mandatory on Arm-64).
+    //
+#if (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_GCC)
+
+    ::__builtin_cpu_init();
+    _sse2Instructions = ::__builtin_cpu_supports("sse2");
+    _avx2Instructions = ::__builtin_cpu_supports("avx2");
+
+    // CPUID leaf 1: ECX bit 1 = PCLMULQDQ, ECX bit 19 = SSE4.1, ECX bit 25 = AES-NI.
+    // CPUID leaf 7: EBX bit 29 = SHA. The SHA code also uses SSE4.1 instructions.
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (::__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) {
+        _aesInstructions = (ecx & (1 << 25)) != 0;
+        _pclmulInstructions = (ecx & (1 << 1)) != 0;
+        const bool sse41 = (ecx & (1 << 19)) != 0;
+        if (sse41 && ::__get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            _shaInstructions = (ebx & (1 << 29)) != 0;
+        }
+    }
+
+#elif (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_MSC)
+
+    // CPUID leaf 1: EDX bit 26 = SSE2, ECX bit 1 = PCLMULQDQ, ECX bit 19 = SSE4.1, ECX bit 25 = AES-NI, ECX bit 27 = OSXSAVE, ECX bit 28 = AVX.
+    // CPUID leaf 7: EBX bit 5 = AVX2, EBX bit 29 = SHA. XCR0 bits 1 and 2: XMM and YMM states are saved by the OS.
+    int regs[4];
+    ::__cpuid(regs, 0);
+    const int max_leaf = regs[0];
+    ::__cpuid(regs, 1);
+    _sse2Instructions = (regs[3] & (1 << 26)) != 0;
+    _aesInstructions = (regs[2] & (1 << 25)) != 0;
+    _pclmulInstructions = (regs[2] & (1 << 1)) != 0;
+    const bool sse41 = (regs[2] & (1 << 19)) != 0;
+    const bool avx = (regs[2] & (1 << 27)) != 0 && (regs[2] & (1 << 28)) != 0 && (::_xgetbv(0) & 0x06) == 0x06;
+    if (max_leaf >= 7) {
+        ::__cpuidex(regs, 7, 0);
+        _avx2Instructions = avx && (regs[1] & (1 << 5)) != 0;
+        _shaInstructions = sse41 && (regs[1] & (1 << 29)) != 0;
+    }
+
+#elif defined(TS_LINUX) && defined(TS_ARM64)
+
+    // Armv8 cryptographic extensions are optional, reported by the kernel.
+    const unsigned long hwcap = ::getauxval(AT_HWCAP);
+    _aesInstructions = (hwcap & HWCAP_AES) != 0;
+    _pclmulInstructions = (hwcap & HWCAP_PMULL) != 0;
+    _shaInstructions = (hwcap & HWCAP_SHA1) != 0 && (hwcap & HWCAP_SHA2) != 0;
+
+#elif defined(TS_MAC) && defined(TS_ARM64)
+
+    // All Apple Silicon processors implement the Armv8 cryptographic extensions.
+    _aesInstructions = true;
+    _pclmulInstructions = true;
+    _shaInstructions = true;
+
 #endif
 }
@@ -138,6 +138,48 @@ namespace ts {
         //!
         size_t memoryPageSize() const { return _memoryPageSize; }
 
+        //!
+        //! Get system huge memory page size.
+        //! @return The default size in bytes of huge memory pages or zero if huge pages are not supported.
+        //!
+        size_t hugeMemoryPageSize() const { return _hugeMemoryPageSize; }
+
+        //!
+        //! Check if the CPU supports the Intel SSE2 instructions.
+        //! @return True if the CPU supports the SSE2 instructions.
+        //!
+        bool sse2Instructions() const { return _sse2Instructions; }
+
+        //!
+        //! Check if the CPU supports the Intel AVX2 instructions and the operating system saves their context.
+        //! @return True if AVX2 instructions can be used.
+        //!
+        bool avx2Instructions() const { return _avx2Instructions; }
+
+        //!
+        //! Check if the CPU supports the Arm NEON instructions (Advanced SIMD).
+        //! @return True if the CPU supports the NEON instructions.
+        //!
+        bool neonInstructions() const { return _neonInstructions; }
+
+        //!
+        //! Check if the CPU supports the AES instructions (AES-NI on Intel, cryptographic extensions on Arm).
+        //! @return True if the CPU supports the AES instructions.
+        //!
+        bool aesInstructions() const { return _aesInstructions; }
+
+        //!
+        //! Check if the CPU supports the carry-less multiplication instructions (PCLMULQDQ on Intel, PMULL on Arm).
+        //! @return True if the CPU supports the carry-less multiplication instructions.
+        //!
+        bool pclmulInstructions() const { return _pclmulInstructions; }
+
+        //!
+        //! Check if the CPU supports the SHA-1 and SHA-256 instructions (SHA extensions on Intel, cryptographic extensions on Arm).
+        //! @return True if the CPU supports the SHA-1 and SHA-256 instructions.
+        //!
+        bool shaInstructions() const { return _shaInstructions; }
+
     private:
         bool    _isLinux;
         bool    _isFedora;
@@ -157,5 +199,12 @@ namespace ts {
         UString _hostName;
         UString _cpuName;
         size_t  _memoryPageSize;
+        size_t  _hugeMemoryPageSize;
+        bool    _sse2Instructions;
+        bool    _avx2Instructions;
+        bool    _neonInstructions;
+        bool    _aesInstructions;
+        bool    _pclmulInstructions;
+        bool    _shaInstructions;
     };
 }
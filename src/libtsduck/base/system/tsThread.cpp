@@ -219,6 +219,20 @@ bool ts::Thread::start()
         return false;
     }
 
+    // Set the CPU affinity, if specified. Only the first 64 CPU's can be used.
+    if (!_attributes._affinity.empty()) {
+        ::DWORD_PTR mask = 0;
+        for (auto cpu : _attributes._affinity) {
+            if (cpu < 8 * sizeof(mask)) {
+                mask |= ::DWORD_PTR(1) << cpu;
+            }
+        }
+        if (mask == 0 || ::SetThreadAffinityMask(_handle, mask) == 0) {
+            ::CloseHandle(_handle);
+            return false;
+        }
+    }
+
     // Release the thread
     if (::ResumeThread(_handle) == ::DWORD(-1)) {
         ::CloseHandle(_handle);
@@ -245,8 +259,11 @@ bool ts::Thread::start()
         }
     }
 
-    // Set scheduling policy identical as current process.
-    if (::pthread_attr_setschedpolicy(&attr, ThreadAttributes::PthreadSchedulingPolicy()) != 0) {
+    // Set scheduling policy: identical as current process or explicit real-time policy.
+    int policy = 0;
+    int priority = 0;
+    _attributes.getPthreadScheduling(policy, priority);
+    if (::pthread_attr_setschedpolicy(&attr, policy) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
     }
@@ -254,12 +271,29 @@ bool ts::Thread::start()
     // Set scheduling priority.
     ::sched_param sparam;
     TS_ZERO(sparam);
-    sparam.sched_priority = _attributes._priority;
+    sparam.sched_priority = priority;
     if (::pthread_attr_setschedparam(&attr, &sparam) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
     }
 
+    // Set CPU affinity, if specified (Linux only).
+#if defined(TS_LINUX) && !defined(TS_ANDROID)
+    if (!_attributes._affinity.empty()) {
+        ::cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (auto cpu : _attributes._affinity) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (::pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0) {
+            ::pthread_attr_destroy(&attr);
+            return false;
+        }
+    }
+#endif
+
     // Use explicit scheduling attributes, do not inherit them from the current thread.
     // Apparently not supported on Android before API version 28.
 #if !defined(__ANDROID_API__) || __ANDROID_API__ >= 28
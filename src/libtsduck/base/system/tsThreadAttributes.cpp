@@ -112,6 +112,34 @@ int ts::ThreadAttributes::PthreadSchedulingPolicy()
     return pol >= 0 ? pol : SCHED_OTHER;
 #endif
 }
+
+
+//----------------------------------------------------------------------------
+// Get the POSIX scheduling policy and priority for a thread with these attributes.
+//----------------------------------------------------------------------------
+
+void ts::ThreadAttributes::getPthreadScheduling(int& policy, int& priority) const
+{
+    switch (_policy) {
+        case SchedulingPolicy::FIFO:
+            policy = SCHED_FIFO;
+            break;
+        case SchedulingPolicy::ROUND_ROBIN:
+            policy = SCHED_RR;
+            break;
+        case SchedulingPolicy::DEFAULT:
+        default:
+            // Same policy as current process, priority within the range of the process policy.
+            policy = PthreadSchedulingPolicy();
+            priority = _priority;
+            return;
+    }
+
+    // Explicit real-time policy, force the priority within the range of the policy.
+    const int prioMin = std::max(0, ::sched_get_priority_min(policy));
+    const int prioMax = std::max(prioMin, ::sched_get_priority_max(policy));
+    priority = _policyPriority == 0 ? (prioMin + prioMax) / 2 : std::max(prioMin, std::min(prioMax, _policyPriority));
+}
 #endif
 
 
@@ -154,6 +182,9 @@ ts::ThreadAttributes::ThreadAttributes() :
     _stackSize(0),
     _deleteWhenTerminated(false),
     _priority(0),
+    _policy(SchedulingPolicy::DEFAULT),
+    _policyPriority(0),
+    _affinity(),
     _name()
 {
     if (!_priorityInitialized) {
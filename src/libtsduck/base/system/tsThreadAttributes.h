@@ -36,6 +36,11 @@
 #include "tsUString.h"
 
 namespace ts {
+    //!
+    //! A set of logical CPU indexes, starting at zero, as used for thread affinity.
+    //!
+    typedef std::set<size_t> CPUSet;
+
     //!
     //! Set of attributes for a thread object (ts::Thread).
     //! @ingroup thread
@@ -43,6 +48,15 @@ namespace ts {
     class TSDUCKDLL ThreadAttributes
     {
     public:
+        //!
+        //! Scheduling policy of a thread.
+        //!
+        enum class SchedulingPolicy {
+            DEFAULT,      //!< Same scheduling policy as the current process, priority from setPriority().
+            FIFO,         //!< Real-time first-in first-out policy (SCHED_FIFO on POSIX systems).
+            ROUND_ROBIN,  //!< Real-time round-robin policy (SCHED_RR on POSIX systems).
+        };
+
         //!
         //! Default constructor (all attributes have their default values).
         //!
@@ -261,11 +275,88 @@ namespace ts {
             return GetPriority(_maximumPriority);
         }
 
+        //!
+        //! Set the scheduling policy for the thread.
+        //!
+        //! By default, a thread uses the same scheduling policy as the current process
+        //! and its priority is set using setPriority(). Using an explicit real-time
+        //! scheduling policy usually requires privileges. Without them, the thread
+        //! cannot be started.
+        //!
+        //! This attribute is currently implemented on POSIX systems only.
+        //! It is ignored on Windows.
+        //!
+        //! @param [in] policy Scheduling policy.
+        //! @param [in] priority Priority of the thread in the scheduling policy. This is an operating
+        //! system value, from 1 to 99 on Linux. This value is used with real-time policies only, instead
+        //! of setPriority(). It is forced within the range of the policy. When zero, use the middle of
+        //! the range of priorities for the policy.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setSchedulingPolicy(SchedulingPolicy policy, int priority = 0)
+        {
+            _policy = policy;
+            _policyPriority = priority;
+            return *this;
+        }
+
+        //!
+        //! Get the scheduling policy for the thread.
+        //! @return The scheduling policy for the thread.
+        //! @see setSchedulingPolicy()
+        //!
+        SchedulingPolicy getSchedulingPolicy() const
+        {
+            return _policy;
+        }
+
+        //!
+        //! Get the priority of the thread in its explicit real-time scheduling policy.
+        //! @return The priority which was given to setSchedulingPolicy().
+        //! @see setSchedulingPolicy()
+        //!
+        int getSchedulingPolicyPriority() const
+        {
+            return _policyPriority;
+        }
+
+        //!
+        //! Set the CPU affinity for the thread.
+        //!
+        //! The thread will be executed only on the specified logical CPU's.
+        //! An empty set means that there is no specific affinity, the thread inherits
+        //! the affinity of the current process (this is the default).
+        //!
+        //! This attribute is currently implemented on Linux and Windows only.
+        //! It is ignored on other systems. On Windows, only the first 64 CPU's can be used.
+        //!
+        //! @param [in] cpus Set of logical CPU indexes, starting at zero.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setCPUAffinity(const CPUSet& cpus)
+        {
+            _affinity = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity for the thread.
+        //! @return A constant reference to the set of logical CPU indexes. Empty when there is no specific affinity.
+        //! @see setCPUAffinity()
+        //!
+        const CPUSet& getCPUAffinity() const
+        {
+            return _affinity;
+        }
+
     private:
-        size_t  _stackSize;
-        bool    _deleteWhenTerminated;
-        int     _priority;
-        UString _name;
+        size_t           _stackSize;
+        bool             _deleteWhenTerminated;
+        int              _priority;
+        SchedulingPolicy _policy;
+        int              _policyPriority;
+        CPUSet           _affinity;
+        UString          _name;
 
         //
         // These fields describe the operating system priority range.
@@ -308,6 +399,9 @@ namespace ts {
         // This static method is used by the implementation of ts::Thread on Unix
         // to obtain the scheduling policy to use for this process.
         static int PthreadSchedulingPolicy();
+
+        // Get the POSIX scheduling policy and priority to use for a thread with these attributes.
+        void getPthreadScheduling(int& policy, int& priority) const;
 #endif
     };
 }
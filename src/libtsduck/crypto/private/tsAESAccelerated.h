@@ -0,0 +1,84 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Hardware-accelerated implementations of AES (internal).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAcceleratedEngine.h"
+#include "tsUChar.h"
+
+namespace ts {
+    //!
+    //! Description of a hardware-accelerated AES engine.
+    //! @ingroup crypto
+    //!
+    struct AESAcceleratedEngine
+    {
+        //!
+        //! Profile of an encryption or decryption function on independent blocks (ECB).
+        //! The blocks are processed in parallel, as much as the instruction set allows.
+        //! @param [in] rk Round keys, in the byte order of the standard, 16 * (@a rounds + 1) bytes.
+        //! For decryption, these are the round keys of the "equivalent inverse cipher" (FIPS-197, 5.3.5),
+        //! in reverse order, with InvMixColumns applied to all round keys but the first and the last.
+        //! @param [in] rounds Number of rounds, 10, 12 or 14.
+        //! @param [in] in Address of input blocks.
+        //! @param [out] out Address of output blocks. Can be the same as @a in but shall not partially overlap.
+        //! @param [in] count Number of 16-byte blocks.
+        //!
+        typedef void (*Function)(const uint8_t* rk, int rounds, const uint8_t* in, uint8_t* out, size_t count);
+
+        const UChar* name;    //!< Engine name, for information.
+        Function     encrypt; //!< Encryption function.
+        Function     decrypt; //!< Decryption function.
+    };
+
+    //!
+    //! Get the AES engine using the Intel AES-NI instructions.
+    //! This engine is compiled in a separate module, using AES-NI code generation.
+    //! @return Address of the engine description or a null pointer if the library
+    //! was not compiled with AES-NI support. The CPU support shall be checked separately.
+    //!
+    const AESAcceleratedEngine* AESEngineIntel();
+
+    //!
+    //! Get the AES engine using the Armv8 cryptographic extensions.
+    //! This engine is compiled in a separate module, using Armv8 crypto code generation.
+    //! @return Address of the engine description or a null pointer if the library
+    //! was not compiled with Armv8 cryptographic extensions. The CPU support shall be checked separately.
+    //!
+    const AESAcceleratedEngine* AESEngineArm();
+
+    //!
+    //! Selection of the hardware-accelerated engine, according to the features of the CPU.
+    //!
+    typedef AcceleratedEngineSelector<AESAcceleratedEngine, &SysInfo::aesInstructions, AESEngineIntel, AESEngineArm> AESEngineSelector;
+}
@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  AES engine using the Armv8 cryptographic extensions.
+//  This module is compiled with Armv8 crypto code generation. It shall be used
+//  only after checking that the CPU supports them, see SysInfo::aesInstructions().
+//
+//----------------------------------------------------------------------------
+
+#include "tsAESAccelerated.h"
+
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES) || (defined(TS_MSC) && defined(TS_ARM64))
+
+#include "tsBeforeStandardHeaders.h"
+#include <arm_neon.h>
+#include "tsAfterStandardHeaders.h"
+
+namespace {
+
+    // Number of blocks which are processed in parallel to fill the pipeline of AES instructions.
+    constexpr size_t PARALLEL_BLOCKS = 8;
+
+    // One round on one block. AESE and AESD include the AddRoundKey at the beginning of the round.
+    template <bool ENCRYPT> inline uint8x16_t Round(uint8x16_t b, uint8x16_t k);
+    template <bool ENCRYPT> inline uint8x16_t LastRound(uint8x16_t b, uint8x16_t k);
+    template <> inline uint8x16_t Round<true>(uint8x16_t b, uint8x16_t k) { return vaesmcq_u8(vaeseq_u8(b, k)); }
+    template <> inline uint8x16_t Round<false>(uint8x16_t b, uint8x16_t k) { return vaesimcq_u8(vaesdq_u8(b, k)); }
+    template <> inline uint8x16_t LastRound<true>(uint8x16_t b, uint8x16_t k) { return vaeseq_u8(b, k); }
+    template <> inline uint8x16_t LastRound<false>(uint8x16_t b, uint8x16_t k) { return vaesdq_u8(b, k); }
+
+    // Encrypt or decrypt independent blocks.
+    template <bool ENCRYPT>
+    inline void Process(const uint8_t* rk, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        uint8x16_t k[15];
+        for (int r = 0; r <= rounds; ++r) {
+            k[r] = vld1q_u8(rk + 16 * r);
+        }
+
+        // Process blocks in parallel, the latency of one AES round is several cycles.
+        uint8x16_t b[PARALLEL_BLOCKS];
+        while (count >= PARALLEL_BLOCKS) {
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                b[i] = vld1q_u8(in + 16 * i);
+            }
+            for (int r = 0; r < rounds - 1; ++r) {
+                for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                    b[i] = Round<ENCRYPT>(b[i], k[r]);
+                }
+            }
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                vst1q_u8(out + 16 * i, veorq_u8(LastRound<ENCRYPT>(b[i], k[rounds - 1]), k[rounds]));
+            }
+            in += 16 * PARALLEL_BLOCKS;
+            out += 16 * PARALLEL_BLOCKS;
+            count -= PARALLEL_BLOCKS;
+        }
+
+        // Remaining blocks, one by one.
+        for (; count > 0; --count) {
+            b[0] = vld1q_u8(in);
+            for (int r = 0; r < rounds - 1; ++r) {
+                b[0] = Round<ENCRYPT>(b[0], k[r]);
+            }
+            vst1q_u8(out, veorq_u8(LastRound<ENCRYPT>(b[0], k[rounds - 1]), k[rounds]));
+            in += 16;
+            out += 16;
+        }
+    }
+
+    void Encrypt(const uint8_t* rk, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        Process<true>(rk, rounds, in, out, count);
+    }
+
+    void Decrypt(const uint8_t* rk, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        Process<false>(rk, rounds, in, out, count);
+    }
+
+    const ts::AESAcceleratedEngine EngineArm = {u"Armv8 crypto", Encrypt, Decrypt};
+}
+
+const ts::AESAcceleratedEngine* ts::AESEngineArm()
+{
+    return &EngineArm;
+}
+
+#else
+
+const ts::AESAcceleratedEngine* ts::AESEngineArm()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  AES engine using the Intel AES-NI instructions.
+//  This module is compiled with AES-NI code generation. It shall be used only
+//  after checking that the CPU supports AES-NI, see SysInfo::aesInstructions().
+//
+//----------------------------------------------------------------------------
+
+#include "tsAESAccelerated.h"
+
+#if defined(__AES__) || (defined(TS_MSC) && (defined(TS_I386) || defined(TS_X86_64)))
+
+#include "tsBeforeStandardHeaders.h"
+#include <wmmintrin.h>
+#include "tsAfterStandardHeaders.h"
+
+namespace {
+
+    // Number of blocks which are processed in parallel to fill the pipeline of AES instructions.
+    constexpr size_t PARALLEL_BLOCKS = 8;
+
+    // One round on one block.
+    template <bool ENCRYPT> inline __m128i Round(__m128i b, __m128i k);
+    template <bool ENCRYPT> inline __m128i LastRound(__m128i b, __m128i k);
+    template <> inline __m128i Round<true>(__m128i b, __m128i k) { return _mm_aesenc_si128(b, k); }
+    template <> inline __m128i Round<false>(__m128i b, __m128i k) { return _mm_aesdec_si128(b, k); }
+    template <> inline __m128i LastRound<true>(__m128i b, __m128i k) { return _mm_aesenclast_si128(b, k); }
+    template <> inline __m128i LastRound<false>(__m128i b, __m128i k) { return _mm_aesdeclast_si128(b, k); }
+
+    // Encrypt or decrypt independent blocks.
+    template <bool ENCRYPT>
+    inline void Process(const uint8_t* rk, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        __m128i k[15];
+        for (int r = 0; r <= rounds; ++r) {
+            k[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rk + 16 * r));
+        }
+
+        // Process blocks in parallel, the latency of one AES round is several cycles.
+        __m128i b[PARALLEL_BLOCKS];
+        while (count >= PARALLEL_BLOCKS) {
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                b[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * i)), k[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                    b[i] = Round<ENCRYPT>(b[i], k[r]);
+                }
+            }
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * i), LastRound<ENCRYPT>(b[i], k[rounds]));
+            }
+            in += 16 * PARALLEL_BLOCKS;
+            out += 16 * PARALLEL_BLOCKS;
+            count -= PARALLEL_BLOCKS;
+        }
+
+        // Remaining blocks, one by one.
+        for (; count > 0; --count) {
+            b[0] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), k[0]);
+            for (int r = 1; r < rounds; ++r) {
+                b[0] = Round<ENCRYPT>(b[0], k[r]);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), LastRound<ENCRYPT>(b[0], k[rounds]));
+            in += 16;
+            out += 16;
+        }
+    }
+
+    void Encrypt(const uint8_t* rk, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        Process<true>(rk, rounds, in, out, count);
+    }
+
+    void Decrypt(const uint8_t* rk, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        Process<false>(rk, rounds, in, out, count);
+    }
+
+    const ts::AESAcceleratedEngine EngineIntel = {u"AES-NI", Encrypt, Decrypt};
+}
+
+const ts::AESAcceleratedEngine* ts::AESEngineIntel()
+{
+    return &EngineIntel;
+}
+
+#else
+
+const ts::AESAcceleratedEngine* ts::AESEngineIntel()
+{
+    return nullptr;
+}
+
+#endif
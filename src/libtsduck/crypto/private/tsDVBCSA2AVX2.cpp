@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Bitsliced DVB-CSA2 batch engine using AVX2 instructions.
+//  This module is compiled with AVX2 code generation. It shall be used only
+//  after checking that the CPU supports AVX2, see SysInfo::avx2Instructions().
+//  All code is private to this module, to avoid sharing AVX2 code with
+//  other modules.
+//
+//----------------------------------------------------------------------------
+
+#include "tsDVBCSA2Bitslice.h"
+
+#if defined(__AVX2__) || (defined(TS_MSC) && defined(TS_X86_64))
+
+#include "tsBeforeStandardHeaders.h"
+#include <immintrin.h>
+#include "tsAfterStandardHeaders.h"
+
+namespace {
+
+    // Bitsliced word of 256 bits, using AVX2 instructions.
+    struct WordAVX2
+    {
+        static constexpr size_t BITS = 256;
+        __m256i v;
+        static WordAVX2 Zero() { return WordAVX2{_mm256_setzero_si256()}; }
+        static WordAVX2 Ones() { return WordAVX2{_mm256_set1_epi32(-1)}; }
+        static WordAVX2 Bytes(uint8_t b) { return WordAVX2{_mm256_set1_epi8(char(b))}; }
+        static WordAVX2 Load(const uint64_t* p) { return WordAVX2{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))}; }
+        static void Store(uint64_t* p, WordAVX2 w) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), w.v); }
+        static WordAVX2 Shl(WordAVX2 w, int n) { return WordAVX2{_mm256_sll_epi64(w.v, _mm_cvtsi32_si128(n))}; }
+        static WordAVX2 Shr(WordAVX2 w, int n) { return WordAVX2{_mm256_srl_epi64(w.v, _mm_cvtsi32_si128(n))}; }
+        friend WordAVX2 operator&(WordAVX2 a, WordAVX2 b) { return WordAVX2{_mm256_and_si256(a.v, b.v)}; }
+        friend WordAVX2 operator|(WordAVX2 a, WordAVX2 b) { return WordAVX2{_mm256_or_si256(a.v, b.v)}; }
+        friend WordAVX2 operator^(WordAVX2 a, WordAVX2 b) { return WordAVX2{_mm256_xor_si256(a.v, b.v)}; }
+        friend WordAVX2 operator~(WordAVX2 a) { return WordAVX2{_mm256_xor_si256(a.v, _mm256_set1_epi32(-1))}; }
+    };
+
+    typedef ts::DVBCSA2Bitslice<WordAVX2> BitsliceAVX2;
+
+    const ts::DVBCSA2BatchEngine EngineAVX2 = {u"AVX2", BitsliceAVX2::LANES, BitsliceAVX2::Encrypt, BitsliceAVX2::Decrypt};
+}
+
+const ts::DVBCSA2BatchEngine* ts::DVBCSA2EngineAVX2()
+{
+    return &EngineAVX2;
+}
+
+#else
+
+const ts::DVBCSA2BatchEngine* ts::DVBCSA2EngineAVX2()
+{
+    return nullptr;
+}
+
+#endif
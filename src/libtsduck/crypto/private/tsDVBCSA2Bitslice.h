@@ -0,0 +1,264 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Bitsliced implementation of DVB-CSA2 on batches of data blocks (internal).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUChar.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TS_DVBCSA2_SSE2 1
+    #include "tsBeforeStandardHeaders.h"
+    #include <emmintrin.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || (defined(TS_MSC) && defined(TS_ARM64))
+    #define TS_DVBCSA2_NEON 1
+    #include "tsBeforeStandardHeaders.h"
+    #include <arm_neon.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+namespace ts {
+    //!
+    //! Description of a DVB-CSA2 batch engine.
+    //! @ingroup crypto
+    //!
+    struct DVBCSA2BatchEngine
+    {
+        //!
+        //! Profile of an encryption or decryption function.
+        //! All data blocks are encrypted or decrypted in place.
+        //! @param [in] cw Control word (8 bytes), after entropy reduction, initial state of the stream cipher.
+        //! @param [in] kk Scheduled keys of the block cipher (56 bytes), kk[0] is used in the first encryption round.
+        //! @param [in] data Addresses of @a count data blocks.
+        //! @param [in] sizes Sizes of the @a count data blocks, at most 184 bytes each.
+        //! @param [in] count Number of data blocks, at most @a lanes.
+        //!
+        typedef void (*Function)(const uint8_t* cw, const uint8_t* kk, uint8_t* const data[], const size_t sizes[], size_t count);
+
+        const UChar* name;    //!< Engine name, for information.
+        size_t       lanes;   //!< Maximum number of data blocks which are processed in parallel.
+        Function     encrypt; //!< Encryption function.
+        Function     decrypt; //!< Decryption function.
+    };
+
+    //!
+    //! S-box of the DVB-CSA2 block cipher, shared by the scalar and batch implementations.
+    //!
+    extern const uint8_t DVBCSA2BlockSBox[256];
+
+    //!
+    //! Get the DVB-CSA2 batch engine using AVX2 instructions.
+    //! This engine is compiled in a separate module, using AVX2 code generation.
+    //! @return Address of the engine description or a null pointer if the library
+    //! was not compiled with AVX2 support. The CPU support shall be checked separately.
+    //!
+    const DVBCSA2BatchEngine* DVBCSA2EngineAVX2();
+
+    //!
+    //! Bitsliced word of 64 bits, using portable C++ code.
+    //! Each bit of a word belongs to a distinct data block of the batch.
+    //! @ingroup crypto
+    //!
+    struct DVBCSA2Word64
+    {
+        static constexpr size_t BITS = 64;  //!< Number of bits in the word.
+        uint64_t v;                         //!< Word value.
+        //! @cond nodoxygen
+        static DVBCSA2Word64 Zero() { return DVBCSA2Word64{0}; }
+        static DVBCSA2Word64 Ones() { return DVBCSA2Word64{~uint64_t(0)}; }
+        static DVBCSA2Word64 Bytes(uint8_t b) { return DVBCSA2Word64{TS_UCONST64(0x0101010101010101) * b}; }
+        static DVBCSA2Word64 Load(const uint64_t* p) { return DVBCSA2Word64{*p}; }
+        static void Store(uint64_t* p, DVBCSA2Word64 w) { *p = w.v; }
+        static DVBCSA2Word64 Shl(DVBCSA2Word64 w, int n) { return DVBCSA2Word64{w.v << n}; }
+        static DVBCSA2Word64 Shr(DVBCSA2Word64 w, int n) { return DVBCSA2Word64{w.v >> n}; }
+        friend DVBCSA2Word64 operator&(DVBCSA2Word64 a, DVBCSA2Word64 b) { return DVBCSA2Word64{a.v & b.v}; }
+        friend DVBCSA2Word64 operator|(DVBCSA2Word64 a, DVBCSA2Word64 b) { return DVBCSA2Word64{a.v | b.v}; }
+        friend DVBCSA2Word64 operator^(DVBCSA2Word64 a, DVBCSA2Word64 b) { return DVBCSA2Word64{a.v ^ b.v}; }
+        friend DVBCSA2Word64 operator~(DVBCSA2Word64 a) { return DVBCSA2Word64{~a.v}; }
+        //! @endcond
+    };
+
+#if defined(TS_DVBCSA2_SSE2) || defined(DOXYGEN)
+    //!
+    //! Bitsliced word of 128 bits, using SSE2 instructions.
+    //! @ingroup crypto
+    //!
+    struct DVBCSA2WordSSE2
+    {
+        static constexpr size_t BITS = 128;  //!< Number of bits in the word.
+        __m128i v;                           //!< Word value.
+        //! @cond nodoxygen
+        static DVBCSA2WordSSE2 Zero() { return DVBCSA2WordSSE2{_mm_setzero_si128()}; }
+        static DVBCSA2WordSSE2 Ones() { return DVBCSA2WordSSE2{_mm_set1_epi32(-1)}; }
+        static DVBCSA2WordSSE2 Bytes(uint8_t b) { return DVBCSA2WordSSE2{_mm_set1_epi8(char(b))}; }
+        static DVBCSA2WordSSE2 Load(const uint64_t* p) { return DVBCSA2WordSSE2{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))}; }
+        static void Store(uint64_t* p, DVBCSA2WordSSE2 w) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), w.v); }
+        static DVBCSA2WordSSE2 Shl(DVBCSA2WordSSE2 w, int n) { return DVBCSA2WordSSE2{_mm_sll_epi64(w.v, _mm_cvtsi32_si128(n))}; }
+        static DVBCSA2WordSSE2 Shr(DVBCSA2WordSSE2 w, int n) { return DVBCSA2WordSSE2{_mm_srl_epi64(w.v, _mm_cvtsi32_si128(n))}; }
+        friend DVBCSA2WordSSE2 operator&(DVBCSA2WordSSE2 a, DVBCSA2WordSSE2 b) { return DVBCSA2WordSSE2{_mm_and_si128(a.v, b.v)}; }
+        friend DVBCSA2WordSSE2 operator|(DVBCSA2WordSSE2 a, DVBCSA2WordSSE2 b) { return DVBCSA2WordSSE2{_mm_or_si128(a.v, b.v)}; }
+        friend DVBCSA2WordSSE2 operator^(DVBCSA2WordSSE2 a, DVBCSA2WordSSE2 b) { return DVBCSA2WordSSE2{_mm_xor_si128(a.v, b.v)}; }
+        friend DVBCSA2WordSSE2 operator~(DVBCSA2WordSSE2 a) { return DVBCSA2WordSSE2{_mm_xor_si128(a.v, _mm_set1_epi32(-1))}; }
+        //! @endcond
+    };
+#endif
+
+#if defined(TS_DVBCSA2_NEON) || defined(DOXYGEN)
+    //!
+    //! Bitsliced word of 128 bits, using Arm NEON instructions.
+    //! @ingroup crypto
+    //!
+    struct DVBCSA2WordNEON
+    {
+        static constexpr size_t BITS = 128;  //!< Number of bits in the word.
+        uint64x2_t v;                        //!< Word value.
+        //! @cond nodoxygen
+        static DVBCSA2WordNEON Zero() { return DVBCSA2WordNEON{vdupq_n_u64(0)}; }
+        static DVBCSA2WordNEON Ones() { return DVBCSA2WordNEON{vdupq_n_u64(~uint64_t(0))}; }
+        static DVBCSA2WordNEON Bytes(uint8_t b) { return DVBCSA2WordNEON{vreinterpretq_u64_u8(vdupq_n_u8(b))}; }
+        static DVBCSA2WordNEON Load(const uint64_t* p) { return DVBCSA2WordNEON{vld1q_u64(p)}; }
+        static void Store(uint64_t* p, DVBCSA2WordNEON w) { vst1q_u64(p, w.v); }
+        static DVBCSA2WordNEON Shl(DVBCSA2WordNEON w, int n) { return DVBCSA2WordNEON{vshlq_u64(w.v, vdupq_n_s64(n))}; }
+        static DVBCSA2WordNEON Shr(DVBCSA2WordNEON w, int n) { return DVBCSA2WordNEON{vshlq_u64(w.v, vdupq_n_s64(-n))}; }
+        friend DVBCSA2WordNEON operator&(DVBCSA2WordNEON a, DVBCSA2WordNEON b) { return DVBCSA2WordNEON{vandq_u64(a.v, b.v)}; }
+        friend DVBCSA2WordNEON operator|(DVBCSA2WordNEON a, DVBCSA2WordNEON b) { return DVBCSA2WordNEON{vorrq_u64(a.v, b.v)}; }
+        friend DVBCSA2WordNEON operator^(DVBCSA2WordNEON a, DVBCSA2WordNEON b) { return DVBCSA2WordNEON{veorq_u64(a.v, b.v)}; }
+        friend DVBCSA2WordNEON operator~(DVBCSA2WordNEON a) { return DVBCSA2WordNEON{vreinterpretq_u64_u8(vmvnq_u8(vreinterpretq_u8_u64(a.v)))}; }
+        //! @endcond
+    };
+#endif
+
+    //!
+    //! Bitsliced implementation of DVB-CSA2, processing in parallel a batch of data blocks
+    //! which share the same control word. The results are identical to the scalar implementation.
+    //! @ingroup crypto
+    //!
+    //! The stream cipher is bitsliced: each bit of a @a WORD belongs to one data block and each
+    //! bit of the cipher state is stored in a distinct @a WORD. The block cipher is byte-sliced:
+    //! the bytes of all data blocks are interleaved so that all operations, except the S-box
+    //! lookups, are performed on full @a WORD values.
+    //!
+    //! @tparam WORD Bitsliced word type. Its number of bits is the number of data blocks in a batch.
+    //!
+    template <class WORD>
+    class DVBCSA2Bitslice
+    {
+    public:
+        static constexpr size_t LANES = WORD::BITS;  //!< Maximum number of data blocks in a batch.
+
+        //!
+        //! Encrypt a batch of data blocks in place.
+        //! @param [in] cw Control word (8 bytes), after entropy reduction, initial state of the stream cipher.
+        //! @param [in] kk Scheduled keys of the block cipher (56 bytes), kk[0] is used in the first encryption round.
+        //! @param [in] data Addresses of @a count data blocks.
+        //! @param [in] sizes Sizes of the @a count data blocks, at most 184 bytes each.
+        //! @param [in] count Number of data blocks, at most LANES.
+        //!
+        static void Encrypt(const uint8_t* cw, const uint8_t* kk, uint8_t* const data[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt a batch of data blocks in place.
+        //! @param [in] cw Control word (8 bytes), after entropy reduction, initial state of the stream cipher.
+        //! @param [in] kk Scheduled keys of the block cipher (56 bytes), kk[0] is used in the first encryption round.
+        //! @param [in] data Addresses of @a count data blocks.
+        //! @param [in] sizes Sizes of the @a count data blocks, at most 184 bytes each.
+        //! @param [in] count Number of data blocks, at most LANES.
+        //!
+        static void Decrypt(const uint8_t* cw, const uint8_t* kk, uint8_t* const data[], const size_t sizes[], size_t count);
+
+    private:
+        static constexpr size_t GROUPS = LANES / 64;     // Number of 64-bit groups in a WORD.
+        static constexpr size_t REG_SIZE = LANES / 8;    // Number of uint64_t in a byte-sliced register (one byte per lane).
+        static constexpr size_t WORD_BYTES = LANES / 8;  // Number of lanes in a WORD in byte-sliced mode.
+
+        // Byte-sliced state of the block cipher. Register k contains byte k of all 8-byte blocks.
+        struct BlockState
+        {
+            uint64_t reg[8][REG_SIZE];
+            uint64_t sbox[REG_SIZE];
+        };
+
+        // Bitsliced state of the stream cipher. Each WORD contains one bit of a nibble.
+        struct StreamState
+        {
+            WORD A[11][4];
+            WORD B[11][4];
+            WORD X[4];
+            WORD Y[4];
+            WORD Z[4];
+            WORD D[4];
+            WORD E[4];
+            WORD F[4];
+            WORD p;
+            WORD q;
+            WORD r;
+
+            // Initialize the state with the control word.
+            void init(const uint8_t* cw);
+
+            // Perform one cycle of the stream cipher. During initialization, in_a and in_b
+            // are the input nibbles for the A and B registers. Return two output bits.
+            template <bool INIT>
+            void cycle(const WORD* in_a, const WORD* in_b, WORD& out_hi, WORD& out_lo);
+        };
+
+        // Number of 8-byte blocks in a data block. Data blocks shorter than 8 bytes are left unmodified.
+        static size_t BlockCount(size_t size) { return size < 8 ? 0 : size / 8; }
+
+        // Byte-sliced block cipher, encryption and decryption.
+        static void Encipher(BlockState& state, const uint8_t* kk, size_t count);
+        static void Decipher(BlockState& state, const uint8_t* kk, size_t count);
+        static WORD Permute(WORD w);
+
+        // Apply the stream cipher on all blocks after the first one (including residue).
+        static void StreamXor(const uint8_t* cw, uint8_t* const data[], const size_t sizes[], size_t count);
+
+        // Transposition between 8-byte blocks and bitsliced words.
+        static void Transpose64(uint64_t* rows);
+        static void BlocksToWords(WORD words[64], uint64_t rows[LANES]);
+        static void WordsToBlocks(uint64_t rows[LANES], const WORD words[64]);
+
+        // Bitsliced S-boxes of the stream cipher: 5 input bits (x4 is the most significant) and 2 output bits.
+        static void SBox1(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0);
+        static void SBox2(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0);
+        static void SBox3(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0);
+        static void SBox4(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0);
+        static void SBox5(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0);
+        static void SBox6(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0);
+        static void SBox7(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0);
+    };
+}
+
+#include "tsDVBCSA2BitsliceTemplate.h"
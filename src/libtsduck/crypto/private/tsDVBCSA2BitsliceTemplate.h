@@ -0,0 +1,668 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Bitsliced implementation of DVB-CSA2 on batches of data blocks.
+//  Template class using a bitsliced word type as template argument.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+template <class WORD>
+constexpr size_t ts::DVBCSA2Bitslice<WORD>::LANES;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Encrypt a batch of data blocks in place.
+//----------------------------------------------------------------------------
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::Encrypt(const uint8_t* cw, const uint8_t* kk, uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    BlockState state;
+    ::memset(&state, 0, sizeof(state));
+    uint8_t* reg[8];
+    for (size_t k = 0; k < 8; ++k) {
+        reg[k] = reinterpret_cast<uint8_t*>(state.reg[k]);
+    }
+
+    size_t max_blocks = 0;
+    for (size_t l = 0; l < count; ++l) {
+        const size_t nb = BlockCount(sizes[l]);
+        if (nb > max_blocks) {
+            max_blocks = nb;
+        }
+    }
+
+    // Perform block cipher in reverse CBC mode, from the last block to the first one.
+    // After last block is initialization vector (zero in DVB-CSA). Each block is enciphered
+    // with the output of the next block, which is still in the state of the block cipher.
+    // The enciphered blocks replace the clear ones in the data blocks.
+    for (size_t i = max_blocks; i-- > 0; ) {
+        for (size_t l = 0; l < count; ++l) {
+            const size_t nb = BlockCount(sizes[l]);
+            if (i < nb) {
+                const uint8_t* const blk = data[l] + 8 * i;
+                if (i + 1 < nb) {
+                    for (size_t k = 0; k < 8; ++k) {
+                        reg[k][l] ^= blk[k];
+                    }
+                }
+                else {
+                    for (size_t k = 0; k < 8; ++k) {
+                        reg[k][l] = blk[k];
+                    }
+                }
+            }
+        }
+        Encipher(state, kk, count);
+        for (size_t l = 0; l < count; ++l) {
+            if (i < BlockCount(sizes[l])) {
+                uint8_t* const blk = data[l] + 8 * i;
+                for (size_t k = 0; k < 8; ++k) {
+                    blk[k] = reg[k][l];
+                }
+            }
+        }
+    }
+
+    // The first block is scrambled using the block cipher only. Its scrambled
+    // value is used to initialize the stream cipher, for all subsequent blocks.
+    StreamXor(cw, data, sizes, count);
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt a batch of data blocks in place.
+//----------------------------------------------------------------------------
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::Decrypt(const uint8_t* cw, const uint8_t* kk, uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    // Remove the stream cipher first. The first scrambled block initializes the stream cipher.
+    // After this, all blocks are intermediate blocks, as produced by the block cipher.
+    StreamXor(cw, data, sizes, count);
+
+    BlockState state;
+    ::memset(&state, 0, sizeof(state));
+    uint8_t* reg[8];
+    for (size_t k = 0; k < 8; ++k) {
+        reg[k] = reinterpret_cast<uint8_t*>(state.reg[k]);
+    }
+
+    size_t max_blocks = 0;
+    for (size_t l = 0; l < count; ++l) {
+        const size_t nb = BlockCount(sizes[l]);
+        if (nb > max_blocks) {
+            max_blocks = nb;
+        }
+    }
+
+    // Decipher all intermediate blocks, they are independent. Each deciphered block
+    // is xor-ed with the next intermediate block (or the zero IV after the last block).
+    for (size_t i = 0; i < max_blocks; ++i) {
+        for (size_t l = 0; l < count; ++l) {
+            if (i < BlockCount(sizes[l])) {
+                const uint8_t* const blk = data[l] + 8 * i;
+                for (size_t k = 0; k < 8; ++k) {
+                    reg[k][l] = blk[k];
+                }
+            }
+        }
+        Decipher(state, kk, count);
+        for (size_t l = 0; l < count; ++l) {
+            const size_t nb = BlockCount(sizes[l]);
+            if (i < nb) {
+                uint8_t* const blk = data[l] + 8 * i;
+                if (i + 1 < nb) {
+                    for (size_t k = 0; k < 8; ++k) {
+                        blk[k] = reg[k][l] ^ blk[8 + k];
+                    }
+                }
+                else {
+                    for (size_t k = 0; k < 8; ++k) {
+                        blk[k] = reg[k][l];
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Byte-sliced block cipher.
+// In the scalar implementation, the 8 registers R1..R8 are shifted at each
+// round. Here, the registers are not moved, their role is rotated instead.
+// After 56 rounds, the registers are back in their initial position.
+//----------------------------------------------------------------------------
+
+template <class WORD>
+WORD ts::DVBCSA2Bitslice<WORD>::Permute(WORD w)
+{
+    // Bit permutation of the block cipher, on all bytes of the word.
+    return WORD::Shl(w & WORD::Bytes(0x29), 1) |
+           WORD::Shl(w & WORD::Bytes(0x02), 6) |
+           WORD::Shl(w & WORD::Bytes(0x04), 3) |
+           WORD::Shr(w & WORD::Bytes(0x10), 2) |
+           WORD::Shr(w & WORD::Bytes(0x40), 6) |
+           WORD::Shr(w & WORD::Bytes(0x80), 4);
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::Encipher(BlockState& state, const uint8_t* kk, size_t count)
+{
+    // Number of uint64_t in the registers which contain lanes in use, rounded up to a full WORD.
+    const size_t size = (count + WORD_BYTES - 1) / WORD_BYTES * GROUPS;
+    uint8_t* const sbox = reinterpret_cast<uint8_t*>(state.sbox);
+
+    // Loop over kk[1]..kk[56]. Register Rn is at index (round + n - 1) % 8.
+    for (size_t round = 0; round < 56; ++round) {
+        uint64_t* const r1 = state.reg[round % 8];
+        uint64_t* const r3 = state.reg[(round + 2) % 8];
+        uint64_t* const r4 = state.reg[(round + 3) % 8];
+        uint64_t* const r5 = state.reg[(round + 4) % 8];
+        uint64_t* const r7 = state.reg[(round + 6) % 8];
+        const uint8_t* const r8 = reinterpret_cast<const uint8_t*>(state.reg[(round + 7) % 8]);
+        const uint8_t k = kk[round];
+        for (size_t l = 0; l < count; ++l) {
+            sbox[l] = DVBCSA2BlockSBox[r8[l] ^ k];
+        }
+        // The new R8 is R1 ^ sbox_out, stored in place in R1.
+        for (size_t w = 0; w < size; w += GROUPS) {
+            const WORD s = WORD::Load(state.sbox + w);
+            const WORD a = WORD::Load(r1 + w);
+            WORD::Store(r3 + w, WORD::Load(r3 + w) ^ a);
+            WORD::Store(r4 + w, WORD::Load(r4 + w) ^ a);
+            WORD::Store(r5 + w, WORD::Load(r5 + w) ^ a);
+            WORD::Store(r7 + w, WORD::Load(r7 + w) ^ Permute(s));
+            WORD::Store(r1 + w, a ^ s);
+        }
+    }
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::Decipher(BlockState& state, const uint8_t* kk, size_t count)
+{
+    // Number of uint64_t in the registers which contain lanes in use, rounded up to a full WORD.
+    const size_t size = (count + WORD_BYTES - 1) / WORD_BYTES * GROUPS;
+    uint8_t* const sbox = reinterpret_cast<uint8_t*>(state.sbox);
+
+    // Loop over kk[56]..kk[1]. Register Rn is at index (n - 1 - round) % 8.
+    for (size_t round = 0; round < 56; ++round) {
+        const size_t base = 8 - round % 8;
+        uint64_t* const r2 = state.reg[(base + 1) % 8];
+        uint64_t* const r3 = state.reg[(base + 2) % 8];
+        uint64_t* const r4 = state.reg[(base + 3) % 8];
+        uint64_t* const r6 = state.reg[(base + 5) % 8];
+        const uint8_t* const r7 = reinterpret_cast<const uint8_t*>(state.reg[(base + 6) % 8]);
+        uint64_t* const r8 = state.reg[(base + 7) % 8];
+        const uint8_t k = kk[55 - round];
+        for (size_t l = 0; l < count; ++l) {
+            sbox[l] = DVBCSA2BlockSBox[r7[l] ^ k];
+        }
+        // The new R1 is R8 ^ sbox_out, stored in place in R8.
+        for (size_t w = 0; w < size; w += GROUPS) {
+            const WORD s = WORD::Load(state.sbox + w);
+            const WORD t = WORD::Load(r8 + w) ^ s;
+            WORD::Store(r8 + w, t);
+            WORD::Store(r4 + w, WORD::Load(r4 + w) ^ t);
+            WORD::Store(r3 + w, WORD::Load(r3 + w) ^ t);
+            WORD::Store(r2 + w, WORD::Load(r2 + w) ^ t);
+            WORD::Store(r6 + w, WORD::Load(r6 + w) ^ Permute(s));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Apply the stream cipher on all blocks after the first one (including residue).
+//----------------------------------------------------------------------------
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::StreamXor(const uint8_t* cw, uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    // Number of 8-byte output blocks of the stream cipher, all blocks after the first one.
+    size_t max_out = 0;
+    for (size_t l = 0; l < count; ++l) {
+        if (sizes[l] >= 8 && (sizes[l] - 1) / 8 > max_out) {
+            max_out = (sizes[l] - 1) / 8;
+        }
+    }
+    if (max_out == 0) {
+        return;
+    }
+
+    // Load the first block of each data block, in little endian order: bit n is bit n % 8 of byte n / 8.
+    uint64_t rows[LANES];
+    for (size_t l = 0; l < LANES; ++l) {
+        rows[l] = 0;
+        if (l < count && sizes[l] >= 8) {
+            for (size_t k = 0; k < 8; ++k) {
+                rows[l] |= uint64_t(data[l][k]) << (8 * k);
+            }
+        }
+    }
+    WORD words[64];
+    BlocksToWords(words, rows);
+
+    // Initialize the stream cipher with the first block. The output is ignored.
+    // Each input byte is used 4 times, alternating its high and low nibbles in A and B.
+    StreamState stream;
+    stream.init(cw);
+    WORD hi, lo;
+    for (size_t i = 0; i < 8; ++i) {
+        const WORD* const in_lo = words + 8 * i;
+        const WORD* const in_hi = words + 8 * i + 4;
+        stream.template cycle<true>(in_hi, in_lo, hi, lo);
+        stream.template cycle<true>(in_lo, in_hi, hi, lo);
+        stream.template cycle<true>(in_hi, in_lo, hi, lo);
+        stream.template cycle<true>(in_lo, in_hi, hi, lo);
+    }
+
+    // Generate the stream cipher output, 8 bytes at a time. Each cycle produces 2 bits, most significant first.
+    for (size_t blk = 1; blk <= max_out; ++blk) {
+        for (size_t i = 0; i < 8; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                stream.template cycle<false>(nullptr, nullptr, words[8 * i + 7 - 2 * j], words[8 * i + 6 - 2 * j]);
+            }
+        }
+        WordsToBlocks(rows, words);
+        for (size_t l = 0; l < count; ++l) {
+            if (sizes[l] >= 8 && 8 * blk < sizes[l]) {
+                uint8_t* const out = data[l] + 8 * blk;
+                const size_t len = sizes[l] - 8 * blk < 8 ? sizes[l] - 8 * blk : 8;
+                for (size_t k = 0; k < len; ++k) {
+                    out[k] ^= uint8_t(rows[l] >> (8 * k));
+                }
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Transposition between 8-byte blocks and bitsliced words.
+//----------------------------------------------------------------------------
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::Transpose64(uint64_t* rows)
+{
+    // Transpose a 64x64 bit matrix in place: bit l of row n becomes bit n of row l.
+    uint64_t mask = TS_UCONST64(0x00000000FFFFFFFF);
+    for (size_t j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            const uint64_t t = ((rows[k] >> j) ^ rows[k | j]) & mask;
+            rows[k | j] ^= t;
+            rows[k] ^= t << j;
+        }
+    }
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::BlocksToWords(WORD words[64], uint64_t rows[LANES])
+{
+    // Row l is the block of lane l. After transposition of each group of 64 rows,
+    // row n of a group contains bit n of the blocks of the 64 lanes in the group.
+    for (size_t g = 0; g < GROUPS; ++g) {
+        Transpose64(rows + 64 * g);
+    }
+    uint64_t w[GROUPS];
+    for (size_t n = 0; n < 64; ++n) {
+        for (size_t g = 0; g < GROUPS; ++g) {
+            w[g] = rows[64 * g + n];
+        }
+        words[n] = WORD::Load(w);
+    }
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::WordsToBlocks(uint64_t rows[LANES], const WORD words[64])
+{
+    uint64_t w[GROUPS];
+    for (size_t n = 0; n < 64; ++n) {
+        WORD::Store(w, words[n]);
+        for (size_t g = 0; g < GROUPS; ++g) {
+            rows[64 * g + n] = w[g];
+        }
+    }
+    for (size_t g = 0; g < GROUPS; ++g) {
+        Transpose64(rows + 64 * g);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Bitsliced stream cipher.
+//----------------------------------------------------------------------------
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::StreamState::init(const uint8_t* cw)
+{
+    // Load first 32 bits of key into A[1]..A[8], last 32 bits of key into B[1]..B[8].
+    // All other registers are zero. The key is the same for all lanes.
+    for (size_t i = 0; i < 8; ++i) {
+        const size_t shift = i % 2 == 0 ? 4 : 0;
+        for (size_t b = 0; b < 4; ++b) {
+            A[i + 1][b] = ((cw[i / 2] >> (shift + b)) & 1) != 0 ? WORD::Ones() : WORD::Zero();
+            B[i + 1][b] = ((cw[4 + i / 2] >> (shift + b)) & 1) != 0 ? WORD::Ones() : WORD::Zero();
+        }
+    }
+    for (size_t b = 0; b < 4; ++b) {
+        A[0][b] = A[9][b] = A[10][b] = WORD::Zero();
+        B[0][b] = B[9][b] = B[10][b] = WORD::Zero();
+        X[b] = Y[b] = Z[b] = D[b] = E[b] = F[b] = WORD::Zero();
+    }
+    p = q = r = WORD::Zero();
+}
+
+template <class WORD>
+template <bool INIT>
+void ts::DVBCSA2Bitslice<WORD>::StreamState::cycle(const WORD* in_a, const WORD* in_b, WORD& out_hi, WORD& out_lo)
+{
+    // From A[1]..A[10], 35 bits are selected as inputs to 7 s-boxes.
+    // 5 bits input per s-box, 2 bits output per s-box.
+    WORD s1h, s1l, s2h, s2l, s3h, s3l, s4h, s4l, s5h, s5l, s6h, s6l, s7h, s7l;
+    SBox1(s1h, s1l, A[4][0], A[1][2], A[6][1], A[7][3], A[9][0]);
+    SBox2(s2h, s2l, A[2][1], A[3][2], A[6][3], A[7][0], A[9][1]);
+    SBox3(s3h, s3l, A[1][3], A[2][0], A[5][1], A[5][3], A[6][2]);
+    SBox4(s4h, s4l, A[3][3], A[1][1], A[2][3], A[4][2], A[8][0]);
+    SBox5(s5h, s5l, A[5][2], A[4][3], A[6][0], A[8][1], A[9][2]);
+    SBox6(s6h, s6l, A[3][1], A[4][1], A[5][0], A[7][2], A[9][3]);
+    SBox7(s7h, s7l, A[2][2], A[3][0], A[7][1], A[8][2], A[8][3]);
+
+    // Use 4x4 xor to produce extra nibble for T3.
+    WORD extra_b[4];
+    extra_b[3] = B[3][0] ^ B[6][1] ^ B[7][2] ^ B[9][3];
+    extra_b[2] = B[6][0] ^ B[8][1] ^ B[3][3] ^ B[4][2];
+    extra_b[1] = B[5][3] ^ B[8][2] ^ B[4][0] ^ B[5][1];
+    extra_b[0] = B[9][2] ^ B[6][3] ^ B[3][1] ^ B[8][0];
+
+    WORD next_a1[4];
+    WORD next_b1[4];
+    WORD sum[4];
+    WORD carry = r;
+    for (size_t b = 0; b < 4; ++b) {
+        // T1 = xor all inputs. The input nibble and D are only used during initialisation.
+        next_a1[b] = A[10][b] ^ X[b];
+        if (INIT) {
+            next_a1[b] = next_a1[b] ^ D[b] ^ in_a[b];
+        }
+        // T2 = xor all inputs. The input nibble is only used during initialisation.
+        next_b1[b] = B[7][b] ^ B[10][b] ^ Y[b];
+        if (INIT) {
+            next_b1[b] = next_b1[b] ^ in_b[b];
+        }
+        // T4 = sum, carry of Z + E + r.
+        const WORD t = Z[b] ^ E[b];
+        sum[b] = t ^ carry;
+        carry = (Z[b] & E[b]) | (carry & t);
+    }
+
+    // T2: if p = 1, rotate left.
+    WORD rot_b1[4];
+    for (size_t b = 0; b < 4; ++b) {
+        rot_b1[b] = next_b1[b] ^ (p & (next_b1[b] ^ next_b1[(b + 3) % 4]));
+    }
+
+    for (size_t b = 0; b < 4; ++b) {
+        // T3 = xor all inputs.
+        D[b] = E[b] ^ Z[b] ^ extra_b[b];
+        // T4: if q = 1, F = Z + E + r, otherwise F = E. The new E is the previous F.
+        const WORD f = F[b];
+        F[b] = E[b] ^ (q & (E[b] ^ sum[b]));
+        E[b] = f;
+    }
+    // r is the carry, if q = 1.
+    r = r ^ (q & (r ^ carry));
+
+    for (size_t i = 10; i > 1; --i) {
+        for (size_t b = 0; b < 4; ++b) {
+            A[i][b] = A[i - 1][b];
+            B[i][b] = B[i - 1][b];
+        }
+    }
+    for (size_t b = 0; b < 4; ++b) {
+        A[1][b] = next_a1[b];
+        B[1][b] = rot_b1[b];
+    }
+
+    X[0] = s1h; X[1] = s2h; X[2] = s3l; X[3] = s4l;
+    Y[0] = s3h; Y[1] = s4h; Y[2] = s5l; Y[3] = s6l;
+    Z[0] = s5h; Z[1] = s6h; Z[2] = s1l; Z[3] = s2l;
+    p = s7h;
+    q = s7l;
+
+    // 2 output bits are a function of the 4 bits of D, xor 2 by 2.
+    out_hi = D[3] ^ D[2];
+    out_lo = D[1] ^ D[0];
+}
+
+
+//----------------------------------------------------------------------------
+// Bitsliced s-boxes of the stream cipher. Boolean circuits which are
+// equivalent to the lookup tables sbox1..sbox7 of the scalar implementation.
+//----------------------------------------------------------------------------
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::SBox1(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0)
+{
+    const WORD t0 = ~x1;
+    const WORD t1 = t0 | ~x4;
+    const WORD t2 = x2 ^ t1;
+    const WORD t3 = x0 & x1;
+    const WORD t4 = t2 ^ t3;
+    const WORD t5 = x4 | x1;
+    const WORD t6 = x2 | t5;
+    const WORD t7 = x0 & t2;
+    const WORD t8 = t6 ^ t7;
+    const WORD t9 = t8 & ~x3;
+    const WORD t10 = t4 ^ t9;
+    const WORD t11 = x2 ^ x4;
+    const WORD t12 = x0 & t11;
+    const WORD t13 = x1 ^ t12;
+    const WORD t14 = x2 & x4;
+    const WORD t15 = t0 ^ t14;
+    const WORD t16 = t15 & ~x0;
+    const WORD t17 = t5 ^ t16;
+    const WORD t18 = x3 & t17;
+    const WORD t19 = t13 ^ t18;
+    hi = t10;
+    lo = t19;
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::SBox2(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0)
+{
+    const WORD t0 = x4 & x2;
+    const WORD t1 = t0 | ~x3;
+    const WORD t2 = ~x2;
+    const WORD t3 = x4 | t2;
+    const WORD t4 = x3 & x4;
+    const WORD t5 = t3 ^ t4;
+    const WORD t6 = x1 & t5;
+    const WORD t7 = t1 ^ t6;
+    const WORD t8 = t2 ^ t4;
+    const WORD t9 = x1 | t8;
+    const WORD t10 = x0 & t9;
+    const WORD t11 = t7 ^ t10;
+    const WORD t12 = x1 ^ t5;
+    const WORD t13 = x2 & ~x4;
+    const WORD t14 = x3 & t13;
+    const WORD t15 = x2 ^ t14;
+    const WORD t16 = x3 | x4;
+    const WORD t17 = x1 & t16;
+    const WORD t18 = t15 ^ t17;
+    const WORD t19 = x0 & t18;
+    const WORD t20 = t12 ^ t19;
+    hi = t11;
+    lo = t20;
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::SBox3(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0)
+{
+    const WORD t0 = ~x4;
+    const WORD t1 = x1 | t0;
+    const WORD t2 = t1 | ~x3;
+    const WORD t3 = x1 | x4;
+    const WORD t4 = x3 | t3;
+    const WORD t5 = t4 & ~x2;
+    const WORD t6 = t2 ^ t5;
+    const WORD t7 = x1 ^ x4;
+    const WORD t8 = x3 | t7;
+    const WORD t9 = t0 & ~x1;
+    const WORD t10 = t9 & ~x2;
+    const WORD t11 = t8 ^ t10;
+    const WORD t12 = x0 & t11;
+    const WORD t13 = t6 ^ t12;
+    const WORD t14 = x3 ^ t7;
+    const WORD t15 = x2 ^ x1;
+    const WORD t16 = x0 & t15;
+    const WORD t17 = t14 ^ t16;
+    hi = t13;
+    lo = t17;
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::SBox4(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0)
+{
+    const WORD t0 = x1 | ~x0;
+    const WORD t1 = ~x1;
+    const WORD t2 = t1 | ~x0;
+    const WORD t3 = x2 & t2;
+    const WORD t4 = t0 ^ t3;
+    const WORD t5 = t1 | ~x2;
+    const WORD t6 = x3 & t5;
+    const WORD t7 = t4 ^ t6;
+    const WORD t8 = x1 & ~x0;
+    const WORD t9 = x2 | t8;
+    const WORD t10 = x2 & t1;
+    const WORD t11 = t0 ^ t10;
+    const WORD t12 = t11 & ~x3;
+    const WORD t13 = t9 ^ t12;
+    const WORD t14 = x4 & t13;
+    const WORD t15 = t7 ^ t14;
+    const WORD t16 = x0 | t1;
+    const WORD t17 = t16 & ~x2;
+    const WORD t18 = t17 ^ t12;
+    const WORD t19 = t18 & ~x4;
+    const WORD t20 = t7 ^ t19;
+    hi = t15;
+    lo = t20;
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::SBox5(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0)
+{
+    const WORD t0 = x4 & ~x1;
+    const WORD t1 = ~x4;
+    const WORD t2 = x2 & t1;
+    const WORD t3 = t0 ^ t2;
+    const WORD t4 = x1 | x4;
+    const WORD t5 = x2 | t4;
+    const WORD t6 = x3 & t5;
+    const WORD t7 = t3 ^ t6;
+    const WORD t8 = x2 & t4;
+    const WORD t9 = x1 ^ t1;
+    const WORD t10 = t9 ^ t2;
+    const WORD t11 = t10 & ~x3;
+    const WORD t12 = t8 ^ t11;
+    const WORD t13 = t12 & ~x0;
+    const WORD t14 = t7 ^ t13;
+    const WORD t15 = x1 | t1;
+    const WORD t16 = x2 & t15;
+    const WORD t17 = x3 & t4;
+    const WORD t18 = t16 ^ t17;
+    const WORD t19 = x4 | ~x1;
+    const WORD t20 = t19 ^ t8;
+    const WORD t21 = x2 ^ t15;
+    const WORD t22 = t21 & ~x3;
+    const WORD t23 = t20 ^ t22;
+    const WORD t24 = x0 & t23;
+    const WORD t25 = t18 ^ t24;
+    hi = t14;
+    lo = t25;
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::SBox6(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0)
+{
+    const WORD t0 = x1 ^ x4;
+    const WORD t1 = x3 & x2;
+    const WORD t2 = t0 ^ t1;
+    const WORD t3 = x1 & x4;
+    const WORD t4 = x2 ^ t3;
+    const WORD t5 = x2 ^ t0;
+    const WORD t6 = x3 & t5;
+    const WORD t7 = t4 ^ t6;
+    const WORD t8 = x0 & t7;
+    const WORD t9 = t2 ^ t8;
+    const WORD t10 = x4 | ~x1;
+    const WORD t11 = x2 & t10;
+    const WORD t12 = x1 ^ t11;
+    const WORD t13 = x3 & t12;
+    const WORD t14 = t11 ^ t13;
+    const WORD t15 = t10 | ~x2;
+    const WORD t16 = t3 & ~x3;
+    const WORD t17 = t15 ^ t16;
+    const WORD t18 = x0 & t17;
+    const WORD t19 = t14 ^ t18;
+    hi = t9;
+    lo = t19;
+}
+
+template <class WORD>
+void ts::DVBCSA2Bitslice<WORD>::SBox7(WORD& hi, WORD& lo, WORD x4, WORD x3, WORD x2, WORD x1, WORD x0)
+{
+    const WORD t0 = x3 ^ x1;
+    const WORD t1 = x0 & ~x1;
+    const WORD t2 = x1 & x0;
+    const WORD t3 = x3 & t2;
+    const WORD t4 = t1 ^ t3;
+    const WORD t5 = t4 & ~x4;
+    const WORD t6 = t0 ^ t5;
+    const WORD t7 = x1 & ~x3;
+    const WORD t8 = t2 ^ t7;
+    const WORD t9 = t8 | ~x4;
+    const WORD t10 = x2 & t9;
+    const WORD t11 = t6 ^ t10;
+    const WORD t12 = x3 ^ t1;
+    const WORD t13 = x0 | ~x1;
+    const WORD t14 = t13 | ~x3;
+    const WORD t15 = x4 & t14;
+    const WORD t16 = t12 ^ t15;
+    const WORD t17 = x3 ^ t13;
+    const WORD t18 = x2 & t17;
+    const WORD t19 = t16 ^ t18;
+    hi = t11;
+    lo = t19;
+}
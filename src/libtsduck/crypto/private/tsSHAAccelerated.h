@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Hardware-accelerated implementations of SHA-1 and SHA-256 (internal).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAcceleratedEngine.h"
+#include "tsUChar.h"
+
+namespace ts {
+    //!
+    //! Description of a hardware-accelerated SHA-1 / SHA-256 compression engine.
+    //! @ingroup crypto
+    //!
+    struct SHAAcceleratedEngine
+    {
+        //!
+        //! Profile of a compression function on consecutive blocks of one message.
+        //! @param [in,out] state Hash state, 5 words for SHA-1, 8 words for SHA-256.
+        //! @param [in] data Address of 64-byte blocks, any alignment.
+        //! @param [in] count Number of 64-byte blocks.
+        //!
+        typedef void (*Function)(uint32_t* state, const uint8_t* data, size_t count);
+
+        //!
+        //! Profile of a compression function on one block of several independent messages.
+        //! The messages are processed in parallel lanes, interleaving the instructions.
+        //! @param [in,out] states Array of addresses of hash states, one per lane.
+        //! @param [in] blocks Array of addresses of 64-byte blocks, one per lane.
+        //!
+        typedef void (*LanesFunction)(uint32_t* const states[], const uint8_t* const blocks[]);
+
+        const UChar*  name;         //!< Engine name, for information.
+        size_t        lanes;        //!< Number of lanes in the functions @a sha1Lanes and @a sha256Lanes.
+        Function      sha1;         //!< SHA-1 compression function.
+        LanesFunction sha1Lanes;    //!< SHA-1 compression function on parallel lanes.
+        Function      sha256;       //!< SHA-256 compression function.
+        LanesFunction sha256Lanes;  //!< SHA-256 compression function on parallel lanes.
+    };
+
+    //!
+    //! The 64 round constants of SHA-256, as defined in FIPS 180-4, section 4.2.2.
+    //!
+    extern const uint32_t SHA256RoundConstants[64];
+
+    //!
+    //! Get the SHA engine using the Intel SHA extensions.
+    //! This engine is compiled in a separate module, using SHA code generation.
+    //! @return Address of the engine description or a null pointer if the library
+    //! was not compiled with SHA extensions support. The CPU support shall be checked separately.
+    //!
+    const SHAAcceleratedEngine* SHAEngineIntel();
+
+    //!
+    //! Get the SHA engine using the Armv8 cryptographic extensions.
+    //! This engine is compiled in a separate module, using Armv8 crypto code generation.
+    //! @return Address of the engine description or a null pointer if the library
+    //! was not compiled with Armv8 cryptographic extensions. The CPU support shall be checked separately.
+    //!
+    const SHAAcceleratedEngine* SHAEngineArm();
+
+    //!
+    //! Selection of the hardware-accelerated engine, according to the features of the CPU.
+    //!
+    typedef AcceleratedEngineSelector<SHAAcceleratedEngine, &SysInfo::shaInstructions, SHAEngineIntel, SHAEngineArm> SHAEngineSelector;
+}
@@ -0,0 +1,240 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  SHA-1 and SHA-256 engine using the Armv8 cryptographic extensions.
+//  This module is compiled with Armv8 crypto code generation. It shall be used
+//  only after checking that the CPU supports them, see SysInfo::shaInstructions().
+//  The structure is the same as in the Intel SHA extensions engine.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSHAAccelerated.h"
+
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2) || (defined(TS_MSC) && defined(TS_ARM64))
+
+#include "tsBeforeStandardHeaders.h"
+#include <arm_neon.h>
+#include "tsAfterStandardHeaders.h"
+
+namespace {
+
+    // Number of messages which are processed in parallel in the "lanes" functions.
+    constexpr size_t LANES = 2;
+
+    // Load a 16-byte block as 4 big-endian words.
+    inline uint32x4_t Load(const uint8_t* p)
+    {
+        return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+    }
+
+    //------------------------------------------------------------------------
+    // SHA-1
+    //------------------------------------------------------------------------
+
+    // Group of rounds 4*G to 4*G+3 on N lanes.
+    template <int G, size_t N>
+    inline void Rounds1(uint32x4_t* abcd, uint32_t* e, uint32x4_t (*msg)[4], const uint8_t* const* data)
+    {
+        static const uint32_t K[4] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+        for (size_t l = 0; l < N; ++l) {
+            uint32x4_t* m = msg[l];
+            if (G < 4) {
+                m[G] = Load(data[l] + 16 * G);
+            }
+            const uint32x4_t wk = vaddq_u32(m[G % 4], vdupq_n_u32(K[G / 5]));
+            const uint32_t enext = vsha1h_u32(vgetq_lane_u32(abcd[l], 0));
+            switch (G / 5) {
+                case 0: abcd[l] = vsha1cq_u32(abcd[l], e[l], wk); break;
+                case 2: abcd[l] = vsha1mq_u32(abcd[l], e[l], wk); break;
+                default: abcd[l] = vsha1pq_u32(abcd[l], e[l], wk); break;
+            }
+            e[l] = enext;
+            if (G < 16) {
+                m[G % 4] = vsha1su1q_u32(vsha1su0q_u32(m[G % 4], m[(G + 1) % 4], m[(G + 2) % 4]), m[(G + 3) % 4]);
+            }
+        }
+    }
+
+    // Compress one block on N lanes.
+    template <size_t N>
+    inline void Block1(uint32x4_t* abcd, uint32_t* e, const uint8_t* const* data)
+    {
+        uint32x4_t abcd_save[N], msg[N][4];
+        uint32_t e_save[N];
+        for (size_t l = 0; l < N; ++l) {
+            abcd_save[l] = abcd[l];
+            e_save[l] = e[l];
+        }
+        Rounds1<0, N>(abcd, e, msg, data);
+        Rounds1<1, N>(abcd, e, msg, data);
+        Rounds1<2, N>(abcd, e, msg, data);
+        Rounds1<3, N>(abcd, e, msg, data);
+        Rounds1<4, N>(abcd, e, msg, data);
+        Rounds1<5, N>(abcd, e, msg, data);
+        Rounds1<6, N>(abcd, e, msg, data);
+        Rounds1<7, N>(abcd, e, msg, data);
+        Rounds1<8, N>(abcd, e, msg, data);
+        Rounds1<9, N>(abcd, e, msg, data);
+        Rounds1<10, N>(abcd, e, msg, data);
+        Rounds1<11, N>(abcd, e, msg, data);
+        Rounds1<12, N>(abcd, e, msg, data);
+        Rounds1<13, N>(abcd, e, msg, data);
+        Rounds1<14, N>(abcd, e, msg, data);
+        Rounds1<15, N>(abcd, e, msg, data);
+        Rounds1<16, N>(abcd, e, msg, data);
+        Rounds1<17, N>(abcd, e, msg, data);
+        Rounds1<18, N>(abcd, e, msg, data);
+        Rounds1<19, N>(abcd, e, msg, data);
+        for (size_t l = 0; l < N; ++l) {
+            abcd[l] = vaddq_u32(abcd[l], abcd_save[l]);
+            e[l] += e_save[l];
+        }
+    }
+
+    void SHA1(uint32_t* state, const uint8_t* data, size_t count)
+    {
+        uint32x4_t abcd = vld1q_u32(state);
+        uint32_t e = state[4];
+        for (; count > 0; --count, data += 64) {
+            Block1<1>(&abcd, &e, &data);
+        }
+        vst1q_u32(state, abcd);
+        state[4] = e;
+    }
+
+    void SHA1Lanes(uint32_t* const states[], const uint8_t* const blocks[])
+    {
+        uint32x4_t abcd[LANES];
+        uint32_t e[LANES];
+        for (size_t l = 0; l < LANES; ++l) {
+            abcd[l] = vld1q_u32(states[l]);
+            e[l] = states[l][4];
+        }
+        Block1<LANES>(abcd, e, blocks);
+        for (size_t l = 0; l < LANES; ++l) {
+            vst1q_u32(states[l], abcd[l]);
+            states[l][4] = e[l];
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // SHA-256
+    //------------------------------------------------------------------------
+
+    // Group of rounds 4*G to 4*G+3 on N lanes.
+    template <int G, size_t N>
+    inline void Rounds256(uint32x4_t* state0, uint32x4_t* state1, uint32x4_t (*msg)[4], const uint8_t* const* data)
+    {
+        const uint32x4_t k = vld1q_u32(ts::SHA256RoundConstants + 4 * G);
+        for (size_t l = 0; l < N; ++l) {
+            uint32x4_t* m = msg[l];
+            if (G < 4) {
+                m[G] = Load(data[l] + 16 * G);
+            }
+            const uint32x4_t wk = vaddq_u32(m[G % 4], k);
+            if (G < 12) {
+                m[G % 4] = vsha256su1q_u32(vsha256su0q_u32(m[G % 4], m[(G + 1) % 4]), m[(G + 2) % 4], m[(G + 3) % 4]);
+            }
+            const uint32x4_t abcd = state0[l];
+            state0[l] = vsha256hq_u32(state0[l], state1[l], wk);
+            state1[l] = vsha256h2q_u32(state1[l], abcd, wk);
+        }
+    }
+
+    // Compress one block on N lanes.
+    template <size_t N>
+    inline void Block256(uint32x4_t* state0, uint32x4_t* state1, const uint8_t* const* data)
+    {
+        uint32x4_t save0[N], save1[N], msg[N][4];
+        for (size_t l = 0; l < N; ++l) {
+            save0[l] = state0[l];
+            save1[l] = state1[l];
+        }
+        Rounds256<0, N>(state0, state1, msg, data);
+        Rounds256<1, N>(state0, state1, msg, data);
+        Rounds256<2, N>(state0, state1, msg, data);
+        Rounds256<3, N>(state0, state1, msg, data);
+        Rounds256<4, N>(state0, state1, msg, data);
+        Rounds256<5, N>(state0, state1, msg, data);
+        Rounds256<6, N>(state0, state1, msg, data);
+        Rounds256<7, N>(state0, state1, msg, data);
+        Rounds256<8, N>(state0, state1, msg, data);
+        Rounds256<9, N>(state0, state1, msg, data);
+        Rounds256<10, N>(state0, state1, msg, data);
+        Rounds256<11, N>(state0, state1, msg, data);
+        Rounds256<12, N>(state0, state1, msg, data);
+        Rounds256<13, N>(state0, state1, msg, data);
+        Rounds256<14, N>(state0, state1, msg, data);
+        Rounds256<15, N>(state0, state1, msg, data);
+        for (size_t l = 0; l < N; ++l) {
+            state0[l] = vaddq_u32(state0[l], save0[l]);
+            state1[l] = vaddq_u32(state1[l], save1[l]);
+        }
+    }
+
+    void SHA256(uint32_t* state, const uint8_t* data, size_t count)
+    {
+        uint32x4_t state0 = vld1q_u32(state);
+        uint32x4_t state1 = vld1q_u32(state + 4);
+        for (; count > 0; --count, data += 64) {
+            Block256<1>(&state0, &state1, &data);
+        }
+        vst1q_u32(state, state0);
+        vst1q_u32(state + 4, state1);
+    }
+
+    void SHA256Lanes(uint32_t* const states[], const uint8_t* const blocks[])
+    {
+        uint32x4_t state0[LANES], state1[LANES];
+        for (size_t l = 0; l < LANES; ++l) {
+            state0[l] = vld1q_u32(states[l]);
+            state1[l] = vld1q_u32(states[l] + 4);
+        }
+        Block256<LANES>(state0, state1, blocks);
+        for (size_t l = 0; l < LANES; ++l) {
+            vst1q_u32(states[l], state0[l]);
+            vst1q_u32(states[l] + 4, state1[l]);
+        }
+    }
+
+    const ts::SHAAcceleratedEngine EngineArm = {u"Armv8 crypto", LANES, SHA1, SHA1Lanes, SHA256, SHA256Lanes};
+}
+
+const ts::SHAAcceleratedEngine* ts::SHAEngineArm()
+{
+    return &EngineArm;
+}
+
+#else
+
+const ts::SHAAcceleratedEngine* ts::SHAEngineArm()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,287 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  SHA-1 and SHA-256 engine using the Intel SHA extensions.
+//  This module is compiled with SHA and SSE4.1 code generation. It shall be
+//  used only after checking that the CPU supports them, see SysInfo::shaInstructions().
+//
+//  The compression functions are templates on the number of lanes. The steps
+//  of independent messages are interleaved to hide the latency of the SHA
+//  instructions. The message schedule of SHA-256 uses a ring of 4 registers,
+//  the function Rounds<G>() implements the group of rounds 4*G to 4*G+3.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSHAAccelerated.h"
+
+#if (defined(__SHA__) && defined(__SSE4_1__)) || (defined(TS_MSC) && (defined(TS_I386) || defined(TS_X86_64)))
+
+#include "tsBeforeStandardHeaders.h"
+#include <immintrin.h>
+#include "tsAfterStandardHeaders.h"
+
+namespace {
+
+    // Number of messages which are processed in parallel in the "lanes" functions.
+    constexpr size_t LANES = 2;
+
+    // Load a 16-byte block, swapping bytes using a mask.
+    inline __m128i Load(const uint8_t* p, __m128i mask)
+    {
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), mask);
+    }
+
+    //------------------------------------------------------------------------
+    // SHA-1
+    //------------------------------------------------------------------------
+
+    // Group of rounds 4*G to 4*G+3 on N lanes. The E registers alternate between groups.
+    template <int G, size_t N>
+    inline void Rounds1(__m128i* abcd, __m128i* e0, __m128i* e1, __m128i (*msg)[4], const uint8_t* const* data, __m128i mask)
+    {
+        for (size_t l = 0; l < N; ++l) {
+            __m128i& e = G % 2 == 0 ? e0[l] : e1[l];
+            __m128i& enext = G % 2 == 0 ? e1[l] : e0[l];
+            __m128i* m = msg[l];
+            if (G < 4) {
+                m[G] = Load(data[l] + 16 * G, mask);
+            }
+            e = G == 0 ? _mm_add_epi32(e, m[0]) : _mm_sha1nexte_epu32(e, m[G % 4]);
+            enext = abcd[l];
+            if (G >= 3 && G <= 18) {
+                m[(G + 1) % 4] = _mm_sha1msg2_epu32(m[(G + 1) % 4], m[G % 4]);
+            }
+            abcd[l] = _mm_sha1rnds4_epu32(abcd[l], e, G / 5);
+            if (G >= 1 && G <= 16) {
+                m[(G + 3) % 4] = _mm_sha1msg1_epu32(m[(G + 3) % 4], m[G % 4]);
+            }
+            if (G >= 2 && G <= 17) {
+                m[(G + 2) % 4] = _mm_xor_si128(m[(G + 2) % 4], m[G % 4]);
+            }
+        }
+    }
+
+    // Compress one block on N lanes.
+    template <size_t N>
+    inline void Block1(__m128i* abcd, __m128i* e0, const uint8_t* const* data, __m128i mask)
+    {
+        __m128i abcd_save[N], e0_save[N], e1[N], msg[N][4];
+        for (size_t l = 0; l < N; ++l) {
+            abcd_save[l] = abcd[l];
+            e0_save[l] = e0[l];
+        }
+        Rounds1<0, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<1, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<2, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<3, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<4, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<5, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<6, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<7, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<8, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<9, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<10, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<11, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<12, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<13, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<14, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<15, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<16, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<17, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<18, N>(abcd, e0, e1, msg, data, mask);
+        Rounds1<19, N>(abcd, e0, e1, msg, data, mask);
+        for (size_t l = 0; l < N; ++l) {
+            e0[l] = _mm_sha1nexte_epu32(e0[l], e0_save[l]);
+            abcd[l] = _mm_add_epi32(abcd[l], abcd_save[l]);
+        }
+    }
+
+    // Byte swap mask for SHA-1: the words are reversed in the ABCD register.
+    inline __m128i Mask1()
+    {
+        return _mm_set_epi64x(0x0001020304050607LL, 0x08090A0B0C0D0E0FLL);
+    }
+
+    // State <-> registers.
+    inline void Load1(const uint32_t* state, __m128i& abcd, __m128i& e0)
+    {
+        abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+        e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+    }
+
+    inline void Store1(uint32_t* state, __m128i abcd, __m128i e0)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+        state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+    }
+
+    void SHA1(uint32_t* state, const uint8_t* data, size_t count)
+    {
+        const __m128i mask = Mask1();
+        __m128i abcd, e0;
+        Load1(state, abcd, e0);
+        for (; count > 0; --count, data += 64) {
+            Block1<1>(&abcd, &e0, &data, mask);
+        }
+        Store1(state, abcd, e0);
+    }
+
+    void SHA1Lanes(uint32_t* const states[], const uint8_t* const blocks[])
+    {
+        const __m128i mask = Mask1();
+        __m128i abcd[LANES], e0[LANES];
+        for (size_t l = 0; l < LANES; ++l) {
+            Load1(states[l], abcd[l], e0[l]);
+        }
+        Block1<LANES>(abcd, e0, blocks, mask);
+        for (size_t l = 0; l < LANES; ++l) {
+            Store1(states[l], abcd[l], e0[l]);
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // SHA-256
+    //------------------------------------------------------------------------
+
+    // Group of rounds 4*G to 4*G+3 on N lanes.
+    template <int G, size_t N>
+    inline void Rounds256(__m128i* state0, __m128i* state1, __m128i (*msg)[4], const uint8_t* const* data, __m128i mask)
+    {
+        const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ts::SHA256RoundConstants + 4 * G));
+        for (size_t l = 0; l < N; ++l) {
+            __m128i* m = msg[l];
+            if (G < 4) {
+                m[G] = Load(data[l] + 16 * G, mask);
+            }
+            __m128i wk = _mm_add_epi32(m[G % 4], k);
+            state1[l] = _mm_sha256rnds2_epu32(state1[l], state0[l], wk);
+            if (G >= 3 && G <= 14) {
+                m[(G + 1) % 4] = _mm_sha256msg2_epu32(_mm_add_epi32(m[(G + 1) % 4], _mm_alignr_epi8(m[G % 4], m[(G + 3) % 4], 4)), m[G % 4]);
+            }
+            wk = _mm_shuffle_epi32(wk, 0x0E);
+            state0[l] = _mm_sha256rnds2_epu32(state0[l], state1[l], wk);
+            if (G >= 1 && G <= 12) {
+                m[(G + 3) % 4] = _mm_sha256msg1_epu32(m[(G + 3) % 4], m[G % 4]);
+            }
+        }
+    }
+
+    // Compress one block on N lanes.
+    template <size_t N>
+    inline void Block256(__m128i* state0, __m128i* state1, const uint8_t* const* data, __m128i mask)
+    {
+        __m128i save0[N], save1[N], msg[N][4];
+        for (size_t l = 0; l < N; ++l) {
+            save0[l] = state0[l];
+            save1[l] = state1[l];
+        }
+        Rounds256<0, N>(state0, state1, msg, data, mask);
+        Rounds256<1, N>(state0, state1, msg, data, mask);
+        Rounds256<2, N>(state0, state1, msg, data, mask);
+        Rounds256<3, N>(state0, state1, msg, data, mask);
+        Rounds256<4, N>(state0, state1, msg, data, mask);
+        Rounds256<5, N>(state0, state1, msg, data, mask);
+        Rounds256<6, N>(state0, state1, msg, data, mask);
+        Rounds256<7, N>(state0, state1, msg, data, mask);
+        Rounds256<8, N>(state0, state1, msg, data, mask);
+        Rounds256<9, N>(state0, state1, msg, data, mask);
+        Rounds256<10, N>(state0, state1, msg, data, mask);
+        Rounds256<11, N>(state0, state1, msg, data, mask);
+        Rounds256<12, N>(state0, state1, msg, data, mask);
+        Rounds256<13, N>(state0, state1, msg, data, mask);
+        Rounds256<14, N>(state0, state1, msg, data, mask);
+        Rounds256<15, N>(state0, state1, msg, data, mask);
+        for (size_t l = 0; l < N; ++l) {
+            state0[l] = _mm_add_epi32(state0[l], save0[l]);
+            state1[l] = _mm_add_epi32(state1[l], save1[l]);
+        }
+    }
+
+    // Byte swap mask for SHA-256: bytes are swapped in each word.
+    inline __m128i Mask256()
+    {
+        return _mm_set_epi64x(0x0C0D0E0F08090A0BLL, 0x0405060700010203LL);
+    }
+
+    // State <-> registers: the SHA-256 instructions use ABEF and CDGH registers.
+    inline void Load256(const uint32_t* state, __m128i& state0, __m128i& state1)
+    {
+        const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+        const __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+        state0 = _mm_alignr_epi8(dcba, efgh, 8);
+        state1 = _mm_blend_epi16(efgh, dcba, 0xF0);
+    }
+
+    inline void Store256(uint32_t* state, __m128i state0, __m128i state1)
+    {
+        const __m128i feba = _mm_shuffle_epi32(state0, 0x1B);
+        const __m128i dchg = _mm_shuffle_epi32(state1, 0xB1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xF0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+    }
+
+    void SHA256(uint32_t* state, const uint8_t* data, size_t count)
+    {
+        const __m128i mask = Mask256();
+        __m128i state0, state1;
+        Load256(state, state0, state1);
+        for (; count > 0; --count, data += 64) {
+            Block256<1>(&state0, &state1, &data, mask);
+        }
+        Store256(state, state0, state1);
+    }
+
+    void SHA256Lanes(uint32_t* const states[], const uint8_t* const blocks[])
+    {
+        const __m128i mask = Mask256();
+        __m128i state0[LANES], state1[LANES];
+        for (size_t l = 0; l < LANES; ++l) {
+            Load256(states[l], state0[l], state1[l]);
+        }
+        Block256<LANES>(state0, state1, blocks, mask);
+        for (size_t l = 0; l < LANES; ++l) {
+            Store256(states[l], state0[l], state1[l]);
+        }
+    }
+
+    const ts::SHAAcceleratedEngine EngineIntel = {u"SHA extensions", LANES, SHA1, SHA1Lanes, SHA256, SHA256Lanes};
+}
+
+const ts::SHAAcceleratedEngine* ts::SHAEngineIntel()
+{
+    return &EngineIntel;
+}
+
+#else
+
+const ts::SHAAcceleratedEngine* ts::SHAEngineIntel()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSHAMultiBuffer.h"
+#include "tsMemory.h"
+
+namespace {
+
+    // SHA-1 and SHA-256 block size.
+    constexpr size_t BLOCK_SIZE = 64;
+
+    // Description of one message, including its padded final blocks.
+    struct Message
+    {
+        const uint8_t* data;       // Message data.
+        size_t         full;       // Number of complete blocks in data.
+        size_t         total;      // Total number of blocks, including the padding.
+        uint8_t        tail[2 * BLOCK_SIZE];  // Last incomplete block and padding.
+
+        void set(const void* addr, size_t size);
+        const uint8_t* block(size_t index) const { return index < full ? data + index * BLOCK_SIZE : tail + (index - full) * BLOCK_SIZE; }
+    };
+
+    void Message::set(const void* addr, size_t size)
+    {
+        data = static_cast<const uint8_t*>(addr);
+        full = size / BLOCK_SIZE;
+
+        // Padding: a '1' bit, zeroes, message size in bits on 64 bits.
+        const size_t rem = size % BLOCK_SIZE;
+        const size_t tail_size = rem < BLOCK_SIZE - 8 ? BLOCK_SIZE : 2 * BLOCK_SIZE;
+        if (rem > 0) {
+            ::memcpy(tail, data + full * BLOCK_SIZE, rem);
+        }
+        tail[rem] = 0x80;
+        ::memset(tail + rem + 1, 0, tail_size - rem - 9);
+        ts::PutUInt64(tail + tail_size - 8, uint64_t(size) * 8);
+        total = full + tail_size / BLOCK_SIZE;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the hashes of independent messages using parallel lanes.
+//----------------------------------------------------------------------------
+
+void ts::SHAMultiBuffer(const uint32_t* init,
+                        size_t words,
+                        SHAAcceleratedEngine::Function compress,
+                        SHAAcceleratedEngine::LanesFunction compress_lanes,
+                        size_t lanes,
+                        const void* const data[],
+                        const size_t sizes[],
+                        size_t count,
+                        uint8_t* hashes)
+{
+    Message msg[SHA_MAX_LANES];
+    uint32_t state[SHA_MAX_LANES][8];
+    uint32_t* states[SHA_MAX_LANES];
+    const uint8_t* blocks[SHA_MAX_LANES];
+
+    for (size_t first = 0; first < count; first += lanes) {
+
+        // Prepare a group of messages.
+        const size_t n = std::min(lanes, count - first);
+        size_t common = std::numeric_limits<size_t>::max();
+        for (size_t l = 0; l < n; ++l) {
+            msg[l].set(data[first + l], sizes[first + l]);
+            ::memcpy(state[l], init, words * sizeof(uint32_t));
+            states[l] = state[l];
+            common = std::min(common, msg[l].total);
+        }
+
+        // Process all lanes in parallel for the number of blocks they have in common.
+        if (n < lanes) {
+            common = 0;
+        }
+        for (size_t b = 0; b < common; ++b) {
+            for (size_t l = 0; l < lanes; ++l) {
+                blocks[l] = msg[l].block(b);
+            }
+            compress_lanes(states, blocks);
+        }
+
+        // Finish each message alone, contiguous data blocks first, then the padded blocks.
+        for (size_t l = 0; l < n; ++l) {
+            size_t b = common;
+            if (b < msg[l].full) {
+                compress(state[l], msg[l].block(b), msg[l].full - b);
+                b = msg[l].full;
+            }
+            if (b < msg[l].total) {
+                compress(state[l], msg[l].block(b), msg[l].total - b);
+            }
+            for (size_t i = 0; i < words; ++i) {
+                PutUInt32(hashes + (first + l) * 4 * words + 4 * i, state[l][i]);
+            }
+        }
+    }
+}
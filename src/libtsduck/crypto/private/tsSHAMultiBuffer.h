@@ -0,0 +1,166 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Multi-buffer computation of SHA-1 and SHA-256 hashes (internal).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSHAAccelerated.h"
+#include "tsMemory.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TS_SHA_SSE2 1
+    #include "tsBeforeStandardHeaders.h"
+    #include <emmintrin.h>
+    #include "tsAfterStandardHeaders.h"
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || (defined(TS_MSC) && defined(TS_ARM64))
+    #define TS_SHA_NEON 1
+    #include "tsBeforeStandardHeaders.h"
+    #include <arm_neon.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+namespace ts {
+    //!
+    //! Maximum number of parallel lanes in a multi-buffer SHA computation.
+    //!
+    constexpr size_t SHA_MAX_LANES = 4;
+
+    //!
+    //! Vector of four 32-bit words, one per lane, for the software multi-buffer SHA-1 and SHA-256.
+    //! Uses SSE2 or NEON instructions when available, portable C++ code otherwise.
+    //! @ingroup crypto
+    //!
+    struct SHALanesWord
+    {
+        static constexpr size_t LANES = 4;  //!< Number of lanes in the word.
+#if defined(TS_SHA_SSE2)
+        __m128i v;                          //!< Word value.
+        //! @cond nodoxygen
+        static SHALanesWord Set(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3) { return SHALanesWord{_mm_set_epi32(int(x3), int(x2), int(x1), int(x0))}; }
+        static SHALanesWord Dup(uint32_t x) { return SHALanesWord{_mm_set1_epi32(int(x))}; }
+        static void Store(uint32_t* p, SHALanesWord w) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), w.v); }
+        template <int N> static SHALanesWord Shr(SHALanesWord w) { return SHALanesWord{_mm_srli_epi32(w.v, N)}; }
+        template <int N> static SHALanesWord Rol(SHALanesWord w) { return SHALanesWord{_mm_or_si128(_mm_slli_epi32(w.v, N), _mm_srli_epi32(w.v, 32 - N))}; }
+        friend SHALanesWord operator+(SHALanesWord a, SHALanesWord b) { return SHALanesWord{_mm_add_epi32(a.v, b.v)}; }
+        friend SHALanesWord operator&(SHALanesWord a, SHALanesWord b) { return SHALanesWord{_mm_and_si128(a.v, b.v)}; }
+        friend SHALanesWord operator|(SHALanesWord a, SHALanesWord b) { return SHALanesWord{_mm_or_si128(a.v, b.v)}; }
+        friend SHALanesWord operator^(SHALanesWord a, SHALanesWord b) { return SHALanesWord{_mm_xor_si128(a.v, b.v)}; }
+        //! @endcond
+#elif defined(TS_SHA_NEON)
+        uint32x4_t v;                       //!< Word value.
+        //! @cond nodoxygen
+        static SHALanesWord Set(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3) { const uint32_t x[4] = {x0, x1, x2, x3}; return SHALanesWord{vld1q_u32(x)}; }
+        static SHALanesWord Dup(uint32_t x) { return SHALanesWord{vdupq_n_u32(x)}; }
+        static void Store(uint32_t* p, SHALanesWord w) { vst1q_u32(p, w.v); }
+        template <int N> static SHALanesWord Shr(SHALanesWord w) { return SHALanesWord{vshrq_n_u32(w.v, N)}; }
+        template <int N> static SHALanesWord Rol(SHALanesWord w) { return SHALanesWord{vsriq_n_u32(vshlq_n_u32(w.v, N), w.v, 32 - N)}; }
+        friend SHALanesWord operator+(SHALanesWord a, SHALanesWord b) { return SHALanesWord{vaddq_u32(a.v, b.v)}; }
+        friend SHALanesWord operator&(SHALanesWord a, SHALanesWord b) { return SHALanesWord{vandq_u32(a.v, b.v)}; }
+        friend SHALanesWord operator|(SHALanesWord a, SHALanesWord b) { return SHALanesWord{vorrq_u32(a.v, b.v)}; }
+        friend SHALanesWord operator^(SHALanesWord a, SHALanesWord b) { return SHALanesWord{veorq_u32(a.v, b.v)}; }
+        //! @endcond
+#else
+        uint32_t v[LANES];                  //!< Word value.
+        //! @cond nodoxygen
+        static SHALanesWord Set(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3) { return SHALanesWord{{x0, x1, x2, x3}}; }
+        static SHALanesWord Dup(uint32_t x) { return SHALanesWord{{x, x, x, x}}; }
+        static void Store(uint32_t* p, SHALanesWord w) { for (size_t i = 0; i < LANES; ++i) { p[i] = w.v[i]; } }
+        template <int N> static SHALanesWord Shr(SHALanesWord w) { return Map(w, [](uint32_t x) { return x >> N; }); }
+        template <int N> static SHALanesWord Rol(SHALanesWord w) { return Map(w, [](uint32_t x) { return (x << N) | (x >> (32 - N)); }); }
+        friend SHALanesWord operator+(SHALanesWord a, SHALanesWord b) { return Map(a, b, [](uint32_t x, uint32_t y) { return x + y; }); }
+        friend SHALanesWord operator&(SHALanesWord a, SHALanesWord b) { return Map(a, b, [](uint32_t x, uint32_t y) { return x & y; }); }
+        friend SHALanesWord operator|(SHALanesWord a, SHALanesWord b) { return Map(a, b, [](uint32_t x, uint32_t y) { return x | y; }); }
+        friend SHALanesWord operator^(SHALanesWord a, SHALanesWord b) { return Map(a, b, [](uint32_t x, uint32_t y) { return x ^ y; }); }
+        template <class F> static SHALanesWord Map(SHALanesWord a, F f) { for (size_t i = 0; i < LANES; ++i) { a.v[i] = f(a.v[i]); } return a; }
+        template <class F> static SHALanesWord Map(SHALanesWord a, SHALanesWord b, F f) { for (size_t i = 0; i < LANES; ++i) { a.v[i] = f(a.v[i], b.v[i]); } return a; }
+        //! @endcond
+#endif
+        //!
+        //! Load one big-endian 32-bit word from each lane.
+        //! @param [in] blocks Addresses of the data blocks, one per lane.
+        //! @param [in] offset Offset of the word in each block.
+        //! @return The vector of words.
+        //!
+        static SHALanesWord Load(const uint8_t* const blocks[], size_t offset)
+        {
+            return Set(GetUInt32(blocks[0] + offset), GetUInt32(blocks[1] + offset), GetUInt32(blocks[2] + offset), GetUInt32(blocks[3] + offset));
+        }
+        //!
+        //! Load the same word of the hash states of all lanes.
+        //! @param [in] states Addresses of the hash states, one per lane.
+        //! @param [in] index Index of the word in each state.
+        //! @return The vector of words.
+        //!
+        static SHALanesWord Gather(const uint32_t* const states[], size_t index)
+        {
+            return Set(states[0][index], states[1][index], states[2][index], states[3][index]);
+        }
+        //!
+        //! Add a vector of words to the same word of the hash states of all lanes.
+        //! @param [in,out] states Addresses of the hash states, one per lane.
+        //! @param [in] index Index of the word in each state.
+        //! @param [in] w The vector of words to add.
+        //!
+        static void AddTo(uint32_t* const states[], size_t index, SHALanesWord w)
+        {
+            uint32_t x[LANES];
+            Store(x, w);
+            for (size_t i = 0; i < LANES; ++i) {
+                states[i][index] += x[i];
+            }
+        }
+    };
+
+    //!
+    //! Compute the hashes of independent messages using parallel lanes.
+    //! Groups of @a lanes messages are processed in parallel for the number of blocks they
+    //! have in common. The rest of each message is processed alone.
+    //! @param [in] init Initial hash state.
+    //! @param [in] words Number of 32-bit words in the hash state and in the resulting hash.
+    //! @param [in] compress Compression function on consecutive blocks of one message.
+    //! @param [in] compress_lanes Compression function on parallel lanes.
+    //! @param [in] lanes Number of lanes in @a compress_lanes, at most SHA_MAX_LANES.
+    //! @param [in] data Array of @a count addresses of messages.
+    //! @param [in] sizes Array of @a count sizes in bytes of messages.
+    //! @param [in] count Number of messages.
+    //! @param [out] hashes Address of the returned hashes, @a count hashes of 4 * @a words bytes each.
+    //!
+    void SHAMultiBuffer(const uint32_t* init,
+                        size_t words,
+                        SHAAcceleratedEngine::Function compress,
+                        SHAAcceleratedEngine::LanesFunction compress_lanes,
+                        size_t lanes,
+                        const void* const data[],
+                        const size_t sizes[],
+                        size_t count,
+                        uint8_t* hashes);
+}
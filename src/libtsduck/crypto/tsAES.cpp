@@ -14,6 +14,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsAES.h"
+#include "tsAESAccelerated.h"
 #include "tsRotate.h"
 
 #define BYTE(x,n) (((x) >> (8 * (n))) & 255)
@@ -1012,6 +1013,16 @@ namespace {
 }
 
 
+//----------------------------------------------------------------------------
+// Check if hardware acceleration is available.
+//----------------------------------------------------------------------------
+
+bool ts::AES::IsAccelerated()
+{
+    return AESEngineSelector::Get() != nullptr;
+}
+
+
 //----------------------------------------------------------------------------
 // Schedule a new key. If rounds is zero, the default is used.
 //----------------------------------------------------------------------------
@@ -1164,6 +1175,14 @@ bool ts::AES::setKeyImpl(const void* key_, size_t key_length, size_t rounds)
     *rk++ = *rrk++;
     *rk   = *rrk;
 
+    // Round keys as byte arrays, in standard order, for hardware implementations.
+    if (AESEngineSelector::Get() != nullptr) {
+        for (i = 0; i < 4 * (_Nr + 1); i++) {
+            PutUInt32(_eKb + 4 * i, _eK[i]);
+            PutUInt32(_dKb + 4 * i, _dK[i]);
+        }
+    }
+
     return true;
 }
 
@@ -1181,6 +1200,17 @@ bool ts::AES::encryptImpl(const void* plain, size_t plain_length, void* cipher,
     const uint8_t* pt = reinterpret_cast<const uint8_t*> (plain);
     uint8_t* ct = reinterpret_cast<uint8_t*> (cipher);
 
+    if (cipher_length != nullptr) {
+        *cipher_length = BLOCK_SIZE;
+    }
+
+    // Use hardware acceleration when available.
+    const AESAcceleratedEngine* engine = AESEngineSelector::Get();
+    if (engine != nullptr) {
+        engine->encrypt(_eKb, _Nr, pt, ct, 1);
+        return true;
+    }
+
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
@@ -1285,10 +1315,6 @@ bool ts::AES::encryptImpl(const void* plain, size_t plain_length, void* cipher,
         rk[3];
     PutUInt32 (ct+12, s3);
 
-    if (cipher_length != nullptr) {
-        *cipher_length = BLOCK_SIZE;
-    }
-
     return true;
 }
 
@@ -1306,6 +1332,17 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
+    if (plain_length != nullptr) {
+        *plain_length = BLOCK_SIZE;
+    }
+
+    // Use hardware acceleration when available.
+    const AESAcceleratedEngine* engine = AESEngineSelector::Get();
+    if (engine != nullptr) {
+        engine->decrypt(_dKb, _Nr, ct, pt, 1);
+        return true;
+    }
+
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
@@ -1411,11 +1448,44 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
         rk[3];
     PutUInt32 (pt+12, s3);
 
-    if (plain_length != nullptr) {
-        *plain_length = BLOCK_SIZE;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Encryption and decryption of several independent blocks.
+//----------------------------------------------------------------------------
+
+bool ts::AES::encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count)
+{
+    const AESAcceleratedEngine* engine = AESEngineSelector::Get();
+    if (engine != nullptr) {
+        engine->encrypt(_eKb, _Nr, plain, cipher, count);
+        return true;
+    }
+    else {
+        // The software implementation can encrypt in place.
+        for (size_t i = 0; i < count; ++i) {
+            encryptImpl(plain + i * BLOCK_SIZE, BLOCK_SIZE, cipher + i * BLOCK_SIZE, BLOCK_SIZE, nullptr);
+        }
+        return true;
     }
+}
 
-    return true;
+bool ts::AES::decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count)
+{
+    const AESAcceleratedEngine* engine = AESEngineSelector::Get();
+    if (engine != nullptr) {
+        engine->decrypt(_dKb, _Nr, cipher, plain, count);
+        return true;
+    }
+    else {
+        // The software implementation can decrypt in place.
+        for (size_t i = 0; i < count; ++i) {
+            decryptImpl(cipher + i * BLOCK_SIZE, BLOCK_SIZE, plain + i * BLOCK_SIZE, BLOCK_SIZE, nullptr);
+        }
+        return true;
+    }
 }
 
 
@@ -1426,7 +1496,9 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
 ts::AES::AES() :
     _Nr(0),
     _eK(),
-    _dK()
+    _dK(),
+    _eKb(),
+    _dKb()
 {
 }
 
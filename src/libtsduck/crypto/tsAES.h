@@ -62,15 +62,27 @@ namespace ts {
         virtual size_t maxRounds() const override;
         virtual size_t defaultRounds() const override;
 
+        //!
+        //! Check if AES is implemented using hardware instructions on this system.
+        //! When the CPU supports it, AES-NI (Intel) or the cryptographic extensions (Armv8)
+        //! are used. Otherwise, a portable software implementation is used.
+        //! @return True if AES is hardware-accelerated.
+        //!
+        static bool IsAccelerated();
+
     protected:
         // Implementation of BlockCipher interface:
         virtual bool setKeyImpl(const void* key, size_t key_length, size_t rounds) override;
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count) override;
+        virtual bool decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count) override;
 
     private:
-        int      _Nr;     //!< Number of rounds
-        uint32_t _eK[60]; //!< Scheduled encryption keys
-        uint32_t _dK[60]; //!< Scheduled decryption keys
+        int      _Nr;       //!< Number of rounds
+        uint32_t _eK[60];   //!< Scheduled encryption keys
+        uint32_t _dK[60];   //!< Scheduled decryption keys
+        uint8_t  _eKb[240]; //!< Scheduled encryption keys, as bytes, for hardware acceleration
+        uint8_t  _dKb[240]; //!< Scheduled decryption keys, as bytes, for hardware acceleration
     };
 }
@@ -185,3 +185,71 @@ bool ts::BlockCipher::decryptInPlaceImpl(void* data, size_t data_length, size_t*
     const size_t plain_max_size = max_actual_length != nullptr ? *max_actual_length : data_length;
     return decryptImpl(cipher.data(), cipher.size(), data, plain_max_size, max_actual_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt several independent blocks of data.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::encryptBlocks(const void* plain, void* cipher, size_t count)
+{
+    if (count > 0 && (plain == nullptr || cipher == nullptr)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowEncrypt()) {
+            return false;
+        }
+    }
+    return encryptBlocksImpl(reinterpret_cast<const uint8_t*>(plain), reinterpret_cast<uint8_t*>(cipher), count);
+}
+
+bool ts::BlockCipher::encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count)
+{
+    const size_t bsize = blockSize();
+    for (size_t i = 0; i < count; ++i) {
+        const bool ok = plain == cipher ?
+            encryptInPlaceImpl(cipher, bsize, nullptr) :
+            encryptImpl(plain, bsize, cipher, bsize, nullptr);
+        if (!ok) {
+            return false;
+        }
+        plain += bsize;
+        cipher += bsize;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt several independent blocks of data.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::decryptBlocks(const void* cipher, void* plain, size_t count)
+{
+    if (count > 0 && (cipher == nullptr || plain == nullptr)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowDecrypt()) {
+            return false;
+        }
+    }
+    return decryptBlocksImpl(reinterpret_cast<const uint8_t*>(cipher), reinterpret_cast<uint8_t*>(plain), count);
+}
+
+bool ts::BlockCipher::decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count)
+{
+    const size_t bsize = blockSize();
+    for (size_t i = 0; i < count; ++i) {
+        const bool ok = cipher == plain ?
+            decryptInPlaceImpl(plain, bsize, nullptr) :
+            decryptImpl(cipher, bsize, plain, bsize, nullptr);
+        if (!ok) {
+            return false;
+        }
+        cipher += bsize;
+        plain += bsize;
+    }
+    return true;
+}
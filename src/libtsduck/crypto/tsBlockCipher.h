@@ -189,6 +189,38 @@ namespace ts {
         //!
         bool decryptInPlace(void* data, size_t data_length, size_t* max_actual_length = nullptr);
 
+        //!
+        //! Encrypt several independent blocks of data.
+        //!
+        //! This is equivalent to calling encrypt() on each block of blockSize() bytes but
+        //! some implementations process several blocks in parallel. This is typically used
+        //! by cipher chainings such as ECB or CTR where blocks can be encrypted independently.
+        //! Each block counts as one encryption for the limitation of key usage.
+        //!
+        //! @param [in] plain Address of plain text, @a count blocks.
+        //! @param [out] cipher Address of buffer for cipher text, @a count blocks.
+        //! It can be the same as @a plain but the two areas shall not partially overlap.
+        //! @param [in] count Number of blocks of blockSize() bytes.
+        //! @return True on success, false on error.
+        //!
+        bool encryptBlocks(const void* plain, void* cipher, size_t count);
+
+        //!
+        //! Decrypt several independent blocks of data.
+        //!
+        //! This is equivalent to calling decrypt() on each block of blockSize() bytes but
+        //! some implementations process several blocks in parallel. This is typically used
+        //! by cipher chainings such as ECB or CBC where blocks can be decrypted independently.
+        //! Each block counts as one decryption for the limitation of key usage.
+        //!
+        //! @param [in] cipher Address of cipher text, @a count blocks.
+        //! @param [out] plain Address of buffer for plain text, @a count blocks.
+        //! It can be the same as @a cipher but the two areas shall not partially overlap.
+        //! @param [in] count Number of blocks of blockSize() bytes.
+        //! @return True on success, false on error.
+        //!
+        bool decryptBlocks(const void* cipher, void* plain, size_t count);
+
         //!
         //! Get the number of times the current key was used for encryption.
         //! @return The number of times the current key was used for encryption.
@@ -314,6 +346,44 @@ namespace ts {
         //!
         virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length);
 
+        //!
+        //! Encrypt several independent blocks of data (implementation of algorithm-specific part).
+        //! The default implementation is to call encryptImpl() or encryptInPlaceImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] plain Address of plain text, @a count blocks.
+        //! @param [out] cipher Address of buffer for cipher text, @a count blocks. Can be the same as @a plain.
+        //! @param [in] count Number of blocks of blockSize() bytes.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptBlocksImpl(const uint8_t* plain, uint8_t* cipher, size_t count);
+
+        //!
+        //! Decrypt several independent blocks of data (implementation of algorithm-specific part).
+        //! The default implementation is to call decryptImpl() or decryptInPlaceImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] cipher Address of cipher text, @a count blocks.
+        //! @param [out] plain Address of buffer for plain text, @a count blocks. Can be the same as @a cipher.
+        //! @param [in] count Number of blocks of blockSize() bytes.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptBlocksImpl(const uint8_t* cipher, uint8_t* plain, size_t count);
+
+        //!
+        //! Check if one encryption is allowed with the current key and count it.
+        //! This is automatically done by the public encryption methods. A subclass which
+        //! implements additional encryption methods shall call it for each encrypted message.
+        //! @return True if encryption is allowed, false otherwise.
+        //!
+        bool allowEncrypt();
+
+        //!
+        //! Check if one decryption is allowed with the current key and count it.
+        //! This is automatically done by the public decryption methods. A subclass which
+        //! implements additional decryption methods shall call it for each decrypted message.
+        //! @return True if decryption is allowed, false otherwise.
+        //!
+        bool allowDecrypt();
+
     private:
         bool      _key_set;                // Current key successfully set.
         int       _cipher_id;              // Cipher identity (from application).
@@ -323,9 +393,5 @@ namespace ts {
         size_t    _key_decrypt_max;        // Maximum number of times a key should be used for decryption.
         ByteBlock _current_key;            // Current unscheduled key.
         BlockCipherAlertInterface* _alert; // Alert handler.
-
-        // Check if encryption or decryption is allowed. Increment counters.
-        bool allowEncrypt();
-        bool allowDecrypt();
     };
 }
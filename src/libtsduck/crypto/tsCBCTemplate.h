@@ -102,14 +102,21 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
+    // Unlike encryption, the decryption of all blocks is independent and can be processed
+    // in parallel by the block cipher. The cipher text must be kept for the chaining.
+    ByteBlock saved;
+    if (pt == ct) {
+        saved.copy(ct, cipher_length);
+        ct = saved.data();
+    }
+    if (!this->algo->decryptBlocks(ct, pt, cipher_length / this->block_size)) {
+        return false;
+    }
+
     while (cipher_length > 0) {
-        // work = decrypt (cipher-text)
-        if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
-            return false;
-        }
-        // plain-text = previous-cipher XOR work
+        // plain-text = previous-cipher XOR decrypted
         for (size_t i = 0; i < this->block_size; ++i) {
-            pt[i] = previous[i] ^ this->work[i];
+            pt[i] ^= previous[i];
         }
         // previous-cipher = cipher-text
         previous = ct;
@@ -85,11 +85,14 @@ namespace ts {
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
 
     private:
+        // Number of counter blocks which are encrypted at a time.
+        static constexpr size_t BATCH_BLOCKS = 8;
+
         size_t _counter_bits; // size in bits of the counter part.
 
-        // We need two work blocks.
+        // We need 1 + BATCH_BLOCKS work blocks.
         // The first one contains the "input block" or counter.
-        // The second one contains the "output block", the encrypted counter.
+        // The next ones contain the "output blocks", the encrypted successive counters.
         // This private method increments the counter block.
         bool incrementCounter();
     };
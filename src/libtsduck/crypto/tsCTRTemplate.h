@@ -30,6 +30,11 @@
 #pragma once
 #include "tsMemory.h"
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+template<class CIPHER>
+constexpr size_t ts::CTR<CIPHER>::BATCH_BLOCKS;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -37,7 +42,7 @@
 
 template<class CIPHER>
 ts::CTR<CIPHER>::CTR(size_t counter_bits) :
-    CipherChainingTemplate<CIPHER>(1, 1, 2),
+    CipherChainingTemplate<CIPHER>(1, 1, 1 + BATCH_BLOCKS),
     _counter_bits(0)
 {
     setCounterBits(counter_bits);
@@ -134,26 +139,34 @@ bool ts::CTR<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     ::memcpy(this->work.data(), this->iv.data(), this->block_size);
 
     // Loop on all blocks, including last truncated one.
+    // Several successive counters are encrypted at a time in the next work blocks.
 
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
+    uint8_t* const output = this->work.data() + this->block_size;
+    const size_t max_blocks = this->work.size() / this->block_size - 1;
 
     while (plain_length > 0) {
-        // work[1] = encrypt(work[0])
-        if (!this->algo->encrypt(this->work.data(), this->block_size, this->work.data() + this->block_size, this->block_size)) {
+        // Number of blocks in this batch, including last truncated one.
+        const size_t count = std::min(max_blocks, (plain_length + this->block_size - 1) / this->block_size);
+        // work[1..count] = successive values of work[0]
+        for (size_t i = 0; i < count; ++i) {
+            ::memcpy(output + i * this->block_size, this->work.data(), this->block_size);
+            if (!incrementCounter()) {
+                return false;
+            }
+        }
+        // work[1..count] = encrypt(work[1..count])
+        if (!this->algo->encryptBlocks(output, output, count)) {
             return false;
         }
-        // This block size:
-        const size_t size = std::min(plain_length, this->block_size);
-        // cipher-text = plain-text XOR work[1]
+        // This batch size:
+        const size_t size = std::min(plain_length, count * this->block_size);
+        // cipher-text = plain-text XOR work[1..count]
         for (size_t i = 0; i < size; ++i) {
-            ct[i] = this->work[this->block_size + i] ^ pt[i];
-        }
-        // work[0] += 1
-        if (!incrementCounter()) {
-            return false;
+            ct[i] = output[i] ^ pt[i];
         }
-        // advance one block
+        // advance to next batch
         ct += size;
         pt += size;
         plain_length -= size;
@@ -66,6 +66,12 @@ namespace ts {
         //!
         virtual bool setIV(const void* iv_data, size_t iv_length);
 
+        //!
+        //! Get the current initialization vector.
+        //! @return A constant reference to the current initialization vector.
+        //!
+        const ByteBlock& getIV() const { return iv; }
+
         //!
         //! Get the minimum IV sizes in bytes.
         //! @return The minimum IV sizes in bytes.
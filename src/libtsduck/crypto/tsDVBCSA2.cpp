@@ -10,6 +10,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsDVBCSA2Bitslice.h"
+#include "tsSysInfo.h"
 
 // Operations on 64-bit areas.
 
@@ -28,6 +30,11 @@ TS_LLVM_NOWARNING(cast-align) // Because of casts to uint64_ptr
 
 #define MAX_NBLOCKS (184 / 8)
 
+// Minimum number of data blocks to use the batch engine. Smaller batches
+// are processed one by one using the scalar implementation.
+
+#define MIN_BATCH 8
+
 
 //----------------------------------------------------------------------------
 // Manually perform entropy reduction on a control word.
@@ -59,6 +66,8 @@ bool ts::DVBCSA2::IsReducedCW(const uint8_t *cw)
 ts::DVBCSA2::DVBCSA2(EntropyMode mode) :
     _init(false),
     _mode(mode),
+    _key(),
+    _kk(),
     _block(),
     _stream()
 {
@@ -336,6 +345,44 @@ void ts::DVBCSA2::StreamCipher::cipher(const uint8_t* sb, uint8_t *cb)
 // Block cipher
 //----------------------------------------------------------------------------
 
+// S-Box, shared with the batch implementations.
+
+const uint8_t ts::DVBCSA2BlockSBox[256] = {
+    0x3A, 0xEA, 0x68, 0xFE, 0x33, 0xE9, 0x88, 0x1A,
+    0x83, 0xCF, 0xE1, 0x7F, 0xBA, 0xE2, 0x38, 0x12,
+    0xE8, 0x27, 0x61, 0x95, 0x0C, 0x36, 0xE5, 0x70,
+    0xA2, 0x06, 0x82, 0x7C, 0x17, 0xA3, 0x26, 0x49,
+    0xBE, 0x7A, 0x6D, 0x47, 0xC1, 0x51, 0x8F, 0xF3,
+    0xCC, 0x5B, 0x67, 0xBD, 0xCD, 0x18, 0x08, 0xC9,
+    0xFF, 0x69, 0xEF, 0x03, 0x4E, 0x48, 0x4A, 0x84,
+    0x3F, 0xB4, 0x10, 0x04, 0xDC, 0xF5, 0x5C, 0xC6,
+    0x16, 0xAB, 0xAC, 0x4C, 0xF1, 0x6A, 0x2F, 0x3C,
+    0x3B, 0xD4, 0xD5, 0x94, 0xD0, 0xC4, 0x63, 0x62,
+    0x71, 0xA1, 0xF9, 0x4F, 0x2E, 0xAA, 0xC5, 0x56,
+    0xE3, 0x39, 0x93, 0xCE, 0x65, 0x64, 0xE4, 0x58,
+    0x6C, 0x19, 0x42, 0x79, 0xDD, 0xEE, 0x96, 0xF6,
+    0x8A, 0xEC, 0x1E, 0x85, 0x53, 0x45, 0xDE, 0xBB,
+    0x7E, 0x0A, 0x9A, 0x13, 0x2A, 0x9D, 0xC2, 0x5E,
+    0x5A, 0x1F, 0x32, 0x35, 0x9C, 0xA8, 0x73, 0x30,
+
+    0x29, 0x3D, 0xE7, 0x92, 0x87, 0x1B, 0x2B, 0x4B,
+    0xA5, 0x57, 0x97, 0x40, 0x15, 0xE6, 0xBC, 0x0E,
+    0xEB, 0xC3, 0x34, 0x2D, 0xB8, 0x44, 0x25, 0xA4,
+    0x1C, 0xC7, 0x23, 0xED, 0x90, 0x6E, 0x50, 0x00,
+    0x99, 0x9E, 0x4D, 0xD9, 0xDA, 0x8D, 0x6F, 0x5F,
+    0x3E, 0xD7, 0x21, 0x74, 0x86, 0xDF, 0x6B, 0x05,
+    0x8E, 0x5D, 0x37, 0x11, 0xD2, 0x28, 0x75, 0xD6,
+    0xA7, 0x77, 0x24, 0xBF, 0xF0, 0xB0, 0x02, 0xB7,
+    0xF8, 0xFC, 0x81, 0x09, 0xB1, 0x01, 0x76, 0x91,
+    0x7D, 0x0F, 0xC8, 0xA0, 0xF2, 0xCB, 0x78, 0x60,
+    0xD1, 0xF7, 0xE0, 0xB5, 0x98, 0x22, 0xB3, 0x20,
+    0x1D, 0xA6, 0xDB, 0x7B, 0x59, 0x9F, 0xAE, 0x31,
+    0xFB, 0xD3, 0xB6, 0xCA, 0x43, 0x72, 0x07, 0xF4,
+    0xD8, 0x41, 0x14, 0x55, 0x0D, 0x54, 0x8B, 0xB9,
+    0xAD, 0x46, 0x0B, 0xAF, 0x80, 0x52, 0x2C, 0xFA,
+    0x8C, 0x89, 0x66, 0xFD, 0xB2, 0xA9, 0x9B, 0xC0
+};
+
 namespace {
 
     // Key preparation
@@ -351,44 +398,6 @@ namespace {
         0x20, 0x3F, 0x2E, 0x0F, 0x03, 0x26, 0x10, 0x37
     };
 
-    // S-Box
-
-    const uint8_t block_sbox[256] = {
-        0x3A, 0xEA, 0x68, 0xFE, 0x33, 0xE9, 0x88, 0x1A,
-        0x83, 0xCF, 0xE1, 0x7F, 0xBA, 0xE2, 0x38, 0x12,
-        0xE8, 0x27, 0x61, 0x95, 0x0C, 0x36, 0xE5, 0x70,
-        0xA2, 0x06, 0x82, 0x7C, 0x17, 0xA3, 0x26, 0x49,
-        0xBE, 0x7A, 0x6D, 0x47, 0xC1, 0x51, 0x8F, 0xF3,
-        0xCC, 0x5B, 0x67, 0xBD, 0xCD, 0x18, 0x08, 0xC9,
-        0xFF, 0x69, 0xEF, 0x03, 0x4E, 0x48, 0x4A, 0x84,
-        0x3F, 0xB4, 0x10, 0x04, 0xDC, 0xF5, 0x5C, 0xC6,
-        0x16, 0xAB, 0xAC, 0x4C, 0xF1, 0x6A, 0x2F, 0x3C,
-        0x3B, 0xD4, 0xD5, 0x94, 0xD0, 0xC4, 0x63, 0x62,
-        0x71, 0xA1, 0xF9, 0x4F, 0x2E, 0xAA, 0xC5, 0x56,
-        0xE3, 0x39, 0x93, 0xCE, 0x65, 0x64, 0xE4, 0x58,
-        0x6C, 0x19, 0x42, 0x79, 0xDD, 0xEE, 0x96, 0xF6,
-        0x8A, 0xEC, 0x1E, 0x85, 0x53, 0x45, 0xDE, 0xBB,
-        0x7E, 0x0A, 0x9A, 0x13, 0x2A, 0x9D, 0xC2, 0x5E,
-        0x5A, 0x1F, 0x32, 0x35, 0x9C, 0xA8, 0x73, 0x30,
-
-        0x29, 0x3D, 0xE7, 0x92, 0x87, 0x1B, 0x2B, 0x4B,
-        0xA5, 0x57, 0x97, 0x40, 0x15, 0xE6, 0xBC, 0x0E,
-        0xEB, 0xC3, 0x34, 0x2D, 0xB8, 0x44, 0x25, 0xA4,
-        0x1C, 0xC7, 0x23, 0xED, 0x90, 0x6E, 0x50, 0x00,
-        0x99, 0x9E, 0x4D, 0xD9, 0xDA, 0x8D, 0x6F, 0x5F,
-        0x3E, 0xD7, 0x21, 0x74, 0x86, 0xDF, 0x6B, 0x05,
-        0x8E, 0x5D, 0x37, 0x11, 0xD2, 0x28, 0x75, 0xD6,
-        0xA7, 0x77, 0x24, 0xBF, 0xF0, 0xB0, 0x02, 0xB7,
-        0xF8, 0xFC, 0x81, 0x09, 0xB1, 0x01, 0x76, 0x91,
-        0x7D, 0x0F, 0xC8, 0xA0, 0xF2, 0xCB, 0x78, 0x60,
-        0xD1, 0xF7, 0xE0, 0xB5, 0x98, 0x22, 0xB3, 0x20,
-        0x1D, 0xA6, 0xDB, 0x7B, 0x59, 0x9F, 0xAE, 0x31,
-        0xFB, 0xD3, 0xB6, 0xCA, 0x43, 0x72, 0x07, 0xF4,
-        0xD8, 0x41, 0x14, 0x55, 0x0D, 0x54, 0x8B, 0xB9,
-        0xAD, 0x46, 0x0B, 0xAF, 0x80, 0x52, 0x2C, 0xFA,
-        0x8C, 0x89, 0x66, 0xFD, 0xB2, 0xA9, 0x9B, 0xC0
-    };
-
     // Permutations
 
     const int block_perm[256] = {
@@ -475,6 +484,15 @@ void ts::DVBCSA2::BlockCipher::init(const uint8_t *key)
 }
 
 
+void ts::DVBCSA2::BlockCipher::getScheduledKeys(uint8_t *kk) const
+{
+    // kk[0]..kk[55] = _kk[1].._kk[56], in the order of encryption.
+    for (size_t i = 0; i < 56; i++) {
+        kk[i] = uint8_t(_kk[i+1]);
+    }
+}
+
+
 void ts::DVBCSA2::BlockCipher::decipher(const uint8_t *ib, uint8_t *bd)
 {
     int i;
@@ -496,7 +514,7 @@ void ts::DVBCSA2::BlockCipher::decipher(const uint8_t *ib, uint8_t *bd)
     // loop over kk[56]..kk[1]
     for (i = 56; i > 0; i--) {
         sbox_in  = _kk[i] ^ R[7];
-        sbox_out = block_sbox[sbox_in];
+        sbox_out = DVBCSA2BlockSBox[sbox_in];
         perm_out = block_perm[sbox_out];
         next_R8 = R[7];
         R[7] = R[6] ^ perm_out;
@@ -541,7 +559,7 @@ void ts::DVBCSA2::BlockCipher::encipher (const uint8_t *bd, uint8_t *ib)
     // loop over kk[1]..kk[56]
     for (i = 1; i <= 56; i++) {
         sbox_in  = _kk[i] ^ R[8];
-        sbox_out = block_sbox[sbox_in];
+        sbox_out = DVBCSA2BlockSBox[sbox_in];
         perm_out = block_perm[sbox_out];
         next_R1 = R[2];
         R[2] = R[3] ^ R[1];
@@ -584,6 +602,7 @@ bool ts::DVBCSA2::setKeyImpl(const void* key, size_t key_length, size_t rounds)
 
     // Block cipher key schedule
     _block.init(_key);
+    _block.getScheduledKeys(_kk);
 
     // Stream cipher initialization
     _stream.init(_key);
@@ -718,6 +737,118 @@ bool ts::DVBCSA2::decryptInPlaceImpl(void* addr, size_t size, size_t* max_actual
 }
 
 
+//----------------------------------------------------------------------------
+// Select the batch engine, once, depending on the CPU.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    typedef ts::DVBCSA2Bitslice<ts::DVBCSA2Word64> Bitslice64;
+    const ts::DVBCSA2BatchEngine Engine64 = {u"64-bit", Bitslice64::LANES, Bitslice64::Encrypt, Bitslice64::Decrypt};
+
+#if defined(TS_DVBCSA2_SSE2)
+    typedef ts::DVBCSA2Bitslice<ts::DVBCSA2WordSSE2> BitsliceSSE2;
+    const ts::DVBCSA2BatchEngine EngineSSE2 = {u"SSE2", BitsliceSSE2::LANES, BitsliceSSE2::Encrypt, BitsliceSSE2::Decrypt};
+#endif
+
+#if defined(TS_DVBCSA2_NEON)
+    typedef ts::DVBCSA2Bitslice<ts::DVBCSA2WordNEON> BitsliceNEON;
+    const ts::DVBCSA2BatchEngine EngineNEON = {u"NEON", BitsliceNEON::LANES, BitsliceNEON::Encrypt, BitsliceNEON::Decrypt};
+#endif
+
+    const ts::DVBCSA2BatchEngine* SelectBatchEngine()
+    {
+        const ts::SysInfo& sys(*ts::SysInfo::Instance());
+        const ts::DVBCSA2BatchEngine* avx2 = ts::DVBCSA2EngineAVX2();
+        if (avx2 != nullptr && sys.avx2Instructions()) {
+            return avx2;
+        }
+#if defined(TS_DVBCSA2_SSE2)
+        if (sys.sse2Instructions()) {
+            return &EngineSSE2;
+        }
+#endif
+#if defined(TS_DVBCSA2_NEON)
+        if (sys.neonInstructions()) {
+            return &EngineNEON;
+        }
+#endif
+        return &Engine64;
+    }
+
+    const ts::DVBCSA2BatchEngine& BatchEngine()
+    {
+        static const ts::DVBCSA2BatchEngine* const engine = SelectBatchEngine();
+        return *engine;
+    }
+}
+
+size_t ts::DVBCSA2::BatchSize()
+{
+    return BatchEngine().lanes;
+}
+
+ts::UString ts::DVBCSA2::BatchEngineName()
+{
+    return BatchEngine().name;
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt several data blocks with the current control word.
+//----------------------------------------------------------------------------
+
+bool ts::DVBCSA2::encryptInPlaceBatch(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    return processBatch(true, data, sizes, count);
+}
+
+bool ts::DVBCSA2::decryptInPlaceBatch(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    return processBatch(false, data, sizes, count);
+}
+
+bool ts::DVBCSA2::processBatch(bool encrypt, uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    // Filter invalid parameters.
+    if (!_init || (count > 0 && (data == nullptr || sizes == nullptr))) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if ((data[i] == nullptr && sizes[i] > 0) || sizes[i] / 8 > MAX_NBLOCKS) {
+            return false;
+        }
+    }
+
+    // Each data block is one encryption or decryption for the key usage limitations.
+    for (size_t i = 0; i < count; i++) {
+        if (!(encrypt ? allowEncrypt() : allowDecrypt())) {
+            return false;
+        }
+    }
+
+    // Split into batches of the engine size. Process small remainders one by one.
+    const DVBCSA2BatchEngine& engine(BatchEngine());
+    for (size_t first = 0; first < count; first += engine.lanes) {
+        const size_t n = std::min(count - first, engine.lanes);
+        if (n >= MIN_BATCH) {
+            (encrypt ? engine.encrypt : engine.decrypt)(_key, _kk, data + first, sizes + first, n);
+        }
+        else {
+            for (size_t i = first; i < first + n; i++) {
+                if (encrypt) {
+                    DVBCSA2::encryptInPlaceImpl(data[i], sizes[i], nullptr);
+                }
+                else {
+                    DVBCSA2::decryptInPlaceImpl(data[i], sizes[i], nullptr);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Wrappers for encrypt and decrypt.
 //----------------------------------------------------------------------------
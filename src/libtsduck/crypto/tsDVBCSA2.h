@@ -88,6 +88,47 @@ namespace ts {
         //!
         static bool IsReducedCW(const uint8_t *cw);
 
+        //!
+        //! Encrypt several data blocks in place with the current control word.
+        //! Typically, the data blocks are the payloads of TS packets. The data blocks are
+        //! processed in parallel by a bitsliced implementation of DVB-CSA2, using the SIMD
+        //! instructions of the CPU when available. The result is identical to calling
+        //! encryptInPlace() on each data block, but faster when many data blocks are encrypted.
+        //! @param [in] data Array of @a count addresses of data blocks to encrypt in place.
+        //! @param [in] sizes Array of @a count sizes of the data blocks in bytes, at most 184 bytes each.
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error.
+        //!
+        bool encryptInPlaceBatch(uint8_t* const data[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt several data blocks in place with the current control word.
+        //! Typically, the data blocks are the payloads of TS packets. The data blocks are
+        //! processed in parallel by a bitsliced implementation of DVB-CSA2, using the SIMD
+        //! instructions of the CPU when available. The result is identical to calling
+        //! decryptInPlace() on each data block, but faster when many data blocks are decrypted.
+        //! @param [in] data Array of @a count addresses of data blocks to decrypt in place.
+        //! @param [in] sizes Array of @a count sizes of the data blocks in bytes, at most 184 bytes each.
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error.
+        //!
+        bool decryptInPlaceBatch(uint8_t* const data[], const size_t sizes[], size_t count);
+
+        //!
+        //! Get the number of data blocks which are processed in parallel by the batch operations.
+        //! Using batches of multiples of this size gives the best performances.
+        //! @return The number of data blocks in a batch.
+        //! @see encryptInPlaceBatch()
+        //! @see decryptInPlaceBatch()
+        //!
+        static size_t BatchSize();
+
+        //!
+        //! Get the name of the implementation of the batch operations on this system.
+        //! @return The name of the implementation, for instance "AVX2".
+        //!
+        static UString BatchEngineName();
+
         // Implementation of CipherChaining interface. Cannot set IV with DVB CSA.
         virtual bool setIV(const void*, size_t) override;
         virtual size_t minIVSize() const override;
@@ -121,6 +162,7 @@ namespace ts {
             int _kk[57]; // 56..1: scheduled keys, index 0 unused
         public:
             void init(const uint8_t *cw);
+            void getScheduledKeys(uint8_t *kk) const;
             void encipher(const uint8_t *bd, uint8_t *ib);
             void decipher(const uint8_t *ib, uint8_t *bd);
         };
@@ -149,7 +191,11 @@ namespace ts {
         bool         _init;
         EntropyMode  _mode;
         uint8_t      _key[KEY_SIZE];
+        uint8_t      _kk[56];        // Scheduled keys of block cipher, for batch operations.
         BlockCipher  _block;
         StreamCipher _stream;
+
+        // Batch operation on a set of data blocks.
+        bool processBatch(bool encrypt, uint8_t* const data[], const size_t sizes[], size_t count);
     };
 }
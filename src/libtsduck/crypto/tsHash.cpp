@@ -57,3 +57,23 @@ bool ts::Hash::hash(const void* data, size_t data_size, ByteBlock& result)
     result.resize(ok ? retsize : 0);
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Compute the hashes of several independent messages.
+//----------------------------------------------------------------------------
+
+bool ts::Hash::hashMultiple(const void* const data[], const size_t sizes[], size_t count, void* hashes, size_t hashes_maxsize)
+{
+    const size_t size = hashSize();
+    if (hashes_maxsize < count * size) {
+        return false;
+    }
+    uint8_t* out = static_cast<uint8_t*>(hashes);
+    for (size_t i = 0; i < count; ++i) {
+        if (!hash(data[i], sizes[i], out + i * size, size)) {
+            return false;
+        }
+    }
+    return true;
+}
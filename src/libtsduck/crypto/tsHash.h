@@ -110,6 +110,21 @@ namespace ts {
         //!
         bool hash(const void* data, size_t data_size, ByteBlock& hash);
 
+        //!
+        //! Compute the hashes of several independent messages in one operation.
+        //! Subclasses may process the messages in parallel lanes, which is faster than
+        //! hashing them one after the other. The default implementation hashes the
+        //! messages one after the other. The current computation, if any, is lost.
+        //! @param [in] data Array of @a count addresses of messages to hash.
+        //! @param [in] sizes Array of @a count sizes in bytes of messages to hash.
+        //! @param [in] count Number of messages.
+        //! @param [out] hashes Address of returned hashes buffer. The @a count hashes are
+        //! returned one after the other, hashSize() bytes each.
+        //! @param [in] hashes_maxsize Size in bytes of hashes buffer.
+        //! @return True on success, false on error.
+        //!
+        virtual bool hashMultiple(const void* const data[], const size_t sizes[], size_t count, void* hashes, size_t hashes_maxsize);
+
         //!
         //! Virtual destructor.
         //!
@@ -14,6 +14,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsSHA1.h"
+#include "tsSHAAccelerated.h"
+#include "tsSHAMultiBuffer.h"
 #include "tsMemory.h"
 #include "tsRotate.h"
 
@@ -22,6 +24,24 @@
 #define F2(x,y,z)  ((x & y) | (z & (x | y)))
 #define F3(x,y,z)  (x ^ y ^ z)
 
+namespace {
+    // Initial hash value.
+    const uint32_t InitState[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    // Number of messages which are processed in parallel by the software multi-buffer implementation.
+    constexpr size_t SOFT_LANES = 4;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if hardware acceleration is available.
+//----------------------------------------------------------------------------
+
+bool ts::SHA1::IsAccelerated()
+{
+    return SHAEngineSelector::Get() != nullptr;
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -42,11 +62,7 @@ ts::SHA1::SHA1() :
 
 bool ts::SHA1::init()
 {
-    _state[0] = 0x67452301UL;
-    _state[1] = 0xEFCDAB89UL;
-    _state[2] = 0x98BADCFEUL;
-    _state[3] = 0x10325476UL;
-    _state[4] = 0xC3D2E1F0UL;
+    ::memcpy(_state, InitState, sizeof(_state));
     _curlen = 0;
     _length = 0;
     return true;
@@ -57,7 +73,25 @@ bool ts::SHA1::init()
 // Compress part of message
 //----------------------------------------------------------------------------
 
-void ts::SHA1::compress(const uint8_t* buf)
+void ts::SHA1::compress(const uint8_t* data, size_t count)
+{
+    const SHAAcceleratedEngine* engine = SHAEngineSelector::Get();
+    if (engine != nullptr) {
+        engine->sha1(_state, data, count);
+    }
+    else {
+        CompressBlocks(_state, data, count);
+    }
+}
+
+void ts::SHA1::CompressBlocks(uint32_t* state, const uint8_t* data, size_t count)
+{
+    for (; count > 0; --count, data += BLOCK_SIZE) {
+        CompressBlock(state, data);
+    }
+}
+
+void ts::SHA1::CompressBlock(uint32_t* state, const uint8_t* buf)
 {
     uint32_t a,b,c,d,e,W[80],i;
 
@@ -67,11 +101,11 @@ void ts::SHA1::compress(const uint8_t* buf)
     }
 
     // Copy state
-    a = _state[0];
-    b = _state[1];
-    c = _state[2];
-    d = _state[3];
-    e = _state[4];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
 
     // Expand it
     for (i = 16; i < 80; i++) {
@@ -126,11 +160,51 @@ void ts::SHA1::compress(const uint8_t* buf)
     #undef FF3
 
     // Store
-    _state[0] += a;
-    _state[1] += b;
-    _state[2] += c;
-    _state[3] += d;
-    _state[4] += e;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+
+//----------------------------------------------------------------------------
+// Compress one block of several messages in parallel lanes.
+// Each 32-bit variable of the algorithm is a vector with one word per lane.
+//----------------------------------------------------------------------------
+
+void ts::SHA1::CompressLanes(uint32_t* const states[], const uint8_t* const blocks[])
+{
+    static_assert(SOFT_LANES == SHALanesWord::LANES, "invalid number of software lanes");
+    typedef SHALanesWord LW;
+    static const uint32_t K[4] = {0x5a827999UL, 0x6ed9eba1UL, 0x8f1bbcdcUL, 0xca62c1d6UL};
+
+    // Message schedule, on a circular buffer of 16 words.
+    LW W[16];
+    LW S[5];
+
+    for (size_t k = 0; k < 5; k++) {
+        S[k] = LW::Gather(states, k);
+    }
+    for (size_t i = 0; i < 80; i++) {
+        LW& w(W[i % 16]);
+        if (i < 16) {
+            w = LW::Load(blocks, 4 * i);
+        }
+        else {
+            w = LW::Rol<1>(W[(i - 3) % 16] ^ W[(i - 8) % 16] ^ W[(i - 14) % 16] ^ w);
+        }
+        const LW f = i < 20 ? F0(S[1],S[2],S[3]) : (i < 40 ? F1(S[1],S[2],S[3]) : (i < 60 ? F2(S[1],S[2],S[3]) : F3(S[1],S[2],S[3])));
+        const LW t = LW::Rol<5>(S[0]) + f + S[4] + w + LW::Dup(K[i / 20]);
+        S[4] = S[3];
+        S[3] = S[2];
+        S[2] = LW::Rol<30>(S[1]);
+        S[1] = S[0];
+        S[0] = t;
+    }
+    for (size_t k = 0; k < 5; k++) {
+        LW::AddTo(states, k, S[k]);
+    }
 }
 
 
@@ -149,10 +223,11 @@ bool ts::SHA1::add(const void* data, size_t size)
     }
     while (size > 0) {
         if (_curlen == 0 && size >= BLOCK_SIZE) {
-            compress (in);
-            _length += BLOCK_SIZE * 8;
-            in += BLOCK_SIZE;
-            size -= BLOCK_SIZE;
+            n = size / BLOCK_SIZE;
+            compress(in, n);
+            _length += n * BLOCK_SIZE * 8;
+            in += n * BLOCK_SIZE;
+            size -= n * BLOCK_SIZE;
         }
         else {
             n = std::min(size, (BLOCK_SIZE - _curlen));
@@ -161,7 +236,7 @@ bool ts::SHA1::add(const void* data, size_t size)
             in += n;
             size -= n;
             if (_curlen == BLOCK_SIZE) {
-                compress (_buf);
+                compress(_buf, 1);
                 _length += 8 * BLOCK_SIZE;
                 _curlen = 0;
             }
@@ -197,7 +272,7 @@ bool ts::SHA1::getHash (void* hash, size_t bufsize, size_t* retsize)
         while (_curlen < 64) {
             _buf[_curlen++] = 0;
         }
-        compress (_buf);
+        compress(_buf, 1);
         _curlen = 0;
     }
 
@@ -208,7 +283,7 @@ bool ts::SHA1::getHash (void* hash, size_t bufsize, size_t* retsize)
 
     /* store length */
     PutUInt64 (_buf + 56, _length);
-    compress (_buf);
+    compress(_buf, 1);
 
     /* copy output */
     uint8_t* out = reinterpret_cast<uint8_t*> (hash);
@@ -223,6 +298,26 @@ bool ts::SHA1::getHash (void* hash, size_t bufsize, size_t* retsize)
 }
 
 
+//----------------------------------------------------------------------------
+// Compute the hashes of several independent messages.
+//----------------------------------------------------------------------------
+
+bool ts::SHA1::hashMultiple(const void* const data[], const size_t sizes[], size_t count, void* hashes, size_t hashes_maxsize)
+{
+    if (hashes_maxsize < count * HASH_SIZE) {
+        return false;
+    }
+    const SHAAcceleratedEngine* engine = SHAEngineSelector::Get();
+    if (engine != nullptr) {
+        SHAMultiBuffer(InitState, 5, engine->sha1, engine->sha1Lanes, engine->lanes, data, sizes, count, static_cast<uint8_t*>(hashes));
+    }
+    else {
+        SHAMultiBuffer(InitState, 5, CompressBlocks, CompressLanes, SOFT_LANES, data, sizes, count, static_cast<uint8_t*>(hashes));
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of Hash interface:
 //----------------------------------------------------------------------------
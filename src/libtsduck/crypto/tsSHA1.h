@@ -54,12 +54,24 @@ namespace ts {
         virtual bool init() override;
         virtual bool add(const void* data, size_t size) override;
         virtual bool getHash(void* hash, size_t bufsize, size_t* retsize = nullptr) override;
+        virtual bool hashMultiple(const void* const data[], const size_t sizes[], size_t count, void* hashes, size_t hashes_maxsize) override;
 
         //! Constructor
         SHA1();
 
+        //!
+        //! Check if SHA-1 is implemented using hardware instructions on this system.
+        //! When the CPU supports it, the SHA extensions (Intel) or the cryptographic extensions (Armv8)
+        //! are used. Otherwise, a portable software implementation is used.
+        //! @return True if SHA-1 is hardware-accelerated.
+        //!
+        static bool IsAccelerated();
+
     private:
-        void compress(const uint8_t* buf);
+        void compress(const uint8_t* data, size_t count);
+        static void CompressBlock(uint32_t* state, const uint8_t* buf);
+        static void CompressBlocks(uint32_t* state, const uint8_t* data, size_t count);
+        static void CompressLanes(uint32_t* const states[], const uint8_t* const blocks[]);
         uint64_t _length;
         uint32_t _state[HASH_SIZE / 4];
         size_t   _curlen;
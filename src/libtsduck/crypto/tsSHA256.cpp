@@ -14,6 +14,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsSHA256.h"
+#include "tsSHAAccelerated.h"
+#include "tsSHAMultiBuffer.h"
 #include "tsMemory.h"
 #include "tsRotate.h"
 
@@ -26,6 +28,37 @@
 #define Gamma0(x)  (S(x, 7) ^ S(x, 18) ^ R(x, 3))
 #define Gamma1(x)  (S(x, 17) ^ S(x, 19) ^ R(x, 10))
 
+const uint32_t ts::SHA256RoundConstants[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+namespace {
+    // Initial hash value.
+    const uint32_t InitState[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+    };
+
+    // Number of messages which are processed in parallel by the software multi-buffer implementation.
+    constexpr size_t SOFT_LANES = 4;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if hardware acceleration is available.
+//----------------------------------------------------------------------------
+
+bool ts::SHA256::IsAccelerated()
+{
+    return SHAEngineSelector::Get() != nullptr;
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -48,14 +81,7 @@ bool ts::SHA256::init()
 {
     _curlen = 0;
     _length = 0;
-    _state[0] = 0x6A09E667UL;
-    _state[1] = 0xBB67AE85UL;
-    _state[2] = 0x3C6EF372UL;
-    _state[3] = 0xA54FF53AUL;
-    _state[4] = 0x510E527FUL;
-    _state[5] = 0x9B05688CUL;
-    _state[6] = 0x1F83D9ABUL;
-    _state[7] = 0x5BE0CD19UL;
+    ::memcpy(_state, InitState, sizeof(_state));
     return true;
 }
 
@@ -64,13 +90,31 @@ bool ts::SHA256::init()
 // Compress part of message
 //----------------------------------------------------------------------------
 
-void ts::SHA256::compress (const uint8_t* buf)
+void ts::SHA256::compress(const uint8_t* data, size_t count)
+{
+    const SHAAcceleratedEngine* engine = SHAEngineSelector::Get();
+    if (engine != nullptr) {
+        engine->sha256(_state, data, count);
+    }
+    else {
+        CompressBlocks(_state, data, count);
+    }
+}
+
+void ts::SHA256::CompressBlocks(uint32_t* state, const uint8_t* data, size_t count)
+{
+    for (; count > 0; --count, data += BLOCK_SIZE) {
+        CompressBlock(state, data);
+    }
+}
+
+void ts::SHA256::CompressBlock(uint32_t* state, const uint8_t* buf)
 {
     uint32_t S[8], W[64], t0, t1;
 
     /* copy state into S */
     for (size_t i = 0; i < 8; i++) {
-        S[i] = _state[i];
+        S[i] = state[i];
     }
 
     /* copy the state into 512-bits into W[0..15] */
@@ -159,10 +203,72 @@ void ts::SHA256::compress (const uint8_t* buf)
 
     /* feedback */
     for (size_t i = 0; i < 8; i++) {
-        _state[i] = _state[i] + S[i];
+        state[i] = state[i] + S[i];
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compress one block of several messages in parallel lanes.
+// Each 32-bit variable of the algorithm is a vector with one word per lane.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Rotate right all words of a vector.
+    template <int N>
+    inline ts::SHALanesWord Ror(ts::SHALanesWord x)
+    {
+        return ts::SHALanesWord::Rol<32 - N>(x);
     }
 }
 
+void ts::SHA256::CompressLanes(uint32_t* const states[], const uint8_t* const blocks[])
+{
+    static_assert(SOFT_LANES == SHALanesWord::LANES, "invalid number of software lanes");
+    typedef SHALanesWord LW;
+
+    // Message schedule, on a circular buffer of 16 words.
+    LW W[16];
+    LW a(LW::Gather(states, 0));
+    LW b(LW::Gather(states, 1));
+    LW c(LW::Gather(states, 2));
+    LW d(LW::Gather(states, 3));
+    LW e(LW::Gather(states, 4));
+    LW f(LW::Gather(states, 5));
+    LW g(LW::Gather(states, 6));
+    LW h(LW::Gather(states, 7));
+
+    for (size_t i = 0; i < 64; i++) {
+        LW& w(W[i % 16]);
+        if (i < 16) {
+            w = LW::Load(blocks, 4 * i);
+        }
+        else {
+            const LW w2(W[(i - 2) % 16]);
+            const LW w15(W[(i - 15) % 16]);
+            w = (Ror<17>(w2) ^ Ror<19>(w2) ^ LW::Shr<10>(w2)) + W[(i - 7) % 16] + (Ror<7>(w15) ^ Ror<18>(w15) ^ LW::Shr<3>(w15)) + w;
+        }
+        const LW t0 = h + (Ror<6>(e) ^ Ror<11>(e) ^ Ror<25>(e)) + Ch(e, f, g) + LW::Dup(SHA256RoundConstants[i]) + w;
+        const LW t1 = (Ror<2>(a) ^ Ror<13>(a) ^ Ror<22>(a)) + Maj(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t0;
+        d = c;
+        c = b;
+        b = a;
+        a = t0 + t1;
+    }
+    LW::AddTo(states, 0, a);
+    LW::AddTo(states, 1, b);
+    LW::AddTo(states, 2, c);
+    LW::AddTo(states, 3, d);
+    LW::AddTo(states, 4, e);
+    LW::AddTo(states, 5, f);
+    LW::AddTo(states, 6, g);
+    LW::AddTo(states, 7, h);
+}
+
 
 //----------------------------------------------------------------------------
 // Add some part of the message to hash. Can be called several times.
@@ -179,10 +285,11 @@ bool ts::SHA256::add (const void* data, size_t size)
     }
     while (size > 0) {
         if (_curlen == 0 && size >= BLOCK_SIZE) {
-            compress (in);
-            _length += BLOCK_SIZE * 8;
-            in += BLOCK_SIZE;
-            size -= BLOCK_SIZE;
+            n = size / BLOCK_SIZE;
+            compress(in, n);
+            _length += n * BLOCK_SIZE * 8;
+            in += n * BLOCK_SIZE;
+            size -= n * BLOCK_SIZE;
         }
         else {
             n = std::min (size, (BLOCK_SIZE - _curlen));
@@ -191,7 +298,7 @@ bool ts::SHA256::add (const void* data, size_t size)
             in += n;
             size -= n;
             if (_curlen == BLOCK_SIZE) {
-                compress (_buf);
+                compress(_buf, 1);
                 _length += 8 * BLOCK_SIZE;
                 _curlen = 0;
             }
@@ -227,7 +334,7 @@ bool ts::SHA256::getHash (void* hash, size_t bufsize, size_t* retsize)
         while (_curlen < 64) {
             _buf[_curlen++] = 0;
         }
-        compress (_buf);
+        compress(_buf, 1);
         _curlen = 0;
     }
 
@@ -238,7 +345,7 @@ bool ts::SHA256::getHash (void* hash, size_t bufsize, size_t* retsize)
 
     /* store length */
     PutUInt64 (_buf + 56, _length);
-    compress (_buf);
+    compress(_buf, 1);
 
     /* copy output */
     uint8_t* out = reinterpret_cast<uint8_t*> (hash);
@@ -253,6 +360,26 @@ bool ts::SHA256::getHash (void* hash, size_t bufsize, size_t* retsize)
 }
 
 
+//----------------------------------------------------------------------------
+// Compute the hashes of several independent messages.
+//----------------------------------------------------------------------------
+
+bool ts::SHA256::hashMultiple(const void* const data[], const size_t sizes[], size_t count, void* hashes, size_t hashes_maxsize)
+{
+    if (hashes_maxsize < count * HASH_SIZE) {
+        return false;
+    }
+    const SHAAcceleratedEngine* engine = SHAEngineSelector::Get();
+    if (engine != nullptr) {
+        SHAMultiBuffer(InitState, 8, engine->sha256, engine->sha256Lanes, engine->lanes, data, sizes, count, static_cast<uint8_t*>(hashes));
+    }
+    else {
+        SHAMultiBuffer(InitState, 8, CompressBlocks, CompressLanes, SOFT_LANES, data, sizes, count, static_cast<uint8_t*>(hashes));
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of Hash interface:
 //----------------------------------------------------------------------------
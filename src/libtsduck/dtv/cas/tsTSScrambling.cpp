@@ -51,7 +51,10 @@ ts::TSScrambling::TSScrambling(Report& report, uint8_t scrambling) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_pkts(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(scrambling);
 }
@@ -71,11 +74,13 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_pkts(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(_scrambling_type);
-    _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
-    _dvbcsa[1].setEntropyMode(other._dvbcsa[1].entropyMode());
+    copyParameters(other);
 }
 
 ts::TSScrambling::TSScrambling(TSScrambling&& other) :
@@ -93,11 +98,28 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_pkts(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(_scrambling_type);
-    _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
-    _dvbcsa[1].setEntropyMode(other._dvbcsa[1].entropyMode());
+    copyParameters(other);
+}
+
+
+//----------------------------------------------------------------------------
+// Copy the configuration parameters of the scramblers, typically set once from the command line.
+//----------------------------------------------------------------------------
+
+void ts::TSScrambling::copyParameters(const TSScrambling& other)
+{
+    for (size_t i = 0; i < 2; ++i) {
+        _dvbcsa[i].setEntropyMode(other._dvbcsa[i].entropyMode());
+        _aescbc[i].setIV(other._aescbc[i].getIV().data(), other._aescbc[i].getIV().size());
+        _aesctr[i].setIV(other._aesctr[i].getIV().data(), other._aesctr[i].getIV().size());
+        _aesctr[i].setCounterBits(other._aesctr[i].counterBits());
+    }
 }
 
 
@@ -577,3 +599,153 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Add a packet in the current batch.
+//----------------------------------------------------------------------------
+
+void ts::TSScrambling::addToBatch(TSPacket* pkt)
+{
+    _batch_pkts.push_back(pkt);
+    _batch_data.push_back(pkt->getPayload());
+    _batch_sizes.push_back(pkt->getPayloadSize());
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt the current batch of packets with DVB-CSA2.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::flushBatch(bool encrypt, uint8_t scv)
+{
+    assert(_batch_pkts.size() == _batch_data.size());
+    assert(_batch_pkts.size() == _batch_sizes.size());
+
+    bool ok = true;
+    if (!_batch_pkts.empty()) {
+        DVBCSA2& algo(_dvbcsa[scv & 1]);
+        if (encrypt) {
+            ok = algo.encryptInPlaceBatch(_batch_data.data(), _batch_sizes.data(), _batch_data.size());
+        }
+        else {
+            ok = algo.decryptInPlaceBatch(_batch_data.data(), _batch_sizes.data(), _batch_data.size());
+        }
+        if (ok) {
+            for (auto pkt : _batch_pkts) {
+                pkt->setScrambling(encrypt ? scv : uint8_t(SC_CLEAR));
+            }
+        }
+        else {
+            _report.error(u"packet %s error using %s", {encrypt ? u"encryption" : u"decryption", algo.name()});
+        }
+    }
+    _batch_pkts.clear();
+    _batch_data.clear();
+    _batch_sizes.clear();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Encrypt a set of TS packets with the current parity and corresponding CW.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::encrypt(TSPacket* const pkts[], size_t count)
+{
+    bool ok = true;
+
+    // Only DVB-CSA2 has a batch implementation.
+    if (_scrambler[0] != &_dvbcsa[0]) {
+        for (size_t i = 0; i < count; ++i) {
+            if (pkts[i] != nullptr) {
+                ok = encrypt(*pkts[i]) && ok;
+            }
+        }
+        return ok;
+    }
+
+    // If no current parity is set, start with even by default.
+    if (_encrypt_scv == SC_CLEAR && !setEncryptParity(SC_EVEN_KEY)) {
+        return false;
+    }
+    assert(_encrypt_scv == SC_EVEN_KEY || _encrypt_scv == SC_ODD_KEY);
+
+    // Collect the payloads to encrypt. The residue is included in DVB-CSA2.
+    for (size_t i = 0; i < count; ++i) {
+        TSPacket* const pkt = pkts[i];
+        if (pkt == nullptr) {
+            continue;
+        }
+        else if (pkt->isScrambled()) {
+            _report.error(u"try to scramble an already scrambled packet");
+            ok = false;
+        }
+        else if (pkt->hasPayload()) {
+            addToBatch(pkt);
+        }
+    }
+    return flushBatch(true, _encrypt_scv) && ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt a set of TS packets with the CW corresponding to their parity.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::decrypt(TSPacket* const pkts[], size_t count)
+{
+    // Only DVB-CSA2 has a batch implementation.
+    if (_scrambler[0] != &_dvbcsa[0]) {
+        for (size_t i = 0; i < count; ++i) {
+            if (pkts[i] != nullptr && !decrypt(*pkts[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (hasFixedCW()) {
+        // With fixed control words, the key changes each time the scrambling control changes.
+        // Accumulate consecutive packets with the same parity.
+        for (size_t i = 0; i < count; ++i) {
+
+            // Clear or invalid packets are silently accepted.
+            TSPacket* const pkt = pkts[i];
+            const uint8_t scv = pkt == nullptr ? uint8_t(SC_CLEAR) : pkt->getScrambling();
+            if (scv != SC_EVEN_KEY && scv != SC_ODD_KEY) {
+                continue;
+            }
+
+            // When the scrambling control changes, process previous packets with the previous key.
+            if (scv != _decrypt_scv) {
+                if (!flushBatch(false, _decrypt_scv)) {
+                    return false;
+                }
+                _decrypt_scv = scv;
+                if (!setNextFixedCW(_decrypt_scv)) {
+                    return false;
+                }
+            }
+            addToBatch(pkt);
+        }
+        return flushBatch(false, _decrypt_scv);
+    }
+    else {
+        // The even and odd keys do not depend on the order of the packets.
+        // Process all even packets in one batch and all odd packets in another one.
+        for (uint8_t scv = SC_EVEN_KEY; scv <= SC_ODD_KEY; ++scv) {
+            for (size_t i = 0; i < count; ++i) {
+                TSPacket* const pkt = pkts[i];
+                if (pkt != nullptr && pkt->getScrambling() == scv) {
+                    addToBatch(pkt);
+                    _decrypt_scv = scv;
+                }
+            }
+            if (!flushBatch(false, scv)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
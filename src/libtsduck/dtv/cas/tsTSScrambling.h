@@ -206,6 +206,33 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Encrypt a set of TS packets with the current parity and corresponding CW.
+        //! This is equivalent to encrypt() on each packet but, with DVB-CSA2, all
+        //! packets are processed in one batch using the bitsliced implementation.
+        //! @param [in,out] pkts Array of addresses of the packets to encrypt, typically
+        //! collected from a TSPacketWindow. Null pointers are ignored.
+        //! @param [in] count Number of packet addresses in @a pkts.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //! All other packets are encrypted anyway.
+        //!
+        bool encrypt(TSPacket* const pkts[], size_t count);
+
+        //!
+        //! Decrypt a set of TS packets with the CW corresponding to the parity in each packet.
+        //! This is equivalent to decrypt() on each packet but, with DVB-CSA2, packets with
+        //! the same key are processed in batches using the bitsliced implementation. With
+        //! fixed control words, the key changes with the scrambling control of consecutive
+        //! packets and only runs of packets with the same parity are grouped. Otherwise,
+        //! all even packets and all odd packets are grouped in two batches.
+        //! @param [in,out] pkts Array of addresses of the packets to decrypt, typically
+        //! collected from a TSPacketWindow. Null pointers are ignored.
+        //! @param [in] count Number of packet addresses in @a pkts.
+        //! @return True on success, false on error. Clear packets are not an error.
+        //! On error, some packets may be left unmodified.
+        //!
+        bool decrypt(TSPacket* const pkts[], size_t count);
+
     private:
         // List of control words
         typedef std::list<ByteBlock> CWList;
@@ -225,10 +252,22 @@ namespace ts {
         CBC<AES>         _aescbc[2];
         CTR<AES>         _aesctr[2];
         CipherChaining*  _scrambler[2];
+        std::vector<TSPacket*> _batch_pkts;   // Batch processing: packets to process.
+        std::vector<uint8_t*>  _batch_data;   // Batch processing: payload addresses.
+        std::vector<size_t>    _batch_sizes;  // Batch processing: payload sizes.
+
+        // Add a packet in the current batch.
+        void addToBatch(TSPacket* pkt);
+
+        // Encrypt or decrypt the current batch of packets with DVB-CSA2 and the key of the specified parity.
+        bool flushBatch(bool encrypt, uint8_t scv);
 
         // Set the next fixed control word as scrambling key.
         bool setNextFixedCW(int parity);
 
+        // Copy the configuration parameters of the scramblers from another instance.
+        void copyParameters(const TSScrambling& other);
+
         // Implementation of BlockCipherAlertInterface.
         virtual bool handleBlockCipherAlert(BlockCipher& cipher, AlertReason reason) override;
 
@@ -118,7 +118,18 @@ void ts::DemuxedData::reload(const void* content, size_t content_size, PID sourc
 {
     _source_pid = source_pid;
     _first_pkt = _last_pkt = 0;
-    _data = new ByteBlock(content, content_size);
+
+    // Reuse the previous data buffer when it is not shared with another object and
+    // the new content is not inside it. This avoids a heap allocation when the same
+    // object is reloaded several times, as done by the section demux.
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(content);
+    ByteBlock* const bb = _data.pointer();
+    if (bb != nullptr && _data.count() == 1 && (bytes + content_size <= bb->data() || bytes >= bb->data() + bb->capacity())) {
+        bb->copy(content, content_size);
+    }
+    else {
+        _data = new ByteBlock(content, content_size);
+    }
 }
 
 void ts::DemuxedData::reload(const ByteBlock& content, PID source_pid)
@@ -136,7 +136,8 @@ void ts::SectionDemux::Status::display(Report& report, int level, const UString&
 // Analysis context for one TID/TIDext into one PID.
 //----------------------------------------------------------------------------
 
-ts::SectionDemux::ETIDContext::ETIDContext() :
+ts::SectionDemux::ETIDContext::ETIDContext(const ETID& id) :
+    etid(id),
     notified(false),
     version(0),
     sect_expected(0),
@@ -146,18 +147,19 @@ ts::SectionDemux::ETIDContext::ETIDContext() :
 }
 
 // Init for a new table.
-void ts::SectionDemux::ETIDContext::init(uint8_t new_version, uint8_t last_section)
+void ts::SectionDemux::ETIDContext::init(SectionDemux& demux, uint8_t new_version, uint8_t last_section)
 {
     notified = false;
     version = new_version;
     sect_expected = size_t(last_section) + 1;
     sect_received = 0;
-    sects.resize(sect_expected);
 
-    // Mark all section entries as unused
-    for (size_t i = 0; i < sect_expected; i++) {
-        sects[i].clear();
+    // Recycle the sections of the previous table and mark all section entries as unused.
+    for (auto& sect : sects) {
+        demux.recycleSection(std::move(sect));
     }
+    sects.clear();
+    sects.resize(sect_expected);
 }
 
 // Notify the application if the table is complete.
@@ -199,7 +201,8 @@ ts::SectionDemux::PIDContext::PIDContext() :
     continuity(0),
     sync(false),
     ts(),
-    tids()
+    tids(),
+    last_tid(0)
 {
 }
 
@@ -210,6 +213,51 @@ void ts::SectionDemux::PIDContext::syncLost()
     ts.clear();
 }
 
+// Get the analysis context for one TID/TIDext.
+ts::SectionDemux::ETIDContext& ts::SectionDemux::PIDContext::getETID(const ETID& etid)
+{
+    // Consecutive sections in a PID usually belong to the same table.
+    if (last_tid < tids.size() && tids[last_tid].etid == etid) {
+        return tids[last_tid];
+    }
+
+    // Binary search in the sorted vector, insert a new context if not found.
+    auto it = std::lower_bound(tids.begin(), tids.end(), etid, [](const ETIDContext& tc, const ETID& e) { return tc.etid < e; });
+    if (it == tids.end() || !(it->etid == etid)) {
+        it = tids.insert(it, ETIDContext(etid));
+    }
+    last_tid = size_t(it - tids.begin());
+    return *it;
+}
+
+
+//----------------------------------------------------------------------------
+// Pool of sections which are reused by the demux.
+//----------------------------------------------------------------------------
+
+ts::SectionPtr ts::SectionDemux::newSection(const uint8_t* data, size_t size, PID pid)
+{
+    if (_section_pool.empty()) {
+        return SectionPtr(new Section(data, size, pid, CRC32::CHECK));
+    }
+    else {
+        // Sections in the pool are not referenced elsewhere, their data buffer is reused.
+        SectionPtr sect(std::move(_section_pool.back()));
+        _section_pool.pop_back();
+        sect->reload(data, size, pid, CRC32::CHECK);
+        return sect;
+    }
+}
+
+void ts::SectionDemux::recycleSection(SectionPtr&& sect)
+{
+    // A section which is still referenced by the application (a table handler
+    // may have kept the table for instance) cannot be reused.
+    if (_section_pool.size() < SECTION_POOL_SIZE && !sect.isNull() && sect.count() == 1) {
+        _section_pool.push_back(std::move(sect));
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // SectionDemux constructor and destructor.
@@ -220,13 +268,22 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
     _table_handler(table_handler),
     _section_handler(section_handler),
     _invalid_handler(nullptr),
-    _pids(),
+    _pids(PID_MAX, nullptr),
+    _section_pool(),
     _status(),
     _get_current(true),
     _get_next(false),
     _track_invalid_version(false),
     _ts_error_level(Severity::Debug)
 {
+    _section_pool.reserve(SECTION_POOL_SIZE);
+}
+
+ts::SectionDemux::~SectionDemux()
+{
+    for (size_t pid = 0; pid < PID_MAX; ++pid) {
+        delete _pids[pid];
+    }
 }
 
 
@@ -237,13 +294,19 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
 void ts::SectionDemux::immediateReset()
 {
     SuperClass::immediateReset();
-    _pids.clear();
+    for (size_t pid = 0; pid < PID_MAX; ++pid) {
+        delete _pids[pid];
+        _pids[pid] = nullptr;
+    }
 }
 
 void ts::SectionDemux::immediateResetPID(PID pid)
 {
     SuperClass::immediateResetPID(pid);
-    _pids.erase(pid);
+    if (pid < PID_MAX) {
+        delete _pids[pid];
+        _pids[pid] = nullptr;
+    }
 }
 
 
@@ -270,7 +333,10 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
     // Get PID and reference to the PID context.
     // The PID context is created if did not exist.
     const PID pid = pkt.getPID();
-    PIDContext& pc(_pids[pid]);
+    if (_pids[pid] == nullptr) {
+        _pids[pid] = new PIDContext;
+    }
+    PIDContext& pc(*_pids[pid]);
 
     // If TS packet is scrambled, we cannot decode it and we loose synchronization
     // on this PID (usually, PID's carrying sections are not scrambled).
@@ -478,7 +544,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             // Get reference to the ETID context for this PID.
             // The ETID context is created if did not exist.
             // Avoid accumulating partial sections when there is no table handler.
-            ETIDContext* tc = _table_handler == nullptr ? nullptr : &pc.tids[etid];
+            ETIDContext* tc = _table_handler == nullptr ? nullptr : &pc.getETID(etid);
 
             // If this is a new version of the table, reset the TID context.
             // Note that short sections do not have versions, so the version
@@ -490,7 +556,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
                     tc->sect_expected == 0 ||    // new TID on this PID
                     tc->version != version)      // new version
                 {
-                    tc->init(version, last_section_number);
+                    tc->init(*this, version, last_section_number);
                 }
 
                 // Check that the total number of sections in the table
@@ -521,10 +587,10 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
 
             // Create a new Section object if necessary (ie. if a section
             // hendler is registered or if this is a new section).
-            SectionPtr sect_ptr;
-
+            // Otherwise, there is nothing to do with this section.
             if (section_ok && (_section_handler != nullptr || (tc != nullptr && tc->sects[section_number].isNull()))) {
-                sect_ptr = new Section(ts_start, section_length, pid, CRC32::CHECK);
+
+                SectionPtr sect_ptr(newSection(ts_start, section_length, pid));
                 sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
                 sect_ptr->setLastTSPacketIndex(_packet_count);
                 if (!sect_ptr->isValid()) {
@@ -532,36 +598,41 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
                     _status.wrong_crc++;  // only possible error (hum?)
                     section_ok = false;
                 }
-            }
-
-            // Mark that we are in the context of a table or section handler.
-            // This is used to prevent the destruction of PID contexts during
-            // the execution of a handler.
-            beforeCallingHandler(pid);
-            try {
-                // If a handler is defined for sections, invoke it.
-                if (section_ok && _section_handler != nullptr) {
-                    _section_handler->handleSection(*this, *sect_ptr);
-                }
-
-                // Save the section in the TID context if this is a new one.
-                if (section_ok && tc != nullptr && tc->sects[section_number].isNull()) {
-
-                    // Save the section
-                    tc->sects[section_number] = sect_ptr;
-                    tc->sect_received++;
-
-                    // If the table is completed and a handler is present, build the table.
-                    tc->notify(*this, false, false);
+                else {
+                    // Mark that we are in the context of a table or section handler.
+                    // This is used to prevent the destruction of PID contexts during
+                    // the execution of a handler.
+                    beforeCallingHandler(pid);
+                    try {
+                        // If a handler is defined for sections, invoke it.
+                        if (_section_handler != nullptr) {
+                            _section_handler->handleSection(*this, *sect_ptr);
+                        }
+
+                        // Save the section in the TID context if this is a new one.
+                        if (tc != nullptr && tc->sects[section_number].isNull()) {
+
+                            // Save the section
+                            tc->sects[section_number] = sect_ptr;
+                            tc->sect_received++;
+
+                            // If the table is completed and a handler is present, build the table.
+                            tc->notify(*this, false, false);
+                        }
+                    }
+                    catch (...) {
+                        afterCallingHandler(false);
+                        throw;
+                    }
+
+                    // Reuse the section object if it was not stored in a table.
+                    recycleSection(std::move(sect_ptr));
+
+                    if (afterCallingHandler(true)) {
+                        return;  // the PID of this packet or the complete demux was reset.
+                    }
                 }
             }
-            catch (...) {
-                afterCallingHandler(false);
-                throw;
-            }
-            if (afterCallingHandler(true)) {
-                return;  // the PID of this packet or the complete demux was reset.
-            }
         }
 
         // If a handler is defined for invalid sections, call it.
@@ -608,10 +679,12 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
 
 void ts::SectionDemux::fixAndFlush(bool pack, bool fill_eit)
 {
-    // Loop on all PID's.
-    for (auto& it1 : _pids) {
-        const PID pid = it1.first;
-        PIDContext& pc(it1.second);
+    // Loop on all PID's. A handler may reset the demux, check the PID context each time.
+    for (PID pid = 0; pid < PID_MAX; ++pid) {
+        if (_pids[pid] == nullptr) {
+            continue;
+        }
+        PIDContext& pc(*_pids[pid]);
 
         // Mark that we are in the context of a table or section handler.
         // This is used to prevent the destruction of PID contexts during
@@ -619,9 +692,9 @@ void ts::SectionDemux::fixAndFlush(bool pack, bool fill_eit)
         beforeCallingHandler(pid);
         try {
             // Loop on all TID's currently found in the PID.
-            for (auto& it2 : pc.tids) {
+            for (auto& tc : pc.tids) {
                 // Force a notification of the partial table, if any.
-                it2.second.notify(*this, pack, fill_eit);
+                tc.notify(*this, pack, fill_eit);
             }
         }
         catch (...) {
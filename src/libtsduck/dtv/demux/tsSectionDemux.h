@@ -71,6 +71,11 @@ namespace ts {
                               SectionHandlerInterface* section_handler = nullptr,
                               const PIDSet& pid_filter = NoPID);
 
+        //!
+        //! Destructor.
+        //!
+        virtual ~SectionDemux() override;
+
         // Inherited methods
         virtual void feedPacket(const TSPacket& pkt) override;
 
@@ -260,17 +265,18 @@ namespace ts {
         // This internal structure contains the analysis context for one TID/TIDext into one PID.
         struct ETIDContext
         {
+            ETID    etid;           // Table id and table id extension
             bool    notified;       // The table was reported to application through a handler
             uint8_t version;        // Version of this table
             size_t  sect_expected;  // Number of expected sections in table
             size_t  sect_received;  // Number of received sections in table
             SectionPtrVector sects; // Array of sections
 
-            // Default constructor.
-            ETIDContext();
+            // Constructor.
+            explicit ETIDContext(const ETID& id = ETID());
 
-            // Init for a new table.
-            void init(uint8_t new_version, uint8_t last_section);
+            // Init for a new table. The previous sections are recycled in the demux.
+            void init(SectionDemux& demux, uint8_t new_version, uint8_t last_section);
 
             // Notify the application if the table is complete.
             // Do not notify twice the same table.
@@ -286,15 +292,30 @@ namespace ts {
             uint8_t       continuity;         // Last continuity counter
             bool          sync;               // We are synchronous in this PID
             ByteBlock     ts;                 // TS payload buffer
-            std::map<ETID,ETIDContext> tids;  // TID analysis contexts
+            std::vector<ETIDContext> tids;    // TID analysis contexts, sorted by ETID
+            size_t        last_tid;           // Index in tids of the last used context
 
             // Default constructor.
             PIDContext();
 
             // Called when packet synchronization is lost on the pid.
             void syncLost();
+
+            // Get the analysis context for one TID/TIDext, create it if it does not exist.
+            // The returned reference is valid until the next call.
+            ETIDContext& getETID(const ETID& etid);
         };
 
+        // Maximum number of unused sections which are kept for reuse.
+        static constexpr size_t SECTION_POOL_SIZE = 64;
+
+        // Get a new section from the pool of unused sections or allocate a new one.
+        SectionPtr newSection(const uint8_t* data, size_t size, PID pid);
+
+        // Recycle a section if it is no longer referenced outside the demux.
+        // The safe pointer may be moved and shall no longer be used, except to be destroyed.
+        void recycleSection(SectionPtr&& sect);
+
         // Notify the application if the table is complete.
         // Do not notify twice the same table.
         // If pack is true, build a packed version of the table and report it.
@@ -305,7 +326,8 @@ namespace ts {
         TableHandlerInterface*          _table_handler;
         SectionHandlerInterface*        _section_handler;
         InvalidSectionHandlerInterface* _invalid_handler;
-        std::map<PID,PIDContext>        _pids;
+        std::vector<PIDContext*>        _pids;           // Contexts of demuxed PID's, indexed by PID, null when unused
+        SectionPtrVector                _section_pool;   // Unused sections, ready to be reloaded
         Status _status;
         bool   _get_current;
         bool   _get_next;
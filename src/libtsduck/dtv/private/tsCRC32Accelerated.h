@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Hardware-accelerated implementations of MPEG CRC32 (internal).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAcceleratedEngine.h"
+#include "tsUChar.h"
+
+namespace ts {
+    //!
+    //! Description of a hardware-accelerated MPEG CRC32 engine, using carry-less multiplications.
+    //! @ingroup mpeg
+    //!
+    struct CRC32AcceleratedEngine
+    {
+        //!
+        //! Profile of a folding function.
+        //! The data are folded into one single 16-byte block which has the same CRC32 as the data.
+        //! More precisely, the CRC32 of @a data, starting from the value @a fcs, is the CRC32
+        //! of @a out, starting from a zero value.
+        //! @param [in] fcs Initial value of the CRC32 before @a data.
+        //! @param [in] data Address of data, any alignment.
+        //! @param [in] blocks Number of 16-byte blocks in @a data, at least 4.
+        //! @param [out] out Address of the 16-byte resulting block.
+        //!
+        typedef void (*Function)(uint32_t fcs, const uint8_t* data, size_t blocks, uint8_t* out);
+
+        const UChar* name;  //!< Engine name, for information.
+        Function     fold;  //!< Folding function.
+    };
+
+    //!
+    //! Get the CRC32 engine using the Intel PCLMULQDQ instructions.
+    //! This engine is compiled in a separate module, using PCLMULQDQ code generation.
+    //! @return Address of the engine description or a null pointer if the library
+    //! was not compiled with PCLMULQDQ support. The CPU support shall be checked separately.
+    //!
+    const CRC32AcceleratedEngine* CRC32EngineIntel();
+
+    //!
+    //! Get the CRC32 engine using the Armv8 PMULL instructions.
+    //! This engine is compiled in a separate module, using Armv8 crypto code generation.
+    //! @return Address of the engine description or a null pointer if the library
+    //! was not compiled with Armv8 cryptographic extensions. The CPU support shall be checked separately.
+    //!
+    const CRC32AcceleratedEngine* CRC32EngineArm();
+
+    //!
+    //! Selection of the hardware-accelerated engine, according to the features of the CPU.
+    //!
+    typedef AcceleratedEngineSelector<CRC32AcceleratedEngine, &SysInfo::pclmulInstructions, CRC32EngineIntel, CRC32EngineArm> CRC32EngineSelector;
+}
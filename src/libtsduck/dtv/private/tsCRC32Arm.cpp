@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  MPEG CRC32 engine using the Armv8 PMULL instructions.
+//  This module is compiled with Armv8 crypto code generation. It shall be used
+//  only after checking that the CPU supports it, see SysInfo::pclmulInstructions().
+//  The algorithm is the same as in the Intel PCLMULQDQ engine.
+//
+//----------------------------------------------------------------------------
+
+#include "tsCRC32Accelerated.h"
+
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES) || (defined(TS_MSC) && defined(TS_ARM64))
+
+#include "tsMemory.h"
+#include "tsBeforeStandardHeaders.h"
+#include <arm_neon.h>
+#include "tsAfterStandardHeaders.h"
+
+namespace {
+
+    // Number of blocks which are folded in parallel to fill the pipeline of multiplications.
+    constexpr size_t PARALLEL_BLOCKS = 4;
+
+    // Folding constants, modulo P = 0x104C11DB7.
+    constexpr uint64_t X128 = 0xE8A45605;  // x^128 mod P
+    constexpr uint64_t X192 = 0xC5B9CD4C;  // x^192 mod P
+    constexpr uint64_t X512 = 0xE6228B11;  // x^512 mod P
+    constexpr uint64_t X576 = 0x8833794C;  // x^576 mod P
+
+    // Load a 16-byte block as a big-endian 128-bit polynomial, lane 1 is the high part.
+    inline uint64x2_t Load(const uint8_t* p)
+    {
+        return vcombine_u64(vcreate_u64(ts::GetUInt64(p + 8)), vcreate_u64(ts::GetUInt64(p)));
+    }
+
+    // 64x64 -> 128 bits carry-less multiplication.
+    inline uint64x2_t Mul(uint64_t a, uint64_t b)
+    {
+        return vreinterpretq_u64_p128(vmull_p64(poly64_t(a), poly64_t(b)));
+    }
+
+    // Fold block a into block b using the constants khi (distance + 64) and klo (distance).
+    inline uint64x2_t Fold(uint64x2_t a, uint64_t khi, uint64_t klo, uint64x2_t b)
+    {
+        return veorq_u64(veorq_u64(Mul(vgetq_lane_u64(a, 1), khi), Mul(vgetq_lane_u64(a, 0), klo)), b);
+    }
+
+    void FoldBlocks(uint32_t fcs, const uint8_t* data, size_t blocks, uint8_t* out)
+    {
+        // Initial blocks, the previous CRC value is xored in the first 4 bytes.
+        uint64x2_t acc[PARALLEL_BLOCKS];
+        for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+            acc[i] = Load(data + 16 * i);
+        }
+        acc[0] = veorq_u64(acc[0], vcombine_u64(vcreate_u64(0), vcreate_u64(uint64_t(fcs) << 32)));
+        data += 16 * PARALLEL_BLOCKS;
+        blocks -= PARALLEL_BLOCKS;
+
+        // Fold groups of blocks in parallel.
+        while (blocks >= PARALLEL_BLOCKS) {
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                acc[i] = Fold(acc[i], X576, X512, Load(data + 16 * i));
+            }
+            data += 16 * PARALLEL_BLOCKS;
+            blocks -= PARALLEL_BLOCKS;
+        }
+
+        // Reduce the parallel accumulators into one, then fold remaining blocks.
+        uint64x2_t res = acc[0];
+        for (size_t i = 1; i < PARALLEL_BLOCKS; ++i) {
+            res = Fold(res, X192, X128, acc[i]);
+        }
+        for (; blocks > 0; --blocks, data += 16) {
+            res = Fold(res, X192, X128, Load(data));
+        }
+
+        // Store the result as a big-endian 16-byte block.
+        ts::PutUInt64(out, vgetq_lane_u64(res, 1));
+        ts::PutUInt64(out + 8, vgetq_lane_u64(res, 0));
+    }
+
+    const ts::CRC32AcceleratedEngine EngineArm = {u"Armv8 PMULL", FoldBlocks};
+}
+
+const ts::CRC32AcceleratedEngine* ts::CRC32EngineArm()
+{
+    return &EngineArm;
+}
+
+#else
+
+const ts::CRC32AcceleratedEngine* ts::CRC32EngineArm()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,125 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  MPEG CRC32 engine using the Intel PCLMULQDQ instructions.
+//  This module is compiled with PCLMULQDQ and SSSE3 code generation. It shall be
+//  used only after checking that the CPU supports PCLMULQDQ, see
+//  SysInfo::pclmulInstructions(). All CPU's with PCLMULQDQ also support SSSE3.
+//
+//  The data are processed as 128-bit big-endian polynomials. A block A at
+//  distance D bits before a block B is folded into B as:
+//    B ^ (A.high * (x^(D+64) mod P)) ^ (A.low * (x^D mod P))
+//  which keeps the value of the message modulo P, the MPEG CRC32 polynomial.
+//
+//----------------------------------------------------------------------------
+
+#include "tsCRC32Accelerated.h"
+
+#if (defined(__PCLMUL__) && defined(__SSSE3__)) || (defined(TS_MSC) && (defined(TS_I386) || defined(TS_X86_64)))
+
+#include "tsBeforeStandardHeaders.h"
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#include "tsAfterStandardHeaders.h"
+
+namespace {
+
+    // Number of blocks which are folded in parallel to fill the pipeline of multiplications.
+    constexpr size_t PARALLEL_BLOCKS = 4;
+
+    // Folding constants, modulo P = 0x104C11DB7.
+    constexpr int64_t X128 = 0xE8A45605;  // x^128 mod P
+    constexpr int64_t X192 = 0xC5B9CD4C;  // x^192 mod P
+    constexpr int64_t X512 = 0xE6228B11;  // x^512 mod P
+    constexpr int64_t X576 = 0x8833794C;  // x^576 mod P
+
+    // Load a 16-byte block as a big-endian 128-bit polynomial.
+    inline __m128i Load(const uint8_t* p, __m128i swap)
+    {
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), swap);
+    }
+
+    // Fold block a into block b using the constants in k (high: distance + 64, low: distance).
+    inline __m128i Fold(__m128i a, __m128i k, __m128i b)
+    {
+        return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x11), _mm_clmulepi64_si128(a, k, 0x00)), b);
+    }
+
+    void FoldBlocks(uint32_t fcs, const uint8_t* data, size_t blocks, uint8_t* out)
+    {
+        const __m128i k128 = _mm_set_epi64x(X192, X128);
+        const __m128i k512 = _mm_set_epi64x(X576, X512);
+        const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+        // Initial blocks, the previous CRC value is xored in the first 4 bytes.
+        __m128i acc[PARALLEL_BLOCKS];
+        for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+            acc[i] = Load(data + 16 * i, swap);
+        }
+        acc[0] = _mm_xor_si128(acc[0], _mm_set_epi64x(int64_t(uint64_t(fcs) << 32), 0));
+        data += 16 * PARALLEL_BLOCKS;
+        blocks -= PARALLEL_BLOCKS;
+
+        // Fold groups of blocks in parallel.
+        while (blocks >= PARALLEL_BLOCKS) {
+            for (size_t i = 0; i < PARALLEL_BLOCKS; ++i) {
+                acc[i] = Fold(acc[i], k512, Load(data + 16 * i, swap));
+            }
+            data += 16 * PARALLEL_BLOCKS;
+            blocks -= PARALLEL_BLOCKS;
+        }
+
+        // Reduce the parallel accumulators into one, then fold remaining blocks.
+        __m128i res = acc[0];
+        for (size_t i = 1; i < PARALLEL_BLOCKS; ++i) {
+            res = Fold(res, k128, acc[i]);
+        }
+        for (; blocks > 0; --blocks, data += 16) {
+            res = Fold(res, k128, Load(data, swap));
+        }
+
+        // Store the result as a big-endian 16-byte block.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(res, swap));
+    }
+
+    const ts::CRC32AcceleratedEngine EngineIntel = {u"PCLMULQDQ", FoldBlocks};
+}
+
+const ts::CRC32AcceleratedEngine* ts::CRC32EngineIntel()
+{
+    return &EngineIntel;
+}
+
+#else
+
+const ts::CRC32AcceleratedEngine* ts::CRC32EngineIntel()
+{
+    return nullptr;
+}
+
+#endif
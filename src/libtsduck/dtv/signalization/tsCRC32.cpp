@@ -28,6 +28,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsCRC32.h"
+#include "tsCRC32Accelerated.h"
+#include "tsMemory.h"
 
 
 // The FCS-32 generator polynomial:
@@ -104,13 +106,138 @@ namespace {
     };
 }
 
-// Continue the computation of a data area, following a previous CRC32
 
-void ts::CRC32::add (const void* data, size_t size)
+//----------------------------------------------------------------------------
+// Slicing-by-8 implementation.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Slicing tables: table t[k][b] is the CRC32 of byte b followed by k zero bytes.
+    // The 8 KB of tables remain small enough to stay in the L1 cache during a demux.
+    struct SliceTables
+    {
+        uint32_t t[8][256];
+        SliceTables();
+    };
+
+    SliceTables::SliceTables() :
+        t()
+    {
+        for (size_t b = 0; b < 256; ++b) {
+            t[0][b] = fcstab_32[b];
+            for (size_t k = 1; k < 8; ++k) {
+                t[k][b] = (t[k-1][b] << 8) ^ fcstab_32[t[k-1][b] >> 24];
+            }
+        }
+    }
+
+    const SliceTables& Tables()
+    {
+        static const SliceTables tables;
+        return tables;
+    }
+
+    // Process 8 bytes at once.
+    inline uint32_t Slice8(const uint32_t (*t)[256], uint32_t fcs, const uint8_t* p)
+    {
+        const uint32_t w = fcs ^ ts::GetUInt32(p);
+        return t[7][w >> 24] ^ t[6][(w >> 16) & 0xFF] ^ t[5][(w >> 8) & 0xFF] ^ t[4][w & 0xFF] ^
+               t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+
+    // Process any size, 8 bytes at a time, then byte by byte.
+    inline uint32_t Slice(uint32_t fcs, const uint8_t* p, size_t size)
+    {
+        const uint32_t (*t)[256] = Tables().t;
+        for (; size >= 8; size -= 8, p += 8) {
+            fcs = Slice8(t, fcs, p);
+        }
+        while (size-- > 0) {
+            fcs = (fcs << 8) ^ fcstab_32[((fcs >> 24) ^ (*p++)) & 0xFF];
+        }
+        return fcs;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Selection of the hardware-accelerated engine, if any.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Minimum size of data areas which are folded using carry-less multiplications.
+    // Below this size, the setup and final reduction cost more than slicing-by-8.
+    constexpr size_t FOLD_MIN_SIZE = 256;
+}
+
+bool ts::CRC32::IsAccelerated()
 {
-    const uint8_t* cp = static_cast <const uint8_t*> (data);
+    return CRC32EngineSelector::Get() != nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Continue the computation of a data area, following a previous CRC32.
+//----------------------------------------------------------------------------
+
+void ts::CRC32::add(const void* data, size_t size)
+{
+    const uint8_t* cp = static_cast<const uint8_t*>(data);
+
+    // Large areas: fold all 16-byte blocks into one using carry-less multiplications.
+    // The folded block has the same CRC32, starting from zero, as the original blocks.
+    const CRC32AcceleratedEngine* engine = size >= FOLD_MIN_SIZE ? CRC32EngineSelector::Get() : nullptr;
+    if (engine != nullptr) {
+        uint8_t folded[16];
+        const size_t blocks = size / 16;
+        engine->fold(_fcs, cp, blocks, folded);
+        _fcs = Slice(0, folded, sizeof(folded));
+        cp += 16 * blocks;
+        size -= 16 * blocks;
+    }
+
+    _fcs = Slice(_fcs, cp, size);
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the CRC32 of several independent data areas.
+//----------------------------------------------------------------------------
+
+void ts::CRC32::Compute(const void* const data[], const size_t sizes[], uint32_t crcs[], size_t count)
+{
+    // Number of areas which are interleaved. The table lookups of independent
+    // areas have no dependency and overlap in the CPU pipeline.
+    constexpr size_t LANES = 4;
+    const uint32_t (*t)[256] = Tables().t;
+
+    for (size_t first = 0; first < count; first += LANES) {
+        const size_t lanes = std::min(LANES, count - first);
+        const uint8_t* p[LANES];
+        uint32_t fcs[LANES];
+        size_t common = std::numeric_limits<size_t>::max();
+        for (size_t i = 0; i < lanes; ++i) {
+            p[i] = static_cast<const uint8_t*>(data[first + i]);
+            fcs[i] = 0xFFFFFFFF;
+            common = std::min(common, sizes[first + i]);
+        }
+
+        // Interleaved processing of the part which is common to all areas.
+        common = lanes < LANES ? 0 : common & ~size_t(7);
+        for (size_t off = 0; off < common; off += 8) {
+            for (size_t i = 0; i < LANES; ++i) {
+                fcs[i] = Slice8(t, fcs[i], p[i] + off);
+            }
+        }
 
-    while (size-- > 0) {
-        _fcs = (_fcs << 8) ^ fcstab_32 [((_fcs >> 24) ^ (*cp++)) & 0xFF];
+        // Process the rest of each area separately.
+        for (size_t i = 0; i < lanes; ++i) {
+            CRC32 crc;
+            crc._fcs = fcs[i];
+            crc.add(p[i] + common, sizes[first + i] - common);
+            crcs[first + i] = crc._fcs;
+        }
     }
 }
@@ -68,6 +68,26 @@ namespace ts {
         //!
         void add(const void* data, size_t size);
 
+        //!
+        //! Compute the CRC32 of several independent data areas.
+        //! The data areas are processed in an interleaved way. This is faster than computing
+        //! the CRC32 of each area one after the other when the areas are short, typically a
+        //! list of MPEG sections.
+        //! @param [in] data Array of @a count addresses of areas to analyze.
+        //! @param [in] sizes Array of @a count sizes in bytes of areas to analyze.
+        //! @param [out] crcs Array of @a count returned CRC32 values.
+        //! @param [in] count Number of data areas.
+        //!
+        static void Compute(const void* const data[], const size_t sizes[], uint32_t crcs[], size_t count);
+
+        //!
+        //! Check if the CRC32 of large data areas is computed using hardware instructions on this system.
+        //! When the CPU supports it, PCLMULQDQ (Intel) or PMULL (Armv8) are used. Otherwise,
+        //! a portable software implementation is used.
+        //! @return True if CRC32 is hardware-accelerated.
+        //!
+        static bool IsAccelerated();
+
         //!
         //! Get the value of the CRC32 as computed so far.
         //! @return The value of the CRC32 as computed so far.
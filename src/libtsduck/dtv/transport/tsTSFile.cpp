@@ -29,8 +29,11 @@
 
 #include "tsTSFile.h"
 #include "tsTSPacketMetadata.h"
+#include "tsAsyncFileIO.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
+#include "tsSysInfo.h"
+#include "tsIntegerUtils.h"
 
 #if defined(TS_WINDOWS)
     #include "tsBeforeStandardHeaders.h"
@@ -40,10 +43,17 @@
     #include "tsBeforeStandardHeaders.h"
     #include <sys/types.h>
     #include <sys/stat.h>
+    #include <sys/mman.h>
     #include <unistd.h>
+    #include <fcntl.h>
     #include "tsAfterStandardHeaders.h"
 #endif
 
+// Size of the area which is read ahead in a memory-mapped file.
+namespace {
+    constexpr size_t MAP_READ_AHEAD = 8 * 1024 * 1024;
+}
+
 
 //----------------------------------------------------------------------------
 // Default constructor.
@@ -67,6 +77,19 @@ ts::TSFile::TSFile() :
     _rewindable(false),
     _regular(false),
     _std_inout(false),
+    _async_depth(0),
+    _async_size(0),
+    _async(nullptr),
+    _direct(false),
+    _prealloc_size(0),
+    _preallocated(false),
+    _mmap(false),
+    _map_data(nullptr),
+    _map_size(0),
+    _map_pos(0),
+    _map_advised(0),
+    _view_packets(),
+    _view_mdata(),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -98,6 +121,19 @@ ts::TSFile::TSFile(const TSFile& other) :
     _rewindable(false),
     _regular(false),
     _std_inout(other._std_inout),
+    _async_depth(other._async_depth),
+    _async_size(other._async_size),
+    _async(nullptr),
+    _direct(other._direct),
+    _prealloc_size(other._prealloc_size),
+    _preallocated(false),
+    _mmap(other._mmap),
+    _map_data(nullptr),
+    _map_size(0),
+    _map_pos(0),
+    _map_advised(0),
+    _view_packets(),
+    _view_mdata(),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -129,6 +165,19 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
     _rewindable(other._rewindable),
     _regular(other._regular),
     _std_inout(other._std_inout),
+    _async_depth(other._async_depth),
+    _async_size(other._async_size),
+    _async(other._async),
+    _direct(other._direct),
+    _prealloc_size(other._prealloc_size),
+    _preallocated(other._preallocated),
+    _mmap(other._mmap),
+    _map_data(other._map_data),
+    _map_size(other._map_size),
+    _map_pos(other._map_pos),
+    _map_advised(other._map_advised),
+    _view_packets(std::move(other._view_packets)),
+    _view_mdata(std::move(other._view_mdata)),
 #if defined(TS_WINDOWS)
     _handle(other._handle)
 #else
@@ -137,6 +186,8 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
 {
     // Mark other object as closed, just in case.
     other._is_open = false;
+    other._async = nullptr;
+    other._map_data = nullptr;
 #if defined(TS_WINDOWS)
     other._handle = INVALID_HANDLE_VALUE;
 #else
@@ -154,6 +205,8 @@ ts::TSFile::~TSFile()
     if (_is_open) {
         close(NULLREP);
     }
+    delete _async;
+    _async = nullptr;
 }
 
 
@@ -189,6 +242,17 @@ void ts::TSFile::setStuffing(size_t initial, size_t final)
 }
 
 
+//----------------------------------------------------------------------------
+// Set asynchronous I/O parameters.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::setAsyncIO(size_t queue_depth, size_t buffer_size)
+{
+    _async_depth = queue_depth;
+    _async_size = buffer_size == 0 ? AsyncFileIO::DEFAULT_BUFFER_SIZE : buffer_size;
+}
+
+
 //----------------------------------------------------------------------------
 // Open file for read in a rewindable mode.
 //----------------------------------------------------------------------------
@@ -391,6 +455,10 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
 
     // Close first if this is a reopen.
     if (reopen) {
+        if (_async != nullptr) {
+            _async->close(report);
+        }
+        unmap();
         ::close(_fd);
         _fd = -1;
     }
@@ -466,6 +534,71 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
         return false;
     }
 
+    // Map the complete file in memory on regular files in read-only mode.
+    // If not possible, silently fall back to read operations.
+    if (_mmap && _regular && read_only && st.st_size > 0) {
+        if (uint64_t(st.st_size) > uint64_t(std::numeric_limits<size_t>::max())) {
+            report.verbose(u"%s is too large to be mapped in memory, using read operations", {getDisplayFileName()});
+        }
+        else {
+            void* const addr = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, _fd, 0);
+            if (addr == MAP_FAILED) {
+                const SysErrorCode err = LastSysErrorCode();
+                report.verbose(u"cannot map %s in memory, using read operations: %s", {getDisplayFileName(), SysErrorCodeMessage(err)});
+            }
+            else {
+                report.debug(u"mapped %s in memory, %'d bytes", {getDisplayFileName(), st.st_size});
+                _map_data = reinterpret_cast<uint8_t*>(addr);
+                _map_size = size_t(st.st_size);
+                _map_pos = size_t(std::min<uint64_t>(_start_offset, _map_size));
+                ::madvise(addr, _map_size, MADV_SEQUENTIAL);
+                adviseMap(true);
+            }
+        }
+    }
+
+    // Preallocate disk space on regular files in write mode, without changing the file size.
+    _preallocated = false;
+#if defined(TS_LINUX)
+    if (_prealloc_size > 0 && _regular && write_access) {
+        const off_t position = ::lseek(_fd, 0, SEEK_CUR);
+        if (position != off_t(-1) && ::fallocate(_fd, FALLOC_FL_KEEP_SIZE, position, off_t(_prealloc_size)) == 0) {
+            report.debug(u"preallocated %'d bytes in %s", {_prealloc_size, getDisplayFileName()});
+            _preallocated = true;
+        }
+        else {
+            const SysErrorCode err = LastSysErrorCode();
+            report.verbose(u"cannot preallocate disk space in %s: %s", {getDisplayFileName(), SysErrorCodeMessage(err)});
+        }
+    }
+#endif
+
+    // Start asynchronous I/O on regular files, in read-only or write-only mode.
+    // Direct I/O in write-only mode always uses asynchronous I/O, with at least two buffers.
+    // If not possible, silently fall back to synchronous and buffered I/O.
+    const bool direct = _direct && _regular && write_access && !read_access;
+    if ((_async_depth > 0 || direct) && _regular && read_access != write_access && _map_data == nullptr) {
+        const off_t position = ::lseek(_fd, 0, SEEK_CUR);
+        if (_async == nullptr) {
+            _async = new AsyncFileIO;
+        }
+        // With direct I/O, all writes must start on a block boundary (when appending to a file for instance).
+        const bool direct_ok = direct && position != off_t(-1) && position % off_t(SysInfo::Instance()->memoryPageSize()) == 0 && setFileDirectIO(true);
+        if (direct && !direct_ok) {
+            report.verbose(u"direct I/O not available on %s, using the page cache", {getDisplayFileName()});
+        }
+        const size_t depth = direct_ok ? std::max<size_t>(2, _async_depth) : _async_depth;
+        if (depth > 0 && position != off_t(-1) && _async->open(_fd, write_access, uint64_t(position), depth, _async_size == 0 ? AsyncFileIO::DEFAULT_BUFFER_SIZE : _async_size, report)) {
+            report.debug(u"using asynchronous%s I/O on %s", {direct_ok ? u" direct" : u"", getDisplayFileName()});
+        }
+        else {
+            if (direct_ok) {
+                setFileDirectIO(false);
+            }
+            report.verbose(u"asynchronous I/O not available on %s, using synchronous I/O", {getDisplayFileName()});
+        }
+    }
+
 #endif
 
     // Reset counters only if not a reopen.
@@ -488,6 +621,21 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Set or reset direct I/O on the open file. Return false if not supported.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::setFileDirectIO(bool on) const
+{
+#if defined(TS_LINUX)
+    const int flags = ::fcntl(_fd, F_GETFL);
+    return flags >= 0 && ::fcntl(_fd, F_SETFL, on ? (flags | O_DIRECT) : (flags & ~O_DIRECT)) == 0;
+#else
+    return false;
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Internal seek check. Return true when seeking is not required or possible.
 // Return false if seeking is required but not possible.
@@ -526,6 +674,23 @@ bool ts::TSFile::seekInternal(uint64_t index, Report& report)
 
     report.debug(u"seeking %s at offset %'d", {_filename, _start_offset + index});
 
+    // In a memory-mapped file, simply move the current position.
+    if (_map_data != nullptr) {
+        _map_pos = size_t(std::min<uint64_t>(_start_offset + index, _map_size));
+        _at_eof = false;
+        adviseMap(true);
+        return true;
+    }
+
+    // With asynchronous I/O, restart reading ahead at the new position.
+    if (_async != nullptr && _async->isOpen()) {
+        if (!_async->seek(_start_offset + index, report)) {
+            return false;
+        }
+        _at_eof = false;
+        return true;
+    }
+
 #if defined(TS_WINDOWS)
     // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
     uint64_t where = _start_offset + index;
@@ -555,16 +720,26 @@ bool ts::TSFile::seek(PacketCounter packet_index, Report& report)
         report.log(_severity, u"not open");
         return false;
     }
-    else if (!_rewindable) {
+    else if (!_rewindable && !isDirectAccess()) {
         report.log(_severity, u"file %s is not rewindable", {getDisplayFileName()});
         return false;
     }
     else {
-        return seekInternal(packet_index * (packetHeaderSize() + PKT_SIZE), report);
+        return seekInternal(packet_index * (packetHeaderSize() + PKT_SIZE + packetTrailerSize()), report);
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Check if any packet can be directly accessed in the file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::isDirectAccess() const
+{
+    return _is_open && _map_data != nullptr && _repeat == 1 && _open_null == 0 && _close_null == 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Close file.
 //----------------------------------------------------------------------------
@@ -581,6 +756,25 @@ bool ts::TSFile::close(Report& report)
         writeStuffing(_close_null, report);
     }
 
+    // Complete asynchronous I/O before closing the file. Pending writes are flushed.
+    bool success = true;
+    if (_async != nullptr && _async->isOpen()) {
+        success = _async->close(report);
+    }
+
+#if !defined(TS_WINDOWS)
+    // Release the unused part of the preallocated disk space, after the end of file.
+    struct stat st;
+    if (_preallocated && ::fstat(_fd, &st) == 0 && ::ftruncate(_fd, st.st_size) < 0) {
+        const SysErrorCode err = LastSysErrorCode();
+        report.verbose(u"cannot release preallocated space in %s: %s", {getDisplayFileName(), SysErrorCodeMessage(err)});
+    }
+    _preallocated = false;
+#endif
+
+    // Unmap the file before closing it.
+    unmap();
+
     if (!_std_inout) {
 #if defined(TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -596,7 +790,7 @@ bool ts::TSFile::close(Report& report)
     _filename.clear();
     _std_inout = false;
 
-    return true;
+    return success;
 }
 
 
@@ -650,6 +844,14 @@ bool ts::TSFile::readStreamPartial(void* buffer, size_t request_size, size_t& re
 
 #else
 
+    // Asynchronous I/O implementation.
+    if (_async != nullptr && _async->isOpen()) {
+        bool eof = false;
+        const bool success = _async->read(buffer, request_size, read_size, eof, report);
+        _at_eof = _at_eof || eof;
+        return success;
+    }
+
     // UNIX implementation
     for (;;) {
         const ssize_t insize = ::read(_fd, buffer, request_size);
@@ -687,6 +889,18 @@ size_t ts::TSFile::readPackets(TSPacket* buffer, TSPacketMetadata* metadata, siz
 {
     size_t ret_count = 0;
 
+    // With a memory-mapped file, copy the packets from the mapped memory.
+    // Stuffing and repetition are handled by readPacketView().
+    if (_map_data != nullptr) {
+        TSPacketView view;
+        size_t count = 0;
+        while (ret_count < max_packets && (count = readPacketView(view, max_packets - ret_count, report)) > 0) {
+            view.copy(buffer + ret_count, metadata == nullptr ? nullptr : metadata + ret_count);
+            ret_count += count;
+        }
+        return ret_count;
+    }
+
     // Initial artificial stuffing.
     if (_open_null_read > 0 && max_packets > 0) {
         const size_t count = std::min(max_packets, _open_null_read);
@@ -739,6 +953,158 @@ size_t ts::TSFile::readPackets(TSPacket* buffer, TSPacketMetadata* metadata, siz
 }
 
 
+//----------------------------------------------------------------------------
+// Read TS packets in place, without copy when possible.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFile::readPacketView(TSPacketView& view, size_t max_packets, Report& report)
+{
+    view.clear();
+
+    if (!_is_open) {
+        report.error(u"%s is not open", {getDisplayFileName()});
+        return 0;
+    }
+    if (max_packets == 0) {
+        return 0;
+    }
+
+    // Without memory mapping, read the packets in the internal buffer.
+    if (_map_data == nullptr) {
+        if (_view_packets.size() < max_packets) {
+            _view_packets.resize(max_packets);
+            _view_mdata.resize(max_packets);
+        }
+        const size_t count = TSFile::readPackets(_view_packets.data(), _view_mdata.data(), max_packets, report);
+        view.set(_view_packets[0].b, count, TSPacketFormat::TS, _view_mdata.data());
+        return count;
+    }
+
+    // Initial artificial stuffing.
+    if (_open_null_read > 0) {
+        const size_t count = std::min(max_packets, _open_null_read);
+        report.debug(u"reading %d starting null packets", {count});
+        view.setStuffing(count);
+        _open_null_read -= count;
+        _total_read += count;
+        return count;
+    }
+
+    // Get packets in place in the mapped file. Rewind on end of file if repeating is set.
+    // Do not rewind twice in a row if there is not a single packet in the file.
+    bool rewound = false;
+    while (!_at_eof) {
+        if (packetFormat() == TSPacketFormat::AUTODETECT) {
+            const TSPacketFormat format = detectMappedFormat(report);
+            if (format == TSPacketFormat::AUTODETECT) {
+                return 0; // format error or no packet at all
+            }
+            setPacketFormat(format);
+            report.debug(u"detected TS file format %s", {packetFormatString()});
+        }
+        const size_t stride = TSPacketView::Stride(packetFormat());
+        const size_t count = std::min(max_packets, (_map_size - _map_pos) / stride);
+        if (count > 0) {
+            view.set(_map_data + _map_pos, count, packetFormat());
+            _map_pos += count * stride;
+            _total_read += count;
+            adviseMap(false);
+            return count;
+        }
+        // End of file. Truncate incomplete packet at end of file.
+        _at_eof = true;
+        if (!rewound && (_repeat == 0 || ++_counter < _repeat)) {
+            if (!seekInternal(0, report)) {
+                return 0;
+            }
+            rewound = true;
+        }
+    }
+
+    // Final artificial stuffing.
+    if (_close_null_read > 0) {
+        const size_t count = std::min(max_packets, _close_null_read);
+        report.debug(u"reading %d stopping null packets", {count});
+        view.setStuffing(count);
+        _close_null_read -= count;
+        _total_read += count;
+        return count;
+    }
+
+    return 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Detect the packet format at the current position in a memory-mapped file.
+// Return AUTODETECT on error or when there is not a single packet.
+//----------------------------------------------------------------------------
+
+ts::TSPacketFormat ts::TSFile::detectMappedFormat(Report& report)
+{
+    const uint8_t* const data = _map_data + _map_pos;
+    const size_t size = _map_size - _map_pos;
+
+    // Same rules as TSPacketStream::readPackets().
+    if (size < PKT_SIZE) {
+        _at_eof = true;
+        return TSPacketFormat::AUTODETECT;
+    }
+    else if (data[0] == SYNC_BYTE) {
+        // Check the presence of a 16-byte Reed-Solomon trailer.
+        const bool rs = size > PKT_RS_SIZE && data[PKT_SIZE] != SYNC_BYTE && data[PKT_RS_SIZE] == SYNC_BYTE;
+        return rs ? TSPacketFormat::RS204 : TSPacketFormat::TS;
+    }
+    else if (data[4] == SYNC_BYTE) {
+        return TSPacketFormat::M2TS;
+    }
+    else if (data[0] == TSPacketMetadata::SERIALIZATION_MAGIC && data[TSPacketMetadata::SERIALIZATION_SIZE] == SYNC_BYTE) {
+        return TSPacketFormat::DUCK;
+    }
+    else {
+        report.error(u"cannot detect TS file format");
+        return TSPacketFormat::AUTODETECT;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Advise the kernel to read ahead the mapped file after the current position.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::adviseMap(bool restart)
+{
+#if !defined(TS_WINDOWS)
+    // After a seek, restart the read-ahead window from the page of the current position.
+    if (restart) {
+        _map_advised = round_down(_map_pos, SysInfo::Instance()->memoryPageSize());
+    }
+    // Advise the next window when the current position reaches the middle of the previous one.
+    if (_map_advised < _map_size && _map_pos + MAP_READ_AHEAD / 2 >= _map_advised) {
+        const size_t size = std::min(MAP_READ_AHEAD, _map_size - _map_advised);
+        ::madvise(_map_data + _map_advised, size, MADV_WILLNEED);
+        _map_advised += size;
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the file, if mapped.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::unmap()
+{
+#if !defined(TS_WINDOWS)
+    if (_map_data != nullptr) {
+        ::munmap(_map_data, _map_size);
+    }
+#endif
+    _map_data = nullptr;
+    _map_size = _map_pos = _map_advised = 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of AbstractWriteStreamInterface
 //----------------------------------------------------------------------------
@@ -781,6 +1147,15 @@ bool ts::TSFile::writeStream(const void* buffer, size_t data_size, size_t& writt
 
 #else
 
+    // Asynchronous I/O implementation.
+    if (_async != nullptr && _async->isOpen()) {
+        if (!_async->write(buffer, data_size, report)) {
+            return false;
+        }
+        written_size = data_size;
+        return true;
+    }
+
     // UNIX implementation
     const char* data = reinterpret_cast<const char*>(buffer);
     size_t remain = data_size;
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsTSPacketStream.h"
+#include "tsTSPacketView.h"
 #include "tsAbstractReadStreamInterface.h"
 #include "tsAbstractWriteStreamInterface.h"
 #include "tsEnumUtils.h"
@@ -41,6 +42,7 @@
 namespace ts {
 
     class TSPacketMetadata;
+    class AsyncFileIO;
 
     //!
     //! Transport stream file, input and/or output.
@@ -178,6 +180,78 @@ namespace ts {
         //!
         void setStuffing(size_t initial, size_t final);
 
+        //!
+        //! Set asynchronous I/O parameters.
+        //! This method shall be called before opening the file.
+        //! When enabled and the file is a regular file, opened in read-only or write-only mode,
+        //! several reads or writes are kept in flight (read-ahead or write-behind, see ts::AsyncFileIO).
+        //! This is currently implemented on Linux only, using io_uring. When not available, the file
+        //! silently falls back to synchronous I/O.
+        //! @param [in] queue_depth Number of I/O operations in flight. Zero disables asynchronous I/O (the default).
+        //! @param [in] buffer_size Size in bytes of each I/O buffer. Zero means the default size.
+        //!
+        void setAsyncIO(size_t queue_depth, size_t buffer_size = 0);
+
+        //!
+        //! Set direct I/O write mode.
+        //! This method shall be called before opening the file.
+        //! When enabled and the file is a regular file, opened in write-only mode, the file is written
+        //! using direct I/O (O_DIRECT), bypassing the page cache of the operating system. Recording large
+        //! files does not evict other data from the page cache and does not trigger periodic write-back
+        //! stalls. The data are written from aligned buffers using asynchronous I/O, with at least two
+        //! buffers (see setAsyncIO()). This is currently implemented on Linux only. When not available,
+        //! the file silently falls back to buffered I/O.
+        //! @param [in] on True to enable direct I/O. Disabled by default.
+        //!
+        void setDirectIO(bool on) { _direct = on; }
+
+        //!
+        //! Set the disk space to preallocate when the file is open for write.
+        //! This method shall be called before opening the file.
+        //! The disk space is reserved without changing the file size. The unused part of
+        //! the preallocated space is released when the file is closed. This is currently
+        //! implemented on Linux only. When not supported by the file system, the space is
+        //! allocated while the file is written, as usual.
+        //! @param [in] size Size in bytes to preallocate. Zero means no preallocation (the default).
+        //!
+        void setPreallocation(uint64_t size) { _prealloc_size = size; }
+
+        //!
+        //! Set memory-mapped read mode.
+        //! This method shall be called before opening the file.
+        //! When enabled and the file is a regular file, opened in read-only mode, the complete file
+        //! is mapped in memory. Packets are then accessed in place using readPacketView(), without
+        //! copy and without system call, or copied from the mapped memory using readPackets().
+        //! Seeking in the file is immediate. The kernel is advised to read the file ahead of the
+        //! current position. This is currently implemented on UNIX systems only. When not available,
+        //! the file silently falls back to read operations.
+        //! @param [in] on True to enable memory-mapped read mode. Disabled by default.
+        //! @see readPacketView()
+        //!
+        void setMemoryMapped(bool on) { _mmap = on; }
+
+        //!
+        //! Check if the file is currently mapped in memory.
+        //! @return True if the file is open and currently mapped in memory.
+        //! @see setMemoryMapped()
+        //!
+        bool isMemoryMapped() const { return _map_data != nullptr; }
+
+        //!
+        //! Read TS packets in place, without copy when possible.
+        //! When the file is mapped in memory, the returned view directly points into the mapped
+        //! file. Otherwise, the packets are read in an internal buffer of the TSFile object.
+        //! In both cases, the content of the view remains valid until the next read operation
+        //! on the file, or until the file is closed.
+        //! @param [out] view Returned view on the read packets. Packets in M2TS or RS204 format
+        //! are not contiguous in a mapped file, see ts::TSPacketView::stride().
+        //! @param [in] max_packets Maximum number of packets to read.
+        //! @param [in,out] report Where to report errors.
+        //! @return The actual number of read packets in @a view. Returning zero means error
+        //! or end of file repetition.
+        //!
+        size_t readPacketView(TSPacketView& view, size_t max_packets, Report& report);
+
         //!
         //! Abort any currenly read/write operation in progress.
         //! The file is left in a broken state and can be only closed.
@@ -196,7 +270,8 @@ namespace ts {
 
         //!
         //! Seek the file at a specified packet index.
-        //! The file must have been opened in rewindable mode.
+        //! The file must have been opened in rewindable mode or must be mapped
+        //! in memory and read only once (see isDirectAccess()).
         //! @param [in] packet_index Seek the file to this specified packet index
         //! (plus the specified @a start_offset from open()).
         //! @param [in,out] report Where to report errors.
@@ -207,6 +282,15 @@ namespace ts {
         // Override TSPacketStream implementation
         virtual size_t readPackets(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets, Report& report) override;
 
+    protected:
+        //!
+        //! Check if the file is mapped in memory, read only once, without artificial stuffing.
+        //! In that case, each packet index is a fixed location in the file and any packet
+        //! can be directly accessed using seek().
+        //! @return True if any packet can be directly accessed in the file.
+        //!
+        bool isDirectAccess() const;
+
     private:
         UString       _filename;         //!< Input file name.
         size_t        _repeat;           //!< Repeat count (0 means infinite)
@@ -224,6 +308,19 @@ namespace ts {
         bool          _rewindable;       //!< Opened in rewindable mode
         bool          _regular;          //!< Is a regular file (ie. not a pipe or special device)
         bool          _std_inout;        //!< File is standard input or output.
+        size_t        _async_depth;      //!< Asynchronous I/O queue depth, zero if disabled.
+        size_t        _async_size;       //!< Asynchronous I/O buffer size.
+        AsyncFileIO*  _async;            //!< Asynchronous I/O, when active.
+        bool          _direct;           //!< Direct I/O write mode is enabled.
+        uint64_t      _prealloc_size;    //!< Size to preallocate when the file is open for write.
+        bool          _preallocated;     //!< Disk space was preallocated, unused space to release on close.
+        bool          _mmap;             //!< Memory-mapped read mode is enabled.
+        uint8_t*      _map_data;         //!< Address of mapped file, null when not mapped.
+        size_t        _map_size;         //!< Size of the mapped file.
+        size_t        _map_pos;          //!< Current read position in the mapped file.
+        size_t        _map_advised;      //!< End of the area in the mapped file which was advised for read-ahead.
+        TSPacketVector         _view_packets;  //!< Internal buffer for readPacketView() when the file is not mapped.
+        TSPacketMetadataVector _view_mdata;    //!< Internal metadata for readPacketView() when the file is not mapped.
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle;           //!< File handle
 #else
@@ -245,6 +342,10 @@ namespace ts {
         bool openInternal(bool reopen, Report& report);
         bool seekCheck(Report& report);
         bool seekInternal(uint64_t index, Report& report);
+        bool setFileDirectIO(bool on) const;
+        TSPacketFormat detectMappedFormat(Report& report);
+        void adviseMap(bool restart);
+        void unmap();
 
         // Inaccessible operations.
         TSFile& operator=(TSFile&) = delete;
@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFileInputArgs.h"
+#include "tsAsyncFileIO.h"
 #include "tsAlgorithm.h"
 
 
@@ -47,6 +48,7 @@ ts::TSFileInputArgs::TSFileInputArgs() :
     _start_offset(0),
     _base_label(0),
     _file_format(TSPacketFormat::AUTODETECT),
+    _async_depth(0),
     _filenames(),
     _start_stuffing(),
     _stop_stuffing(),
@@ -84,6 +86,13 @@ void ts::TSFileInputArgs::defineArgs(Args& args)
               u"If several input files are specified, several options --add-stop-stuffing are allowed. "
               u"If there are less options than input files, the last value is used for subsequent files.");
 
+    args.option(u"async-io", 0, Args::INTEGER, 0, 1, 2, AsyncFileIO::MAX_QUEUE_DEPTH, true);
+    args.help(u"async-io", u"count",
+              u"Linux only: read regular files using asynchronous I/O (io_uring). "
+              u"The specified number of reads are kept in flight, ahead of the packet processing. "
+              u"The default count is " + UString::Decimal(AsyncFileIO::DEFAULT_QUEUE_DEPTH) + u". "
+              u"If asynchronous I/O is not available, the files are read in the usual way.");
+
     args.option(u"byte-offset", 'b', Args::UNSIGNED);
     args.help(u"byte-offset",
               u"Start reading each file at the specified byte offset (default: 0). "
@@ -144,6 +153,7 @@ bool ts::TSFileInputArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValues(_start_stuffing, u"add-start-stuffing");
     args.getIntValues(_stop_stuffing, u"add-stop-stuffing");
     _file_format = LoadTSPacketFormatInputOption(args);
+    _async_depth = args.present(u"async-io") ? args.intValue<size_t>(u"async-io", AsyncFileIO::DEFAULT_QUEUE_DEPTH) : 0;
 
     // If there is no file, then this is the standard input, an empty file name.
     if (_filenames.empty()) {
@@ -190,6 +200,7 @@ bool ts::TSFileInputArgs::openFile(size_t name_index, size_t file_index, Report&
 
     // Preset artificial stuffing.
     _files[file_index].setStuffing(_start_stuffing[name_index], _stop_stuffing[name_index]);
+    _files[file_index].setAsyncIO(_async_depth);
 
     // Actually open the file.
     return _files[file_index].openRead(name, _repeat_count, _start_offset, report, _file_format);
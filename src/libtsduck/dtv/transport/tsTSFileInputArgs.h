@@ -113,6 +113,7 @@ namespace ts {
         uint64_t            _start_offset;
         size_t              _base_label;
         TSPacketFormat      _file_format;
+        size_t              _async_depth;        // Asynchronous I/O queue depth, zero if disabled.
         UStringVector       _filenames;
         std::vector<size_t> _start_stuffing;
         std::vector<size_t> _stop_stuffing;
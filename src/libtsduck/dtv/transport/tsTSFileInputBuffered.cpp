@@ -44,7 +44,8 @@ ts::TSFileInputBuffered::TSFileInputBuffered(size_t buffer_size) :
     _metadata(_buffer.size()),
     _first_index(0),
     _current_offset(0),
-    _total_count(0)
+    _total_count(0),
+    _direct_end(0)
 {
 }
 
@@ -90,6 +91,7 @@ bool ts::TSFileInputBuffered::openRead(const UString& filename, size_t repeat_co
         _first_index = 0;
         _current_offset = 0;
         _total_count = 0;
+        _direct_end = 0;
         return TSFile::openRead(filename, repeat_count, start_offset, report, format);
     }
 }
@@ -113,7 +115,15 @@ bool ts::TSFileInputBuffered::open(const UString& filename, OpenFlags flags, Rep
 ts::PacketCounter ts::TSFileInputBuffered::readPacketsCount() const
 {
     // Make sure we do not report packets twice.
-    return isOpen() ? TSFile::readPacketsCount() - (_total_count - _current_offset) : 0;
+    if (!isOpen()) {
+        return 0;
+    }
+    else if (isDirectAccess()) {
+        return TSFile::readPacketsCount();
+    }
+    else {
+        return TSFile::readPacketsCount() - (_total_count - _current_offset);
+    }
 }
 
 
@@ -124,6 +134,10 @@ ts::PacketCounter ts::TSFileInputBuffered::readPacketsCount() const
 
 bool ts::TSFileInputBuffered::canSeek(PacketCounter pos) const
 {
+    if (isDirectAccess()) {
+        // All previously read packets are directly accessible in the file.
+        return pos <= _direct_end;
+    }
     const int64_t rel = int64_t(pos) - int64_t(readPacketsCount());
     return isOpen() &&
         ((rel >= 0 && uint64_t(_current_offset) + uint64_t(rel) <= uint64_t(_total_count)) ||
@@ -137,7 +151,14 @@ bool ts::TSFileInputBuffered::canSeek(PacketCounter pos) const
 
 bool ts::TSFileInputBuffered::seek(PacketCounter pos, Report& report)
 {
-    if (canSeek(pos)) {
+    if (isDirectAccess() && canSeek(pos)) {
+        if (!TSFile::seek(pos, report)) {
+            return false;
+        }
+        _total_read = pos;
+        return true;
+    }
+    else if (canSeek(pos)) {
         _current_offset = size_t(int64_t(_current_offset) + int64_t(pos) - int64_t(readPacketsCount()));
         return true;
     }
@@ -158,10 +179,13 @@ bool ts::TSFileInputBuffered::seekBackward(size_t packet_count, Report& report)
         report.error(u"file not open");
         return false;
     }
-    else if (packet_count > _current_offset) {
+    else if (packet_count > getBackwardSeekableCount()) {
         report.error(u"trying to seek TS input file backward too far");
         return false;
     }
+    else if (isDirectAccess()) {
+        return seek(readPacketsCount() - packet_count, report);
+    }
     else {
         _current_offset -= packet_count;
         return true;
@@ -175,10 +199,13 @@ bool ts::TSFileInputBuffered::seekForward(size_t packet_count, Report& report)
         report.error(u"file not open");
         return false;
     }
-    else if (_current_offset + packet_count > _total_count) {
+    else if (packet_count > getForwardSeekableCount()) {
         report.error(u"trying to seek TS input file forward too far");
         return false;
     }
+    else if (isDirectAccess()) {
+        return seek(readPacketsCount() + packet_count, report);
+    }
     else {
         _current_offset += packet_count;
         return true;
@@ -197,6 +224,13 @@ size_t ts::TSFileInputBuffered::read(TSPacket* user_buffer, size_t max_packets,
         return false;
     }
 
+    // In a directly accessed file, no need to keep a copy of the read packets.
+    if (isDirectAccess()) {
+        const size_t count = TSFile::readPackets(user_buffer, user_metadata, max_packets, report);
+        _direct_end = std::max(_direct_end, TSFile::readPacketsCount());
+        return count;
+    }
+
     const size_t buffer_size = _buffer.size();
 
     assert(_first_index < buffer_size);
@@ -44,6 +44,11 @@ namespace ts {
     //! This variant of TSFile allows to seek back and forth to some extent
     //! without doing I/O's and can work on non-seekable files (pipes for instance).
     //!
+    //! When the file is mapped in memory (see TSFile::setMemoryMapped()) and read
+    //! only once, the seekable buffer is not used. All previously read packets remain
+    //! directly accessible in the mapped file and seeking back is not limited by the
+    //! buffer size.
+    //!
     class TSDUCKDLL TSFileInputBuffered: public TSFile
     {
         TS_NOBUILD_NOCOPY(TSFileInputBuffered);
@@ -90,7 +95,7 @@ namespace ts {
         //! Get the number of TS packets in the buffer.
         //! @return The number of TS packets in the buffer.
         //!
-        size_t getBufferedCount() const { return isOpen() ? _total_count : 0; }
+        size_t getBufferedCount() const { return !isOpen() ? 0 : (isDirectAccess() ? size_t(_direct_end) : _total_count); }
 
         //!
         //! Open the file.
@@ -129,14 +134,14 @@ namespace ts {
         //! @return The buffer size from the highest previously read packet or
         //! the beginning of file, whichever comes first.
         //!
-        size_t getBackwardSeekableCount() const { return isOpen() ? _current_offset : 0; }
+        size_t getBackwardSeekableCount() const { return !isOpen() ? 0 : (isDirectAccess() ? size_t(readPacketsCount()) : _current_offset); }
 
         //!
         //! Get the forward seekable distance inside the buffer.
         //! This is the minimum guaranteed seekable distance.
         //! @return  The highest previously read packet index, before backward seek.
         //!
-        size_t getForwardSeekableCount() const { return isOpen() ? _total_count - _current_offset : 0; }
+        size_t getForwardSeekableCount() const { return !isOpen() ? 0 : (isDirectAccess() ? size_t(_direct_end - readPacketsCount()) : _total_count - _current_offset); }
 
         //!
         //! Seek the file backward the specified number of packets.
@@ -184,6 +189,7 @@ namespace ts {
         size_t                 _first_index;    // Index of first packet in buffer.
         size_t                 _current_offset; // Offset from _first_index of "current" readable packet
         size_t                 _total_count;    // Total count of valid packets in buffer.
+        PacketCounter          _direct_end;     // Highest read packet count in a directly accessed file.
 
         // Make sure that the generic open() returns an error.
         virtual bool open(const UString& filename, OpenFlags flags, Report& report, TSPacketFormat format) override;
@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFileOutputArgs.h"
+#include "tsAsyncFileIO.h"
 #include "tsNullReport.h"
 #include "tsFileUtils.h"
 #include "tsSysUtils.h"
@@ -44,6 +45,10 @@ ts::TSFileOutputArgs::TSFileOutputArgs(bool allow_stdout) :
     _name(),
     _flags(TSFile::NONE),
     _file_format(TSPacketFormat::TS),
+    _async_depth(0),
+    _direct_io(false),
+    _preallocate(false),
+    _prealloc_size(0),
     _reopen(false),
     _retry_interval(DEF_RETRY_INTERVAL),
     _retry_max(0),
@@ -53,7 +58,11 @@ ts::TSFileOutputArgs::TSFileOutputArgs(bool allow_stdout) :
     _max_duration(0),
     _max_files(0),
     _multiple_files(false),
-    _file(),
+    _files(),
+    _file(&_files[0]),
+    _next_file(&_files[1]),
+    _next_name(),
+    _next_failed(false),
     _name_gen(),
     _current_size(0),
     _next_open_time(),
@@ -88,6 +97,21 @@ void ts::TSFileOutputArgs::defineArgs(Args& args)
     args.option(u"append", 'a');
     args.help(u"append", u"If the file already exists, append to the end of the file. By default, existing files are overwritten.");
 
+    args.option(u"async-io", 0, Args::INTEGER, 0, 1, 2, AsyncFileIO::MAX_QUEUE_DEPTH, true);
+    args.help(u"async-io", u"count",
+              u"Linux only: write regular files using asynchronous I/O (io_uring). "
+              u"The specified number of writes are kept in flight, behind the packet processing. "
+              u"The default count is " + UString::Decimal(AsyncFileIO::DEFAULT_QUEUE_DEPTH) + u". "
+              u"If asynchronous I/O is not available, the files are written in the usual way.");
+
+    args.option(u"direct-io");
+    args.help(u"direct-io",
+              u"Linux only: write regular files using direct I/O (O_DIRECT), bypassing the page cache. "
+              u"Recording large files does not evict other data from the page cache and does not trigger periodic write-back stalls. "
+              u"The data are written from aligned buffers using asynchronous I/O, with at least two buffers (see also --async-io). "
+              u"With --max-duration or --max-size, the next file is created in advance, before the rotation. "
+              u"If direct I/O is not available, the files are written in the usual way.");
+
     args.option(u"keep", 'k');
     args.help(u"keep", u"Keep existing file (abort if the specified file already exists). By default, existing files are overwritten.");
 
@@ -123,6 +147,14 @@ void ts::TSFileOutputArgs::defineArgs(Args& args)
               u"When the number of created files exceeds the specified number, the oldest files are deleted. "
               u"By default, all created files are kept.");
 
+    args.option(u"preallocate", 0, Args::POSITIVE, 0, 1, 0, 0, true);
+    args.help(u"preallocate", u"bytes",
+              u"Linux only: preallocate the specified disk space in each output file when it is created. "
+              u"The unused part of the preallocated space is released when the file is closed. "
+              u"Without value, the preallocated size is the value of --max-size or, with --max-duration, "
+              u"an estimate based on the current file. "
+              u"With --max-duration or --max-size, the next file is created and preallocated in advance, before the rotation.");
+
     args.option(u"max-size", 0, Args::POSITIVE);
     args.help(u"max-size",
               u"Specify a maximum size in bytes for the output files. "
@@ -152,6 +184,10 @@ bool ts::TSFileOutputArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(_max_size, u"max-size", 0);
     args.getIntValue(_max_duration, u"max-duration", 0);
     _file_format = LoadTSPacketFormatOutputOption(args);
+    _async_depth = args.present(u"async-io") ? args.intValue<size_t>(u"async-io", AsyncFileIO::DEFAULT_QUEUE_DEPTH) : 0;
+    _direct_io = args.present(u"direct-io");
+    _preallocate = args.present(u"preallocate");
+    args.getIntValue(_prealloc_size, u"preallocate", 0);
     _multiple_files = _max_size > 0 || _max_duration > 0;
 
     _flags = TSFile::WRITE | TSFile::SHARED;
@@ -181,7 +217,7 @@ bool ts::TSFileOutputArgs::loadArgs(DuckContext& duck, Args& args)
 
 bool ts::TSFileOutputArgs::open(Report& report, AbortInterface* abort)
 {
-    if (_file.isOpen()) {
+    if (_file->isOpen()) {
         return false; // already open
     }
     if (_max_size > 0) {
@@ -192,7 +228,12 @@ bool ts::TSFileOutputArgs::open(Report& report, AbortInterface* abort)
     }
     _next_open_time = Time::CurrentUTC();
     _current_files.clear();
-    _file.setStuffing(_start_stuffing, _stop_stuffing);
+    _next_failed = false;
+    for (auto& file : _files) {
+        file.setStuffing(_start_stuffing, _stop_stuffing);
+        file.setAsyncIO(_async_depth);
+        file.setDirectIO(_direct_io);
+    }
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
     return openAndRetry(false, retry_allowed, report, abort);
 }
@@ -204,6 +245,11 @@ bool ts::TSFileOutputArgs::open(Report& report, AbortInterface* abort)
 
 bool ts::TSFileOutputArgs::close(Report& report)
 {
+    // Delete the next file if it was created in advance and not used.
+    if (_next_file->isOpen()) {
+        _next_file->close(report);
+        DeleteFile(_next_name, report);
+    }
     return closeAndCleanup(report);
 }
 
@@ -224,10 +270,21 @@ bool ts::TSFileOutputArgs::openAndRetry(bool initial_wait, size_t& retry_allowed
             SleepThread(_retry_interval);
         }
 
-        // Try to open the file.
-        const UString name(_multiple_files ? _name_gen.newFileName() : _name);
-        report.verbose(u"creating file %s", {name});
-        const bool success = _file.open(name, _flags, report, _file_format);
+        // Try to open the file. On rotation, use the next file if it was already created in advance.
+        UString name;
+        bool success = false;
+        if (_next_file->isOpen()) {
+            std::swap(_file, _next_file);
+            name = _next_name;
+            success = true;
+        }
+        else {
+            name = _multiple_files ? _name_gen.newFileName() : _name;
+            report.verbose(u"creating file %s", {name});
+            _file->setPreallocation(preallocationSize());
+            success = _file->open(name, _flags, report, _file_format);
+        }
+        _next_failed = false;
 
         // Remember the list of created files if we need to limit their number.
         if (success && _multiple_files && _max_files > 0) {
@@ -266,7 +323,7 @@ bool ts::TSFileOutputArgs::openAndRetry(bool initial_wait, size_t& retry_allowed
 bool ts::TSFileOutputArgs::closeAndCleanup(Report& report)
 {
     // Close the current file.
-    if (_file.isOpen() && !_file.close(report)) {
+    if (_file->isOpen() && !_file->close(report)) {
         return false;
     }
 
@@ -297,6 +354,58 @@ bool ts::TSFileOutputArgs::closeAndCleanup(Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Create the next file in advance when the current one is close to its rotation.
+//----------------------------------------------------------------------------
+
+void ts::TSFileOutputArgs::prepareNextFile(Report& report)
+{
+    // Only with preallocation or direct I/O, where creating a file is expensive.
+    if (!_multiple_files || (!_preallocate && !_direct_io) || _next_file->isOpen() || _next_failed) {
+        return;
+    }
+
+    // Create the next file when the current one reaches 7/8 of its maximum size or duration.
+    if ((_max_size > 0 && _current_size < _max_size - _max_size / 8) ||
+        (_max_duration > 0 && Time::CurrentUTC() < _next_open_time - _max_duration * MilliSecPerSec / 8))
+    {
+        return;
+    }
+
+    // With --max-duration, the name of the next file is based on its scheduled creation time.
+    _next_name = _max_duration > 0 ? _name_gen.newFileName(_next_open_time) : _name_gen.newFileName();
+    report.verbose(u"creating next file %s", {_next_name});
+    _next_file->setPreallocation(preallocationSize());
+    _next_failed = !_next_file->open(_next_name, _flags, report, _file_format);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the disk space to preallocate in the next file.
+//----------------------------------------------------------------------------
+
+uint64_t ts::TSFileOutputArgs::preallocationSize() const
+{
+    if (!_preallocate) {
+        return 0;
+    }
+    else if (_prealloc_size > 0) {
+        return _prealloc_size;
+    }
+    else if (_max_size > 0) {
+        return _max_size;
+    }
+    else if (_max_duration > 0 && _file->isOpen()) {
+        // Estimate the final size of the current file.
+        const MilliSecond elapsed = Time::CurrentUTC() - (_next_open_time - _max_duration * MilliSecPerSec);
+        return elapsed <= 0 ? 0 : _current_size * uint64_t(_max_duration * MilliSecPerSec) / uint64_t(elapsed);
+    }
+    else {
+        return 0;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Write packets.
 //----------------------------------------------------------------------------
@@ -318,11 +427,16 @@ bool ts::TSFileOutputArgs::write(const TSPacket* buffer, const TSPacketMetadata*
         }
 
         // Write some packets.
-        const PacketCounter where = _file.writePacketsCount();
-        const bool success = _file.writePackets(buffer, pkt_data, packet_count, report);
-        const size_t written = std::min(size_t(_file.writePacketsCount() - where), packet_count);
+        const PacketCounter where = _file->writePacketsCount();
+        const bool success = _file->writePackets(buffer, pkt_data, packet_count, report);
+        const size_t written = std::min(size_t(_file->writePacketsCount() - where), packet_count);
         _current_size += written * PKT_SIZE;
 
+        // Prepare the next file before rotation when necessary.
+        if (success) {
+            prepareNextFile(report);
+        }
+
         // In case of success or no retry, return now.
         if (success || !_reopen || (abort != nullptr && abort->aborting())) {
             return success;
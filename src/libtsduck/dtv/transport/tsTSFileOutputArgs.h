@@ -105,6 +105,10 @@ namespace ts {
         UString           _name;
         TSFile::OpenFlags _flags;
         TSPacketFormat    _file_format;
+        size_t            _async_depth;
+        bool              _direct_io;
+        bool              _preallocate;
+        uint64_t          _prealloc_size;
         bool              _reopen;
         MilliSecond       _retry_interval;
         size_t            _retry_max;
@@ -116,7 +120,11 @@ namespace ts {
         bool              _multiple_files;
 
         // Working data:
-        TSFile            _file;
+        TSFile            _files[2];      // Current and next file.
+        TSFile*           _file;          // Current file.
+        TSFile*           _next_file;     // Next file, created in advance before rotation.
+        UString           _next_name;     // Name of next file, when open.
+        bool              _next_failed;   // Failed to create the next file in advance, don't retry before rotation.
         FileNameGenerator _name_gen;
         uint64_t          _current_size;
         Time              _next_open_time;
@@ -128,5 +136,11 @@ namespace ts {
 
         // Close the current file, cleanup oldest files when necessary.
         bool closeAndCleanup(Report& report);
+
+        // Create the next file in advance when the current one is close to its rotation.
+        void prepareNextFile(Report& report);
+
+        // Get the disk space to preallocate in the next file.
+        uint64_t preallocationSize() const;
     };
 }
@@ -150,6 +150,12 @@ namespace ts {
         //!
         void resetPacketStream(TSPacketFormat format, AbstractReadStreamInterface* reader, AbstractWriteStreamInterface* writer);
 
+        //!
+        //! Set the packet format after an autodetection by a subclass.
+        //! @param [in] format The detected packet format.
+        //!
+        void setPacketFormat(TSPacketFormat format) { _format = format; }
+
         PacketCounter _total_read;   //!< Total read packets.
         PacketCounter _total_write;  //!< Total written packets.
 
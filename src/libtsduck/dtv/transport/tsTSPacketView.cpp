@@ -0,0 +1,158 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketView.h"
+#include "tsTSPacketMetadata.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TSPacketView::TSPacketView() :
+    _data(nullptr),
+    _count(0),
+    _stride(PKT_SIZE),
+    _header_size(0),
+    _format(TSPacketFormat::TS),
+    _stuffing(false),
+    _metadata(nullptr)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Distance between two packets in memory for a given format.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacketView::Stride(TSPacketFormat format)
+{
+    switch (format) {
+        case TSPacketFormat::AUTODETECT: return 0;
+        case TSPacketFormat::TS:         return PKT_SIZE;
+        case TSPacketFormat::M2TS:       return 4 + PKT_SIZE;
+        case TSPacketFormat::RS204:      return PKT_RS_SIZE;
+        case TSPacketFormat::DUCK:       return TSPacketMetadata::SERIALIZATION_SIZE + PKT_SIZE;
+        default:                         return 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Set the content of the view.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketView::clear()
+{
+    _data = nullptr;
+    _count = 0;
+    _stride = PKT_SIZE;
+    _header_size = 0;
+    _format = TSPacketFormat::TS;
+    _stuffing = false;
+    _metadata = nullptr;
+}
+
+void ts::TSPacketView::set(const uint8_t* data, size_t count, TSPacketFormat format, const TSPacketMetadata* metadata)
+{
+    assert(format != TSPacketFormat::AUTODETECT);
+    _data = data;
+    _count = count;
+    _stride = Stride(format);
+    _header_size = _stride - PKT_SIZE - (format == TSPacketFormat::RS204 ? RS_SIZE : 0);
+    _format = format;
+    _stuffing = false;
+    _metadata = metadata;
+}
+
+void ts::TSPacketView::setStuffing(size_t count)
+{
+    // The same null packet is repeated.
+    _data = NullPacket.b;
+    _count = count;
+    _stride = 0;
+    _header_size = 0;
+    _format = TSPacketFormat::TS;
+    _stuffing = true;
+    _metadata = nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the metadata of a packet in the view.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketView::getMetadata(size_t index, TSPacketMetadata& mdata) const
+{
+    if (_metadata != nullptr) {
+        mdata = _metadata[index];
+    }
+    else if (_format == TSPacketFormat::DUCK) {
+        mdata.deserialize(_data + index * _stride, TSPacketMetadata::SERIALIZATION_SIZE);
+    }
+    else {
+        mdata.reset();
+        if (_stuffing) {
+            mdata.setInputStuffing(true);
+        }
+        else if (_format == TSPacketFormat::M2TS) {
+            mdata.setInputTimeStamp(GetUInt32(_data + index * _stride) & 0x3FFFFFFF, SYSTEM_CLOCK_FREQ, TimeSource::M2TS);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Copy all packets of the view into a contiguous array.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketView::copy(TSPacket* buffer, TSPacketMetadata* metadata) const
+{
+    if (isContiguous()) {
+        TSPacket::Copy(buffer, _data, _count);
+    }
+    else {
+        for (size_t i = 0; i < _count; ++i) {
+            buffer[i] = (*this)[i];
+        }
+    }
+    if (metadata != nullptr) {
+        if (_metadata != nullptr) {
+            TSPacketMetadata::Copy(metadata, _metadata, _count);
+        }
+        else if (_format == TSPacketFormat::TS && !_stuffing) {
+            TSPacketMetadata::Reset(metadata, _count);
+        }
+        else {
+            for (size_t i = 0; i < _count; ++i) {
+                getMetadata(i, metadata[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,156 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  A read-only view on TS packets which are stored somewhere else in memory.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketFormat.h"
+
+namespace ts {
+
+    class TSPacketMetadata;
+
+    //!
+    //! A read-only view on contiguous TS packets which are stored somewhere else in memory.
+    //! @ingroup mpeg
+    //!
+    //! The packets are not copied. They are accessed in place, typically in a memory-mapped
+    //! file (see ts::TSFile::readPacketView()). The view does not own the memory. The view
+    //! is valid as long as the referenced memory is valid.
+    //!
+    //! Depending on the format of the packets in memory (see ts::TSPacketFormat), the packets
+    //! are not necessarily adjacent. In M2TS or DUCK format, each packet is preceded by a header.
+    //! In RS204 format, each packet is followed by a trailer. The view is "strided": the
+    //! distance in bytes between two consecutive packets is the @e stride of the view.
+    //!
+    class TSDUCKDLL TSPacketView
+    {
+    public:
+        //!
+        //! Default constructor, an empty view.
+        //!
+        TSPacketView();
+
+        //!
+        //! Clear the view, make it empty.
+        //!
+        void clear();
+
+        //!
+        //! Set the content of the view.
+        //! @param [in] data Address of the first packet, including its header, if any.
+        //! @param [in] count Number of packets.
+        //! @param [in] format Format of the packets in memory. In M2TS or DUCK format, @a data is the
+        //! address of the header of the first packet. The format cannot be AUTODETECT.
+        //! @param [in] metadata Optional address of an array of @a count metadata for the packets.
+        //! If not null, these metadata are returned instead of the metadata from the packet headers.
+        //!
+        void set(const uint8_t* data, size_t count, TSPacketFormat format = TSPacketFormat::TS, const TSPacketMetadata* metadata = nullptr);
+
+        //!
+        //! Set the content of the view as a sequence of artificial null packets.
+        //! The corresponding metadata are marked as input stuffing.
+        //! @param [in] count Number of null packets.
+        //!
+        void setStuffing(size_t count);
+
+        //!
+        //! Get the number of packets in the view.
+        //! @return The number of packets in the view.
+        //!
+        size_t size() const { return _count; }
+
+        //!
+        //! Check if the view is empty.
+        //! @return True if the view is empty.
+        //!
+        bool empty() const { return _count == 0; }
+
+        //!
+        //! Get the distance in bytes between two consecutive packets in the view.
+        //! @return The distance in bytes between two consecutive packets. This is
+        //! PKT_SIZE when the packets are adjacent in memory. This is zero for artificial
+        //! stuffing since the same null packet is repeated.
+        //!
+        size_t stride() const { return _stride; }
+
+        //!
+        //! Check if the packets in the view are adjacent in memory.
+        //! In that case, the address of the first packet can be used as an array of packets.
+        //! @return True if the packets in the view are adjacent in memory.
+        //!
+        bool isContiguous() const { return _stride == PKT_SIZE; }
+
+        //!
+        //! Access a packet in the view.
+        //! @param [in] index Index of the packet in the view. Must be lower than size().
+        //! @return A constant reference to the packet.
+        //!
+        const TSPacket& operator[](size_t index) const
+        {
+            return *reinterpret_cast<const TSPacket*>(_data + index * _stride + _header_size);
+        }
+
+        //!
+        //! Get the metadata of a packet in the view.
+        //! In M2TS or DUCK format, the metadata are extracted from the packet header.
+        //! @param [in] index Index of the packet in the view. Must be lower than size().
+        //! @param [out] mdata Metadata of the packet.
+        //!
+        void getMetadata(size_t index, TSPacketMetadata& mdata) const;
+
+        //!
+        //! Copy all packets of the view into a contiguous array.
+        //! @param [out] buffer Address of an array of at least size() packets.
+        //! @param [out] metadata Optional address of an array of at least size() metadata.
+        //! Ignored when null.
+        //!
+        void copy(TSPacket* buffer, TSPacketMetadata* metadata = nullptr) const;
+
+        //!
+        //! Get the distance in bytes between two consecutive packets in memory for a given format.
+        //! @param [in] format Format of the packets in memory.
+        //! @return The distance in bytes between two consecutive packets, zero for AUTODETECT.
+        //!
+        static size_t Stride(TSPacketFormat format);
+
+    private:
+        const uint8_t*          _data;         // Address of header of first packet.
+        size_t                  _count;        // Number of packets.
+        size_t                  _stride;       // Distance between two packets.
+        size_t                  _header_size;  // Size of header before each packet.
+        TSPacketFormat          _format;       // Format of packets in memory.
+        bool                    _stuffing;     // Artificial stuffing.
+        const TSPacketMetadata* _metadata;     // Optional external metadata.
+    };
+}
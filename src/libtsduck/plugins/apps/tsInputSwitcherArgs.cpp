@@ -67,7 +67,8 @@ ts::InputSwitcherArgs::InputSwitcherArgs() :
     allowedRemote(),
     receiveTimeout(0),
     inputs(),
-    output()
+    output(),
+    scheduling()
 {
 }
 
@@ -102,6 +103,8 @@ void ts::InputSwitcherArgs::enforceDefaults()
 
 void ts::InputSwitcherArgs::defineArgs(Args& args)
 {
+    scheduling.defineArgs(args);
+
     args.option(u"allow", 'a', Args::STRING);
     args.help(u"allow",
               u"Specify an IP address or host name which is allowed to send remote commands. "
@@ -304,6 +307,9 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
         args.error(u"invalid input index for --primary-input %d", {primaryInput});
     }
 
+    // CPU placement and scheduling of plugin threads.
+    scheduling.loadArgs(duck, args);
+
     return args.valid();
 }
 
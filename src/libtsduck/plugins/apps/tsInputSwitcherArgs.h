@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsPluginOptions.h"
+#include "tsPluginSchedulingArgs.h"
 #include "tsIPv4SocketAddress.h"
 
 namespace ts {
@@ -70,6 +71,7 @@ namespace ts {
         MilliSecond         receiveTimeout;    //!< Receive timeout before switch (0=none).
         PluginOptionsVector inputs;            //!< Input plugins descriptions.
         PluginOptions       output;            //!< Output plugin description.
+        PluginSchedulingArgs scheduling;       //!< CPU placement and scheduling of plugin threads.
 
         static constexpr size_t      DEFAULT_MAX_INPUT_PACKETS = 128;  //!< Default maximum input packets to read at a time.
         static constexpr size_t      MIN_INPUT_PACKETS = 1;            //!< Minimum input packets to read at a time.
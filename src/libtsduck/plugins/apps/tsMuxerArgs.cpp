@@ -53,6 +53,7 @@ ts::MuxerArgs::MuxerArgs() :
     appName(),
     inputs(),
     output(),
+    scheduling(),
     outputBitRate(0),
     patBitRate(DEFAULT_PSI_BITRATE),
     catBitRate(DEFAULT_PSI_BITRATE),
@@ -112,6 +113,8 @@ void ts::MuxerArgs::enforceDefaults()
 
 void ts::MuxerArgs::defineArgs(Args& args)
 {
+    scheduling.defineArgs(args);
+
     args.option<BitRate>(u"bitrate", 'b');
     args.help(u"bitrate",
               u"Specify the target constant output bitrate in bits per seconds. "
@@ -268,6 +271,9 @@ bool ts::MuxerArgs::loadArgs(DuckContext& duck, Args& args)
     // Get default options for TSDuck contexts in each plugin.
     duck.saveArgs(duckArgs);
 
+    // CPU placement and scheduling of plugin threads.
+    scheduling.loadArgs(duck, args);
+
     // Enforce defaults and other invalid values.
     enforceDefaults();
 
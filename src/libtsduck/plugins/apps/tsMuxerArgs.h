@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsPluginOptions.h"
+#include "tsPluginSchedulingArgs.h"
 
 namespace ts {
 
@@ -50,6 +51,7 @@ namespace ts {
         UString                appName;            //!< Application name, for help messages.
         PluginOptionsVector    inputs;             //!< Input plugins descriptions.
         PluginOptions          output;             //!< Output plugin description.
+        PluginSchedulingArgs   scheduling;         //!< CPU placement and scheduling of plugin threads.
         BitRate                outputBitRate;      //!< Target output bitrate.
         BitRate                patBitRate;         //!< Bitrate of output PAT.
         BitRate                catBitRate;         //!< Bitrate of output CAT.
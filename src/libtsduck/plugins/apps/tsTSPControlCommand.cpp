@@ -56,6 +56,15 @@ ts::TSPControlCommand::TSPControlCommand(Report& report) :
 
     arg = command(u"list", u"List all running plugins", u"[options]", flags);
 
+    arg = command(u"statistics", u"Display performance statistics of all plugins", u"[options]", flags);
+    arg->setIntro(u"Display the performance statistics of all plugins. "
+                  u"The statistics are collected only when tsp was started with option --plugin-statistics. "
+                  u"With --verbose, the histogram of call durations is also displayed.");
+    arg->option(u"json", 'j');
+    arg->help(u"json", u"Display the statistics as one line of JSON.");
+    arg->option(u"reset");
+    arg->help(u"reset", u"Reset the statistics of all plugins after displaying them.");
+
     arg = command(u"suspend", u"Suspend a plugin", u"[options] plugin-index", flags);
     arg->setIntro(u"Suspend a plugin. When a packet processing plugin is suspended, "
                   u"the TS packets are directly passed from the previous to the next plugin, "
@@ -32,8 +32,10 @@
 #include "tstspOutputExecutor.h"
 #include "tstspProcessorExecutor.h"
 #include "tstspControlServer.h"
+#include "tstspLatencyController.h"
 #include "tsMonotonic.h"
 #include "tsGuardMutex.h"
+#include "tsjsonObject.h"
 
 
 //----------------------------------------------------------------------------
@@ -49,8 +51,10 @@ ts::TSProcessor::TSProcessor(Report& report) :
     _input(nullptr),
     _output(nullptr),
     _control(nullptr),
+    _latency(nullptr),
     _packet_buffer(nullptr),
-    _metadata_buffer(nullptr)
+    _metadata_buffer(nullptr),
+    _last_statistics()
 {
 }
 
@@ -82,6 +86,13 @@ void ts::TSProcessor::cleanupInternal()
         proc->waitForTermination();
     } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
 
+    // Keep the final plugin statistics, the executors are deleted.
+    if (_args.plugin_stats) {
+        GuardMutex lock(_mutex);
+        _last_statistics = new json::Object;
+        _input->allStatisticsToJSON(*_last_statistics);
+    }
+
     // Deallocate all plugin executors.
     bool last = false;
     proc = _input;
@@ -96,6 +107,12 @@ void ts::TSProcessor::cleanupInternal()
     _input = nullptr;
     _output = nullptr;
 
+    // Deallocate the latency controller after all executors which use it.
+    if (_latency != nullptr) {
+        delete _latency;
+        _latency = nullptr;
+    }
+
     // Deallocate packet buffers.
     if (_packet_buffer != nullptr) {
         delete _packet_buffer;
@@ -140,10 +157,10 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // plugin has a hight priority to make room in the buffer, but not as
         // high as the input which must remain the top-most priority?
 
-        _input = new tsp::InputExecutor(_args, *this, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), _mutex, &_report);
+        _input = new tsp::InputExecutor(_args, *this, _args.input, _args.scheduling.apply(ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), 0), _mutex, &_report);
         CheckNonNull(_input);
 
-        _output = new tsp::OutputExecutor(_args, *this, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _mutex, &_report);
+        _output = new tsp::OutputExecutor(_args, *this, _args.output, _args.scheduling.apply(ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _args.plugins.size() + 1), _mutex, &_report);
         CheckNonNull(_output);
 
         _output->ringInsertAfter(_input);
@@ -152,7 +169,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         bool realtime = _args.realtime == Tristate::True || _input->isRealTime() || _output->isRealTime();
 
         for (size_t i = 0; i < _args.plugins.size(); ++i) {
-            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, ThreadAttributes(), _mutex, &_report);
+            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, _args.scheduling.apply(ThreadAttributes(), i + 1), _mutex, &_report);
             CheckNonNull(p);
             p->ringInsertBefore(_output);
             realtime = realtime || p->isRealTime();
@@ -167,6 +184,11 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // Adjust some default parameters.
         _args.applyDefaults(realtime);
 
+        // Adaptive batch sizes when a latency target is specified.
+        if (_args.latency_target > 0) {
+            _latency = new tsp::LatencyController(_args, _report);
+        }
+
         // Exit on error when initializing the plugins.
         if (_report.gotErrors()) {
             _report.debug(u"error when initializing the plugins");
@@ -179,6 +201,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         do {
             // Set realtime defaults.
             proc->setRealTimeForAll(realtime);
+            proc->setLatencyController(_latency);
             // Decode command line parameters for the plugin.
             if (!proc->plugin()->getOptions()) {
                 _report.debug(u"getOptions() error in plugin %s", {proc->pluginName()});
@@ -188,17 +211,24 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
 
         // Allocate a memory-resident buffer of TS packets
-        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE);
+        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE, _args.huge_pages, _args.numa_node);
         CheckNonNull(_packet_buffer);
         if (!_packet_buffer->isLocked()) {
             _report.debug(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
                           {_packet_buffer->lockErrorCode(), ts::SysErrorCodeMessage(_packet_buffer->lockErrorCode())});
         }
-        _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes", {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE});
+        if (_args.huge_pages && !_packet_buffer->hugePages()) {
+            _report.verbose(u"tsp: huge pages not available, using regular memory pages");
+        }
+        if (_args.numa_node != NUMA_NODE_NONE && _packet_buffer->numaNode() == NUMA_NODE_NONE) {
+            _report.verbose(u"tsp: cannot bind buffer to NUMA node, using default memory policy");
+        }
+        _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes, huge pages: %s, NUMA node: %d",
+                      {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE, _packet_buffer->hugePages(), _packet_buffer->numaNode()});
 
-        // Buffer for the packet metadata.
+        // Buffer for the packet metadata, using the same memory placement as the packet buffer.
         // A packet and its metadata have the same index in their respective buffer.
-        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
+        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count(), _args.huge_pages, _packet_buffer->numaNode());
         CheckNonNull(_metadata_buffer);
 
         // End of locked section.
@@ -214,6 +244,24 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         }
     }
 
+    // Group consecutive packet processing plugins in one thread when requested.
+    // This must be done after starting the plugins since their processing mode may depend on their options.
+    if (_args.fuse_plugins) {
+        tsp::ProcessorExecutor* leader = nullptr;
+        for (tsp::PluginExecutor* proc = _input->ringNext<tsp::PluginExecutor>(); proc != _output; proc = proc->ringNext<tsp::PluginExecutor>()) {
+            tsp::ProcessorExecutor* pe = dynamic_cast<tsp::ProcessorExecutor*>(proc);
+            if (pe == nullptr || !pe->canBeFused()) {
+                leader = nullptr;
+            }
+            else if (leader == nullptr) {
+                leader = pe;
+            }
+            else {
+                leader->fuse(pe);
+            }
+        }
+    }
+
     // Initialize packet buffer in the ring of executors.
     // Exit application in case of error.
     if (!_input->initAllBuffers(_packet_buffer, _metadata_buffer)) {
@@ -231,9 +279,13 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
     }
 
     // Start all plugin executors threads.
+    // Exit application in case of error.
     tsp::PluginExecutor* proc = _input;
     do {
-        proc->start();
+        if (!PluginSchedulingArgs::StartThread(*proc, _report)) {
+            cleanupInternal();
+            return false;
+        }
     } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
 
     // Create a control server thread. Display but ignore errors (not a fatal error).
@@ -256,6 +308,25 @@ bool ts::TSProcessor::isStarted()
 }
 
 
+//----------------------------------------------------------------------------
+// Get the performance statistics of all plugins.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::TSProcessor::pluginStatistics()
+{
+    GuardMutex lock(_mutex);
+
+    if (_input != nullptr && _args.plugin_stats) {
+        json::ValuePtr root(new json::Object);
+        _input->allStatisticsToJSON(*root);
+        return root;
+    }
+    else {
+        return _last_statistics;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Abort the processing.
 //----------------------------------------------------------------------------
@@ -37,6 +37,7 @@
 #include "tsTSProcessorArgs.h"
 #include "tsTSPacketMetadata.h"
 #include "tsMutex.h"
+#include "tsjson.h"
 
 namespace ts {
 
@@ -46,6 +47,7 @@ namespace ts {
         class InputExecutor;
         class OutputExecutor;
         class ControlServer;
+        class LatencyController;
     }
     //! @endcond
 
@@ -104,20 +106,31 @@ namespace ts {
         //!
         void waitForTermination();
 
+        //!
+        //! Get the performance statistics of all plugins (option -\-plugin-statistics).
+        //! Can be called during the processing. After termination, the final statistics
+        //! of the last processing are returned.
+        //! @return A JSON object containing an array named "plugins", one element per plugin
+        //! in plugin index order. Null pointer if no statistics were collected.
+        //!
+        json::ValuePtr pluginStatistics();
+
     private:
         // There is one global mutex for protected operations.
         // The resulting bottleneck of this single mutex is acceptable as long
         // as all protected operations are fast (pointer update, simple arithmetic).
 
-        Report&               _report;           // Common log object.
-        Mutex                 _mutex;            // Global mutex.
-        volatile bool         _terminating;      // In the process of terminating everything.
-        TSProcessorArgs       _args;             // Processing options.
-        tsp::InputExecutor*   _input;            // Input processor execution thread.
-        tsp::OutputExecutor*  _output;           // Output processor execution thread.
-        tsp::ControlServer*   _control;          // TSP control command server thread.
-        PacketBuffer*         _packet_buffer;    // Global TS packet buffer.
-        PacketMetadataBuffer* _metadata_buffer;  // Global packet metabata buffer.
+        Report&                 _report;           // Common log object.
+        Mutex                   _mutex;            // Global mutex.
+        volatile bool           _terminating;      // In the process of terminating everything.
+        TSProcessorArgs         _args;             // Processing options.
+        tsp::InputExecutor*     _input;            // Input processor execution thread.
+        tsp::OutputExecutor*    _output;           // Output processor execution thread.
+        tsp::ControlServer*     _control;          // TSP control command server thread.
+        tsp::LatencyController* _latency;          // Adaptive batch sizes for --latency-target.
+        PacketBuffer*           _packet_buffer;    // Global TS packet buffer.
+        PacketMetadataBuffer*   _metadata_buffer;  // Global packet metabata buffer.
+        json::ValuePtr          _last_statistics;  // Final plugin statistics of last processing.
 
         // Deallocate and cleanup internal resources.
         void cleanupInternal();
@@ -30,10 +30,12 @@
 #include "tsTSProcessorArgs.h"
 #include "tsPluginRepository.h"
 #include "tsArgsWithPlugins.h"
+#include "tsResidentBuffer.h"
 
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 constexpr size_t ts::TSProcessorArgs::DEFAULT_BUFFER_SIZE;
 constexpr size_t ts::TSProcessorArgs::MIN_BUFFER_SIZE;
+constexpr size_t ts::TSProcessorArgs::DEFAULT_HANDOFF_SPIN;
 #endif
 
 #define DEF_BITRATE_INTERVAL               5  // seconds
@@ -54,10 +56,20 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     ignore_jt(false),
     log_plugin_index(false),
     ts_buffer_size(DEFAULT_BUFFER_SIZE),
+    huge_pages(false),
+    numa_node(NUMA_NODE_NONE),
     max_flush_pkt(0),
+    latency_target(0),
     max_input_pkt(0),
     max_output_pkt(NPOS), // unlimited
     init_input_pkt(0),
+    lockfree_handoff(false),
+    handoff_spin(DEFAULT_HANDOFF_SPIN),
+    shard_threads(1),
+    fuse_plugins(false),
+    plugin_stats(false),
+    stats_interval(0),
+    stats_file(),
     instuff_nullpkt(0),
     instuff_inpkt(0),
     instuff_start(0),
@@ -76,7 +88,8 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     duck_args(),
     input(),
     plugins(),
-    output()
+    output(),
+    scheduling()
 {
 }
 
@@ -87,6 +100,8 @@ ts::TSProcessorArgs::TSProcessorArgs() :
 
 void ts::TSProcessorArgs::defineArgs(Args& args)
 {
+    scheduling.defineArgs(args);
+
     args.option(u"add-input-stuffing", 'a', Args::STRING);
     args.help(u"add-input-stuffing", u"nullpkt/inpkt",
               u"Specify that <nullpkt> null TS packets must be automatically inserted "
@@ -160,6 +175,29 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"Wait the specified number of milliseconds after the last input packet. "
               u"Zero means wait forever.");
 
+    args.option(u"fuse-plugins");
+    args.help(u"fuse-plugins",
+              u"Execute consecutive packet processing plugins in one single thread instead of one thread per plugin. "
+              u"Each packet goes through all plugins of a group before being passed to the next thread. "
+              u"This avoids thread handoffs and improves cache locality in long chains of lightweight plugins. "
+              u"Plugins which use packet windows or are executed in several threads (see --shard-threads) "
+              u"keep their own thread. Fused plugins can still be individually suspended, resumed or restarted "
+              u"using tspcontrol.");
+
+    args.option(u"handoff-spin-count", 0, Args::UNSIGNED);
+    args.help(u"handoff-spin-count",
+              u"With --lock-free-handoff, specify how many times a plugin thread polls for new packets "
+              u"before sleeping. Higher values reduce the wake-up latency at the expense of CPU usage. "
+              u"The default is " + UString::Decimal(DEFAULT_HANDOFF_SPIN) + u".");
+
+    args.option(u"huge-pages");
+    args.help(u"huge-pages",
+              u"Try to allocate the global buffer (see --buffer-size-mb) in huge memory pages to reduce TLB misses. "
+              u"Explicit huge pages are used first, when some are reserved in the system. "
+              u"Otherwise, transparent huge pages are used, when enabled in the system. "
+              u"Otherwise, the buffer uses regular memory pages. "
+              u"This option is currently implemented on Linux only.");
+
     args.option(u"ignore-joint-termination", 'i');
     args.help(u"ignore-joint-termination",
               u"Ignore all --joint-termination options in plugins. "
@@ -180,6 +218,21 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"a valid bitrate value from the beginning. "
               u"The default initial load is half the size of the global buffer.");
 
+    args.option(u"lock-free-handoff");
+    args.help(u"lock-free-handoff",
+              u"Pass packets from one plugin to the next one using atomic counters instead of a global lock. "
+              u"With long chains of plugins at high bitrates, this reduces the contention between plugin threads. "
+              u"A plugin thread which has no packet to process first polls for a short time "
+              u"(see --handoff-spin-count) and then sleeps until packets are available.");
+
+    args.option(u"latency-target", 0, Args::POSITIVE);
+    args.help(u"latency-target", u"milliseconds",
+              u"Adapt the number of packets per flush, input and output operation at run time to keep the "
+              u"end-to-end delay of packets inside tsp below the specified value. The batch sizes are reduced "
+              u"when the measured delay exceeds the target and increased again for throughput when the delay "
+              u"is well below the target, taking the bitrate into account. The values of --max-flushed-packets, "
+              u"--max-input-packets and --max-output-packets (or their defaults) become upper bounds.");
+
     args.option(u"log-plugin-index");
     args.help(u"log-plugin-index",
               u"In log messages, add the plugin index to the plugin name. "
@@ -214,6 +267,24 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"This option is useful only when an output plugin or device has problems with large output requests. "
               u"This option forces multiple smaller send operations.");
 
+    args.option(u"numa-node", 0, Enumeration({{u"local", NUMA_NODE_LOCAL}}));
+    args.help(u"numa-node", u"local|node",
+              u"Allocate the physical memory of the global buffer on the specified NUMA node. "
+              u"The value 'local' designates the NUMA node of the CPU on which tsp starts. "
+              u"Use this option with CPU affinity of the tsp process on the same NUMA node "
+              u"(numactl or taskset commands for instance) to avoid cross-socket memory traffic. "
+              u"By default, the system memory policy applies. "
+              u"This option is currently implemented on Linux only.");
+
+    args.option(u"plugin-statistics");
+    args.help(u"plugin-statistics",
+              u"Collect performance statistics in each plugin: number of calls and packets, "
+              u"time spent in the plugin, time spent waiting for packets, high-water mark of "
+              u"the plugin area in the global buffer, histogram of the call durations. "
+              u"The statistics can be displayed using the tspcontrol command 'statistics' "
+              u"(see option --control-port) or periodically reported using --statistics-interval. "
+              u"Collecting statistics has a small cost in CPU usage.");
+
     args.option(u"realtime", 'r', Args::TRISTATE, 0, 1, -255, 256, true);
     args.help(u"realtime",
               u"Specifies if tsp and all plugins should use default values for real-time "
@@ -223,6 +294,23 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"are enforced. The explicit values 'no', 'false', 'off' are used to enforce "
               u"the offline defaults and the explicit values 'yes', 'true', 'on' are used "
               u"to enforce the real-time defaults.");
+
+    args.option(u"shard-threads", 0, Args::POSITIVE);
+    args.help(u"shard-threads", u"count",
+              u"Specify the number of threads which are used by each packet processing plugin "
+              u"which can process packets in parallel. Only some plugins support it. "
+              u"The packets are distributed over all threads but their order is preserved. "
+              u"The default is 1, meaning that all packets are processed in the plugin thread.");
+
+    args.option(u"statistics-file", 0, Args::FILENAME);
+    args.help(u"statistics-file",
+              u"With --statistics-interval, append the periodic JSON reports in the specified file, "
+              u"one line per report. By default, the JSON reports are logged.");
+
+    args.option(u"statistics-interval", 0, Args::POSITIVE);
+    args.help(u"statistics-interval", u"milliseconds",
+              u"Periodically report the performance statistics of all plugins as one line of JSON. "
+              u"This option implies --plugin-statistics.");
 }
 
 
@@ -235,12 +323,22 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     app_name = args.appName();
     log_plugin_index = args.present(u"log-plugin-index");
     ts_buffer_size = args.intValue<size_t>(u"buffer-size-mb", DEFAULT_BUFFER_SIZE);
+    huge_pages = args.present(u"huge-pages");
+    args.getIntValue(numa_node, u"numa-node", NUMA_NODE_NONE);
     args.getValue(fixed_bitrate, u"bitrate", 0);
     bitrate_adj = MilliSecPerSec * args.intValue(u"bitrate-adjust-interval", DEF_BITRATE_INTERVAL);
     args.getIntValue(max_flush_pkt, u"max-flushed-packets", 0);
+    args.getIntValue(latency_target, u"latency-target", 0);
     args.getIntValue(max_input_pkt, u"max-input-packets", 0);
     args.getIntValue(max_output_pkt, u"max-output-packets", NPOS); // unlimited by default
     args.getIntValue(init_input_pkt, u"initial-input-packets", 0);
+    lockfree_handoff = args.present(u"lock-free-handoff");
+    args.getIntValue(handoff_spin, u"handoff-spin-count", DEFAULT_HANDOFF_SPIN);
+    args.getIntValue(shard_threads, u"shard-threads", 1);
+    fuse_plugins = args.present(u"fuse-plugins");
+    args.getIntValue(stats_interval, u"statistics-interval", 0);
+    args.getValue(stats_file, u"statistics-file");
+    plugin_stats = stats_interval > 0 || args.present(u"plugin-statistics");
     args.getIntValue(instuff_start, u"add-start-stuffing", 0);
     args.getIntValue(instuff_stop, u"add-stop-stuffing", 0);
     ignore_jt = args.present(u"ignore-joint-termination");
@@ -300,6 +398,9 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     // Get default options for TSDuck contexts in each plugin.
     duck.saveArgs(duck_args);
 
+    // CPU placement and scheduling of plugin threads.
+    scheduling.loadArgs(duck, args);
+
     return args.valid();
 }
 
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsPluginOptions.h"
+#include "tsPluginSchedulingArgs.h"
 #include "tsIPv4Address.h"
 
 namespace ts {
@@ -52,10 +53,20 @@ namespace ts {
         bool              ignore_jt;        //!< Ignore "joint termination" options in plugins.
         bool              log_plugin_index; //!< Log plugin index with plugin name.
         size_t            ts_buffer_size;   //!< Size in bytes of the global TS packet buffer.
+        bool              huge_pages;       //!< Try to allocate the global TS packet buffer in huge pages.
+        int               numa_node;        //!< NUMA node for the global TS packet buffer, NUMA_NODE_NONE or NUMA_NODE_LOCAL (see ResidentBuffer).
         size_t            max_flush_pkt;    //!< Max processed packets before flush.
+        MilliSecond       latency_target;   //!< Target end-to-end delay, adapt the batch sizes (zero means fixed batch sizes).
         size_t            max_input_pkt;    //!< Max packets per input operation.
         size_t            max_output_pkt;   //!< Max packets per outsput operation.
         size_t            init_input_pkt;   //!< Initial number of input packets to read before starting the processing (zero means default).
+        bool              lockfree_handoff; //!< Pass packets between plugin executors using atomic counters instead of the global mutex.
+        size_t            handoff_spin;     //!< With @a lockfree_handoff, number of spin iterations before waiting for packets.
+        size_t            shard_threads;    //!< Number of threads for packet processing plugins which allow sharding (1 means no sharding).
+        bool              fuse_plugins;     //!< Execute consecutive packet processing plugins in one single thread when possible.
+        bool              plugin_stats;     //!< Collect performance statistics in each plugin executor.
+        MilliSecond       stats_interval;   //!< Interval between periodic JSON reports of plugin statistics (zero means none).
+        UString           stats_file;       //!< File receiving the periodic JSON reports of plugin statistics (empty means log).
         size_t            instuff_nullpkt;  //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
         size_t            instuff_inpkt;    //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
         size_t            instuff_start;    //!< Add input stuffing: add @a instuff_start null packets before actual input.
@@ -75,9 +86,11 @@ namespace ts {
         PluginOptions          input;       //!< Input plugin description.
         PluginOptionsVector    plugins;     //!< Packet processor plugins descriptions.
         PluginOptions          output;      //!< Output plugin description.
+        PluginSchedulingArgs   scheduling;  //!< CPU placement and scheduling of plugin threads.
 
         static constexpr size_t DEFAULT_BUFFER_SIZE = 16 * 1000000;  //!< Default size in bytes of global TS buffer.
         static constexpr size_t MIN_BUFFER_SIZE = 18800;             //!< Minimum size in bytes of global TS buffer.
+        static constexpr size_t DEFAULT_HANDOFF_SPIN = 100;          //!< Default number of spin iterations with lock-free handoff.
 
         //!
         //! Constructor.
@@ -0,0 +1,246 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPluginSchedulingArgs.h"
+#include "tsPluginThread.h"
+#include "tsCPUTopology.h"
+#include "tsArgs.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PluginSchedulingArgs::PluginSchedulingArgs() :
+    auto_placement(false),
+    affinity(),
+    policies(),
+    priorities(),
+    _placement()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Define command line options in an Args.
+//----------------------------------------------------------------------------
+
+void ts::PluginSchedulingArgs::defineArgs(Args& args)
+{
+    args.option(u"cpu-affinity", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"cpu-affinity", u"[index:]cpu-list",
+              u"Execute the thread of a plugin on the specified list of CPU's only. "
+              u"The list is a comma-separated list of CPU indexes or ranges of indexes, for instance '0-3,8'. "
+              u"The optional prefix 'index:' specifies the index of the plugin in the command line, "
+              u"starting at 0 for the first plugin (the input plugin in tsp). "
+              u"Without index, the CPU list applies to all plugins which have no explicit affinity. "
+              u"Several --cpu-affinity options are allowed. "
+              u"This option is currently implemented on Linux and Windows only.");
+
+    args.option(u"cpu-placement");
+    args.help(u"cpu-placement",
+              u"Automatically place each plugin thread on one CPU. Adjacent plugins in the chain are placed on "
+              u"distinct physical cores which share the same cache (L3, then L2) when possible. "
+              u"The topology of the CPU's and caches is read from the system. "
+              u"The plugins with an explicit --cpu-affinity are not affected. "
+              u"This option is currently implemented on Linux and Windows only.");
+
+    args.option(u"scheduling-policy", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"scheduling-policy", u"[index:]fifo|rr|default",
+              u"Use the specified scheduling policy for the thread of a plugin. "
+              u"The policies 'fifo' and 'rr' (round-robin) are real-time policies which usually require privileges. "
+              u"The policy 'default' uses the scheduling policy of the tsp process. "
+              u"The optional prefix 'index:' is the plugin index, as in --cpu-affinity. "
+              u"Without index, the policy applies to all plugins which have no explicit policy. "
+              u"Several --scheduling-policy options are allowed. "
+              u"This option is currently implemented on POSIX systems (Linux, macOS) only.");
+
+    args.option(u"scheduling-priority", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"scheduling-priority", u"[index:]value",
+              u"With a real-time --scheduling-policy, specify the system priority of the thread of a plugin "
+              u"(from 1 to 99 on Linux). By default, use the middle of the range of priorities. "
+              u"The optional prefix 'index:' is the plugin index, as in --cpu-affinity. "
+              u"Several --scheduling-priority options are allowed.");
+}
+
+
+//----------------------------------------------------------------------------
+// Load arguments from command line.
+//----------------------------------------------------------------------------
+
+bool ts::PluginSchedulingArgs::loadArgs(DuckContext& duck, Args& args)
+{
+    auto_placement = args.present(u"cpu-placement");
+    affinity.clear();
+    policies.clear();
+    priorities.clear();
+    _placement.clear();
+
+    size_t index = NPOS;
+    UString value;
+
+    const size_t cpu_count = CPUTopology::ConfiguredCPUCount();
+    for (size_t i = 0; i < args.count(u"cpu-affinity"); ++i) {
+        CPUSet cpus;
+        if (!SplitIndex(index, value, args.value(u"cpu-affinity", u"", i)) || !CPUTopology::ParseCPUList(cpus, value, cpu_count) || cpus.empty()) {
+            args.error(u"invalid value for --cpu-affinity, use \"[index:]cpu-list\" with CPU indexes in 0-%d", {cpu_count - 1});
+        }
+        else {
+            affinity[index] = cpus;
+        }
+    }
+
+    for (size_t i = 0; i < args.count(u"scheduling-policy"); ++i) {
+        if (!SplitIndex(index, value, args.value(u"scheduling-policy", u"", i))) {
+            args.error(u"invalid value for --scheduling-policy, use \"[index:]policy\"");
+        }
+        else if (value.similar(u"fifo")) {
+            policies[index] = ThreadAttributes::SchedulingPolicy::FIFO;
+        }
+        else if (value.similar(u"rr") || value.similar(u"round-robin")) {
+            policies[index] = ThreadAttributes::SchedulingPolicy::ROUND_ROBIN;
+        }
+        else if (value.similar(u"default")) {
+            policies[index] = ThreadAttributes::SchedulingPolicy::DEFAULT;
+        }
+        else {
+            args.error(u"invalid scheduling policy \"%s\", use fifo, rr or default", {value});
+        }
+    }
+
+    for (size_t i = 0; i < args.count(u"scheduling-priority"); ++i) {
+        int priority = 0;
+        if (!SplitIndex(index, value, args.value(u"scheduling-priority", u"", i)) || !value.toInteger(priority) || priority <= 0) {
+            args.error(u"invalid value for --scheduling-priority, use \"[index:]value\"");
+        }
+        else {
+            priorities[index] = priority;
+        }
+    }
+
+    // Compute the automatic placement once, from the topology of the system.
+    if (auto_placement) {
+        _placement = CPUTopology().placementOrder();
+        UStringList order;
+        for (auto cpu : _placement) {
+            order.push_back(UString::Decimal(cpu));
+        }
+        args.debug(u"automatic CPU placement order: %s", {UString::Join(order)});
+    }
+
+    return args.valid();
+}
+
+
+//----------------------------------------------------------------------------
+// Split a "[index:]value" option value.
+//----------------------------------------------------------------------------
+
+bool ts::PluginSchedulingArgs::SplitIndex(size_t& index, UString& value, const UString& option_value)
+{
+    const size_t colon = option_value.find(u':');
+    index = NPOS;
+    if (colon == NPOS) {
+        value = option_value;
+        return true;
+    }
+    else {
+        value = option_value.substr(colon + 1);
+        return option_value.substr(0, colon).toInteger(index);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the value for a plugin in a map.
+//----------------------------------------------------------------------------
+
+template <typename T>
+const T* ts::PluginSchedulingArgs::Get(const std::map<size_t,T>& map, size_t plugin_index)
+{
+    auto it = map.find(plugin_index);
+    if (it == map.end()) {
+        it = map.find(NPOS);
+    }
+    return it == map.end() ? nullptr : &it->second;
+}
+
+
+//----------------------------------------------------------------------------
+// Apply the options to the attributes of a plugin thread.
+//----------------------------------------------------------------------------
+
+ts::ThreadAttributes ts::PluginSchedulingArgs::apply(const ThreadAttributes& base, size_t plugin_index) const
+{
+    ThreadAttributes attributes(base);
+
+    // CPU affinity: explicit for this plugin, automatic placement, explicit for all plugins.
+    const auto explicit_cpus = affinity.find(plugin_index);
+    const CPUSet* cpus = nullptr;
+    if (explicit_cpus != affinity.end()) {
+        attributes.setCPUAffinity(explicit_cpus->second);
+    }
+    else if (!_placement.empty()) {
+        attributes.setCPUAffinity(CPUSet({_placement[plugin_index % _placement.size()]}));
+    }
+    else if ((cpus = Get(affinity, plugin_index)) != nullptr) {
+        attributes.setCPUAffinity(*cpus);
+    }
+
+    // Scheduling policy.
+    const ThreadAttributes::SchedulingPolicy* policy = Get(policies, plugin_index);
+    const int* priority = Get(priorities, plugin_index);
+    if (policy != nullptr) {
+        attributes.setSchedulingPolicy(*policy, priority == nullptr ? 0 : *priority);
+    }
+    return attributes;
+}
+
+
+//----------------------------------------------------------------------------
+// Start the thread of a plugin, with fallback to the default scheduling.
+//----------------------------------------------------------------------------
+
+bool ts::PluginSchedulingArgs::StartThread(PluginThread& thread, Report& report)
+{
+    if (thread.start()) {
+        return true;
+    }
+    ThreadAttributes attr;
+    thread.getAttributes(attr);
+    if (attr.getSchedulingPolicy() != ThreadAttributes::SchedulingPolicy::DEFAULT) {
+        report.warning(u"cannot use the requested scheduling policy for plugin %s, using default scheduling", {thread.pluginName()});
+        attr.setSchedulingPolicy(ThreadAttributes::SchedulingPolicy::DEFAULT);
+        if (thread.setAttributes(attr) && thread.start()) {
+            return true;
+        }
+    }
+    report.error(u"cannot start the thread of plugin %s", {thread.pluginName()});
+    return false;
+}
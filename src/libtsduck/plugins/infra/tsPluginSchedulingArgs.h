@@ -0,0 +1,124 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Command line options for the CPU placement and scheduling of plugin threads.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsThreadAttributes.h"
+
+namespace ts {
+
+    class Args;
+    class DuckContext;
+    class PluginThread;
+    class Report;
+
+    //!
+    //! Command line options for the CPU placement and scheduling of plugin threads.
+    //! @ingroup plugin
+    //!
+    //! These options are used by applications which run one thread per plugin (tsp, tsswitch, tsmux).
+    //! Plugins are identified by their index in the command line, starting at zero.
+    //!
+    class TSDUCKDLL PluginSchedulingArgs
+    {
+    public:
+        //!
+        //! Map of per-plugin CPU affinity, indexed by plugin index. Index NPOS applies to all plugins.
+        //!
+        typedef std::map<size_t, CPUSet> AffinityMap;
+
+        //!
+        //! Map of per-plugin scheduling policy, indexed by plugin index. Index NPOS applies to all plugins.
+        //!
+        typedef std::map<size_t, ThreadAttributes::SchedulingPolicy> PolicyMap;
+
+        //!
+        //! Map of per-plugin real-time priority, indexed by plugin index. Index NPOS applies to all plugins.
+        //!
+        typedef std::map<size_t, int> PriorityMap;
+
+        // Public fields
+        bool        auto_placement; //!< Automatically place adjacent plugins on CPU's which share caches.
+        AffinityMap affinity;       //!< Explicit CPU affinity, override automatic placement.
+        PolicyMap   policies;       //!< Explicit scheduling policy.
+        PriorityMap priorities;     //!< Priority in explicit real-time scheduling policy.
+
+        //!
+        //! Default constructor.
+        //!
+        PluginSchedulingArgs();
+
+        //!
+        //! Add command line option definitions in an Args.
+        //! @param [in,out] args Command line arguments to update.
+        //!
+        void defineArgs(Args& args);
+
+        //!
+        //! Load arguments from command line.
+        //! Args error indicator is set in case of incorrect arguments.
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in,out] args Command line arguments.
+        //! @return True on success, false on error in argument line.
+        //!
+        bool loadArgs(DuckContext& duck, Args& args);
+
+        //!
+        //! Apply the CPU placement and scheduling options to the attributes of a plugin thread.
+        //! @param [in] attributes Base thread attributes.
+        //! @param [in] plugin_index Index of the plugin in the command line, starting at zero.
+        //! @return A copy of @a attributes with CPU affinity and scheduling policy.
+        //!
+        ThreadAttributes apply(const ThreadAttributes& attributes, size_t plugin_index) const;
+
+        //!
+        //! Start the thread of a plugin.
+        //! A real-time scheduling policy usually requires privileges. If the thread cannot be
+        //! created with its explicit scheduling policy, fall back to the default policy of the process.
+        //! @param [in,out] thread The plugin thread to start.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        static bool StartThread(PluginThread& thread, Report& report);
+
+    private:
+        std::vector<size_t> _placement;  // Ordered list of CPU's for automatic placement.
+
+        // Split a "[index:]value" option value. The index is NPOS when unspecified.
+        static bool SplitIndex(size_t& index, UString& value, const UString& option_value);
+
+        // Get the value for a plugin in a map, either for this index or for all plugins.
+        template <typename T>
+        static const T* Get(const std::map<size_t,T>& map, size_t plugin_index);
+    };
+}
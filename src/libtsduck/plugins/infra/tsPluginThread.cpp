@@ -134,6 +134,11 @@ ts::Plugin* ts::PluginThread::plugin() const
     return _shlib;
 }
 
+void ts::PluginThread::getThreadAttributes(ThreadAttributes& attributes)
+{
+    getAttributes(attributes);
+}
+
 
 //----------------------------------------------------------------------------
 // Invoked by the plugin shared library to log messages.
@@ -88,6 +88,7 @@ namespace ts {
         // Implementation of TSP virtual methods.
         virtual UString pluginName() const override;
         virtual Plugin* plugin() const override;
+        virtual void getThreadAttributes(ThreadAttributes& attributes) override;
 
     protected:
         // Inherited from Report (via TSP)
@@ -59,3 +59,8 @@ bool ts::TSP::aborting() const
 {
     return _tsp_aborting;
 }
+
+void ts::TSP::getThreadAttributes(ThreadAttributes& attributes)
+{
+    attributes = ThreadAttributes();
+}
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsReport.h"
 #include "tsAbortInterface.h"
+#include "tsThreadAttributes.h"
 #include "tsTS.h"
 
 namespace ts {
@@ -206,6 +207,15 @@ namespace ts {
         //!
         virtual bool thisJointTerminated() const = 0;
 
+        //!
+        //! Get the attributes of the thread which executes the plugin.
+        //! A plugin which creates its own processing threads should use the same
+        //! CPU affinity and scheduling attributes as the plugin thread.
+        //! The default implementation returns the default thread attributes.
+        //! @param [out] attributes Attributes of the plugin thread.
+        //!
+        virtual void getThreadAttributes(ThreadAttributes& attributes);
+
         //!
         //! Virtual desctructor.
         //!
@@ -216,7 +226,7 @@ namespace ts {
         BitRate           _tsp_bitrate;             //!< TSP input bitrate.
         BitRateConfidence _tsp_bitrate_confidence;  //!< TSP input bitrate confidence.
         MilliSecond       _tsp_timeout;             //!< Timeout when waiting for packets (infinite by default).
-        volatile bool     _tsp_aborting;            //!< TSP is currently aborting.
+        std::atomic<bool> _tsp_aborting;            //!< TSP is currently aborting, read and written by all executor threads.
 
         //!
         //! Constructor for subclasses.
@@ -57,11 +57,15 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
     _packets_0(0),
     _start_1(Time::Epoch),
     _packets_1(0),
+    _datagram_size(std::max(buffer_size, 7 * PKT_SIZE)),
+    _dgram_count(0),
+    _dgram_next(0),
     _inbuf_count(0),
-    _inbuf_next(0),
+    _inbuf_next(nullptr),
     _mdata_next(0),
-    _inbuf(std::max(buffer_size, 7 * PKT_SIZE)),
-    _mdata(_inbuf.size() / PKT_SIZE)
+    _inbuf(_datagram_size),
+    _dgrams(1),
+    _mdata(_datagram_size / PKT_SIZE)
 {
     if (_real_time) {
         option(u"display-interval", 'd', POSITIVE);
@@ -113,6 +117,16 @@ bool ts::AbstractDatagramInputPlugin::isRealTime()
 }
 
 
+//----------------------------------------------------------------------------
+// Set the maximum number of datagram messages to receive at once.
+//----------------------------------------------------------------------------
+
+void ts::AbstractDatagramInputPlugin::setDatagramBatch(size_t count)
+{
+    _dgrams.resize(std::max<size_t>(count, 1));
+}
+
+
 //----------------------------------------------------------------------------
 // Input command line options method
 //----------------------------------------------------------------------------
@@ -135,7 +149,9 @@ bool ts::AbstractDatagramInputPlugin::getOptions()
 bool ts::AbstractDatagramInputPlugin::start()
 {
     // Initialize working data.
-    _inbuf_count = _inbuf_next = _mdata_next = 0;
+    _inbuf.resize(_dgrams.size() * _datagram_size);
+    _dgram_count = _dgram_next = _inbuf_count = _mdata_next = 0;
+    _inbuf_next = nullptr;
     _start = _start_0 = _start_1 = _next_display = Time::Epoch;
     _packets = _packets_0 = _packets_1 = 0;
     return true;
@@ -168,88 +184,137 @@ ts::BitRateConfidence ts::AbstractDatagramInputPlugin::getBitrateConfidence()
 
 
 //----------------------------------------------------------------------------
-// Input method
+// Receive several datagram messages at once. Default implementation.
 //----------------------------------------------------------------------------
 
-size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+bool ts::AbstractDatagramInputPlugin::receiveDatagrams(uint8_t* buffer, size_t datagram_size, size_t max_count, Datagram* datagrams, size_t& ret_count)
 {
-    MicroSecond timestamp = -1;
+    ret_count = 0;
+    if (max_count == 0 || !receiveDatagram(buffer, datagram_size, datagrams[0].size, datagrams[0].timestamp)) {
+        return false;
+    }
+    datagrams[0].data = buffer;
+    ret_count = 1;
+    return true;
+}
+
 
-    // Check if we receive new packets or process remain of previous buffer.
-    bool new_packets = false;
+//----------------------------------------------------------------------------
+// Locate TS packets in a datagram message, build their metadata.
+//----------------------------------------------------------------------------
 
-    // If there is no remaining packet in the input buffer, wait for a datagram message.
-    // Loop until we get some TS packets.
-    while (_inbuf_count == 0) {
+bool ts::AbstractDatagramInputPlugin::processDatagram(const Datagram& dgram)
+{
+    // Look for TS packets in the UDP message.
+    size_t start_index = 0;
+    if (!TSPacket::Locate(dgram.data, dgram.size, start_index, _inbuf_count)) {
+        _inbuf_count = 0;
+        return false;
+    }
+    _inbuf_next = dgram.data + start_index;
+
+    // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
+    // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
+    const bool rtp = start_index >= RTP_HEADER_SIZE && (dgram.data[1] & 0x7F) == RTP_PT_MP2T;
+    const uint32_t rtp_timestamp = rtp ? GetUInt32(dgram.data + 4) : 0;
+    const MicroSecond timestamp = dgram.timestamp;
+
+    // Use RTP time stamp if there is one and RTP is the preferred choice.
+    bool use_rtp = false;
+    bool use_kernel = false;
+    switch (_time_priority) {
+        case RTP_SYSTEM_TSP:
+            use_rtp = rtp;
+            use_kernel = !rtp && timestamp >= 0;
+            break;
+        case SYSTEM_RTP_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = !use_kernel && rtp;
+            break;
+        case RTP_TSP:
+            use_rtp = rtp;
+            use_kernel = false;
+            break;
+        case SYSTEM_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = false;
+            break;
+        case TSP_ONLY:
+        default:
+            use_rtp = false;
+            use_kernel = false;
+            break;
+    }
 
-        // Wait for a datagram message
-        size_t insize = 0;
-        if (!receiveDatagram(_inbuf.data(), _inbuf.size(), insize, timestamp)) {
-            return 0;
+    // Build time stamps in packet metadata.
+    _mdata_next = 0;
+    for (size_t i = 0; i < _inbuf_count; ++i) {
+        if (use_rtp) {
+            // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
+            _mdata[i].setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
+        }
+        else if (use_kernel) {
+            // IP time stamp unit is microseconds.
+            _mdata[i].setInputTimeStamp(uint64_t(timestamp), MicroSecPerSec, TimeSource::KERNEL);
+        }
+        else {
+            _mdata[i].clearInputTimeStamp();
         }
+    }
+    return true;
+}
 
-        // Look for TS packets in the UDP message.
-        new_packets = TSPacket::Locate(_inbuf.data(), insize, _inbuf_next, _inbuf_count);
 
-        if (new_packets) {
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
 
-            // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
-            // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
-            const bool rtp = _inbuf_next >= RTP_HEADER_SIZE && (_inbuf[1] & 0x7F) == RTP_PT_MP2T;
-            const uint32_t rtp_timestamp = rtp ? GetUInt32(_inbuf.data() + 4) : 0;
+size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    // Number of returned packets and newly received packets.
+    size_t pkt_cnt = 0;
+    size_t new_packets = 0;
 
-            // Use RTP time stamp if there is one and RTP is the preferred choice.
-            bool use_rtp = false;
-            bool use_kernel = false;
-            switch (_time_priority) {
-                case RTP_SYSTEM_TSP:
-                    use_rtp = rtp;
-                    use_kernel = !rtp && timestamp >= 0;
-                    break;
-                case SYSTEM_RTP_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = !use_kernel && rtp;
-                    break;
-                case RTP_TSP:
-                    use_rtp = rtp;
-                    use_kernel = false;
-                    break;
-                case SYSTEM_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = false;
-                    break;
-                case TSP_ONLY:
-                default:
-                    use_rtp = false;
-                    use_kernel = false;
-                    break;
-            }
+    // Loop until the caller's buffer is full or there is no more immediately available packet.
+    while (pkt_cnt < max_packets) {
 
-            // Build time stamps in packet metadata.
-            _mdata_next = 0;
-            for (size_t i = 0; i < _inbuf_count; ++i) {
-                if (use_rtp) {
-                    // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
-                    _mdata[i].setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
-                }
-                else if (use_kernel) {
-                    // IP time stamp unit is microseconds.
-                    _mdata[i].setInputTimeStamp(uint64_t(timestamp), MicroSecPerSec, TimeSource::KERNEL);
+        // If there is no remaining packet in the current datagram, process the next one.
+        if (_inbuf_count == 0) {
+
+            // If there is no remaining datagram, wait for new datagram messages.
+            // But never block when some packets are already available for the caller.
+            if (_dgram_next >= _dgram_count) {
+                if (pkt_cnt > 0) {
+                    break;
                 }
-                else {
-                    _mdata[i].clearInputTimeStamp();
+                _dgram_next = _dgram_count = 0;
+                if (!receiveDatagrams(_inbuf.data(), _datagram_size, _dgrams.size(), _dgrams.data(), _dgram_count)) {
+                    return 0;
                 }
             }
 
-            break; // found packets.
+            // Look for TS packets in the next datagram message.
+            const Datagram& dgram(_dgrams[_dgram_next++]);
+            if (!processDatagram(dgram)) {
+                // No TS packet found in UDP message, wait for another one.
+                tsp->debug(u"no TS packet in message, %s bytes", {dgram.size});
+                continue;
+            }
+            new_packets += _inbuf_count;
         }
 
-        // No TS packet found in UDP message, wait for another one.
-        tsp->debug(u"no TS packet in message, %s bytes", {insize});
+        // Return packets from the current datagram.
+        const size_t cnt = std::min(_inbuf_count, max_packets - pkt_cnt);
+        TSPacket::Copy(buffer + pkt_cnt, _inbuf_next, cnt);
+        TSPacketMetadata::Copy(pkt_data + pkt_cnt, &_mdata[_mdata_next], cnt);
+        pkt_cnt += cnt;
+        _inbuf_count -= cnt;
+        _inbuf_next += cnt * PKT_SIZE;
+        _mdata_next += cnt;
     }
 
     // If new packets were received, we may need to re-evaluate the real-time input bitrate.
-    if (new_packets && _real_time && _eval_time > 0) {
+    if (new_packets > 0 && _real_time && _eval_time > 0) {
 
         const Time now(Time::CurrentUTC());
 
@@ -262,9 +327,9 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         }
 
         // Count packets
-        _packets += _inbuf_count;
-        _packets_0 += _inbuf_count;
-        _packets_1 += _inbuf_count;
+        _packets += new_packets;
+        _packets_0 += new_packets;
+        _packets_1 += new_packets;
 
         // Detect new evaluation period
         if (now >= _start_1 + _eval_time) {
@@ -288,13 +353,5 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         }
     }
 
-    // Return packets from the input buffer
-    size_t pkt_cnt = std::min(_inbuf_count, max_packets);
-    TSPacket::Copy(buffer, _inbuf.data() + _inbuf_next, pkt_cnt);
-    TSPacketMetadata::Copy(pkt_data, &_mdata[_mdata_next], pkt_cnt);
-    _inbuf_count -= pkt_cnt;
-    _inbuf_next += pkt_cnt * PKT_SIZE;
-    _mdata_next += pkt_cnt;
-
     return pkt_cnt;
 }
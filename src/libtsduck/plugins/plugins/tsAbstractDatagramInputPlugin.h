@@ -91,6 +91,38 @@ namespace ts {
         //!
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) = 0;
 
+        //!
+        //! Description of a datagram message which was received by receiveDatagrams().
+        //!
+        struct TSDUCKDLL Datagram
+        {
+            uint8_t*    data;      //!< Address of the datagram message.
+            size_t      size;      //!< Size in bytes of the datagram message.
+            MicroSecond timestamp; //!< Receive timestamp in micro-seconds or -1 if not available.
+        };
+
+        //!
+        //! Receive several datagram messages at once.
+        //! Subclasses may override this method when the lower layer can receive several messages using one
+        //! single system call. The default implementation receives one single message using receiveDatagram().
+        //! @param [out] buffer Address of the buffer for the received messages. It is made of @a max_count
+        //! consecutive areas of @a datagram_size bytes. The areas may be used in any order.
+        //! @param [in] datagram_size Size in bytes of each area in @a buffer.
+        //! @param [in] max_count Maximum number of messages to receive. Never zero.
+        //! @param [out] datagrams Address of an array of @a max_count datagram descriptions. On return, the
+        //! first @a ret_count elements describe the received messages in their order of reception.
+        //! @param [out] ret_count Number of received messages. Never zero on success.
+        //! @return True on success, false on error.
+        //!
+        virtual bool receiveDatagrams(uint8_t* buffer, size_t datagram_size, size_t max_count, Datagram* datagrams, size_t& ret_count);
+
+        //!
+        //! Set the maximum number of datagram messages to receive at once using receiveDatagrams().
+        //! This must be called before start().
+        //! @param [in] count Maximum number of datagram messages to receive at once. Zero is interpreted as 1.
+        //!
+        void setDatagramBatch(size_t count);
+
     private:
         // Order of priority for input timestamps. SYSTEM means lower layer from subclass (UDP, SRT, etc).
         enum TimePriority {RTP_SYSTEM_TSP, SYSTEM_RTP_TSP, RTP_TSP, SYSTEM_TSP, TSP_ONLY};
@@ -111,10 +143,17 @@ namespace ts {
         PacketCounter _packets_0;             // Number of received packets since _start_0
         Time          _start_1;               // Start of previous bitrate evaluation period
         PacketCounter _packets_1;             // Number of received packets since _start_1
-        size_t        _inbuf_count;           // Number of remaining TS packets in inbuf
-        size_t        _inbuf_next;            // Byte index in _inbuf of next TS packet to return
+        size_t        _datagram_size;         // Max size of one datagram message
+        size_t        _dgram_count;           // Number of received datagram messages in _dgrams
+        size_t        _dgram_next;            // Index in _dgrams of next datagram message to process
+        size_t        _inbuf_count;           // Number of remaining TS packets in current datagram
+        const uint8_t* _inbuf_next;           // Address of next TS packet to return in current datagram
         size_t        _mdata_next;            // Index in _mdata of next TS packet metadata to return
-        ByteBlock     _inbuf;                 // Input buffer
-        TSPacketMetadataVector _mdata;        // Metadata for packets in _inbuf
+        ByteBlock     _inbuf;                 // Input buffer, one area per datagram message
+        std::vector<Datagram> _dgrams;        // Received datagram messages in _inbuf
+        TSPacketMetadataVector _mdata;        // Metadata for packets in current datagram
+
+        // Locate TS packets in a datagram message, build their metadata. Return false if there is none.
+        bool processDatagram(const Datagram& dgram);
     };
 }
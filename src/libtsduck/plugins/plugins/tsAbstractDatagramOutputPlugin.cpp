@@ -54,6 +54,7 @@ ts::AbstractDatagramOutputPlugin::AbstractDatagramOutputPlugin(TSP* tsp_, const
     _rtp_user_ssrc(0),
     _pcr_user_pid(PID_NULL),
     _rs204_format(false),
+    _batch(1),
     _rtp_sequence(0),
     _rtp_ssrc(0),
     _pcr_pid(PID_NULL),
@@ -63,7 +64,11 @@ ts::AbstractDatagramOutputPlugin::AbstractDatagramOutputPlugin(TSP* tsp_, const
     _rtp_pcr_offset(0),
     _pkt_count(0),
     _out_count(0),
-    _out_buffer()
+    _out_buffer(),
+    _dgram_size(0),
+    _dgram_buffer(),
+    _dgram_count(0),
+    _dgrams()
 {
     option(u"enforce-burst", 'e');
     help(u"enforce-burst",
@@ -140,6 +145,18 @@ bool ts::AbstractDatagramOutputPlugin::start()
         _out_count = 0;
     }
 
+    // Allocate the buffers for pending datagrams. Datagrams are built in a separate buffer only with
+    // RTP or RS204 format. Otherwise, they are directly sent from the packet buffer. Full datagrams
+    // are contiguous in the buffer to allow segmentation offload by the lower layer.
+    _dgram_size = (_use_rtp ? RTP_HEADER_SIZE : 0) + _pkt_burst * (_rs204_format ? PKT_RS_SIZE : PKT_SIZE);
+    if (_use_rtp || _rs204_format) {
+        // Since the initial value of the buffer is zero, there is no need to explicitly set the RS204 trailers.
+        _dgram_buffer.clear();
+        _dgram_buffer.resize(_batch * _dgram_size, 0);
+    }
+    _dgrams.resize(_batch);
+    _dgram_count = 0;
+
     // Initialize RTP parameters.
     if (_use_rtp) {
         // Use a system PRNG. This type of RNG does not need to be seeded.
@@ -184,7 +201,7 @@ bool ts::AbstractDatagramOutputPlugin::stop()
         success = sendPackets(_out_buffer.data(), _out_count);
         _out_count = 0;
     }
-    return success;
+    return flushDatagrams() && success;
 }
 
 
@@ -211,9 +228,9 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
         packet_count -= count;
         _out_count += count;
 
-        // Send the output buffer when full.
+        // Send the output buffer when full. Flush it now since the output buffer will be reused.
         if (_out_count == _pkt_burst) {
-            if (!sendPackets(_out_buffer.data(), _out_count)) {
+            if (!sendPackets(_out_buffer.data(), _out_count) || !flushDatagrams()) {
                 return false;
             }
             _out_count = 0;
@@ -230,6 +247,11 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
         packet_count -= count;
     }
 
+    // Send all pending datagrams before returning, to preserve the packet pacing.
+    if (!flushDatagrams()) {
+        return false;
+    }
+
     // If remaining packets are present, save them in output buffer.
     if (packet_count > 0) {
         assert(_enforce_burst);
@@ -242,13 +264,48 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
 }
 
 
+//----------------------------------------------------------------------------
+// Send several datagram messages at once. Default implementation.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramOutputPlugin::sendDatagrams(const Datagram* datagrams, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!sendDatagram(datagrams[i].address, datagrams[i].size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Send all pending datagrams.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramOutputPlugin::flushDatagrams()
+{
+    const size_t count = _dgram_count;
+    _dgram_count = 0;
+    return count == 0 || sendDatagrams(_dgrams.data(), count);
+}
+
+
 //----------------------------------------------------------------------------
 // Send contiguous packets in one single datagram.
 //----------------------------------------------------------------------------
 
 bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t packet_count)
 {
-    bool status = true;
+    // Send pending datagrams when the batch is full.
+    if (_dgram_count >= _dgrams.size() && !flushDatagrams()) {
+        return false;
+    }
+
+    // Next datagram to send. With RTP or RS204, it is built in its own area of the datagram buffer.
+    Datagram& dgram(_dgrams[_dgram_count]);
+    uint8_t* const buffer = _dgram_buffer.empty() ? nullptr : _dgram_buffer.data() + _dgram_count * _dgram_size;
+    _dgram_count++;
 
     if (_use_rtp) {
         // RTP datagram are relatively trivial to build, except the time stamp.
@@ -261,8 +318,6 @@ bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t p
         // But never jump back in RTP timestamps, only increase "more slowly" when adjusting.
 
         // Build an RTP datagram. Use a simple RTP header without options nor extensions.
-        ByteBlock buffer(RTP_HEADER_SIZE + packet_count * PKT_RS_SIZE);
-
         // Build the RTP header, except the timestamp.
         buffer[0] = 0x80;             // Version = 2, P = 0, X = 0, CC = 0
         buffer[1] = _rtp_pt & 0x7F;   // M = 0, payload type
@@ -336,41 +391,44 @@ bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t p
         _last_rtp_pcr = rtp_pcr;
         _last_rtp_pcr_pkt = _pkt_count;
 
-        // Copy the TS packets after the RTP header and send the packets.
-        uint8_t* buf = buffer.data() + RTP_HEADER_SIZE;
+        // Copy the TS packets after the RTP header.
+        uint8_t* buf = buffer + RTP_HEADER_SIZE;
         if (_rs204_format) {
-            // Copy TS packets one by one with RS204 zero trailer. Since the default initial value
-            // of the buffer vector is zero, there is no need to explicitly set the trailers.
+            // Copy TS packets one by one with RS204 zero trailer. The trailers are never
+            // written in the datagram buffer, there is no need to explicitly set them.
             for (size_t i = 0; i < packet_count; ++i) {
                 ::memcpy(buf, pkt++, PKT_SIZE);
                 buf += PKT_SIZE + RS_SIZE;
             }
+            dgram.size = RTP_HEADER_SIZE + packet_count * PKT_RS_SIZE;
         }
         else {
-            // Directly copy the TS packets and shrink the buffer (no RS204 trailers).
+            // Directly copy the TS packets (no RS204 trailers).
             ::memcpy(buf, pkt, packet_count * PKT_SIZE);
-            buffer.resize(RTP_HEADER_SIZE + packet_count * PKT_SIZE);
+            dgram.size = RTP_HEADER_SIZE + packet_count * PKT_SIZE;
         }
-        status = sendDatagram(buffer.data(), buffer.size());
+        dgram.address = buffer;
     }
     else if (_rs204_format) {
-        // No RTP header, add TS trailer after each packet. Since the default initial value
-        // of the buffer vector is zero, there is no need to explicitly set the trailers.
-        ByteBlock buffer(packet_count * PKT_RS_SIZE);
-        uint8_t* buf = buffer.data();
+        // No RTP header, add TS trailer after each packet. The trailers are never
+        // written in the datagram buffer, there is no need to explicitly set them.
+        uint8_t* buf = buffer;
         for (size_t i = 0; i < packet_count; ++i) {
             ::memcpy(buf, pkt++, PKT_SIZE);
             buf += PKT_SIZE + RS_SIZE;
         }
-        status = sendDatagram(buffer.data(), buffer.size());
+        dgram.address = buffer;
+        dgram.size = packet_count * PKT_RS_SIZE;
     }
     else {
         // No RTP, send TS packets directly as datagram.
-        status = sendDatagram(pkt, packet_count * PKT_SIZE);
+        dgram.address = pkt;
+        dgram.size = packet_count * PKT_SIZE;
     }
 
     // Count packets datagram per datagram.
     _pkt_count += packet_count;
 
-    return status;
+    // Without batch, send the datagram immediately.
+    return _dgrams.size() > 1 || flushDatagrams();
 }
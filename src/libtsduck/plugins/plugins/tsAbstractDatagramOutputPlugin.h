@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsOutputPlugin.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -98,6 +99,33 @@ namespace ts {
         //!
         virtual bool sendDatagram(const void* address, size_t size) = 0;
 
+        //!
+        //! Description of a datagram message to send using sendDatagrams().
+        //!
+        struct TSDUCKDLL Datagram
+        {
+            const void* address;  //!< Address of datagram.
+            size_t      size;     //!< Size in bytes of datagram.
+        };
+
+        //!
+        //! Send several datagram messages at once.
+        //! Subclasses may override this method when the lower layer can send several messages using one
+        //! single system call. The default implementation sends the messages one by one using sendDatagram().
+        //! @param [in] datagrams Address of an array of @a count datagram descriptions, in sending order.
+        //! @param [in] count Number of datagrams to send.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendDatagrams(const Datagram* datagrams, size_t count);
+
+        //!
+        //! Set the maximum number of datagram messages to accumulate and send at once using sendDatagrams().
+        //! The accumulated datagrams are always sent before returning from send(), preserving the pacing
+        //! of the packets by @c tsp. This must be called before start().
+        //! @param [in] count Maximum number of datagram messages to send at once. Zero is interpreted as 1.
+        //!
+        void setDatagramBatch(size_t count) { _batch = std::max<size_t>(count, 1); }
+
     private:
         // Configuration and command line options.
         const Options  _flags;              // Configuration flags.
@@ -111,6 +139,7 @@ namespace ts {
         uint32_t       _rtp_user_ssrc;      // RTP user-specified SSRC id
         PID            _pcr_user_pid;       // User-specified PCR PID.
         bool           _rs204_format;       // Use 204-byte format with Reed Solomon placeholder.
+        size_t         _batch;              // Max number of datagrams to send at once.
 
         // Working data.
         uint16_t       _rtp_sequence;       // RTP current sequence number
@@ -123,8 +152,15 @@ namespace ts {
         PacketCounter  _pkt_count;          // Total packet counter for output packets
         size_t         _out_count;          // Number of packets in _out_buffer
         TSPacketVector _out_buffer;         // Buffered packets for output with --enforce-burst
+        size_t         _dgram_size;         // Size of a full datagram in _dgram_buffer.
+        ByteBlock      _dgram_buffer;       // Buffer for datagrams with RTP header or RS204 format.
+        size_t         _dgram_count;        // Number of pending datagrams in _dgrams.
+        std::vector<Datagram> _dgrams;      // Pending datagrams to send.
 
-        // Send a buffer of TS packets.
+        // Build a datagram from a buffer of TS packets and queue it for sending.
         bool sendPackets(const TSPacket* packet, size_t count);
+
+        // Send all pending datagrams.
+        bool flushDatagrams();
     };
 }
@@ -28,12 +28,17 @@
 //----------------------------------------------------------------------------
 
 #include "tsAbstractDescrambler.h"
+#include "tsGuardMutex.h"
 #include "tsGuardCondition.h"
 #include "tsNames.h"
 
 // Stack usage required by this module in the ECM deciphering thread.
 #define ECM_THREAD_STACK_OVERHEAD (16  * 1024)
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::AbstractDescrambler::DEFAULT_PACKET_WINDOW;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -50,13 +55,25 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
     _pids(),
     _service(duck, this),
     _stack_usage(stack_usage),
+    _window_size(0),
+    _group_count(1),
+    _batch_scrambling(nullptr),
+    _batch(),
+    _replicas(),
     _demux(duck, nullptr, this),
     _ecm_streams(),
     _scrambled_streams(),
     _mutex(),
     _ecm_to_do(),
     _ecm_thread(this),
-    _stop_thread(false)
+    _stop_thread(false),
+    _workers_mutex(),
+    _workers_done(),
+    _workers(),
+    _workers_batch(0),
+    _workers_pending(0),
+    _workers_terminate(false),
+    _group_engines()
 {
     // We need to define character sets to specify service names.
     duck.defineArgsForCharset(*this);
@@ -75,12 +92,30 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
          u"If the argument is omitted, --pid options shall be specified to list explicit "
          u"PID's to descramble and fixed control words shall be specified as well.");
 
+    option(u"packet-window", 0, UNSIGNED);
+    help(u"packet-window", u"count",
+         u"Number of packets to process at once. The packets in this window which use the same "
+         u"control word are descrambled together, using SIMD instructions of the CPU with DVB-CSA2. "
+         u"Larger windows use the CPU more efficiently but increase the latency of the stream. "
+         u"The default is " + UString::Decimal(DEFAULT_PACKET_WINDOW) + u" packets. "
+         u"The value zero means that packets are descrambled one by one.");
+
     option(u"pid", 'p', PIDVAL, 0, UNLIMITED_COUNT);
     help(u"pid", u"pid1[-pid2]",
          u"Descramble packets with this PID value or range of PID values. "
          u"Several -p or --pid options may be specified. "
          u"By default, descramble the specified service.");
 
+    option(u"worker-threads", 0, POSITIVE);
+    help(u"worker-threads", u"count",
+         u"Number of threads which descramble packets in parallel. The scrambled PID's are "
+         u"distributed in groups, one per thread. This is useful with services having several "
+         u"scrambled components at high bitrate, on a multi-core system. The packets are "
+         u"descrambled in place and their order is preserved. This option requires a packet "
+         u"window (see option --packet-window). It is ignored with a list of several fixed "
+         u"control words. The default is 1, meaning that all packets are descrambled in the "
+         u"thread of the plugin.");
+
     option(u"synchronous");
     help(u"synchronous",
          u"Specify to synchronously decipher the ECM's. By default, in real-time "
@@ -105,11 +140,26 @@ bool ts::AbstractDescrambler::getOptions()
     _service.set(value(u""));
     _synchronous = present(u"synchronous") || !tsp->realtime();
     _swap_cw = present(u"swap-cw");
+    getIntValue(_window_size, u"packet-window", DEFAULT_PACKET_WINDOW);
+    getIntValue(_group_count, u"worker-threads", 1);
     getIntValues(_pids, u"pid");
     if (!duck.loadArgs(*this) || !_scrambling.loadArgs(duck, *this)) {
         return false;
     }
 
+    // Parallel descrambling is done on each batch of packets from the packet window.
+    if (_group_count > 1 && _window_size == 0) {
+        tsp->error(u"--worker-threads cannot be used with --packet-window 0");
+        return false;
+    }
+
+    // With several fixed control words, the next CW is used when the scrambling control changes.
+    // This depends on the order of all packets and cannot be split between groups of PID's.
+    if (_group_count > 1 && _scrambling.fixedCWCount() > 1) {
+        tsp->warning(u"several fixed control words, --worker-threads ignored");
+        _group_count = 1;
+    }
+
     // Descramble either a service or a list of PID's, not a mixture of them.
     if ((_use_service + _pids.any()) != 1) {
         tsp->error(u"specify either a service or a list of PID's");
@@ -172,6 +222,7 @@ ts::AbstractDescrambler::ECMStreamPtr ts::AbstractDescrambler::getOrCreateECMStr
     else {
         ECMStreamPtr p(new ECMStream(this));
         _ecm_streams.insert(std::make_pair(ecm_pid, p));
+        createReplicas(p->scrambling);
         return p;
     }
 }
@@ -188,11 +239,15 @@ bool ts::AbstractDescrambler::start()
     _ecm_streams.clear();
     _scrambled_streams.clear();
     _demux.reset();
+    _batch_scrambling = nullptr;
+    _batch.assign(_group_count, std::vector<TSPacket*>());
+    _replicas.clear();
 
     // Initialize the scrambling engine.
     if (!_scrambling.start()) {
         return false;
     }
+    createReplicas(_scrambling);
 
     // In asynchronous mode, create a thread for ECM processing
     if (_need_ecm && !_synchronous) {
@@ -204,6 +259,8 @@ bool ts::AbstractDescrambler::start()
         _ecm_thread.start();
     }
 
+    // Start the worker threads for parallel descrambling.
+    startWorkerThreads();
     return true;
 }
 
@@ -225,11 +282,25 @@ bool ts::AbstractDescrambler::stop()
         _ecm_thread.waitForTermination();
     }
 
+    stopWorkerThreads();
     _scrambling.stop();
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Get the packet window size.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::getPacketWindowSize()
+{
+    if (_window_size > 0) {
+        tsp->debug(u"packet window: %'d packets, DVB-CSA2 batch engine: %s", {_window_size, DVBCSA2::BatchEngineName()});
+    }
+    return _window_size;
+}
+
+
 //----------------------------------------------------------------------------
 //  This method is invoked when a PMT is available for the service.
 //----------------------------------------------------------------------------
@@ -238,6 +309,12 @@ void ts::AbstractDescrambler::handlePMT(const PMT& pmt, PID)
 {
     tsp->debug(u"PMT: service 0x%X, %d elementary streams", {pmt.service_id, pmt.streams.size()});
 
+    // The scrambling type may change, descramble pending packets first.
+    if (!descrambleBatch()) {
+        _abort = true;
+        return;
+    }
+
     // Default scrambling is DVB-CSA2.
     uint8_t scrambling_type = SCRAMBLING_DVB_CSA2;
 
@@ -271,10 +348,10 @@ void ts::AbstractDescrambler::handlePMT(const PMT& pmt, PID)
     }
 
     // Set global scrambling type from scrambling descriptor, if not specified on the command line.
-    _scrambling.setScramblingType(scrambling_type, false);
+    setScramblingType(_scrambling, scrambling_type);
     tsp->verbose(u"using scrambling mode: %s", {NameFromDTV(u"ScramblingMode", _scrambling.scramblingType())});
     for (auto& it : _ecm_streams) {
-        it.second->scrambling.setScramblingType(scrambling_type, false);
+        setScramblingType(it.second->scrambling, scrambling_type);
     }
 }
 
@@ -508,10 +585,268 @@ void ts::AbstractDescrambler::ECMThread::main()
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Add a packet in the batch of packets to descramble.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDescrambler::addToBatch(TSScrambling& scrambling, TSPacket& pkt)
+{
+    if (&scrambling != _batch_scrambling) {
+        if (!descrambleBatch()) {
+            return false;
+        }
+        _batch_scrambling = &scrambling;
+    }
+    _batch[pkt.getPID() % _group_count].push_back(&pkt);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble all packets in the current batch.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDescrambler::descrambleBatch()
+{
+    bool ok = true;
+
+    if (_batch_scrambling != nullptr) {
+
+        // Get the descrambling engine of each PID group and count non-empty groups.
+        size_t busy_groups = 0;
+        for (size_t i = 0; i < _group_count; ++i) {
+            _group_engines[i] = &engine(*_batch_scrambling, i);
+            if (!_batch[i].empty()) {
+                busy_groups++;
+            }
+        }
+
+        if (busy_groups <= 1) {
+            // Not worth waking up the worker threads.
+            for (size_t i = 0; i < _group_count; ++i) {
+                ok = descrambleGroup(i) && ok;
+            }
+        }
+        else {
+            // Start all worker threads on the new batch.
+            {
+                GuardMutex lock(_workers_mutex);
+                _workers_pending = _workers.size();
+                _workers_batch++;
+                for (const auto& thread : _workers) {
+                    thread->start_work.signal();
+                }
+            }
+
+            // Descramble the first group in this thread.
+            ok = descrambleGroup(0);
+
+            // Wait for all worker threads to complete. The packets are descrambled in place,
+            // their order in the packet window is unchanged.
+            {
+                GuardCondition lock(_workers_mutex, _workers_done);
+                while (_workers_pending > 0) {
+                    lock.waitCondition();
+                }
+            }
+            for (const auto& thread : _workers) {
+                ok = thread->success && ok;
+            }
+        }
+    }
+
+    for (auto& pkts : _batch) {
+        pkts.clear();
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble the packets of one group of PID's in the current batch.
 //----------------------------------------------------------------------------
 
+bool ts::AbstractDescrambler::descrambleGroup(size_t index)
+{
+    std::vector<TSPacket*>& pkts(_batch[index]);
+    return pkts.empty() || _group_engines[index]->decrypt(pkts.data(), pkts.size());
+}
+
+
+//----------------------------------------------------------------------------
+// Replicas of descrambling engines for the worker threads.
+//----------------------------------------------------------------------------
+
+void ts::AbstractDescrambler::createReplicas(const TSScrambling& main)
+{
+    TSScramblingPtrVector& replicas(_replicas[&main]);
+    replicas.clear();
+    for (size_t i = 1; i < _group_count; ++i) {
+        replicas.push_back(TSScramblingPtr(new TSScrambling(main)));
+        replicas.back()->start();
+    }
+}
+
+ts::TSScrambling& ts::AbstractDescrambler::engine(TSScrambling& main, size_t index)
+{
+    if (index == 0) {
+        return main;
+    }
+    const auto it = _replicas.find(&main);
+    assert(it != _replicas.end());
+    assert(index <= it->second.size());
+    return *it->second[index - 1];
+}
+
+void ts::AbstractDescrambler::setScramblingType(TSScrambling& main, uint8_t scrambling)
+{
+    for (size_t i = 0; i < _group_count; ++i) {
+        engine(main, i).setScramblingType(scrambling, false);
+    }
+}
+
+bool ts::AbstractDescrambler::setCW(TSScrambling& main, const ByteBlock& cw, int parity)
+{
+    bool ok = true;
+    for (size_t i = 0; i < _group_count; ++i) {
+        ok = engine(main, i).setCW(cw, parity) && ok;
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Worker threads for parallel descrambling.
+//----------------------------------------------------------------------------
+
+ts::AbstractDescrambler::WorkerThread::WorkerThread(AbstractDescrambler* parent, size_t index, const ThreadAttributes& attributes) :
+    Thread(attributes),
+    start_work(),
+    success(true),
+    _parent(parent),
+    _index(index)
+{
+}
+
+ts::AbstractDescrambler::WorkerThread::~WorkerThread()
+{
+    waitForTermination();
+}
+
+void ts::AbstractDescrambler::WorkerThread::main()
+{
+    uint64_t batch = 0;
+    for (;;) {
+        // Wait for a new batch of packets or termination.
+        {
+            GuardCondition lock(_parent->_workers_mutex, start_work);
+            while (_parent->_workers_batch == batch && !_parent->_workers_terminate) {
+                lock.waitCondition();
+            }
+            if (_parent->_workers_terminate) {
+                break;
+            }
+            batch = _parent->_workers_batch;
+        }
+
+        // Descramble our group of PID's. The batch is not modified until all threads complete.
+        success = _parent->descrambleGroup(_index);
+
+        // Notify the parent when the last worker thread completes.
+        GuardCondition lock(_parent->_workers_mutex, _parent->_workers_done);
+        assert(_parent->_workers_pending > 0);
+        if (--_parent->_workers_pending == 0) {
+            lock.signal();
+        }
+    }
+}
+
+void ts::AbstractDescrambler::startWorkerThreads()
+{
+    _workers_batch = 0;
+    _workers_pending = 0;
+    _workers_terminate = false;
+    _group_engines.assign(_group_count, nullptr);
+
+    // The worker threads use the CPU affinity and scheduling attributes of the plugin thread.
+    ThreadAttributes attributes;
+    tsp->getThreadAttributes(attributes);
+    attributes.setDeleteWhenTerminated(false);
+
+    // PID group 0 is descrambled in the plugin thread.
+    for (size_t i = 1; i < _group_count; ++i) {
+        const WorkerThreadPtr thread(new WorkerThread(this, i, attributes));
+        _workers.push_back(thread);
+        thread->start();
+    }
+    if (_group_count > 1) {
+        tsp->verbose(u"descrambling using %d threads", {_group_count});
+    }
+}
+
+void ts::AbstractDescrambler::stopWorkerThreads()
+{
+    {
+        GuardMutex lock(_workers_mutex);
+        _workers_terminate = true;
+        for (const auto& thread : _workers) {
+            thread->start_work.signal();
+        }
+    }
+    for (const auto& thread : _workers) {
+        thread->waitForTermination();
+    }
+    _workers.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processing methods
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::AbstractDescrambler::inspectPacket(TSPacket&, TSPacketMetadata&)
+{
+    return TSP_OK;
+}
+
 ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    Status status = inspectPacket(pkt, pkt_data);
+    if (status == TSP_OK) {
+        status = handlePacket(pkt);
+    }
+    return descrambleBatch() ? status : TSP_END;
+}
+
+size_t ts::AbstractDescrambler::processPacketWindow(TSPacketWindow& win)
+{
+    for (size_t i = 0; i < win.size(); ++i) {
+        TSPacket* pkt = nullptr;
+        TSPacketMetadata* pkt_data = nullptr;
+        if (win.get(i, pkt, pkt_data)) {
+            Status status = inspectPacket(*pkt, *pkt_data);
+            if (status == TSP_OK) {
+                status = handlePacket(*pkt);
+            }
+            switch (status) {
+                case TSP_END:
+                    // On descrambling error, some previous packets may be left scrambled, do not pass any of them.
+                    return descrambleBatch() ? i : 0;
+                case TSP_DROP:
+                    win.drop(i);
+                    break;
+                case TSP_NULL:
+                    win.nullify(i);
+                    break;
+                case TSP_OK:
+                default:
+                    break;
+            }
+        }
+    }
+    return descrambleBatch() ? win.size() : 0;
+}
+
+ts::ProcessorPlugin::Status ts::AbstractDescrambler::handlePacket(TSPacket& pkt)
 {
     const PID pid = pkt.getPID();
 
@@ -519,7 +854,7 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     // If there is a user-specified list of PID's, we don't manage a service
     // and there is nothing else to do.
     if (_pids.any()) {
-        return !_pids.test(pid) || _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return !_pids.test(pid) || addToBatch(_scrambling, pkt) ? TSP_OK : TSP_END;
     }
 
     // Filter sections to locate the service and grab ECM's.
@@ -541,7 +876,7 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
 
     // Without ECM's, we descramble using fixed control words.
     if (!_need_ecm) {
-        return _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return addToBatch(_scrambling, pkt) ? TSP_OK : TSP_END;
     }
 
     // Get PID context. If the PID is not known as a scrambled PID,
@@ -571,6 +906,11 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     if ((scv == SC_EVEN_KEY && pecm->new_cw_even) || (scv == SC_ODD_KEY && pecm->new_cw_odd)) {
 
         // A new CW was deciphered.
+        // Pending packets of this ECM stream must be descrambled with the previous CW.
+        if (_batch_scrambling == &pecm->scrambling && !descrambleBatch()) {
+            return TSP_END;
+        }
+
         // In asynchronous mode, the CW are accessed under mutex protection.
         if (!_synchronous) {
             _mutex.acquire();
@@ -578,13 +918,13 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
 
         // Store the new CW in the descrambler.
         if (scv == SC_EVEN_KEY) {
-            pecm->scrambling.setScramblingType(pecm->cw_even.scrambling, false);
-            pecm->scrambling.setCW(pecm->cw_even.cw, SC_EVEN_KEY);
+            setScramblingType(pecm->scrambling, pecm->cw_even.scrambling);
+            setCW(pecm->scrambling, pecm->cw_even.cw, SC_EVEN_KEY);
             pecm->new_cw_even = false;
         }
         else {
-            pecm->scrambling.setScramblingType(pecm->cw_odd.scrambling, false);
-            pecm->scrambling.setCW(pecm->cw_odd.cw, SC_ODD_KEY);
+            setScramblingType(pecm->scrambling, pecm->cw_odd.scrambling);
+            setCW(pecm->scrambling, pecm->cw_odd.cw, SC_ODD_KEY);
             pecm->new_cw_odd = false;
         }
 
@@ -593,6 +933,6 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
         }
     }
 
-    // Descramble the packet payload.
-    return pecm->scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+    // Descramble the packet payload with the next batch.
+    return addToBatch(pecm->scrambling, pkt) ? TSP_OK : TSP_END;
 }
@@ -56,12 +56,23 @@ namespace ts {
     {
         TS_NOBUILD_NOCOPY(AbstractDescrambler);
     public:
+        //!
+        //! Default number of packets to process at once (see option -\-packet-window).
+        //!
+        static constexpr size_t DEFAULT_PACKET_WINDOW = 256;
+
         // Implementation of ProcessorPlugin interface.
         // If overridden by descrambler subclass, superclass must be explicitly invoked.
+        // By default, the packets are processed by windows (see option --packet-window).
+        // Descrambler subclasses should not override processPacket() or processPacketWindow()
+        // because only one of them is called, depending on the packet window. To process
+        // individual packets, subclasses shall override inspectPacket() instead.
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     protected:
         //!
@@ -165,6 +176,21 @@ namespace ts {
         //!
         virtual bool decipherECM(const Section& ecm, CWData& cw_even, CWData& cw_odd) = 0;
 
+        //!
+        //! Inspect or modify a packet before descrambling.
+        //!
+        //! This hook is invoked for each packet, in the plugin thread, before the packet is
+        //! descrambled, whether the packets are processed one by one or by windows. This is
+        //! the per-packet extension point of descramblers. The default implementation
+        //! returns TSP_OK.
+        //!
+        //! @param [in,out] pkt The TS packet, not yet descrambled.
+        //! @param [in,out] pkt_data Packet metadata.
+        //! @return TSP_OK to descramble the packet, TSP_END to terminate, TSP_DROP or TSP_NULL
+        //! to drop the packet or replace it with a null packet, without descrambling it.
+        //!
+        virtual Status inspectPacket(TSPacket& pkt, TSPacketMetadata& pkt_data);
+
     protected:
         //!
         //! This hook is invoked when a new PMT is available.
@@ -232,6 +258,35 @@ namespace ts {
         typedef SafePtr<ECMStream, NullMutex> ECMStreamPtr;
         typedef std::map<PID, ECMStreamPtr> ECMStreamMap;
 
+        // Each descrambling engine (the default one and the one of each ECM stream) has
+        // replicas for the worker threads. All replicas always use the same keys.
+        typedef SafePtr<TSScrambling, NullMutex> TSScramblingPtr;
+        typedef std::vector<TSScramblingPtr> TSScramblingPtrVector;
+        typedef std::map<const TSScrambling*, TSScramblingPtrVector> ReplicaMap;
+
+        // Worker thread which descrambles the packets from one group of PID's.
+        class WorkerThread : public Thread
+        {
+            TS_NOBUILD_NOCOPY(WorkerThread);
+        public:
+            // Constructor, destructor.
+            WorkerThread(AbstractDescrambler* parent, size_t index, const ThreadAttributes& attributes);
+            virtual ~WorkerThread() override;
+
+            Condition start_work;  // Signaled by parent when a new batch is available.
+            bool      success;     // Result of last batch.
+
+        private:
+            // Thread entry point.
+            virtual void main() override;
+
+            AbstractDescrambler* _parent;
+            const size_t         _index;
+        };
+
+        typedef SafePtr<WorkerThread> WorkerThreadPtr;
+        typedef std::vector<WorkerThreadPtr> WorkerThreadPtrVector;
+
         // ECM deciphering thread
         class ECMThread : public Thread
         {
@@ -259,6 +314,33 @@ namespace ts {
         // Analyze a list of descriptors from the PMT, looking for ECM PID's
         void analyzeDescriptors(const DescriptorList& dlist, std::set<PID>& ecm_pids, uint8_t& scrambling);
 
+        // Process one packet. The packets to descramble are added in the current batch.
+        Status handlePacket(TSPacket&);
+
+        // Add a packet in the batch of packets to descramble with a given descrambler.
+        // The previous batch is descrambled when the descrambler changes.
+        bool addToBatch(TSScrambling&, TSPacket&);
+
+        // Descramble all packets in the current batch.
+        bool descrambleBatch();
+
+        // Descramble the packets of one group of PID's in the current batch.
+        bool descrambleGroup(size_t index);
+
+        // Create the replicas of a descrambling engine for the worker threads.
+        void createReplicas(const TSScrambling&);
+
+        // Get the descrambling engine of a worker thread, index 0 is the engine itself.
+        TSScrambling& engine(TSScrambling&, size_t index);
+
+        // Set the scrambling type or a control word in a descrambling engine and all its replicas.
+        void setScramblingType(TSScrambling&, uint8_t scrambling);
+        bool setCW(TSScrambling&, const ByteBlock& cw, int parity);
+
+        // Start and terminate the worker threads.
+        void startWorkerThreads();
+        void stopWorkerThreads();
+
         // Abstract descrambler private data.
         bool               _use_service;       // Descramble a service (ie. not a specific list of PID's).
         bool               _need_ecm;          // We need to get control words from ECM's.
@@ -269,6 +351,11 @@ namespace ts {
         PIDSet             _pids;              // Explicit PID's to descramble.
         ServiceDiscovery   _service;           // Service to descramble (by name, id or none).
         size_t             _stack_usage;       // Stack usage for ECM deciphering.
+        size_t             _window_size;       // Number of packets to process at once, zero means one by one.
+        size_t             _group_count;       // Number of PID groups, descrambled by distinct threads.
+        TSScrambling*      _batch_scrambling;  // Descrambler of the packets in _batch.
+        std::vector<std::vector<TSPacket*>> _batch; // Packets to descramble with _batch_scrambling, by PID group.
+        ReplicaMap         _replicas;          // Replicas of descrambling engines, for PID groups 1 to N-1.
         SectionDemux       _demux;             // Section demux to extract ECM's.
         ECMStreamMap       _ecm_streams;       // ECM streams, indexed by PID.
         ScrambledStreamMap _scrambled_streams; // Scrambled streams, indexed by PID.
@@ -278,5 +365,14 @@ namespace ts {
         // -- start of protected area --
         bool               _stop_thread;       // Terminate ECM processing thread
         // -- end of protected area --
+
+        // Worker threads for PID groups 1 to N-1 (group 0 is descrambled in the plugin thread).
+        Mutex                   _workers_mutex;     // Protect the following fields.
+        Condition               _workers_done;      // Signaled by last worker thread when a batch is completed.
+        WorkerThreadPtrVector   _workers;           // Worker threads.
+        uint64_t                _workers_batch;     // Sequence number of current batch.
+        size_t                  _workers_pending;   // Number of worker threads still processing the current batch.
+        bool                    _workers_terminate; // Worker threads shall terminate.
+        std::vector<TSScrambling*> _group_engines;  // Descrambling engine for each PID group in current batch.
     };
 }
@@ -51,7 +51,7 @@ ts::ForkInputPlugin::ForkInputPlugin(TSP* tsp_) :
     help(u"", u"Specifies the command line to execute in the created process.");
 
     option(u"buffered-packets", 'b', POSITIVE);
-    help(u"buffered-packets", u"Windows only: Specifies the pipe buffer size in number of TS packets.");
+    help(u"buffered-packets", u"Windows and Linux only: Specifies the pipe buffer size in number of TS packets.");
 
     option(u"nowait", 'n');
     help(u"nowait", u"Do not wait for child process termination at end of its output.");
@@ -80,7 +80,7 @@ bool ts::ForkInputPlugin::start()
     // Create pipe & process.
     return _pipe.open(_command,
                       _nowait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
-                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows only, zero meaning default).
+                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows and Linux only, zero meaning default).
                       *tsp,                     // Error reporting.
                       ForkPipe::STDOUT_PIPE,    // Output: send stdout to pipe, keep same stderr as tsp.
                       ForkPipe::STDIN_NONE,     // Input: null device (do not use the same stdin as tsp).
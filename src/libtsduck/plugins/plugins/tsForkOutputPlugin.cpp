@@ -51,10 +51,17 @@ ts::ForkOutputPlugin::ForkOutputPlugin(TSP* tsp_) :
     help(u"", u"Specifies the command line to execute in the created process.");
 
     option(u"buffered-packets", 'b', POSITIVE);
-    help(u"buffered-packets", u"Windows only: Specifies the pipe buffer size in number of TS packets.");
+    help(u"buffered-packets", u"Windows and Linux only: Specifies the pipe buffer size in number of TS packets.");
 
     option(u"nowait", 'n');
     help(u"nowait", u"Do not wait for child process termination at end of input.");
+
+    option(u"zero-copy", 'z');
+    help(u"zero-copy",
+         u"Linux only: Transmit the packets to the created process without copy, using vmsplice(). "
+         u"Each write operation to the pipe returns only when the created process has read all data. "
+         u"Do not use this option when the command forwards its standard input using splice() "
+         u"(to another pipe for instance) because the forwarded data would still reference the tsp buffer.");
 }
 
 
@@ -68,6 +75,7 @@ bool ts::ForkOutputPlugin::getOptions()
     getValue(_command, u"");
     getIntValue(_buffer_size, u"buffered-packets", 0);
     _nowait = present(u"nowait");
+    _pipe.setZeroCopy(present(u"zero-copy"));
     _format = LoadTSPacketFormatOutputOption(*this);
     return true;
 }
@@ -78,7 +86,7 @@ bool ts::ForkOutputPlugin::start()
     // Create pipe & process.
     return _pipe.open(_command,
                       _nowait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
-                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows only), same as internal buffer size.
+                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows and Linux only, zero meaning default).
                       *tsp,                     // Error reporting.
                       ForkPipe::KEEP_BOTH,      // Output: same stdout and stderr as tsp process.
                       ForkPipe::STDIN_PIPE,     // Input: use the pipe.
@@ -67,6 +67,13 @@ ts::ForkPacketPlugin::ForkPacketPlugin(TSP* tsp_) :
 
     option(u"nowait", 'n');
     help(u"nowait", u"Do not wait for child process termination at end of input.");
+
+    option(u"zero-copy", 'z');
+    help(u"zero-copy",
+         u"Linux only: Transmit the packets to the created process without copy, using vmsplice(). "
+         u"Each write operation to the pipe returns only when the created process has read all data. "
+         u"Do not use this option when the command forwards its standard input using splice() "
+         u"(to another pipe for instance) because the forwarded data would still reference the tsp buffer.");
 }
 
 
@@ -83,6 +90,7 @@ bool ts::ForkPacketPlugin::getOptions()
     _nowait = present(u"nowait");
     _format = LoadTSPacketFormatOutputOption(*this);
     _pipe.setIgnoreAbort(present(u"ignore-abort"));
+    _pipe.setZeroCopy(present(u"zero-copy"));
 
     // If packet buffering is requested, allocate the buffer
     _buffer.resize(_buffer_size);
@@ -100,7 +108,7 @@ bool ts::ForkPacketPlugin::start()
     // Create pipe & process.
     return _pipe.open(_command,
                       _nowait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
-                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows only), same as internal buffer size.
+                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows and Linux only), same as internal buffer size.
                       *tsp,                     // Error reporting.
                       ForkPipe::KEEP_BOTH,      // Output: same stdout and stderr as tsp process.
                       ForkPipe::STDIN_PIPE,     // Input: use the pipe.
@@ -46,7 +46,9 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
     _ttl(0),
     _tos(-1),
     _force_mc_local(false),
-    _sock(false, *tsp_)
+    _use_gso(false),
+    _sock(false, *tsp_),
+    _messages()
 {
     option(u"", 0, STRING, 1, 1);
     help(u"",
@@ -65,6 +67,13 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
          u"declared, this option may transport multicast IP packets in unicast Ethernet frames "
          u"to the gateway, preventing multicast reception on the local network (seen on Linux).");
 
+    option(u"gso");
+    help(u"gso",
+         u"Linux only: use UDP segmentation offload (GSO). With --send-batch, consecutive datagrams "
+         u"of the same size are passed to the kernel as one large buffer which is split into UDP datagrams "
+         u"by the kernel or the network interface. If the network interface does not support it, "
+         u"segmentation offload is automatically disabled. Ignored without --send-batch.");
+
     option(u"local-address", 'l', STRING);
     help(u"local-address",
          u"When the destination is a multicast address, specify the IP address "
@@ -81,6 +90,15 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
          u"Use 204-byte format for TS packets in UDP datagrams. "
          u"Each TS packet is followed by a zeroed placeholder for a 16-byte Reed-Solomon trailer.");
 
+    option(u"send-batch", 0, INTEGER, 0, 1, 1, UDPSocket::MAX_SEND_BATCH);
+    help(u"send-batch", u"count",
+         u"Specify the maximum number of UDP datagrams to send using one single system call. "
+         u"The datagrams are accumulated while processing each chunk of packets from tsp and "
+         u"sent before returning from the chunk, preserving the pacing of the packets. "
+         u"On Linux, batch transmission reduces the number of system calls at high bitrates. "
+         u"On other systems, datagrams are always sent one by one. "
+         u"The default is 1, one datagram per system call.");
+
     option(u"tos", 's', INTEGER, 0, 1, 1, 255);
     help(u"tos",
          u"Specifies the TOS (Type-Of-Service) socket option. Setting this value "
@@ -122,6 +140,8 @@ bool ts::IPOutputPlugin::getOptions()
     getIntValue(_ttl, u"ttl", 0);
     getIntValue(_tos, u"tos", -1);
     _force_mc_local = present(u"force-local-multicast-outgoing");
+    _use_gso = present(u"gso");
+    setDatagramBatch(intValue<size_t>(u"send-batch", 1));
     setRS204Format(present(u"rs204"));
 
     return success;
@@ -151,6 +171,7 @@ bool ts::IPOutputPlugin::start()
         _sock.close(*tsp);
         return false;
     }
+    _sock.setSegmentationOffload(_use_gso, *tsp);
     return true;
 }
 
@@ -176,3 +197,23 @@ bool ts::IPOutputPlugin::sendDatagram(const void* address, size_t size)
 {
     return _sock.send(address, size, *tsp);
 }
+
+
+//----------------------------------------------------------------------------
+// Implementation of AbstractDatagramOutputPlugin: send several datagrams.
+//----------------------------------------------------------------------------
+
+bool ts::IPOutputPlugin::sendDatagrams(const Datagram* datagrams, size_t count)
+{
+    // A single datagram is sent the usual way.
+    if (count == 1) {
+        return sendDatagram(datagrams[0].address, datagrams[0].size);
+    }
+
+    _messages.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        _messages[i].data = datagrams[i].address;
+        _messages[i].size = datagrams[i].size;
+    }
+    return _sock.sendMultiple(_messages.data(), count, *tsp);
+}
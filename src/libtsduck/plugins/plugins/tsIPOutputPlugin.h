@@ -60,6 +60,7 @@ namespace ts {
     protected:
         // Implementation of AbstractDatagramOutputPlugin
         virtual bool sendDatagram(const void* address, size_t size) override;
+        virtual bool sendDatagrams(const Datagram* datagrams, size_t count) override;
 
     private:
         IPv4SocketAddress _destination;     // Destination address/port.
@@ -68,6 +69,8 @@ namespace ts {
         int               _ttl;             // Time to live option.
         int               _tos;             // Type of service option.
         bool              _force_mc_local;  // Force multicast outgoing local interface
+        bool              _use_gso;         // Use UDP segmentation offload
         UDPSocket         _sock;            // Outgoing socket
+        std::vector<UDPSocket::OutgoingMessage> _messages;  // Descriptions of messages in batch transmission
     };
 }
@@ -38,6 +38,13 @@
 namespace ts {
     //!
     //! Memory input plugin for tsp.
+    //!
+    //! Each time tsp needs input packets, the plugin signals an event with an instance of
+    //! PluginEventData. The event data directly point to the free area of the global packet
+    //! buffer of tsp, there is no intermediate copy. The event handler shall write the input
+    //! packets there before returning. The event data are no longer valid after the handler
+    //! returns because tsp processes the packets in place in its buffer.
+    //!
     //! @ingroup plugin
     //!
     class TSDUCKDLL MemoryInputPlugin: public InputPlugin
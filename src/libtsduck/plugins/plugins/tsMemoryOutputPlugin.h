@@ -38,6 +38,13 @@
 namespace ts {
     //!
     //! Memory output plugin for tsp.
+    //!
+    //! Each time packets are output, the plugin signals an event with an instance of
+    //! PluginEventData. The event data directly point to the packets in the global packet
+    //! buffer of tsp, there is no intermediate copy. The event handler shall consume the
+    //! packets before returning. When the handler returns, the buffer area is passed back
+    //! to the input plugin and is overwritten with new packets.
+    //!
     //! @ingroup plugin
     //!
     class TSDUCKDLL MemoryOutputPlugin: public OutputPlugin
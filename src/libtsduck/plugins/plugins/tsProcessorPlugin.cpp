@@ -35,7 +35,8 @@
 //----------------------------------------------------------------------------
 
 ts::ProcessorPlugin::ProcessorPlugin(TSP* tsp_, const UString& description, const UString& syntax) :
-    Plugin(tsp_, description, syntax)
+    Plugin(tsp_, description, syntax),
+    _pid_filter(AllPIDs)
 {
     // The option --label is defined in all packet processing plugins.
     option(u"only-label", 0, INTEGER, 0, UNLIMITED_COUNT, 0, TSPacketMetadata::LABEL_MAX);
@@ -68,6 +69,11 @@ ts::PluginType ts::ProcessorPlugin::type() const
     return PluginType::PROCESSOR;
 }
 
+ts::ProcessorPlugin::Sharding ts::ProcessorPlugin::getSharding()
+{
+    return SHARD_NONE;
+}
+
 size_t ts::ProcessorPlugin::getPacketWindowSize()
 {
     return 0;
@@ -93,6 +93,17 @@ namespace ts {
     //! sizes is larger than the size of the global buffer, the stream processing can enter a deadlock and
     //! stops. The global @c tsp command shall be carefully tuned to avoid that.
     //!
+    //! In the "packet method", a plugin can declare that it is safe to process several packets
+    //! in parallel by overriding ProcessorPlugin::getSharding(). If the @c tsp option -\-shard-threads
+    //! is used, the packets are then distributed over several threads which concurrently call
+    //! ProcessorPlugin::processPacket(). The packets are modified in place in the global buffer and
+    //! their order is consequently always preserved.
+    //!
+    //! Many plugins process only a few PID's and ignore all other packets. Such a plugin should
+    //! declare the PID's of interest using setPIDFilter(). The packets from other PID's are then
+    //! passed to the next plugin without invoking processPacket() and are not part of the packet
+    //! windows which are passed to processPacketWindow().
+    //!
     class TSDUCKDLL ProcessorPlugin : public Plugin
     {
         TS_NOBUILD_NOCOPY(ProcessorPlugin);
@@ -108,6 +119,37 @@ namespace ts {
             TSP_NULL = 3   //!< Replace this packet with a null packet.
         };
 
+        //!
+        //! Capability of a plugin to process packets in parallel (sharding).
+        //! Returned by getSharding().
+        //!
+        enum Sharding {
+            SHARD_NONE = 0,     //!< Packets must be processed one by one, in sequence (the default).
+            SHARD_PACKETS = 1,  //!< Any packet can be processed in any thread, the plugin has no shared state, or per-packet state only.
+            SHARD_PIDS = 2      //!< All packets from one PID must be processed in the same thread, the plugin has per-PID state only.
+        };
+
+        //!
+        //! Get the capability of the plugin to process packets in parallel.
+        //!
+        //! This method shall be overriden by plugins which can safely process packets concurrently
+        //! in several threads. It is called by the application after start() but before processing
+        //! any packet. It is ignored when the plugin uses the "packet window" processing method.
+        //!
+        //! When sharding is used, processPacket() is concurrently invoked from several threads.
+        //! With SHARD_PIDS, all packets with the same PID are processed by the same thread but
+        //! different PID's are processed concurrently. Therefore, the plugin may keep per-PID
+        //! states but only in data structures which are never modified after start() (for
+        //! instance, a fixed array indexed by PID). The plugin shall not modify any other shared
+        //! data than the packet and its metadata. The packet counters which
+        //! are returned by @c tsp (pluginPackets() for instance) are updated after each group
+        //! of packets only.
+        //!
+        //! @return The sharding capability of the plugin. If this method is not overriden,
+        //! the default implementation returns SHARD_NONE.
+        //!
+        virtual Sharding getSharding();
+
         //!
         //! Get the preferred packet window size.
         //!
@@ -160,6 +202,14 @@ namespace ts {
         //!
         TSPacketMetadata::LabelSet getOnlyLabelOption() const;
 
+        //!
+        //! Get the set of PID's which are processed by the plugin.
+        //! This is checked by the application before each packet and may change at any time.
+        //! @return A constant reference to the set of PID's to process. All PID's by default.
+        //! @see setPIDFilter()
+        //!
+        const PIDSet& getPIDFilter() const { return _pid_filter; }
+
         // Implementation of inherited interface.
         virtual PluginType type() const override;
 
@@ -172,5 +222,33 @@ namespace ts {
         //! @param [in] syntax A short one-line syntax summary, eg. "[options] filename ...".
         //!
         ProcessorPlugin(TSP* tsp_, const UString& description = UString(), const UString& syntax = UString());
+
+        //!
+        //! Set the set of PID's which are processed by the plugin.
+        //!
+        //! Packets from other PID's are passed to the next plugin without invoking processPacket(),
+        //! exactly like packets which are excluded by the option -\-only-label. They are not counted
+        //! in tsp->pluginPackets(). Therefore, a plugin which uses pluginPackets() to evaluate the
+        //! distance between packets shall not use a PID filter.
+        //!
+        //! This method is typically called in start(). The filter is not reset when the plugin is
+        //! restarted. It can also be modified during the packet processing, for instance when the
+        //! plugin discovers new PID's of interest in the PSI. The new filter applies to the next packet.
+        //! When the plugin uses sharding (see getSharding()), the filter shall not be modified
+        //! outside start().
+        //!
+        //! @param [in] pids The set of PID's to process.
+        //!
+        void setPIDFilter(const PIDSet& pids) { _pid_filter = pids; }
+
+        //!
+        //! Add a PID in the set of PID's which are processed by the plugin.
+        //! @param [in] pid The PID to add.
+        //! @see setPIDFilter()
+        //!
+        void addPIDFilter(PID pid) { _pid_filter.set(pid); }
+
+    private:
+        PIDSet _pid_filter;  // Set of PID's to process, all by default.
     };
 }
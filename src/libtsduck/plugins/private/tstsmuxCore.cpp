@@ -137,7 +137,7 @@ bool ts::tsmux::Core::start()
     }
 
     // Now that all plugins are open, start all executor threads.
-    bool success = _output.start();
+    bool success = PluginSchedulingArgs::StartThread(_output, _log);
     for (size_t i = 0; success && i < _inputs.size(); ++i) {
         success = _inputs[i]->start();
     }
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsThread.h"
 #include "tsMuxerArgs.h"
+#include "tsPluginSchedulingArgs.h"
 #include "tstsmuxInputExecutor.h"
 #include "tstsmuxOutputExecutor.h"
 #include "tsTime.h"
@@ -166,7 +167,7 @@ namespace ts {
                 bool uninit() { return _input.plugin()->stop(); }
 
                 // Start the executor thread.
-                bool start() { return _input.start(); }
+                bool start() { return PluginSchedulingArgs::StartThread(_input, _core._log); }
 
                 // Request the executor thread to terminate.
                 void terminate() { _input.terminate(); _terminated = true; }
@@ -38,7 +38,7 @@
 
 ts::tsmux::InputExecutor::InputExecutor(const MuxerArgs& opt, const PluginEventHandlerRegistry& handlers, size_t index, Report& log) :
     // Input threads have a high priority to be always ready to load incoming packets in the buffer.
-    PluginExecutor(opt, handlers, PluginType::INPUT, opt.inputs[index], ThreadAttributes().setPriority(ThreadAttributes::GetHighPriority()), log),
+    PluginExecutor(opt, handlers, PluginType::INPUT, opt.inputs[index], opt.scheduling.apply(ThreadAttributes().setPriority(ThreadAttributes::GetHighPriority()), index), log),
     _input(dynamic_cast<InputPlugin*>(PluginThread::plugin())),
     _pluginIndex(index)
 {
@@ -37,7 +37,7 @@
 //----------------------------------------------------------------------------
 
 ts::tsmux::OutputExecutor::OutputExecutor(const MuxerArgs& opt, const PluginEventHandlerRegistry& handlers, Report& log) :
-    PluginExecutor(opt, handlers, PluginType::OUTPUT, opt.output, ThreadAttributes(), log),
+    PluginExecutor(opt, handlers, PluginType::OUTPUT, opt.output, opt.scheduling.apply(ThreadAttributes(), opt.inputs.size()), log),
     _output(dynamic_cast<OutputPlugin*>(plugin()))
 {
 }
@@ -35,6 +35,8 @@
 #include "tsTelnetConnection.h"
 #include "tsGuardMutex.h"
 #include "tsSysUtils.h"
+#include "tsjsonObject.h"
+#include "tsTextFormatter.h"
 
 
 //----------------------------------------------------------------------------
@@ -75,6 +77,7 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, Mut
     _reference.setCommandLineHandler(this, &ControlServer::executeExit, u"exit");
     _reference.setCommandLineHandler(this, &ControlServer::executeSetLog, u"set-log");
     _reference.setCommandLineHandler(this, &ControlServer::executeList, u"list");
+    _reference.setCommandLineHandler(this, &ControlServer::executeStatistics, u"statistics");
     _reference.setCommandLineHandler(this, &ControlServer::executeSuspend, u"suspend");
     _reference.setCommandLineHandler(this, &ControlServer::executeResume, u"resume");
     _reference.setCommandLineHandler(this, &ControlServer::executeRestart, u"restart");
@@ -261,14 +264,61 @@ void ts::tsp::ControlServer::listOnePlugin(size_t index, UChar type, PluginExecu
 {
     const bool verbose = report.verbose();
     const bool suspended = plugin->getSuspended();
-    report.info(u"%2d: %s-%c %s", {
+    report.info(u"%2d: %s%s-%c %s", {
                 index,
                 verbose && suspended ? u"(suspended) " : u"",
+                verbose && plugin->isFused() ? u"(fused) " : u"",
                 type,
                 verbose ? plugin->plugin()->commandLine() : plugin->pluginName() });
 }
 
 
+//----------------------------------------------------------------------------
+// Statistics command.
+//----------------------------------------------------------------------------
+
+ts::CommandStatus ts::tsp::ControlServer::executeStatistics(const UString& command, Args& args)
+{
+    if (!_options.plugin_stats) {
+        args.error(u"plugin statistics are not collected, use tsp option --plugin-statistics");
+        return CommandStatus::ERROR;
+    }
+
+    if (args.present(u"json")) {
+        json::Object root;
+        _input->allStatisticsToJSON(root);
+        TextFormatter text(args);
+        text.setString();
+        text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+        root.print(text);
+        UString line;
+        text.getString(line);
+        args.info(line);
+    }
+    else {
+        statisticsOnePlugin(0, u'I', _input, args);
+        size_t index = 1;
+        for (size_t i = 0; i < _plugins.size(); ++i) {
+            statisticsOnePlugin(index++, u'P', _plugins[i], args);
+        }
+        statisticsOnePlugin(index, u'O', _output, args);
+    }
+
+    if (args.present(u"reset")) {
+        PluginExecutor* proc = _input;
+        do {
+            proc->resetStatistics();
+        } while ((proc = proc->ringNext<PluginExecutor>()) != _input);
+    }
+    return CommandStatus::SUCCESS;
+}
+
+void ts::tsp::ControlServer::statisticsOnePlugin(size_t index, UChar type, PluginExecutor* plugin, Report& report)
+{
+    report.info(u"%2d: %c-%s: %s", {index, type, plugin->pluginName(), plugin->statistics().toString(report.verbose())});
+}
+
+
 //----------------------------------------------------------------------------
 // Suspend/resume commands.
 //----------------------------------------------------------------------------
@@ -260,7 +260,15 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
     if (_use_watchdog) {
         _watchdog.restart();
     }
-    size_t count = _input->receive(pkt, data, max_packets);
+    size_t count = 0;
+    if (_options.plugin_stats) {
+        const Monotonic start(true);
+        count = _input->receive(pkt, data, max_packets);
+        _stats.addCall(Monotonic(true) - start, count);
+    }
+    else {
+        count = _input->receive(pkt, data, max_packets);
+    }
     _plugin_completed = _plugin_completed || count == 0;
     if (_use_watchdog) {
         _watchdog.suspend();
@@ -459,8 +467,9 @@ void ts::tsp::InputExecutor::main()
         }
 
         // Do not read more packets than request by --max-input-packets
-        if (_options.max_input_pkt > 0 && pkt_max > _options.max_input_pkt) {
-            pkt_max = _options.max_input_pkt;
+        const size_t max_input_pkt = maxInputPackets();
+        if (max_input_pkt > 0 && pkt_max > max_input_pkt) {
+            pkt_max = max_input_pkt;
         }
 
         // Now read at most the specified number of packets (pkt_max).
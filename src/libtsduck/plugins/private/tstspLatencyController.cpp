@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspLatencyController.h"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::tsp::LatencyController::MIN_BATCH;
+constexpr size_t ts::tsp::LatencyController::MARK_COUNT;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::LatencyController::LatencyController(const TSProcessorArgs& options, Report& report) :
+    _report(report),
+    _origin(true),
+    _target(options.latency_target * NanoSecPerMilliSec),
+    _interval(std::max<NanoSecond>(NanoSecPerMilliSec, _target / 4)),
+    _max_flush(options.max_flush_pkt > 0 ? options.max_flush_pkt : NPOS),
+    _max_input(options.max_input_pkt > 0 ? options.max_input_pkt : NPOS),
+    _max_output(options.max_output_pkt > 0 ? options.max_output_pkt : NPOS),
+    _max_batch(std::max(MIN_BATCH, std::min(options.ts_buffer_size / PKT_SIZE / 4, std::max(_max_flush == NPOS ? 0 : _max_flush, _max_input == NPOS ? 0 : _max_input)))),
+    _batch(MIN_BATCH),
+    _last_latency(0),
+    _last_adjust(0),
+    _input_count(0),
+    _output_count(0),
+    _mark_head(0),
+    _mark_tail(0),
+    _marks()
+{
+    _report.debug(u"latency target: %'d ms, batch size from %'d to %'d packets", {options.latency_target, MIN_BATCH, _max_batch});
+}
+
+
+//----------------------------------------------------------------------------
+// Report packets which are passed by the input executor.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyController::inputPackets(size_t count)
+{
+    _input_count += count;
+
+    // Record a mark for the last packet, unless all marks are in use.
+    const size_t head = _mark_head.load(std::memory_order_relaxed);
+    if (count > 0 && head - _mark_tail.load(std::memory_order_acquire) < MARK_COUNT) {
+        Mark& mark(_marks[head % MARK_COUNT]);
+        mark.sequence = _input_count;
+        mark.time = now();
+        _mark_head.store(head + 1, std::memory_order_release);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Report packets which are released by the output executor.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyController::outputPackets(size_t count, const BitRate& bitrate)
+{
+    _output_count += count;
+
+    // Consume all marks for packets which are now released.
+    const size_t head = _mark_head.load(std::memory_order_acquire);
+    size_t tail = _mark_tail.load(std::memory_order_relaxed);
+    NanoSecond time = -1;
+    while (tail != head && _marks[tail % MARK_COUNT].sequence <= _output_count) {
+        time = _marks[tail % MARK_COUNT].time;
+        tail++;
+    }
+    _mark_tail.store(tail, std::memory_order_release);
+
+    // Use the most recent mark as latency sample.
+    if (time >= 0) {
+        adjust(now() - time, bitrate);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Adjust the batch size from a measured latency.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyController::adjust(NanoSecond latency, const BitRate& bitrate)
+{
+    _last_latency = latency;
+
+    // Wait for the effect of the previous adjustment.
+    const NanoSecond current = now();
+    if (current - _last_adjust < _interval) {
+        return;
+    }
+
+    const size_t previous = _batch;
+    size_t batch = previous;
+
+    if (latency > _target) {
+        // Latency exceeded, reduce batches quickly.
+        batch = std::max(MIN_BATCH, batch / 2);
+    }
+    else if (latency < _target / 2) {
+        // Far below target, slowly increase batches for throughput.
+        batch += std::max<size_t>(1, batch / 8);
+    }
+
+    // Never exceed the number of packets which are received during a quarter of the target.
+    const uint64_t bps = bitrate.toInt();
+    if (bps > 0) {
+        const uint64_t limit = (bps * uint64_t(_target)) / (4 * PKT_SIZE_BITS * uint64_t(NanoSecPerSec));
+        batch = std::min<size_t>(batch, std::max<size_t>(MIN_BATCH, size_t(limit)));
+    }
+    batch = std::min(batch, _max_batch);
+
+    if (batch != previous) {
+        _batch = batch;
+        _last_adjust = current;
+        _report.log(10, u"latency: %'d us, target: %'d us, batch size: %'d -> %'d packets", {latency / 1000, _target / 1000, previous, batch});
+    }
+}
@@ -0,0 +1,152 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Adaptive batch sizes for a latency target
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSProcessorArgs.h"
+#include "tsMonotonic.h"
+#include "tsReport.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Adaptive batch sizes in tsp for a latency target (option -\-latency-target).
+        //! This class is internal to the TSDuck library and cannot be called by applications.
+        //! @ingroup plugin
+        //!
+        //! The end-to-end delay of packets inside tsp is measured from the time they are passed
+        //! by the input executor to the time they are released by the output executor. Because
+        //! packets are never reordered in the global buffer, the N-th packet from the input is
+        //! the N-th packet which is released by the output. The input executor periodically
+        //! records (packet sequence number, time) marks, the output executor uses them to
+        //! compute the delay of the corresponding packets.
+        //!
+        //! The maximum number of packets per flush, input and output operation are adapted
+        //! from this delay: halved when the delay exceeds the target, slowly increased when the
+        //! delay is below half the target. They are also bounded by the number of packets which
+        //! are received during a fraction of the target at the current bitrate. They never exceed
+        //! the values from the command line (-\-max-flushed-packets, -\-max-input-packets,
+        //! -\-max-output-packets).
+        //!
+        class LatencyController
+        {
+            TS_NOBUILD_NOCOPY(LatencyController);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] options Command line options for tsp, after applying the defaults.
+            //! @param [in,out] report Where to report logs.
+            //!
+            LatencyController(const TSProcessorArgs& options, Report& report);
+
+            //!
+            //! Minimum batch size in packets (the content of one UDP datagram).
+            //!
+            static constexpr size_t MIN_BATCH = 7;
+
+            //!
+            //! Get the current maximum number of processed packets before flush.
+            //! @return The current maximum number of processed packets before flush.
+            //!
+            size_t maxFlushPackets() const { return std::min<size_t>(_batch, _max_flush); }
+
+            //!
+            //! Get the current maximum number of packets per input operation.
+            //! @return The current maximum number of packets per input operation.
+            //!
+            size_t maxInputPackets() const { return std::min<size_t>(_batch, _max_input); }
+
+            //!
+            //! Get the current maximum number of packets per output operation.
+            //! @return The current maximum number of packets per output operation.
+            //!
+            size_t maxOutputPackets() const { return std::min<size_t>(_batch, _max_output); }
+
+            //!
+            //! Get the last measured end-to-end delay.
+            //! @return The last measured end-to-end delay in nanoseconds.
+            //!
+            NanoSecond lastLatency() const { return _last_latency; }
+
+            //!
+            //! Report packets which are passed by the input executor.
+            //! Must be called from the input executor thread only.
+            //! @param [in] count Number of packets.
+            //!
+            void inputPackets(size_t count);
+
+            //!
+            //! Report packets which are released by the output executor.
+            //! Must be called from the output executor thread only.
+            //! @param [in] count Number of packets.
+            //! @param [in] bitrate Current bitrate.
+            //!
+            void outputPackets(size_t count, const BitRate& bitrate);
+
+        private:
+            // Input mark: time when a given packet was passed by the input executor.
+            class Mark
+            {
+            public:
+                Mark() : sequence(0), time(0) {}
+                PacketCounter sequence;  // Packet sequence number, counted from the start.
+                NanoSecond    time;      // Time in nanoseconds since start.
+            };
+
+            static constexpr size_t MARK_COUNT = 256;  // Max number of pending marks.
+
+            Report&                  _report;
+            const Monotonic          _origin;        // Time reference.
+            const NanoSecond         _target;        // Latency target in nanoseconds.
+            const NanoSecond         _interval;      // Minimum interval between two adjustments.
+            const size_t             _max_flush;     // Upper bound for --max-flushed-packets.
+            const size_t             _max_input;     // Upper bound for --max-input-packets.
+            const size_t             _max_output;    // Upper bound for --max-output-packets.
+            const size_t             _max_batch;     // Upper bound for the batch size.
+            std::atomic<size_t>      _batch;         // Current batch size.
+            std::atomic<NanoSecond>  _last_latency;  // Last measured latency.
+            NanoSecond               _last_adjust;   // Time of last adjustment (output thread only).
+            PacketCounter            _input_count;   // Number of input packets (input thread only).
+            PacketCounter            _output_count;  // Number of output packets (output thread only).
+            std::atomic<size_t>      _mark_head;     // Next mark to write (written by input thread only).
+            std::atomic<size_t>      _mark_tail;     // Next mark to read (written by output thread only).
+            Mark                     _marks[MARK_COUNT];
+
+            // Current time in nanoseconds since start.
+            NanoSecond now() const { return Monotonic(true) - _origin; }
+
+            // Adjust the batch size from a measured latency.
+            void adjust(NanoSecond latency, const BitRate& bitrate);
+        };
+    }
+}
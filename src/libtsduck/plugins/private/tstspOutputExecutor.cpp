@@ -28,6 +28,9 @@
 //----------------------------------------------------------------------------
 
 #include "tstspOutputExecutor.h"
+#include "tsjsonObject.h"
+#include "tsTextFormatter.h"
+#include "tsMonotonic.h"
 
 
 //----------------------------------------------------------------------------
@@ -42,7 +45,9 @@ ts::tsp::OutputExecutor::OutputExecutor(const TSProcessorArgs& options,
                                         Report* report) :
 
     PluginExecutor(options, handlers, PluginType::OUTPUT, pl_options, attributes, global_mutex, report),
-    _output(dynamic_cast<OutputPlugin*>(PluginThread::plugin()))
+    _output(dynamic_cast<OutputPlugin*>(PluginThread::plugin())),
+    _stats_due(),
+    _stats_file()
 {
     if (options.log_plugin_index) {
         // Make sure that plugins display their index. Output plugin is always last.
@@ -67,6 +72,54 @@ size_t ts::tsp::OutputExecutor::pluginIndex() const
 }
 
 
+//----------------------------------------------------------------------------
+// Send packets to the output plugin, with optional statistics.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::OutputExecutor::send(const TSPacket* pkt, const TSPacketMetadata* data, size_t count)
+{
+    if (!_options.plugin_stats) {
+        return _output->send(pkt, data, count);
+    }
+    else {
+        const Monotonic start(true);
+        const bool ok = _output->send(pkt, data, count);
+        _stats.addCall(Monotonic(true) - start, count);
+        return ok;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Report the statistics of all plugins as one line of JSON.
+//----------------------------------------------------------------------------
+
+void ts::tsp::OutputExecutor::reportStatistics()
+{
+    const Time now(Time::CurrentLocalTime());
+    _stats_due = Time::CurrentUTC() + _options.stats_interval;
+
+    json::Object root;
+    root.add(u"time", now.format(Time::DATETIME));
+    allStatisticsToJSON(root);
+
+    // Generate one JSON line.
+    TextFormatter text(*this);
+    text.setString();
+    text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+    root.print(text);
+    UString line;
+    text.getString(line);
+
+    if (_stats_file.is_open()) {
+        _stats_file << line << std::endl;
+    }
+    else {
+        info(line);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Output plugin thread
 //----------------------------------------------------------------------------
@@ -79,6 +132,17 @@ void ts::tsp::OutputExecutor::main()
     bool aborted = false;
     bool restarted = false;
 
+    // Prepare periodic reports of plugin statistics.
+    if (_options.stats_interval > 0) {
+        _stats_due = Time::CurrentUTC() + _options.stats_interval;
+        if (!_options.stats_file.empty()) {
+            _stats_file.open(_options.stats_file.toUTF8().c_str(), std::ios::out | std::ios::app);
+            if (!_stats_file) {
+                error(u"cannot create statistics file %s", {_options.stats_file});
+            }
+        }
+    }
+
     do {
         // Wait for packets to output
         size_t pkt_first = 0;
@@ -142,12 +206,12 @@ void ts::tsp::OutputExecutor::main()
 
             // Output contiguous ranges of non-dropped packets with respect to --max-output-packets.
             while (!aborted && out_cnt > 0) {
-                const size_t out_subcnt = std::min(out_cnt, _options.max_output_pkt);
+                const size_t out_subcnt = std::min(out_cnt, maxOutputPackets());
                 if (_suspended) {
                     // Don't output packet when the plugin is suspended.
                     addNonPluginPackets(out_subcnt);
                 }
-                else if (_output->send(pkt, data, out_subcnt)) {
+                else if (send(pkt, data, out_subcnt)) {
                     // Packet successfully sent.
                     addPluginPackets(out_subcnt);
                     output_packets += out_subcnt;
@@ -165,11 +229,23 @@ void ts::tsp::OutputExecutor::main()
         }
 
         // Pass free buffers to input processor.
-        // Do not transmit bitrate or input end to next (since next is input processor).
-        aborted = !passPackets(pkt_cnt, 0, BitRateConfidence::LOW, false, aborted);
+        // Do not transmit input end to next (since next is input processor). The bitrate is ignored
+        // by the input processor but it is used by the latency controller (--latency-target).
+        aborted = !passPackets(pkt_cnt, _tsp_bitrate, _tsp_bitrate_confidence, false, aborted);
+
+        // Periodic report of plugin statistics.
+        if (_options.stats_interval > 0 && Time::CurrentUTC() >= _stats_due) {
+            reportStatistics();
+        }
 
     } while (!aborted);
 
+    // Final report of plugin statistics.
+    if (_options.stats_interval > 0) {
+        reportStatistics();
+        _stats_file.close();
+    }
+
     // Close the output processor.
     debug(u"stopping the output plugin");
     _output->stop();
@@ -35,6 +35,7 @@
 #pragma once
 #include "tstspPluginExecutor.h"
 #include "tsOutputPlugin.h"
+#include "tsTime.h"
 
 namespace ts {
     namespace tsp {
@@ -73,9 +74,17 @@ namespace ts {
 
         private:
             OutputPlugin* _output;
+            Time          _stats_due;   // Next periodic report of plugin statistics.
+            std::ofstream _stats_file;  // Output file for periodic reports of plugin statistics.
 
             // Inherited from Thread
             virtual void main() override;
+
+            // Send packets to the output plugin, with optional statistics.
+            bool send(const TSPacket* pkt, const TSPacketMetadata* data, size_t count);
+
+            // Report the statistics of all plugins as one line of JSON (--statistics-interval).
+            void reportStatistics();
         };
     }
 }
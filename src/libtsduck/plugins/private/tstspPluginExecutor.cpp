@@ -31,6 +31,8 @@
 #include "tsPluginRepository.h"
 #include "tsGuardCondition.h"
 #include "tsGuardMutex.h"
+#include "tsMonotonic.h"
+#include "tsjson.h"
 
 
 //----------------------------------------------------------------------------
@@ -50,6 +52,9 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _buffer(nullptr),
     _metadata(nullptr),
     _suspended(false),
+    _stats(),
+    _runner(this),
+    _latency(nullptr),
     _handlers(handlers),
     _to_do(),
     _pkt_first(0),
@@ -58,7 +63,15 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _bitrate(0),
     _br_confidence(BitRateConfidence::LOW),
     _restart(false),
-    _restart_data()
+    _restart_data(),
+    _lf_mutex(),
+    _lf_cond(),
+    _lf_waiting(false),
+    _lf_bitrate_changed(false),
+    _lf_bitrate(0),
+    _lf_br_confidence(BitRateConfidence::LOW),
+    _lf_sent_bitrate(0),
+    _lf_sent_confidence(BitRateConfidence::LOW)
 {
     // Preset common default options.
     if (plugin() != nullptr) {
@@ -94,15 +107,73 @@ void ts::tsp::PluginExecutor::signalPluginEvent(uint32_t event_code, Object* plu
 }
 
 
+//----------------------------------------------------------------------------
+// Next and previous executors which run a thread, skipping fused plugins.
+//----------------------------------------------------------------------------
+
+ts::tsp::PluginExecutor* ts::tsp::PluginExecutor::nextRunner()
+{
+    PluginExecutor* next = ringNext<PluginExecutor>();
+    while (next->isFused()) {
+        next = next->ringNext<PluginExecutor>();
+    }
+    return next;
+}
+
+ts::tsp::PluginExecutor* ts::tsp::PluginExecutor::previousRunner()
+{
+    PluginExecutor* previous = ringPrevious<PluginExecutor>();
+    while (previous->isFused()) {
+        previous = previous->ringPrevious<PluginExecutor>();
+    }
+    return previous;
+}
+
+
 //----------------------------------------------------------------------------
 // This method sets the current processor in an abort state.
 //----------------------------------------------------------------------------
 
 void ts::tsp::PluginExecutor::setAbort()
 {
-    GuardMutex lock(_global_mutex);
-    _tsp_aborting = true;
-    ringPrevious<PluginExecutor>()->_to_do.signal();
+    if (_options.lockfree_handoff) {
+        _tsp_aborting = true;
+        previousRunner()->wakeUpLockFree(true);
+    }
+    else {
+        GuardMutex lock(_global_mutex);
+        _tsp_aborting = true;
+        previousRunner()->_to_do.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build a JSON report of the performance statistics of all plugins.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::allStatisticsToJSON(json::Value& root) const
+{
+    // Sort all executors in the ring by plugin index.
+    std::vector<const PluginExecutor*> all(pluginCount(), nullptr);
+    const PluginExecutor* proc = this;
+    do {
+        if (proc->pluginIndex() < all.size()) {
+            all[proc->pluginIndex()] = proc;
+        }
+    } while ((proc = proc->ringNext<PluginExecutor>()) != this);
+
+    for (const auto& pe : all) {
+        if (pe != nullptr && pe->plugin() != nullptr) {
+            json::Value& jv(root.query(u"plugins[]", true));
+            jv.add(u"index", pe->pluginIndex());
+            jv.add(u"type", PluginTypeNames.name(pe->plugin()->type()));
+            jv.add(u"name", pe->pluginName());
+            jv.add(u"suspended", json::Bool(pe->getSuspended()));
+            jv.add(u"total-packets", pe->totalPacketsInThread());
+            pe->statistics().toJSON(jv);
+        }
+    }
 }
 
 
@@ -142,6 +213,11 @@ void ts::tsp::PluginExecutor::initBuffer(PacketBuffer*         buffer,
     _br_confidence = br_confidence;
     _tsp_bitrate = bitrate;
     _tsp_bitrate_confidence = br_confidence;
+    _lf_bitrate_changed = false;
+    _lf_bitrate = bitrate;
+    _lf_br_confidence = br_confidence;
+    _lf_sent_bitrate = bitrate;
+    _lf_sent_confidence = br_confidence;
 }
 
 
@@ -155,6 +231,20 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", {count, bitrate, input_end, aborted});
 
+    // Measure the end-to-end delay for --latency-target.
+    if (_latency != nullptr && count > 0) {
+        if (plugin()->type() == PluginType::INPUT) {
+            _latency->inputPackets(count);
+        }
+        else if (plugin()->type() == PluginType::OUTPUT) {
+            _latency->outputPackets(count, bitrate);
+        }
+    }
+
+    if (_options.lockfree_handoff) {
+        return passPacketsLockFree(count, bitrate, br_confidence, input_end, aborted);
+    }
+
     // We access data under the protection of the global mutex.
     GuardMutex lock(_global_mutex);
 
@@ -163,7 +253,7 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
     _pkt_cnt -= count;
 
     // Update next processor's buffer: add 'count' packets at the end of its slice of the buffer.
-    PluginExecutor* next = ringNext<PluginExecutor>();
+    PluginExecutor* next = nextRunner();
     next->_pkt_cnt += count;
 
     // Propagate bitrate and end of input flag to next processor.
@@ -184,8 +274,8 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 
     // Wake the previous processor when we abort (propagate abort conditions backward).
     if (aborted) {
-        _tsp_aborting = true; // volatile bool in TSP superclass
-        ringPrevious<PluginExecutor>()->_to_do.signal();
+        _tsp_aborting = true; // atomic bool in TSP superclass
+        previousRunner()->_to_do.signal();
     }
 
     // Return false when the current processor shall stop.
@@ -209,10 +299,33 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
         min_pkt_cnt = _buffer->count();
     }
 
+    if (!_options.plugin_stats) {
+        waitWorkDispatch(min_pkt_cnt, pkt_first, pkt_cnt, bitrate, br_confidence, input_end, aborted, timeout);
+    }
+    else {
+        // Account the wait time and the high-water mark of our area in the buffer.
+        const Monotonic start(true);
+        waitWorkDispatch(min_pkt_cnt, pkt_first, pkt_cnt, bitrate, br_confidence, input_end, aborted, timeout);
+        _stats.addWait(Monotonic(true) - start, _pkt_cnt);
+    }
+
+    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
+        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+}
+
+void ts::tsp::PluginExecutor::waitWorkDispatch(size_t min_pkt_cnt, size_t& pkt_first, size_t& pkt_cnt,
+                                               BitRate& bitrate, BitRateConfidence& br_confidence,
+                                               bool& input_end, bool& aborted, bool &timeout)
+{
+    if (_options.lockfree_handoff) {
+        waitWorkLockFree(min_pkt_cnt, pkt_first, pkt_cnt, bitrate, br_confidence, input_end, aborted, timeout);
+        return;
+    }
+
     // We access data under the protection of the global mutex.
     GuardCondition lock(_global_mutex, _to_do);
 
-    PluginExecutor* next = ringNext<PluginExecutor>();
+    PluginExecutor* next = nextRunner();
     timeout = false;
 
     // Loop until enough packets are available (or some error condition).
@@ -233,7 +346,7 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     }
     else if (_pkt_first + min_pkt_cnt <= _buffer->count()) {
         // Return up to the wrap-up point. This will satisfy the requested minimum.
-        pkt_cnt = std::min(_pkt_cnt, _buffer->count() - _pkt_first);
+        pkt_cnt = std::min(_pkt_cnt.load(), _buffer->count() - _pkt_first);
     }
     else {
         // The requested minimum does not fit into a contiguous area.
@@ -249,9 +362,135 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     // Don't do that if current is output and next is input because
     // there is no propagation of packets from output back to input.
     aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
+}
 
-    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
-        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+
+//----------------------------------------------------------------------------
+// Lock-free packet handoff (--lock-free-handoff).
+//
+// The packet areas of two adjacent executors are exchanged through atomic
+// counters only: _pkt_cnt is incremented by the previous executor and
+// decremented by the owner, _pkt_first is private to the owner. The global
+// mutex is never used. An executor which has nothing to do first spins a
+// few times and then parks on its own condition. The previous executor
+// signals the condition only when the executor is known to be parked.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::wakeUpLockFree(bool force)
+{
+    // Sequentially consistent load: either we see _lf_waiting set by the parking thread
+    // or the parking thread sees the updated counters before waiting.
+    if (force || _lf_waiting.load()) {
+        GuardCondition lock(_lf_mutex, _lf_cond);
+        lock.signal();
+    }
+}
+
+bool ts::tsp::PluginExecutor::passPacketsLockFree(size_t count, const BitRate& bitrate, BitRateConfidence br_confidence, bool input_end, bool aborted)
+{
+    PluginExecutor* next = nextRunner();
+
+    // Update our buffer: we remove the first 'count' packets from the beginning of our slice of the buffer.
+    _pkt_first = (_pkt_first + count) % _buffer->count();
+    _pkt_cnt -= count;
+
+    // Propagate the bitrate to next processor, only when it changes, before passing the packets.
+    if (bitrate != _lf_sent_bitrate || br_confidence != _lf_sent_confidence) {
+        {
+            GuardMutex lock(next->_lf_mutex);
+            next->_bitrate = bitrate;
+            next->_br_confidence = br_confidence;
+        }
+        next->_lf_bitrate_changed = true;
+        _lf_sent_bitrate = bitrate;
+        _lf_sent_confidence = br_confidence;
+    }
+
+    // Update next processor's buffer: add 'count' packets at the end of its slice of the buffer.
+    // The end of input is set after the packets so that next processor never sees the end of input
+    // without the corresponding packets.
+    next->_pkt_cnt += count;
+    if (input_end) {
+        next->_input_end = true;
+    }
+
+    // Wake the next processor when there is some new input data or end of input.
+    if (count > 0 || input_end) {
+        next->wakeUpLockFree(false);
+    }
+
+    // Force to abort our processor when the next one is aborting (see passPackets()).
+    if (plugin()->type() != PluginType::OUTPUT) {
+        aborted = aborted || next->_tsp_aborting;
+    }
+
+    // Wake the previous processor when we abort (propagate abort conditions backward).
+    if (aborted) {
+        _tsp_aborting = true;
+        previousRunner()->wakeUpLockFree(true);
+    }
+
+    // Return false when the current processor shall stop.
+    return !input_end && !aborted;
+}
+
+void ts::tsp::PluginExecutor::waitWorkLockFree(size_t min_pkt_cnt, size_t& pkt_first, size_t& pkt_cnt,
+                                               BitRate& bitrate, BitRateConfidence& br_confidence,
+                                               bool& input_end, bool& aborted, bool &timeout)
+{
+    PluginExecutor* next = nextRunner();
+    timeout = false;
+
+    // Always read the end of input before the packet count (see passPacketsLockFree()).
+    bool end = _input_end;
+    size_t cnt = _pkt_cnt;
+
+    // First, spin a few times, waiting for enough packets without sleeping.
+    for (size_t spin = 0; cnt < min_pkt_cnt && !end && !next->_tsp_aborting && spin < _options.handoff_spin; ++spin) {
+        Thread::Yield();
+        end = _input_end;
+        cnt = _pkt_cnt;
+    }
+
+    // Then park the thread until enough packets are available (or some error condition).
+    if (cnt < min_pkt_cnt && !end && !next->_tsp_aborting) {
+        GuardCondition lock(_lf_mutex, _lf_cond);
+        _lf_waiting = true;
+        for (;;) {
+            end = _input_end;
+            cnt = _pkt_cnt;
+            if (cnt >= min_pkt_cnt || end || timeout || next->_tsp_aborting) {
+                break;
+            }
+            timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+        }
+        _lf_waiting = false;
+    }
+
+    // The number of returned packets is limited up to the wrap-up point of the circular buffer,
+    // if allowed by the requested minimum number of packets.
+    if (timeout) {
+        pkt_cnt = 0;
+    }
+    else if (_pkt_first + min_pkt_cnt <= _buffer->count()) {
+        pkt_cnt = std::min(cnt, _buffer->count() - _pkt_first);
+    }
+    else {
+        pkt_cnt = cnt;
+    }
+
+    // Refresh our copy of the input bitrate if the previous processor changed it.
+    if (_lf_bitrate_changed.exchange(false)) {
+        GuardMutex lock(_lf_mutex);
+        _lf_bitrate = _bitrate;
+        _lf_br_confidence = _br_confidence;
+    }
+
+    pkt_first = _pkt_first;
+    bitrate = _lf_bitrate;
+    br_confidence = _lf_br_confidence;
+    input_end = end && pkt_cnt == cnt;
+    aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
 }
 
 
@@ -289,7 +528,7 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
     // Acquire the global mutex to modify global data.
     // To avoid deadlocks, always acquire the global mutex first, then a RestartData mutex.
     {
-        GuardCondition lock1(_global_mutex, _to_do);
+        GuardMutex lock1(_global_mutex);
 
         // If there was a previous pending restart operation, cancel it.
         if (!_restart_data.isNull()) {
@@ -305,7 +544,11 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
         _restart = true;
 
         // Signal the plugin thread that there is something to do.
-        lock1.signal();
+        // When the plugin is fused, this is the thread of the first plugin in the group.
+        _runner->_to_do.signal();
+    }
+    if (_options.lockfree_handoff) {
+        _runner->wakeUpLockFree(true);
     }
 
     // Now wait for the restart operation to complete.
@@ -322,6 +565,10 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
 
 bool ts::tsp::PluginExecutor::pendingRestart()
 {
+    // Fast path without the global mutex, _restart is atomic.
+    if (!_restart) {
+        return false;
+    }
     GuardMutex lock(_global_mutex);
     return _restart && !_restart_data.isNull();
 }
@@ -333,6 +580,13 @@ bool ts::tsp::PluginExecutor::pendingRestart()
 
 bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
 {
+    // Fast path without the global mutex, _restart is atomic. This is checked
+    // for each chunk of packets, avoid contention on the global mutex.
+    if (!_restart) {
+        restarted = false;
+        return true;
+    }
+
     // Run under the protection of the global mutex.
     // To avoid deadlocks, always acquire the global mutex first, then a RestartData mutex.
     GuardMutex lock1(_global_mutex);
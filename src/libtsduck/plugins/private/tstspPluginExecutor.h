@@ -34,6 +34,8 @@
 
 #pragma once
 #include "tstspJointTermination.h"
+#include "tstspPluginStatistics.h"
+#include "tstspLatencyController.h"
 #include "tsRingNode.h"
 #include "tsTSProcessorArgs.h"
 #include "tsPluginEventHandlerRegistry.h"
@@ -103,6 +105,14 @@ namespace ts {
             //!
             void setRealTimeForAll(bool on) { _use_realtime = on; }
 
+            //!
+            //! Set the controller of batch sizes for a latency target (tsp option -\-latency-target).
+            //! Must be called before starting the executor threads.
+            //! @param [in] latency Address of the controller. Must remain valid while the executor is running.
+            //! If null, the batch sizes are fixed, as specified in the tsp options.
+            //!
+            void setLatencyController(LatencyController* latency) { _latency = latency; }
+
             //!
             //! This method sets the current packet processor in an abort state.
             //!
@@ -130,6 +140,14 @@ namespace ts {
             //!
             bool getSuspended() const { return _suspended; }
 
+            //!
+            //! Check if the plugin is fused in the thread of a previous plugin (tsp option -\-fuse-plugins).
+            //! A fused plugin has no active thread of its own. Its packets are processed by the thread
+            //! of the first plugin of its group.
+            //! @return True when the plugin is fused in the thread of a previous plugin.
+            //!
+            bool isFused() const { return _runner != this; }
+
             //!
             //! Restart the plugin with new parameters.
             //! This method is called from another thread, not the plugin thread.
@@ -145,6 +163,26 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Get the performance statistics of the plugin.
+            //! The statistics are collected only when the tsp option @c -\-plugin-statistics is specified.
+            //! @return A constant reference to the performance statistics of the plugin.
+            //!
+            const PluginStatistics& statistics() const { return _stats; }
+
+            //!
+            //! Reset the performance statistics of the plugin.
+            //! This method can be called from another thread.
+            //!
+            void resetStatistics() { _stats.reset(); }
+
+            //!
+            //! Build a JSON report of the performance statistics of all plugins in the chain.
+            //! One object per plugin, in plugin index order, is added in the array "plugins" of @a root.
+            //! @param [in,out] root The JSON object to update.
+            //!
+            void allStatisticsToJSON(json::Value& root) const;
+
             // Implementation of TSP virtual methods.
             virtual size_t pluginCount() const override;
             virtual void signalPluginEvent(uint32_t event_code, Object* plugin_data = nullptr) const override;
@@ -153,6 +191,39 @@ namespace ts {
             PacketBuffer*         _buffer;    //!< Description of shared packet buffer.
             PacketMetadataBuffer* _metadata;  //!< Description of shared packet metadata buffer.
             volatile bool         _suspended; //!< The plugin is suspended / resumed.
+            PluginStatistics      _stats;     //!< Performance statistics, updated only with option -\-plugin-statistics.
+            PluginExecutor*       _runner;    //!< Executor whose thread runs this plugin (this one, unless fused).
+            LatencyController*    _latency;   //!< Adaptive batch sizes, null when not used.
+
+            //!
+            //! Get the current maximum number of processed packets before flush.
+            //! @return The current maximum number of processed packets before flush, zero if unlimited.
+            //!
+            size_t maxFlushPackets() const { return _latency == nullptr ? _options.max_flush_pkt : _latency->maxFlushPackets(); }
+
+            //!
+            //! Get the current maximum number of packets per input operation.
+            //! @return The current maximum number of packets per input operation, zero if unlimited.
+            //!
+            size_t maxInputPackets() const { return _latency == nullptr ? _options.max_input_pkt : _latency->maxInputPackets(); }
+
+            //!
+            //! Get the current maximum number of packets per output operation.
+            //! @return The current maximum number of packets per output operation.
+            //!
+            size_t maxOutputPackets() const { return _latency == nullptr ? _options.max_output_pkt : _latency->maxOutputPackets(); }
+
+            //!
+            //! Get the next executor in the chain which runs a thread, skipping fused plugins.
+            //! @return The executor to which the processed packets are passed.
+            //!
+            PluginExecutor* nextRunner();
+
+            //!
+            //! Get the previous executor in the chain which runs a thread, skipping fused plugins.
+            //! @return The executor from which the packets are received.
+            //!
+            PluginExecutor* previousRunner();
 
             //!
             //! Pass processed packets to the next packet processor.
@@ -218,6 +289,21 @@ namespace ts {
             bool processPendingRestart(bool& restarted);
 
         private:
+            // Actual wait for work, without statistics, in mutex or lock-free mode.
+            void waitWorkDispatch(size_t min_pkt_cnt, size_t& pkt_first, size_t& pkt_cnt,
+                                  BitRate& bitrate, BitRateConfidence& br_confidence,
+                                  bool& input_end, bool& aborted, bool &timeout);
+
+            // Lock-free variants of passPackets() and waitWork(), used with --lock-free-handoff.
+            bool passPacketsLockFree(size_t count, const BitRate& bitrate, BitRateConfidence br_confidence, bool input_end, bool aborted);
+            void waitWorkLockFree(size_t min_pkt_cnt, size_t& pkt_first, size_t& pkt_cnt,
+                                  BitRate& bitrate, BitRateConfidence& br_confidence,
+                                  bool& input_end, bool& aborted, bool &timeout);
+
+            // Wake up the plugin thread if it is parked in waitWorkLockFree().
+            // If force is true, always signal the condition, even if the thread is not known to be parked.
+            void wakeUpLockFree(bool force);
+
             // Registry of plugin event handlers.
             const PluginEventHandlerRegistry& _handlers;
 
@@ -228,14 +314,29 @@ namespace ts {
             // The following private data must be accessed exclusively under the protection of the global mutex.
             // Implementation details: see the file src/docs/developing-plugins.dox.
             // [*] After initialization, these fields are read/written only in passPackets() and waitWork().
-            Condition         _to_do;          // Notify processor to do something.
-            size_t            _pkt_first;      // Starting index of packets area [*]
-            size_t            _pkt_cnt;        // Size of packets area [*]
-            bool              _input_end;      // No more packet after current ones [*]
-            BitRate           _bitrate;        // Input bitrate (set by previous plugin) [*]
-            BitRateConfidence _br_confidence;  // Input bitrate confidence (set by previous plugin) [*]
-            bool              _restart;        // Restart the plugin asap using _restart_data
-            RestartDataPtr    _restart_data;   // How to restart the plugin
+            // [L] With --lock-free-handoff, these fields are accessed without the global mutex (see below).
+            Condition           _to_do;          // Notify processor to do something.
+            size_t              _pkt_first;      // Starting index of packets area [*] [L]
+            std::atomic<size_t> _pkt_cnt;        // Size of packets area [*] [L]
+            std::atomic<bool>   _input_end;      // No more packet after current ones [*] [L]
+            BitRate             _bitrate;        // Input bitrate (set by previous plugin) [*]
+            BitRateConfidence   _br_confidence;  // Input bitrate confidence (set by previous plugin) [*]
+            std::atomic<bool>   _restart;        // Restart the plugin asap using _restart_data
+            RestartDataPtr      _restart_data;   // How to restart the plugin
+
+            // Private data for --lock-free-handoff mode.
+            // _pkt_first is written by this executor only. _pkt_cnt is incremented by the previous executor
+            // and decremented by this one. The bitrate fields above are written by the previous executor
+            // under the protection of _lf_mutex and copied in the _lf_bitrate cache by this executor.
+            // _lf_mutex and _lf_cond are also used to park this executor when it has nothing to do.
+            Mutex               _lf_mutex;           // Protect _bitrate and _br_confidence, park the thread.
+            Condition           _lf_cond;            // Signaled to wake up a parked thread.
+            std::atomic<bool>   _lf_waiting;         // The thread is parked on _lf_cond.
+            std::atomic<bool>   _lf_bitrate_changed; // _bitrate or _br_confidence were updated by previous executor.
+            BitRate             _lf_bitrate;         // Cached input bitrate, owned by this executor.
+            BitRateConfidence   _lf_br_confidence;   // Cached input bitrate confidence, owned by this executor.
+            BitRate             _lf_sent_bitrate;    // Last bitrate which was passed to next executor.
+            BitRateConfidence   _lf_sent_confidence; // Last bitrate confidence which was passed to next executor.
 
             // Description of a restart operation.
             class RestartData
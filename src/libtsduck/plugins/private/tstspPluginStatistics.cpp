@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspPluginStatistics.h"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::tsp::PluginStatistics::HISTOGRAM_SIZE;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::PluginStatistics::PluginStatistics() :
+    _calls(0),
+    _packets(0),
+    _call_ns(0),
+    _max_call_ns(0),
+    _waits(0),
+    _wait_ns(0),
+    _max_buffered(0),
+    _histogram()
+{
+    reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Reset all statistics.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginStatistics::reset()
+{
+    _calls = 0;
+    _packets = 0;
+    _call_ns = 0;
+    _max_call_ns = 0;
+    _waits = 0;
+    _wait_ns = 0;
+    _max_buffered = 0;
+    for (size_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+        _histogram[i] = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Update statistics. Invoked from the plugin thread only.
+// Because there is only one writer, we use relaxed operations and the
+// maximum values are updated without compare-and-swap.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginStatistics::addCall(NanoSecond duration, size_t packets)
+{
+    const uint64_t ns = duration < 0 ? 0 : uint64_t(duration);
+
+    _calls.fetch_add(1, std::memory_order_relaxed);
+    _packets.fetch_add(packets, std::memory_order_relaxed);
+    _call_ns.fetch_add(ns, std::memory_order_relaxed);
+    if (ns > _max_call_ns.load(std::memory_order_relaxed)) {
+        _max_call_ns.store(ns, std::memory_order_relaxed);
+    }
+
+    // Bucket index is the number of significant bits in the number of microseconds.
+    size_t bucket = 0;
+    for (uint64_t us = ns / 1000; us != 0 && bucket < HISTOGRAM_SIZE - 1; us >>= 1) {
+        bucket++;
+    }
+    _histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ts::tsp::PluginStatistics::addWait(NanoSecond duration, size_t buffered)
+{
+    _waits.fetch_add(1, std::memory_order_relaxed);
+    _wait_ns.fetch_add(duration < 0 ? 0 : uint64_t(duration), std::memory_order_relaxed);
+    if (buffered > _max_buffered.load(std::memory_order_relaxed)) {
+        _max_buffered.store(buffered, std::memory_order_relaxed);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the average call duration in nanoseconds.
+//----------------------------------------------------------------------------
+
+uint64_t ts::tsp::PluginStatistics::averageCall() const
+{
+    const uint64_t calls = _calls;
+    return calls == 0 ? 0 : _call_ns / calls;
+}
+
+
+//----------------------------------------------------------------------------
+// Format the statistics in a one-line human-readable string.
+//----------------------------------------------------------------------------
+
+ts::UString ts::tsp::PluginStatistics::toString(bool histogram) const
+{
+    UString str(UString::Format(u"%'d packets, %'d calls, %'d us in calls (avg: %'d ns, max: %'d us), %'d us in %'d waits, max buffered: %'d packets",
+                                {_packets.load(), _calls.load(), _call_ns / 1000, averageCall(), _max_call_ns / 1000,
+                                 _wait_ns / 1000, _waits.load(), _max_buffered.load()}));
+    if (histogram) {
+        str.append(u", histogram:");
+        for (size_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+            const uint64_t count = _histogram[i];
+            if (count > 0) {
+                const bool last = i == HISTOGRAM_SIZE - 1;
+                str.append(UString::Format(u" %s%'d us: %'d", {last ? u">=" : u"<", uint64_t(1) << (last ? i - 1 : i), count}));
+            }
+        }
+    }
+    return str;
+}
+
+
+//----------------------------------------------------------------------------
+// Add the statistics in a JSON object.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginStatistics::toJSON(json::Value& obj) const
+{
+    obj.add(u"packets", _packets.load());
+    obj.add(u"calls", _calls.load());
+    obj.add(u"call-ns", _call_ns.load());
+    obj.add(u"avg-call-ns", averageCall());
+    obj.add(u"max-call-ns", _max_call_ns.load());
+    obj.add(u"waits", _waits.load());
+    obj.add(u"wait-ns", _wait_ns.load());
+    obj.add(u"max-buffered", _max_buffered.load());
+    json::Value& histo(obj.query(u"histogram-us", true, json::Type::Array));
+    for (size_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+        histo.set(int64_t(_histogram[i].load()));
+    }
+}
@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Performance statistics of a plugin executor
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsjsonValue.h"
+#include "tsUString.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Performance statistics of a tsp plugin executor.
+        //!
+        //! The statistics are updated by the plugin thread only and can be read at any time
+        //! from another thread (control server, periodic report). All counters are atomic,
+        //! without any mutex, so that the cost in the plugin thread is minimal.
+        //!
+        //! A "call" is one invocation of the plugin: receive() for an input plugin, send()
+        //! for an output plugin, processPacket() or processPacketWindow() for a packet
+        //! processing plugin. The duration of each call is added in a histogram with
+        //! logarithmic buckets.
+        //!
+        //! @ingroup plugin
+        //!
+        class PluginStatistics
+        {
+            TS_NOCOPY(PluginStatistics);
+        public:
+            //!
+            //! Number of buckets in the call duration histogram.
+            //! Bucket 0 counts calls under 1 microsecond. Bucket @a n counts calls from 2^(n-1)
+            //! to 2^n microseconds. The last bucket counts all longer calls.
+            //!
+            static constexpr size_t HISTOGRAM_SIZE = 24;
+
+            //!
+            //! Constructor.
+            //!
+            PluginStatistics();
+
+            //!
+            //! Reset all statistics.
+            //!
+            void reset();
+
+            //!
+            //! Account for one plugin call.
+            //! @param [in] duration Duration of the call in nanoseconds.
+            //! @param [in] packets Number of packets which were processed by the call.
+            //!
+            void addCall(NanoSecond duration, size_t packets);
+
+            //!
+            //! Account for one wait for packets in the buffer.
+            //! @param [in] duration Duration of the wait in nanoseconds.
+            //! @param [in] buffered Number of packets which are available in the plugin area after the wait.
+            //!
+            void addWait(NanoSecond duration, size_t buffered);
+
+            //!
+            //! Get the total number of plugin calls.
+            //! @return The total number of plugin calls.
+            //!
+            uint64_t calls() const { return _calls; }
+
+            //!
+            //! Get the total number of packets which were processed in plugin calls.
+            //! @return The total number of packets which were processed in plugin calls.
+            //!
+            uint64_t packets() const { return _packets; }
+
+            //!
+            //! Get the cumulated duration of plugin calls.
+            //! @return The cumulated duration of plugin calls in nanoseconds.
+            //!
+            NanoSecond callDuration() const { return NanoSecond(_call_ns.load()); }
+
+            //!
+            //! Get the cumulated duration of waits for packets.
+            //! @return The cumulated duration of waits for packets in nanoseconds.
+            //!
+            NanoSecond waitDuration() const { return NanoSecond(_wait_ns.load()); }
+
+            //!
+            //! Get the high-water mark of the plugin area in the global buffer.
+            //! @return The maximum number of packets which were available to the plugin after a wait.
+            //!
+            uint64_t maxBuffered() const { return _max_buffered; }
+
+            //!
+            //! Format the statistics in a one-line human-readable string.
+            //! @param [in] histogram If true, append the non-empty buckets of the call duration histogram.
+            //! @return The formatted string.
+            //!
+            UString toString(bool histogram = false) const;
+
+            //!
+            //! Add the statistics in a JSON object.
+            //! @param [in,out] obj The JSON object to update.
+            //!
+            void toJSON(json::Value& obj) const;
+
+        private:
+            std::atomic<uint64_t> _calls;         // Number of plugin calls.
+            std::atomic<uint64_t> _packets;       // Number of packets in plugin calls.
+            std::atomic<uint64_t> _call_ns;       // Cumulated duration of plugin calls.
+            std::atomic<uint64_t> _max_call_ns;   // Longest plugin call.
+            std::atomic<uint64_t> _waits;         // Number of waits for packets.
+            std::atomic<uint64_t> _wait_ns;       // Cumulated duration of waits for packets.
+            std::atomic<uint64_t> _max_buffered;  // Max number of packets in plugin area.
+            std::atomic<uint64_t> _histogram[HISTOGRAM_SIZE];  // Call durations, log2 of microseconds.
+
+            // Get the average call duration in nanoseconds.
+            uint64_t averageCall() const;
+        };
+    }
+}
@@ -28,6 +28,9 @@
 //----------------------------------------------------------------------------
 
 #include "tstspProcessorExecutor.h"
+#include "tsGuardCondition.h"
+#include "tsGuardMutex.h"
+#include "tsMonotonic.h"
 
 
 //----------------------------------------------------------------------------
@@ -43,7 +46,28 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(const TSProcessorArgs& options,
 
     PluginExecutor(options, handlers, PluginType::PROCESSOR, options.plugins[plugin_index], attributes, global_mutex, report),
     _processor(dynamic_cast<ProcessorPlugin*>(PluginThread::plugin())),
-    _plugin_index(1 + plugin_index) // include first input plugin in the count
+    _plugin_index(1 + plugin_index), // include first input plugin in the count
+    _shard_mutex(),
+    _shard_done(),
+    _shard_threads(),
+    _shard_batch(0),
+    _shard_pending(0),
+    _shard_terminate(false),
+    _shard_count(1),
+    _shard_mode(ProcessorPlugin::SHARD_NONE),
+    _shard_pkt(nullptr),
+    _shard_data(nullptr),
+    _shard_pkt_cnt(0),
+    _shard_index(),
+    _shard_labels(),
+    _fused(),
+    _only_labels(),
+    _passed_packets(0),
+    _dropped_packets(0),
+    _nullified_packets(0),
+    _output_bitrate(0),
+    _output_br_confidence(BitRateConfidence::LOW),
+    _bitrate_never_modified(true)
 {
     if (options.log_plugin_index) {
         // Make sure that plugins display their index.
@@ -68,13 +92,11 @@ size_t ts::tsp::ProcessorExecutor::pluginIndex() const
 
 
 //----------------------------------------------------------------------------
-// Packet processor plugin thread
+// Get the packet window size of the plugin, zero for individual-packet mode.
 //----------------------------------------------------------------------------
 
-void ts::tsp::ProcessorExecutor::main()
+size_t ts::tsp::ProcessorExecutor::packetWindowSize() const
 {
-    debug(u"packet processing thread started");
-
     // Debug feature: if the environment variable TSP_FORCED_WINDOW_SIZE is
     // defined to some non-zero integer value, force all plugins to use the
     // packet window processing method. This can be used to check that using
@@ -88,18 +110,65 @@ void ts::tsp::ProcessorExecutor::main()
     if (window_size == 0) {
         window_size = _processor->getPacketWindowSize();
     }
+    return window_size;
+}
+
+
+//----------------------------------------------------------------------------
+// Plugin fusion (option --fuse-plugins).
+//----------------------------------------------------------------------------
+
+bool ts::tsp::ProcessorExecutor::canBeFused() const
+{
+    return packetWindowSize() == 0 && (_options.shard_threads <= 1 || _processor->getSharding() == ProcessorPlugin::SHARD_NONE);
+}
+
+void ts::tsp::ProcessorExecutor::fuse(ProcessorExecutor* next)
+{
+    if (next != nullptr && next != this && !next->isFused() && next->_fused.empty()) {
+        debug(u"fusing plugin %s[%d] in this thread", {next->pluginName(), next->pluginIndex()});
+        next->_runner = this;
+        _fused.push_back(next);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processor plugin thread
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::main()
+{
+    // When the plugin is fused, it is executed in the thread of a previous plugin.
+    if (isFused()) {
+        debug(u"plugin is fused, no packet processing thread");
+        return;
+    }
+
+    debug(u"packet processing thread started");
 
     // Perform the complete packet processing in individual-packet or packet-window mode.
-    if (window_size == 0) {
+    // In individual-packet mode, use several threads when requested and allowed by the plugin.
+    // Fused plugins are always processed in individual-packet mode.
+    const size_t window_size = _fused.empty() ? packetWindowSize() : 0;
+    const ProcessorPlugin::Sharding sharding = window_size == 0 && _fused.empty() && _options.shard_threads > 1 ? _processor->getSharding() : ProcessorPlugin::SHARD_NONE;
+    if (sharding != ProcessorPlugin::SHARD_NONE) {
+        processShardedPackets(sharding);
+    }
+    else if (window_size == 0) {
         processIndividualPackets();
     }
     else {
         processPacketWindows(window_size);
     }
 
-    // Close the packet processor.
+    // Close the packet processor and all fused plugins.
     debug(u"stopping the plugin");
     _processor->stop();
+    for (auto pe : _fused) {
+        pe->debug(u"stopping the plugin");
+        pe->_processor->stop();
+    }
 }
 
 
@@ -109,13 +178,14 @@ void ts::tsp::ProcessorExecutor::main()
 
 void ts::tsp::ProcessorExecutor::processIndividualPackets()
 {
-    TSPacketMetadata::LabelSet only_labels(_processor->getOnlyLabelOption());
-    PacketCounter passed_packets = 0;
-    PacketCounter dropped_packets = 0;
-    PacketCounter nullified_packets = 0;
-    BitRate output_bitrate = _tsp_bitrate;
-    BitRateConfidence br_confidence = _tsp_bitrate_confidence;
-    bool bitrate_never_modified = true;
+    // The chain of plugins which are executed in this thread: this one, followed by fused plugins, if any.
+    std::vector<ProcessorExecutor*> chain(1, this);
+    chain.insert(chain.end(), _fused.begin(), _fused.end());
+    for (auto pe : chain) {
+        pe->_only_labels = pe->_processor->getOnlyLabelOption();
+    }
+
+    ProcessorExecutor* const last = chain.back();
     bool input_end = false;
     bool aborted = false;
     bool restarted = false;
@@ -127,43 +197,45 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
         bool timeout = false;
         waitWork(1, pkt_first, pkt_cnt, _tsp_bitrate, _tsp_bitrate_confidence, input_end, aborted, timeout);
 
-        // If bitrate was never modified by the plugin, always copy the input bitrate as output bitrate.
-        // Otherwise, keep previous output bitrate, as modified by the plugin.
-        if (bitrate_never_modified) {
-            output_bitrate = _tsp_bitrate;
-            br_confidence = _tsp_bitrate_confidence;
+        // Propagate the input bitrate along the chain of plugins.
+        setInputBitrate(_tsp_bitrate, _tsp_bitrate_confidence);
+        for (size_t i = 1; i < chain.size(); ++i) {
+            chain[i]->setInputBitrate(chain[i-1]->_output_bitrate, chain[i-1]->_output_br_confidence);
         }
 
         // Process restart requests.
-        if (!processPendingRestart(restarted)) {
-            timeout = true; // restart error
-        }
-        else if (restarted) {
-            // Plugin was restarted, need to recheck --only-label
-            only_labels = _processor->getOnlyLabelOption();
+        for (auto pe : chain) {
+            if (!pe->processPendingRestart(restarted)) {
+                timeout = true; // restart error
+            }
+            else if (restarted) {
+                // Plugin was restarted, need to recheck --only-label
+                pe->_only_labels = pe->_processor->getOnlyLabelOption();
+            }
         }
 
         // In case of abort on timeout, notify previous and next plugin, then exit.
         if (timeout) {
-            passPackets(0, output_bitrate, br_confidence, true, true);
+            passPackets(0, last->_output_bitrate, last->_output_br_confidence, true, true);
             break;
         }
 
         // If next processor has aborted, abort as well.
         // We call passPacket to inform our predecessor that we aborted.
         if (aborted && !input_end) {
-            passPackets(0, output_bitrate, br_confidence, true, true);
+            passPackets(0, last->_output_bitrate, last->_output_br_confidence, true, true);
             break;
         }
 
         // Exit thread if no more packet to process.
         // We call passPackets to inform our successor of end of input.
         if (pkt_cnt == 0 && input_end) {
-            passPackets(0, output_bitrate, br_confidence, true, false);
+            passPackets(0, last->_output_bitrate, last->_output_br_confidence, true, false);
             break;
         }
 
         // Now process the packets.
+        const size_t max_flush_pkt = maxFlushPackets();
         size_t pkt_done = 0;
         size_t pkt_flush = 0;
 
@@ -172,74 +244,29 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
             TSPacket* const pkt = _buffer->base() + pkt_first + pkt_done;
             TSPacketMetadata* const pkt_data = _metadata->base() + pkt_first + pkt_done;
             bool got_new_bitrate = false;
+            bool flush = false;
 
             pkt_done++;
             pkt_flush++;
 
-            if (pkt->b[0] == 0) {
-                // The packet has already been dropped by a previous packet processor.
-                addNonPluginPackets(1);
-            }
-            else {
-                // Apply the processing routine to the packet
-                const bool was_null = pkt->getPID() == PID_NULL;
-                pkt_data->setFlush(false);
-                pkt_data->setBitrateChanged(false);
-                ProcessorPlugin::Status status = ProcessorPlugin::TSP_OK;
-                if (!_suspended && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
-                    // Either no --only-label option or the packet has a specified label => process it.
-                    status = _processor->processPacket(*pkt, *pkt_data);
-                    addPluginPackets(1);
+            // Apply all plugins in the chain to the packet.
+            for (size_t i = 0; i < chain.size(); ++i) {
+                bool new_bitrate = false;
+                if (!chain[i]->processOnePacket(pkt, pkt_data, new_bitrate)) {
+                    // Signal end of input to successors and abort to predecessors.
+                    // The packet is not passed to the next executor.
+                    input_end = aborted = true;
+                    pkt_done--;
+                    pkt_flush--;
+                    pkt_cnt = pkt_done;
+                    break;
                 }
-                else {
-                    // The plugin is suspended or some --only-label was specified but the packet does
-                    // not have any required label. Pass the packet without submitting it to the plugin.
-                    addNonPluginPackets(1);
-                }
-
-                // Use the returned status
-                switch (status) {
-                    case ProcessorPlugin::TSP_OK:
-                        // Normal case, pass packet
-                        passed_packets++;
-                        break;
-                    case ProcessorPlugin::TSP_NULL:
-                        // Replace the packet with a complete null packet
-                        *pkt = NullPacket;
-                        break;
-                    case ProcessorPlugin::TSP_DROP:
-                        // Drop this packet.
-                        pkt->b[0] = 0;
-                        dropped_packets++;
-                        break;
-                    case ProcessorPlugin::TSP_END:
-                        // Signal end of input to successors and abort to predecessors
-                        debug(u"plugin requests termination");
-                        input_end = aborted = true;
-                        pkt_done--;
-                        pkt_flush--;
-                        pkt_cnt = pkt_done;
-                        break;
-                    default:
-                        // Invalid status, report error and accept packet.
-                        error(u"invalid packet processing status %d", {status});
-                        break;
-                }
-
-                // Detect if the packet was nullified by the plugin, either by returning TSP_NULL or by overwriting the packet.
-                if (!was_null && pkt->getPID() == PID_NULL) {
-                    pkt_data->setNullified(true);
-                    nullified_packets++;
-                }
-
-                // If the packet processor has signaled a new bitrate, get it.
-                if (pkt_data->getBitrateChanged()) {
-                    const BitRate new_bitrate = _processor->getBitrate();
-                    if (new_bitrate != 0) {
-                        bitrate_never_modified = false;
-                        got_new_bitrate = new_bitrate != output_bitrate;
-                        output_bitrate = new_bitrate;
-                        br_confidence = _processor->getBitrateConfidence();
+                flush = flush || pkt_data->getFlush();
+                if (new_bitrate) {
+                    // Propagate the new bitrate to the rest of the chain.
+                    got_new_bitrate = true;
+                    for (size_t j = i + 1; j < chain.size(); ++j) {
+                        chain[j]->setInputBitrate(chain[j-1]->_output_bitrate, chain[j-1]->_output_br_confidence);
                     }
                 }
             }
@@ -247,16 +274,120 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
             // Do not wait to process pkt_cnt packets before notifying the next processor.
             // Perform periodic flush to avoid waiting too long before two output operations.
             // Also propagate new bitrate values immediately.
-            if (pkt_data->getFlush() || got_new_bitrate || pkt_done == pkt_cnt || (_options.max_flush_pkt > 0 && pkt_flush >= _options.max_flush_pkt)) {
-                aborted = !passPackets(pkt_flush, output_bitrate, br_confidence, pkt_done == pkt_cnt && input_end, aborted);
+            if (flush || got_new_bitrate || pkt_done == pkt_cnt || (max_flush_pkt > 0 && pkt_flush >= max_flush_pkt)) {
+                aborted = !passPackets(pkt_flush, last->_output_bitrate, last->_output_br_confidence, pkt_done == pkt_cnt && input_end, aborted);
                 pkt_flush = 0;
             }
         }
 
     } while (!input_end && !aborted);
 
-    debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
-          {input_end ? u"terminated" : u"aborted", pluginPackets(), passed_packets, dropped_packets, nullified_packets});
+    for (auto pe : chain) {
+        if (pe != this && aborted) {
+            // Fused plugins abort with the thread which executes them.
+            pe->_tsp_aborting = true;
+        }
+        pe->debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
+                  {input_end ? u"terminated" : u"aborted", pe->pluginPackets(), pe->_passed_packets, pe->_dropped_packets, pe->_nullified_packets});
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Set the input bitrate of the plugin in individual-packet mode.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::setInputBitrate(const BitRate& bitrate, BitRateConfidence br_confidence)
+{
+    _tsp_bitrate = bitrate;
+    _tsp_bitrate_confidence = br_confidence;
+
+    // If bitrate was never modified by the plugin, always copy the input bitrate as output bitrate.
+    // Otherwise, keep previous output bitrate, as modified by the plugin.
+    if (_bitrate_never_modified) {
+        _output_bitrate = bitrate;
+        _output_br_confidence = br_confidence;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process one packet in individual-packet mode. Return false on TSP_END.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::ProcessorExecutor::processOnePacket(TSPacket* pkt, TSPacketMetadata* pkt_data, bool& got_new_bitrate)
+{
+    if (pkt->b[0] == 0) {
+        // The packet has already been dropped by a previous packet processor.
+        addNonPluginPackets(1);
+        return true;
+    }
+
+    // Apply the processing routine to the packet
+    const bool was_null = pkt->getPID() == PID_NULL;
+    pkt_data->setFlush(false);
+    pkt_data->setBitrateChanged(false);
+    ProcessorPlugin::Status status = ProcessorPlugin::TSP_OK;
+    if (!_suspended && _processor->getPIDFilter().test(pkt->getPID()) && (_only_labels.none() || pkt_data->hasAnyLabel(_only_labels))) {
+        // The PID is processed by the plugin and either no --only-label option or the packet has a specified label => process it.
+        if (_options.plugin_stats) {
+            const Monotonic start(true);
+            status = _processor->processPacket(*pkt, *pkt_data);
+            _stats.addCall(Monotonic(true) - start, 1);
+        }
+        else {
+            status = _processor->processPacket(*pkt, *pkt_data);
+        }
+        addPluginPackets(1);
+    }
+    else {
+        // The plugin is suspended, or the PID is filtered out by the plugin, or some --only-label was specified
+        // but the packet does not have any required label. Pass the packet without submitting it to the plugin.
+        addNonPluginPackets(1);
+    }
+
+    // Use the returned status
+    switch (status) {
+        case ProcessorPlugin::TSP_OK:
+            // Normal case, pass packet
+            _passed_packets++;
+            break;
+        case ProcessorPlugin::TSP_NULL:
+            // Replace the packet with a complete null packet
+            *pkt = NullPacket;
+            break;
+        case ProcessorPlugin::TSP_DROP:
+            // Drop this packet.
+            pkt->b[0] = 0;
+            _dropped_packets++;
+            break;
+        case ProcessorPlugin::TSP_END:
+            // The caller signals end of input to successors and abort to predecessors.
+            debug(u"plugin requests termination");
+            return false;
+        default:
+            // Invalid status, report error and accept packet.
+            error(u"invalid packet processing status %d", {status});
+            break;
+    }
+
+    // Detect if the packet was nullified by the plugin, either by returning TSP_NULL or by overwriting the packet.
+    if (!was_null && pkt->getPID() == PID_NULL) {
+        pkt_data->setNullified(true);
+        _nullified_packets++;
+    }
+
+    // If the packet processor has signaled a new bitrate, get it.
+    if (pkt_data->getBitrateChanged()) {
+        const BitRate new_bitrate = _processor->getBitrate();
+        if (new_bitrate != 0) {
+            _bitrate_never_modified = false;
+            got_new_bitrate = new_bitrate != _output_bitrate;
+            _output_bitrate = new_bitrate;
+            _output_br_confidence = _processor->getBitrateConfidence();
+        }
+    }
+    return true;
 }
 
 
@@ -269,6 +400,7 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
     debug(u"packet processing window size: %'d packets", {window_size});
 
     TSPacketMetadata::LabelSet only_labels(_processor->getOnlyLabelOption());
+    const PIDSet& pid_filter(_processor->getPIDFilter());  // can be updated by the plugin at any time
     PacketCounter passed_packets = 0;
     PacketCounter dropped_packets = 0;
     PacketCounter nullified_packets = 0;
@@ -335,6 +467,7 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
             }
 
             // Inspect the packets we got from the buffer (pkt_first / pkt_count) and insert usable packets in the packet window.
+            const size_t max_flush_pkt = maxFlushPackets();
             for (size_t pkt_offset = 0; pkt_offset < allocated_packets; ++pkt_offset) {
 
                 // Take care that waitWork() may have returned a slice of the buffer which wraps up.
@@ -342,14 +475,14 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
                 TSPacket* const pkt = _buffer->base() + buf_index;
                 TSPacketMetadata* const pkt_data = _metadata->base() + buf_index;
 
-                // Packet was not dropped and its label is in --only-label (if used), add it in window.
-                if (pkt->b[0] != 0 && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
+                // Packet was not dropped, its PID is processed by the plugin and its label is in --only-label (if used), add it in window.
+                if (pkt->b[0] != 0 && pid_filter.test(pkt->getPID()) && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
                     win.addPacketsReference(pkt, pkt_data, 1);
                 }
 
                 // If --max-flushed-packets is set and we have enough packets for both the window size
                 // and --max-flushed-packets, stop building the window now.
-                if (_options.max_flush_pkt > 0 && pkt_offset + 1 >= _options.max_flush_pkt && win.size() >= window_size && pkt_offset + 1 < allocated_packets) {
+                if (max_flush_pkt > 0 && pkt_offset + 1 >= max_flush_pkt && win.size() >= window_size && pkt_offset + 1 < allocated_packets) {
                     // Will use only the first part of the allocated packets.
                     // When we call passPackets() later, we pass only this part.
                     // The remaining part (unused for now) will be returned again by waitWork().
@@ -370,7 +503,15 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
         }
 
         // Let the plugin process the packet window.
-        const size_t processed_packets = _processor->processPacketWindow(win);
+        size_t processed_packets = 0;
+        if (_options.plugin_stats) {
+            const Monotonic start(true);
+            processed_packets = _processor->processPacketWindow(win);
+            _stats.addCall(Monotonic(true) - start, processed_packets);
+        }
+        else {
+            processed_packets = _processor->processPacketWindow(win);
+        }
 
         // If not all packets from the window were processed, the plugin want to terminate the stream processing.
         if (processed_packets < win.size()) {
@@ -432,3 +573,359 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
     debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
           {input_end ? u"terminated" : u"aborted", pluginPackets(), passed_packets, dropped_packets, nullified_packets});
 }
+
+
+//----------------------------------------------------------------------------
+// Sharded processing: results of the processing of one shard.
+//----------------------------------------------------------------------------
+
+ts::tsp::ProcessorExecutor::ShardResult::ShardResult() :
+    plugin_packets(0),
+    non_plugin_packets(0),
+    passed_packets(0),
+    dropped_packets(0),
+    nullified_packets(0),
+    end_index(NPOS)
+{
+}
+
+void ts::tsp::ProcessorExecutor::ShardResult::clear()
+{
+    plugin_packets = non_plugin_packets = passed_packets = dropped_packets = nullified_packets = 0;
+    end_index = NPOS;
+}
+
+
+//----------------------------------------------------------------------------
+// Sharded processing: worker threads.
+//----------------------------------------------------------------------------
+
+ts::tsp::ProcessorExecutor::ShardThread::ShardThread(ProcessorExecutor* parent, size_t shard, const ThreadAttributes& attributes) :
+    Thread(attributes),
+    start_work(),
+    result(),
+    _parent(parent),
+    _shard(shard)
+{
+}
+
+ts::tsp::ProcessorExecutor::ShardThread::~ShardThread()
+{
+    waitForTermination();
+}
+
+void ts::tsp::ProcessorExecutor::ShardThread::main()
+{
+    uint64_t batch = 0;
+    for (;;) {
+        // Wait for a new batch of packets or termination.
+        {
+            GuardCondition lock(_parent->_shard_mutex, start_work);
+            while (_parent->_shard_batch == batch && !_parent->_shard_terminate) {
+                lock.waitCondition();
+            }
+            if (_parent->_shard_terminate) {
+                break;
+            }
+            batch = _parent->_shard_batch;
+        }
+
+        // Process our part of the batch. The batch description is not modified until all threads complete.
+        _parent->processShard(_shard, result);
+
+        // Notify the parent when the last worker thread completes.
+        GuardCondition lock(_parent->_shard_mutex, _parent->_shard_done);
+        assert(_parent->_shard_pending > 0);
+        if (--_parent->_shard_pending == 0) {
+            lock.signal();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Sharded processing: process one shard of the current batch.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::processShard(size_t shard, ShardResult& result)
+{
+    result.clear();
+
+    // The number of shards may have been reduced after a restart of the plugin.
+    if (shard >= _shard_count) {
+        return;
+    }
+
+    // With SHARD_PACKETS, each shard is a contiguous range of packets.
+    // With SHARD_PIDS, each shard processes all packets from a subset of PID's.
+    size_t first = 0;
+    size_t last = _shard_pkt_cnt;
+    if (_shard_mode == ProcessorPlugin::SHARD_PACKETS) {
+        first = (shard * _shard_pkt_cnt) / _shard_count;
+        last = ((shard + 1) * _shard_pkt_cnt) / _shard_count;
+    }
+
+    const PIDSet& pid_filter(_processor->getPIDFilter());
+
+    for (size_t i = first; i < last; ++i) {
+
+        TSPacket* const pkt = _shard_pkt + i;
+        TSPacketMetadata* const pkt_data = _shard_data + i;
+
+        if (_shard_mode == ProcessorPlugin::SHARD_PIDS && _shard_index[i] != shard) {
+            // Not in this shard.
+            continue;
+        }
+
+        if (pkt->b[0] == 0) {
+            // The packet has already been dropped by a previous packet processor.
+            result.non_plugin_packets++;
+            continue;
+        }
+
+        const PID pid = pkt->getPID();
+
+        // Apply the processing routine to the packet, same as processIndividualPackets().
+        pkt_data->setFlush(false);
+        pkt_data->setBitrateChanged(false);
+        ProcessorPlugin::Status status = ProcessorPlugin::TSP_OK;
+        if (!_suspended && pid_filter.test(pid) && (_shard_labels.none() || pkt_data->hasAnyLabel(_shard_labels))) {
+            status = _processor->processPacket(*pkt, *pkt_data);
+            result.plugin_packets++;
+        }
+        else {
+            result.non_plugin_packets++;
+        }
+
+        switch (status) {
+            case ProcessorPlugin::TSP_OK:
+                result.passed_packets++;
+                break;
+            case ProcessorPlugin::TSP_NULL:
+                *pkt = NullPacket;
+                break;
+            case ProcessorPlugin::TSP_DROP:
+                pkt->b[0] = 0;
+                result.dropped_packets++;
+                break;
+            case ProcessorPlugin::TSP_END:
+                // Stop this shard. The packets after this one won't be passed to the next plugin.
+                result.end_index = i;
+                return;
+            default:
+                error(u"invalid packet processing status %d", {status});
+                break;
+        }
+
+        if (pid != PID_NULL && pkt->getPID() == PID_NULL) {
+            pkt_data->setNullified(true);
+            result.nullified_packets++;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Sharded processing: process a batch of contiguous packets in all shards.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::processBatch(TSPacket* pkt, TSPacketMetadata* pkt_data, size_t pkt_cnt, ShardResult& result)
+{
+    // With SHARD_PIDS, assign all packets to shards before processing them: the PID of a packet may
+    // be modified by its shard while another shard looks for its own packets. Dropped packets are
+    // counted in the first shard.
+    if (_shard_mode == ProcessorPlugin::SHARD_PIDS) {
+        _shard_index.resize(pkt_cnt);
+        for (size_t i = 0; i < pkt_cnt; ++i) {
+            _shard_index[i] = pkt[i].b[0] == 0 ? 0 : pkt[i].getPID() % _shard_count;
+        }
+    }
+
+    // Start all worker threads on the new batch.
+    {
+        GuardMutex lock(_shard_mutex);
+        _shard_pkt = pkt;
+        _shard_data = pkt_data;
+        _shard_pkt_cnt = pkt_cnt;
+        _shard_pending = _shard_threads.size();
+        _shard_batch++;
+        for (const auto& thread : _shard_threads) {
+            thread->start_work.signal();
+        }
+    }
+
+    // Process the first shard in this thread.
+    processShard(0, result);
+
+    // Wait for all worker threads to complete.
+    {
+        GuardCondition lock(_shard_mutex, _shard_done);
+        while (_shard_pending > 0) {
+            lock.waitCondition();
+        }
+    }
+
+    // Accumulate the results of all shards.
+    for (const auto& thread : _shard_threads) {
+        const ShardResult& res(thread->result);
+        result.plugin_packets += res.plugin_packets;
+        result.non_plugin_packets += res.non_plugin_packets;
+        result.passed_packets += res.passed_packets;
+        result.dropped_packets += res.dropped_packets;
+        result.nullified_packets += res.nullified_packets;
+        result.end_index = std::min(result.end_index, res.end_index);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Sharded processing: terminate all worker threads.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::stopShardThreads()
+{
+    {
+        GuardMutex lock(_shard_mutex);
+        _shard_terminate = true;
+        for (const auto& thread : _shard_threads) {
+            thread->start_work.signal();
+        }
+    }
+    for (const auto& thread : _shard_threads) {
+        thread->waitForTermination();
+    }
+    _shard_threads.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Process packets one by one, using several threads.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::processShardedPackets(ProcessorPlugin::Sharding mode)
+{
+    debug(u"packet processing using %d threads, sharding by %s", {_options.shard_threads, mode == ProcessorPlugin::SHARD_PIDS ? u"PID" : u"packet"});
+
+    _shard_count = _options.shard_threads;
+    _shard_mode = mode;
+    _shard_labels = _processor->getOnlyLabelOption();
+    _shard_terminate = false;
+
+    // Start all worker threads. Shard 0 is processed in this thread.
+    // The worker threads use the same attributes (priority, scheduling policy, CPU affinity) as this thread.
+    ThreadAttributes attributes;
+    getAttributes(attributes);
+    attributes.setDeleteWhenTerminated(false);
+    const UString name(attributes.getName());
+
+    for (size_t shard = 1; shard < _shard_count; ++shard) {
+        if (!name.empty()) {
+            attributes.setName(UString::Format(u"%s-%d", {name, shard}));
+        }
+        const ShardThreadPtr thread(new ShardThread(this, shard, attributes));
+        _shard_threads.push_back(thread);
+        thread->start();
+    }
+
+    PacketCounter passed_packets = 0;
+    PacketCounter dropped_packets = 0;
+    PacketCounter nullified_packets = 0;
+    BitRate output_bitrate = _tsp_bitrate;
+    BitRateConfidence br_confidence = _tsp_bitrate_confidence;
+    bool bitrate_never_modified = true;
+    bool input_end = false;
+    bool aborted = false;
+    bool restarted = false;
+
+    do {
+        // Wait for packets to process
+        size_t pkt_first = 0;
+        size_t pkt_cnt = 0;
+        bool timeout = false;
+        waitWork(1, pkt_first, pkt_cnt, _tsp_bitrate, _tsp_bitrate_confidence, input_end, aborted, timeout);
+
+        // If bitrate was never modified by the plugin, always copy the input bitrate as output bitrate.
+        if (bitrate_never_modified) {
+            output_bitrate = _tsp_bitrate;
+            br_confidence = _tsp_bitrate_confidence;
+        }
+
+        // Process restart requests. The worker threads are idle here.
+        if (!processPendingRestart(restarted)) {
+            timeout = true; // restart error
+        }
+        else if (restarted) {
+            // Plugin was restarted, need to recheck --only-label and the sharding capability.
+            _shard_labels = _processor->getOnlyLabelOption();
+            _shard_mode = _processor->getSharding();
+            _shard_count = _shard_mode == ProcessorPlugin::SHARD_NONE ? 1 : _options.shard_threads;
+        }
+
+        // Same termination conditions as processIndividualPackets().
+        if (timeout || (aborted && !input_end)) {
+            passPackets(0, output_bitrate, br_confidence, true, true);
+            break;
+        }
+        if (pkt_cnt == 0 && input_end) {
+            passPackets(0, output_bitrate, br_confidence, true, false);
+            break;
+        }
+
+        // Process the packets by batches of at most --max-flushed-packets.
+        size_t pkt_done = 0;
+        while (pkt_done < pkt_cnt && !aborted) {
+
+            const size_t max_flush_pkt = maxFlushPackets();
+            const size_t batch_cnt = max_flush_pkt > 0 ? std::min(pkt_cnt - pkt_done, max_flush_pkt) : pkt_cnt - pkt_done;
+            TSPacket* const pkt = _buffer->base() + pkt_first + pkt_done;
+            TSPacketMetadata* const pkt_data = _metadata->base() + pkt_first + pkt_done;
+
+            // With sharding, the statistics account for one call per batch, processed by all threads.
+            ShardResult result;
+            if (_options.plugin_stats) {
+                const Monotonic start(true);
+                processBatch(pkt, pkt_data, batch_cnt, result);
+                _stats.addCall(Monotonic(true) - start, size_t(result.plugin_packets));
+            }
+            else {
+                processBatch(pkt, pkt_data, batch_cnt, result);
+            }
+
+            // Only pass the packets before the one which triggered TSP_END, if any.
+            size_t pass_cnt = batch_cnt;
+            if (result.end_index != NPOS) {
+                debug(u"plugin requests termination");
+                pass_cnt = result.end_index;
+                input_end = aborted = true;
+            }
+
+            addPluginPackets(size_t(result.plugin_packets));
+            addNonPluginPackets(size_t(result.non_plugin_packets));
+            passed_packets += result.passed_packets;
+            dropped_packets += result.dropped_packets;
+            nullified_packets += result.nullified_packets;
+
+            // If the packet processor has signaled a new bitrate, get it.
+            for (size_t i = 0; i < pass_cnt; ++i) {
+                if (pkt_data[i].getBitrateChanged()) {
+                    const BitRate new_bitrate = _processor->getBitrate();
+                    if (new_bitrate != 0) {
+                        bitrate_never_modified = false;
+                        output_bitrate = new_bitrate;
+                        br_confidence = _processor->getBitrateConfidence();
+                    }
+                    break;
+                }
+            }
+
+            pkt_done += batch_cnt;
+            aborted = !passPackets(pass_cnt, output_bitrate, br_confidence, (pkt_done == pkt_cnt || result.end_index != NPOS) && input_end, aborted);
+        }
+
+    } while (!input_end && !aborted);
+
+    stopShardThreads();
+
+    debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
+          {input_end ? u"terminated" : u"aborted", pluginPackets(), passed_packets, dropped_packets, nullified_packets});
+}
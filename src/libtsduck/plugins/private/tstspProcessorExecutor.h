@@ -35,6 +35,7 @@
 #pragma once
 #include "tstspPluginExecutor.h"
 #include "tsProcessorPlugin.h"
+#include "tsSafePtr.h"
 
 namespace ts {
     namespace tsp {
@@ -68,19 +69,106 @@ namespace ts {
             //!
             virtual ~ProcessorExecutor() override;
 
+            //!
+            //! Check if the plugin can be fused with adjacent plugins (tsp option -\-fuse-plugins).
+            //! Only plugins which process packets one by one in one single thread can be fused.
+            //! Plugins using packet windows or sharding keep their own thread.
+            //! Must be called after starting the plugin, before starting the executor thread.
+            //! @return True if the plugin can be fused.
+            //!
+            bool canBeFused() const;
+
+            //!
+            //! Fuse a plugin in the thread of this one.
+            //! The packets are processed by all plugins of the group, one packet at a time,
+            //! before being passed to the next executor. Each plugin keeps its own options,
+            //! statistics, suspend and restart state. Must be called before starting the
+            //! executor threads.
+            //! @param [in] next The processor executor to fuse. It must immediately follow
+            //! this executor or the last plugin which was fused into it.
+            //!
+            void fuse(ProcessorExecutor* next);
+
             // Overridden methods.
             virtual size_t pluginIndex() const override;
 
         private:
+            // Results of the processing of one shard of packets.
+            class ShardResult
+            {
+            public:
+                ShardResult();
+                void clear();
+                PacketCounter plugin_packets;      // Packets which were submitted to the plugin.
+                PacketCounter non_plugin_packets;  // Packets which were not submitted to the plugin.
+                PacketCounter passed_packets;      // Packets which were passed by the plugin.
+                PacketCounter dropped_packets;     // Packets which were dropped by the plugin.
+                PacketCounter nullified_packets;   // Packets which were nullified by the plugin.
+                size_t        end_index;           // Index of first packet with TSP_END in the batch, NPOS if none.
+            };
+
+            // Worker thread which processes one shard of each batch of packets.
+            class ShardThread : public Thread
+            {
+                TS_NOBUILD_NOCOPY(ShardThread);
+            public:
+                ShardThread(ProcessorExecutor* parent, size_t shard, const ThreadAttributes& attributes);
+                virtual ~ShardThread() override;
+                Condition   start_work;  // Signaled by parent when a new batch is available.
+                ShardResult result;      // Result of last batch.
+            private:
+                ProcessorExecutor* _parent;
+                const size_t       _shard;
+                virtual void main() override;
+            };
+            typedef SafePtr<ShardThread> ShardThreadPtr;
+            typedef std::vector<ShardThreadPtr> ShardThreadPtrVector;
+
             ProcessorPlugin* _processor;
             const size_t     _plugin_index;
 
+            // Description of the current batch in sharded mode, protected by _shard_mutex.
+            Mutex                      _shard_mutex;      // Protect the following fields.
+            Condition                  _shard_done;       // Signaled by last worker thread when a batch is completed.
+            ShardThreadPtrVector       _shard_threads;    // Worker threads for shards 1 to N-1 (shard 0 is this thread).
+            uint64_t                   _shard_batch;      // Sequence number of current batch.
+            size_t                     _shard_pending;    // Number of worker threads still processing the current batch.
+            bool                       _shard_terminate;  // Worker threads shall terminate.
+            size_t                     _shard_count;      // Number of shards in current batch (1 means no sharding).
+            ProcessorPlugin::Sharding  _shard_mode;       // How packets are distributed in shards.
+            TSPacket*                  _shard_pkt;        // First packet of current batch.
+            TSPacketMetadata*          _shard_data;       // Metadata of first packet of current batch.
+            size_t                     _shard_pkt_cnt;    // Number of packets in current batch.
+            std::vector<size_t>        _shard_index;      // With SHARD_PIDS, shard of each packet in current batch.
+            TSPacketMetadata::LabelSet _shard_labels;     // Value of --only-label.
+
+            // Processing state in individual-packet mode, per plugin (including fused plugins).
+            std::vector<ProcessorExecutor*> _fused;                  // Plugins which are fused in the thread of this one (--fuse-plugins).
+            TSPacketMetadata::LabelSet      _only_labels;            // Value of --only-label.
+            PacketCounter                   _passed_packets;         // Packets which were passed by the plugin.
+            PacketCounter                   _dropped_packets;        // Packets which were dropped by the plugin.
+            PacketCounter                   _nullified_packets;      // Packets which were nullified by the plugin.
+            BitRate                         _output_bitrate;         // Output bitrate, as passed to next plugin.
+            BitRateConfidence               _output_br_confidence;   // Confidence in _output_bitrate.
+            bool                            _bitrate_never_modified; // The plugin never modified the bitrate.
+
             // Inherited from Thread
             virtual void main() override;
 
+            // Get the packet window size of the plugin, zero for individual-packet mode.
+            size_t packetWindowSize() const;
+
             // Process packets one by one or using packet windows.
             void processIndividualPackets();
+            void setInputBitrate(const BitRate& bitrate, BitRateConfidence br_confidence);
+            bool processOnePacket(TSPacket* pkt, TSPacketMetadata* pkt_data, bool& got_new_bitrate);
             void processPacketWindows(size_t window_size);
+
+            // Process packets one by one, using several threads, for plugins which allow sharding.
+            void processShardedPackets(ProcessorPlugin::Sharding mode);
+            void processShard(size_t shard, ShardResult& result);
+            void processBatch(TSPacket* pkt, TSPacketMetadata* pkt_data, size_t pkt_cnt, ShardResult& result);
+            void stopShardThreads();
         };
     }
 }
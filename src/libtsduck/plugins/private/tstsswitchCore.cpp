@@ -32,6 +32,7 @@
 #include "tsGuardCondition.h"
 #include "tsAlgorithm.h"
 #include "tsFatal.h"
+#include "tsPluginSchedulingArgs.h"
 
 
 //----------------------------------------------------------------------------
@@ -92,9 +93,9 @@ bool ts::tsswitch::Core::start()
     }
 
     // Start output plugin.
-    if (!_output.plugin()->getOptions() ||  // Let plugin fetch its command line options.
-        !_output.plugin()->start() ||       // Open the output "device", whatever it means.
-        !_output.start())                   // Start the output thread.
+    if (!_output.plugin()->getOptions() ||                  // Let plugin fetch its command line options.
+        !_output.plugin()->start() ||                       // Open the output "device", whatever it means.
+        !PluginSchedulingArgs::StartThread(_output, _log))  // Start the output thread.
     {
         return false;
     }
@@ -107,7 +108,7 @@ bool ts::tsswitch::Core::start()
     bool success = true;
     for (size_t i = 0; success && i < _inputs.size(); ++i) {
         // Here, start() means start the thread, not start input plugin.
-        success = _inputs[i]->start();
+        success = PluginSchedulingArgs::StartThread(*_inputs[i], _log);
     }
 
     if (!success) {
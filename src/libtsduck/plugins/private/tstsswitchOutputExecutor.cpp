@@ -40,7 +40,7 @@ ts::tsswitch::OutputExecutor::OutputExecutor(const InputSwitcherArgs& opt,
                                              Core& core,
                                              Report& log) :
 
-    PluginExecutor(opt, handlers, PluginType::OUTPUT, opt.output, ThreadAttributes(), core, log),
+    PluginExecutor(opt, handlers, PluginType::OUTPUT, opt.output, opt.scheduling.apply(ThreadAttributes(), opt.inputs.size()), core, log),
     _output(dynamic_cast<OutputPlugin*>(plugin())),
     _terminate(false)
 {
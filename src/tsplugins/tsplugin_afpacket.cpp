@@ -0,0 +1,366 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor shared library:
+//  Capture UDP datagrams from a network interface using a packet ring.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractDatagramInputPlugin.h"
+#include "tsPluginRepository.h"
+#include "tsPacketRing.h"
+#include "tsUDPStreamSelector.h"
+#include "tsUDPSocket.h"
+
+
+//----------------------------------------------------------------------------
+// Plugin definition
+//----------------------------------------------------------------------------
+
+namespace ts {
+    class AFPacketInputPlugin: public AbstractDatagramInputPlugin
+    {
+        TS_NOBUILD_NOCOPY(AFPacketInputPlugin);
+    public:
+        // Implementation of plugin API
+        AFPacketInputPlugin(TSP*);
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool abortInput() override;
+        virtual bool setReceiveTimeout(MilliSecond timeout) override;
+
+    protected:
+        // Implementation of AbstractDatagramInputPlugin.
+        virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
+        virtual bool receiveDatagrams(uint8_t* buffer, size_t datagram_size, size_t max_count, Datagram* datagrams, size_t& ret_count) override;
+
+    private:
+        // Maximum number of datagrams which are returned at once to the superclass.
+        static constexpr size_t DATAGRAM_BATCH = 32;
+
+        // Command line options:
+        UString           _interface;       // Network interface name.
+        IPv4SocketAddress _destination;     // Selected destination UDP socket address.
+        IPv4SocketAddress _source;          // Selected source UDP socket address.
+        IPv4Address       _local_address;   // Local address for multicast membership.
+        bool              _multicast;       // Use multicast destinations only.
+        bool              _no_join;         // Do not join the multicast group.
+        size_t            _block_size;      // Size of blocks in the ring.
+        size_t            _block_count;     // Number of blocks in the ring.
+        MilliSecond       _block_timeout;   // Block retire timeout.
+
+        // Working data:
+        PacketRing        _ring;            // Packet ring on the network interface.
+        UDPSocket         _membership;      // Socket which holds the multicast membership.
+        UDPStreamSelector _selector;        // Selection of the UDP stream.
+
+        // Join a multicast group, unless --no-join or already joined.
+        bool joinGroup(const IPv4Address& group);
+    };
+}
+
+TS_REGISTER_INPUT_PLUGIN(u"afpacket", ts::AFPacketInputPlugin);
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::AFPacketInputPlugin::DATAGRAM_BATCH;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::AFPacketInputPlugin::AFPacketInputPlugin(TSP* tsp_) :
+    AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE,
+                                u"Capture TS packets in UDP datagrams from a network interface using a packet ring (Linux only)",
+                                u"[options] interface",
+                                u"kernel", u"A kernel-provided time-stamp for the packet",
+                                true), // real-time network reception
+    _interface(),
+    _destination(),
+    _source(),
+    _local_address(),
+    _multicast(false),
+    _no_join(false),
+    _block_size(0),
+    _block_count(0),
+    _block_timeout(0),
+    _ring(),
+    _membership(),
+    _selector()
+{
+    setDatagramBatch(DATAGRAM_BATCH);
+
+    option(u"", 0, STRING, 1, 1);
+    help(u"", u"interface",
+         u"The name of the network interface to capture, for instance 'eth0' or 'lo'. "
+         u"The capture is performed at link level, using a memory-mapped packet ring which is shared with the kernel. "
+         u"This input plugin extracts IPv4 UDP datagrams which contain transport stream packets, with or without RTP headers. "
+         u"Only the selected datagrams are copied by the kernel into the ring. "
+         u"This plugin requires the CAP_NET_RAW capability.");
+
+    option(u"block-count", 0, POSITIVE);
+    help(u"block-count",
+         u"Number of blocks in the packet ring. "
+         u"The default is " + UString::Decimal(PacketRing::DEFAULT_BLOCK_COUNT) + u".");
+
+    option(u"block-size", 0, POSITIVE);
+    help(u"block-size",
+         u"Size in bytes of each block in the packet ring. "
+         u"The size is rounded up to a power of two. "
+         u"The default is " + UString::Decimal(PacketRing::DEFAULT_BLOCK_SIZE) + u" bytes.");
+
+    option(u"block-timeout", 0, POSITIVE);
+    help(u"block-timeout", u"milliseconds",
+         u"Timeout after which a partially filled block of the packet ring is passed to the plugin. "
+         u"This is the maximum reception latency at low bitrates. "
+         u"The default is " + UString::Decimal(PacketRing::DEFAULT_BLOCK_TIMEOUT) + u" milliseconds.");
+
+    option(u"destination", 'd', STRING);
+    help(u"destination", u"[address][:port]",
+         u"Filter UDP datagrams based on the specified destination socket address. "
+         u"By default or if either the IP address or UDP port is missing, "
+         u"use the destination of the first matching UDP datagram containing TS packets. "
+         u"Then, select only UDP datagrams with this socket address.");
+
+    option(u"local-address", 'l', STRING);
+    help(u"local-address", u"address",
+         u"When the destination is a multicast address, either specified or selected from the first datagram, "
+         u"specify the IP address of the local interface on which the multicast group is joined. "
+         u"By default, the multicast group is joined on the default interface.");
+
+    option(u"multicast-only", 'm');
+    help(u"multicast-only",
+         u"When there is no --destination option, select the first multicast address which is found in a UDP datagram. "
+         u"By default, use the destination address of the first UDP datagram containing TS packets, unicast or multicast.");
+
+    option(u"no-join");
+    help(u"no-join",
+         u"When the destination is a multicast address, either specified or selected from the first datagram, "
+         u"do not join the multicast group. "
+         u"By default, the multicast group is joined so that the multicast traffic is routed to the network interface. "
+         u"Use this option when another application has already joined the group.");
+
+    option(u"source", 's', STRING);
+    help(u"source", u"[address][:port]",
+         u"Filter UDP datagrams based on the specified source socket address. "
+         u"By default, do not filter on source address.");
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options method
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::getOptions()
+{
+    getValue(_interface, u"");
+    const UString str_source(value(u"source"));
+    const UString str_destination(value(u"destination"));
+    const UString str_local(value(u"local-address"));
+    _multicast = present(u"multicast-only");
+    _no_join = present(u"no-join");
+    getIntValue(_block_size, u"block-size", PacketRing::DEFAULT_BLOCK_SIZE);
+    getIntValue(_block_count, u"block-count", PacketRing::DEFAULT_BLOCK_COUNT);
+    getIntValue(_block_timeout, u"block-timeout", PacketRing::DEFAULT_BLOCK_TIMEOUT);
+
+    // Decode socket addresses.
+    _source.clear();
+    _destination.clear();
+    _local_address.clear();
+    if (!str_source.empty() && !_source.resolve(str_source, *tsp)) {
+        return false;
+    }
+    if (!str_destination.empty() && !_destination.resolve(str_destination, *tsp)) {
+        return false;
+    }
+    if (!str_local.empty() && !_local_address.resolve(str_local, *tsp)) {
+        return false;
+    }
+
+    // Get command line arguments for superclass.
+    return AbstractDatagramInputPlugin::getOptions();
+}
+
+
+//----------------------------------------------------------------------------
+// Start method
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::start()
+{
+    _selector.reset(_source, _destination, _multicast);
+
+    // Initialize superclass and packet ring. The kernel filter selects the UDP datagrams
+    // with the specified parts of the source and destination.
+    _ring.setRingSize(_block_size, _block_count);
+    _ring.setBlockTimeout(_block_timeout);
+    _ring.setUDPFilter(_source, _destination, _multicast);
+    if (!AbstractDatagramInputPlugin::start() || !_ring.open(_interface, *tsp)) {
+        return false;
+    }
+
+    // When the destination is not specified, the multicast group is joined when it is selected.
+    if (_destination.hasAddress() && _destination.isMulticast() && !joinGroup(_destination)) {
+        _ring.close(*tsp);
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Join a multicast group.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::joinGroup(const IPv4Address& group)
+{
+    if (_no_join || _membership.isOpen()) {
+        return true;
+    }
+
+    // Join the multicast group so that the traffic is routed to the interface. The membership socket
+    // is bound to an ephemeral port: it receives nothing and the datagrams are only copied into the ring.
+    const IPv4Address source(_source);
+    const bool ok = _membership.open(*tsp) &&
+        _membership.bind(IPv4SocketAddress(IPv4Address::AnyAddress, IPv4SocketAddress::AnyPort), *tsp) &&
+        (_local_address.hasAddress() ? _membership.addMembership(group, _local_address, source, *tsp) : _membership.addMembershipDefault(group, source, *tsp));
+    if (!ok) {
+        _membership.close(*tsp);
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::stop()
+{
+    uint64_t received = 0;
+    uint64_t dropped = 0;
+    if (_ring.isOpen() && _ring.getStatistics(received, dropped, *tsp)) {
+        tsp->verbose(u"packet ring: %'d selected packets, %'d dropped by the kernel", {received, dropped});
+    }
+    if (_membership.isOpen()) {
+        _membership.close(*tsp);
+    }
+    _ring.close(*tsp);
+    return AbstractDatagramInputPlugin::stop();
+}
+
+
+//----------------------------------------------------------------------------
+// Input abort method
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::abortInput()
+{
+    tsp->debug(u"aborting packet ring input");
+    _ring.abort();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Set receive timeout from tsp.
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::setReceiveTimeout(MilliSecond timeout)
+{
+    _ring.setReceiveTimeout(timeout);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Input methods
+//----------------------------------------------------------------------------
+
+bool ts::AFPacketInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp)
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    IPv4SocketAddress src;
+    IPv4SocketAddress dst;
+
+    // Loop on UDP datagrams from the ring until a matching one is found. The headers are parsed
+    // in place in the ring and the UDP payload is copied only once, in the input buffer.
+    for (;;) {
+
+        // Read one UDP datagram. The ring filter returns UDP datagrams only.
+        if (!_ring.receiveUDP(data, size, src, dst, timestamp, tsp, *tsp)) {
+            return false;
+        }
+
+        // The kernel filter is wider than the selected stream once the destination is selected.
+        if (!_selector.match(src, dst)) {
+            continue;
+        }
+
+        // The destination can be dynamically selected (address, port or both) by the first UDP datagram containing TS packets.
+        if (!_selector.hasDestination()) {
+            size_t start_index = 0;
+            size_t packet_count = 0;
+            if (!TSPacket::Locate(data, size, start_index, packet_count)) {
+                continue; // no TS packet in this UDP datagram.
+            }
+            // We just found the first UDP datagram with TS packets, now use this destination address all the time.
+            _selector.setDestination(dst, *tsp);
+            if (dst.isMulticast() && !joinGroup(dst)) {
+                tsp->warning(u"cannot join multicast group %s, the reception may stop", {IPv4Address(dst)});
+            }
+        }
+
+        // List all source addresses as they appear.
+        _selector.addSource(src, *tsp);
+
+        ret_size = std::min(size, buffer_size);
+        ::memcpy(buffer, data, ret_size);
+        return true;
+    }
+}
+
+bool ts::AFPacketInputPlugin::receiveDatagrams(uint8_t* buffer, size_t datagram_size, size_t max_count, Datagram* datagrams, size_t& ret_count)
+{
+    // Wait for the first datagram, then get all datagrams which are already in the ring, without waiting.
+    ret_count = 0;
+    while (ret_count < max_count && (ret_count == 0 || _ring.available())) {
+        Datagram& dgram(datagrams[ret_count]);
+        dgram.data = buffer + ret_count * datagram_size;
+        if (!receiveDatagram(dgram.data, datagram_size, dgram.size, dgram.timestamp)) {
+            // Abort or error, return the previous datagrams, if any. The next call will fail again.
+            return ret_count > 0;
+        }
+        ret_count++;
+    }
+    return true;
+}
@@ -63,6 +63,7 @@ namespace ts {
         Status          _drop_status;        // Return status for unselected packets
         int             _scrambling_ctrl;    // Scrambling control value (<0: no filter)
         bool            _need_demux;         // Need the help of the signalization demux.
+        bool            _pid_only;           // Packets are selected on their PID only.
         bool            _with_payload;       // Packets with payload
         bool            _with_af;            // Packets with adaptation field
         bool            _with_pes;           // Packets with clear PES headers
@@ -128,6 +129,7 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
     _drop_status(TSP_DROP),
     _scrambling_ctrl(0),
     _need_demux(false),
+    _pid_only(false),
     _with_payload(false),
     _with_af(false),
     _with_pes(false),
@@ -495,6 +497,15 @@ bool ts::FilterPlugin::getOptions()
     // If we look for service names, we also need to be notified of changes in service list.
     _demux.setHandler(_service_names.empty() ? nullptr : this);
 
+    // Check if the packets are selected on their PID only (see start()).
+    _pid_only = !_need_demux && _after_packets == 0 && _every_packets == 0 && _ranges.empty() && _pattern.empty() &&
+        _labels.none() && _stream_ids.empty() && _scrambling_ctrl < 0 &&
+        !_with_payload && !_with_af && !_with_pes && !_with_pcr && !_with_splice && !_unit_start &&
+        !_nullified && !_input_stuffing && !_valid &&
+        _splice < -128 && _min_splice < -128 && _max_splice < -128 &&
+        _min_payload < 0 && _max_payload < 0 && _min_af < 0 && _max_af < 0 &&
+        _set_perm_labels.none() && _reset_perm_labels.none();
+
     return true;
 }
 
@@ -509,6 +520,11 @@ bool ts::FilterPlugin::start()
     _all_service_ids = _service_ids;
     _stream_id_pid.reset();
     _demux.reset();
+
+    // When the packets are selected on their PID only and the packets from all other PID's
+    // are passed unmodified, these packets are not even submitted to the plugin.
+    const bool pass_others = _negate ? _set_labels.none() && _reset_labels.none() : _drop_status == TSP_OK;
+    setPIDFilter(_pid_only && pass_others ? _explicit_pid : AllPIDs);
     return true;
 }
 
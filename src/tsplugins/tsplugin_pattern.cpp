@@ -48,6 +48,7 @@ namespace ts {
         // Implementation of plugin API
         PatternPlugin(TSP*);
         virtual bool start() override;
+        virtual Sharding getSharding() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -118,10 +119,23 @@ bool ts::PatternPlugin::start()
         _pid_list.flip();
     }
 
+    // Packets from other PID's are not even submitted to the plugin.
+    setPIDFilter(_pid_list);
+
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// The packets are independently processed, they can be processed in parallel.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Sharding ts::PatternPlugin::getSharding()
+{
+    return SHARD_PACKETS;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 #include "tsAbstractDatagramInputPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsPcapStream.h"
+#include "tsUDPStreamSelector.h"
 #include "tsEMMGMUX.h"
 #include "tstlvMessageFactory.h"
 
@@ -75,8 +76,7 @@ namespace ts {
         PcapFilter           _pcap_udp;         // Pcap file, in UDP mode.
         PcapStream           _pcap_tcp;         // Pcap file, in TCP mode (DVB SimulCrypt EMMG/PDG <=> MUX).
         MicroSecond          _first_tstamp;     // Time stamp of first datagram.
-        IPv4SocketAddress    _act_destination;  // Actual destination UDP socket address.
-        IPv4SocketAddressSet _all_sources;      // All source addresses.
+        UDPStreamSelector    _selector;         // Selection of the UDP stream.
 
         // Internal receive methods.
         bool receiveUDP(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp);
@@ -113,10 +113,11 @@ ts::PcapInputPlugin::PcapInputPlugin(TSP* tsp_) :
     _pcap_udp(),
     _pcap_tcp(),
     _first_tstamp(0),
-    _act_destination(),
-    _all_sources()
+    _selector()
 {
     _pcap_udp.defineArgs(*this);
+    _pcap_udp.setMemoryMapped(true);
+    _pcap_tcp.setMemoryMapped(true);
 
     option(u"", 0, FILENAME, 0, 1);
     help(u"", u"file-name",
@@ -216,8 +217,7 @@ bool ts::PcapInputPlugin::getOptions()
 bool ts::PcapInputPlugin::start()
 {
     _first_tstamp = -1;
-    _act_destination = _destination;
-    _all_sources.clear();
+    _selector.reset(_source, _destination, _multicast);
 
     // Initialize superclass and pcap file.
     bool ok = AbstractDatagramInputPlugin::start();
@@ -232,7 +232,10 @@ bool ts::PcapInputPlugin::start()
         else {
             ok = _pcap_udp.open(_file_name, *tsp);
             if (ok) {
+                // The filters are checked again here but, with an index, only the matching flows are read.
                 _pcap_udp.setProtocolFilterUDP();
+                _pcap_udp.setSourceFilter(_source);
+                _pcap_udp.setDestinationFilter(_destination);
             }
         }
     }
@@ -282,16 +285,11 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
         const IPv4SocketAddress src(ip.sourceSocketAddress());
         const IPv4SocketAddress dst(ip.destinationSocketAddress());
 
-        // Filter source or destination socket address if one was specified.
-        if (!src.match(_source) || !dst.match(_act_destination)) {
+        // Filter source or destination socket address, multicast destinations only if required.
+        if (!_selector.match(src, dst)) {
             continue; // not a matching address
         }
 
-        // If the destination is not yet found, filter multicast addresses if required.
-        if (!_act_destination.hasAddress() && _multicast && !dst.isMulticast()) {
-            continue; // not a multicast address
-        }
-
         // Locate UDP payload.
         const uint8_t* const udp_data = ip.protocolData();
         const size_t udp_size = ip.protocolDataSize();
@@ -300,7 +298,7 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
         // The destination can be dynamically selected (address, port or both) by the first UDP datagram containing TS packets.
         if (_udp_emmg_mux) {
             // Try to decode UDP packet as DVB SimulCrypt.
-            if (!_act_destination.hasAddress() || !_act_destination.hasPort()) {
+            if (!_selector.hasDestination()) {
                 // The actual destination is not fully known yet.
                 // We are still waiting for the first UDP datagram containing a data_provision message.
                 // Is there any in this one?
@@ -308,8 +306,8 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
                     continue; // no data_provision message in this UDP datagram.
                 }
                 // We just found the first UDP datagram with a data_provision message, now use this destination address all the time.
-                _act_destination = dst;
-                tsp->verbose(u"using UDP destination address %s", {dst});
+                _selector.setDestination(dst, *tsp);
+                _pcap_udp.setDestinationFilter(dst);
             }
 
             // Extract TS packets from the data_provision message.
@@ -320,7 +318,7 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
         }
         else {
             // Look for raw TS.
-            if (!_act_destination.hasAddress() || !_act_destination.hasPort()) {
+            if (!_selector.hasDestination()) {
                 // The actual destination is not fully known yet.
                 // We are still waiting for the first UDP datagram containing TS packets.
                 // Is there any TS packet in this one?
@@ -330,8 +328,8 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
                     continue; // no TS packet in this UDP datagram.
                 }
                 // We just found the first UDP datagram with TS packets, now use this destination address all the time.
-                _act_destination = dst;
-                tsp->verbose(u"using UDP destination address %s", {dst});
+                _selector.setDestination(dst, *tsp);
+                _pcap_udp.setDestinationFilter(dst);
             }
 
             // Now we have a valid UDP packet.
@@ -340,11 +338,7 @@ bool ts::PcapInputPlugin::receiveUDP(uint8_t *buffer, size_t buffer_size, size_t
         }
 
         // List all source addresses as they appear.
-        if (_all_sources.find(src) == _all_sources.end()) {
-            // This is a new source address.
-            tsp->verbose(u"%s UDP source address %s", {_all_sources.empty() ? u"using" : u"adding", src});
-            _all_sources.insert(src);
-        }
+        _selector.addSource(src, *tsp);
 
         // Adjust time stamps according to first one.
         if (timestamp >= 0) {
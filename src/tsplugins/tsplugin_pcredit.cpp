@@ -48,6 +48,7 @@ namespace ts {
         // Implementation of plugin API
         PCREditPlugin(TSP*);
         virtual bool getOptions() override;
+        virtual Sharding getSharding() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -169,6 +170,17 @@ bool ts::PCREditPlugin::getOptions()
 }
 
 
+//----------------------------------------------------------------------------
+// The time stamps of each packet are independently edited. With
+// --ignore-scrambled, the set of PID's is updated while processing packets.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Sharding ts::PCREditPlugin::getSharding()
+{
+    return _ignore_scrambled ? SHARD_NONE : SHARD_PIDS;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -177,11 +177,14 @@ bool ts::PIDShiftPlugin::start()
 {
     if (_shift_packets > 0) {
         // Initialize the buffer only when its size is specified in packets.
+        // Packets from other PID's are then not even submitted to the plugin.
+        setPIDFilter(_pids);
         _buffer.setTotalPackets(_shift_packets);
         return _buffer.open(*tsp);
     }
     else {
-        // Need an evaluation phase.
+        // Need an evaluation phase, using the global bitrate and packet count.
+        setPIDFilter(AllPIDs);
         _pass_all = false;
         _init_packets = 0;
         return true;
@@ -56,6 +56,7 @@ namespace ts {
         RemapPlugin(TSP*);
         virtual bool getOptions() override;
         virtual bool start() override;
+        virtual Sharding getSharding() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -138,11 +139,35 @@ bool ts::RemapPlugin::start()
     // Do not care about PMT if no need to update PSI
     _pmt_ready = !_update_psi;
 
+    // Without PSI update, only the remapped PID's and the PID conflicts need to be checked.
+    // Packets from other PID's are not even submitted to the plugin.
+    if (_update_psi) {
+        setPIDFilter(AllPIDs);
+    }
+    else {
+        setPIDFilter(_unchecked ? NoPID : _newPIDs);
+        for (const auto& it : _pidMap) {
+            addPIDFilter(it.first);
+        }
+    }
+
     tsp->verbose(u"%d PID's remapped", {_pidMap.size()});
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Without PSI update, the PID map is never modified after start() and the
+// packets are independently remapped. The PSI update uses the same demux for
+// all PID's, the packets must then be processed in sequence.
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Sharding ts::RemapPlugin::getSharding()
+{
+    return _update_psi ? SHARD_NONE : SHARD_PIDS;
+}
+
+
 //----------------------------------------------------------------------------
 // Get the remapped value of a PID (or same PID if not remapped)
 //----------------------------------------------------------------------------
@@ -47,6 +47,7 @@
 #define DEFAULT_ECM_BITRATE 30000
 #define DEFAULT_ECM_INTER_PACKET  7000  // When bitrate is unknown, use 10 ECM/s for TS @10Mb/s
 #define ASYNC_HANDLER_EXTRA_STACK_SIZE (1024 * 1024)
+#define DEFAULT_PACKET_WINDOW 256
 
 
 //----------------------------------------------------------------------------
@@ -103,7 +104,9 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     private:
         // Description of a crypto-period.
@@ -170,6 +173,7 @@ namespace ts {
         BitRate           _ecm_bitrate;         // ECM PID's bitrate
         PID               _ecm_pid;             // PID for ECM
         PacketCounter     _partial_scrambling;  // Do not scramble all packets if > 1
+        size_t            _window_size;         // Number of packets to process at once, zero means one by one.
         ECMGClientArgs    _ecmg_args;           // Parameters for ECMG client
         tlv::Logger       _logger;              // Message logger for ECMG <=> SCS protocol
         ecmgscs::ChannelStatus _channel_status; // Initial response to ECMG channel_setup
@@ -195,8 +199,15 @@ namespace ts {
         size_t            _current_cw;          // Index to current CW (current crypto period)
         size_t            _current_ecm;         // Index to current ECM (ECM being broadcast)
         TSScrambling      _scrambling;          // Scrambler
+        std::vector<TSPacket*> _batch;          // Packets to scramble with the current CW.
         CyclingPacketizer _pzer_pmt;            // Packetizer for modified PMT
 
+        // Process one packet. The packets to scramble are added in _batch.
+        Status handlePacket(TSPacket&);
+
+        // Scramble all packets in _batch with the current CW.
+        bool scrambleBatch();
+
         // Initialize ECM and CP scheduling.
         void initializeScheduling();
 
@@ -246,6 +257,7 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
     _ecm_bitrate(0),
     _ecm_pid(PID_NULL),
     _partial_scrambling(0),
+    _window_size(0),
     _ecmg_args(),
     _logger(Severity::Debug, tsp_),
     _channel_status(),
@@ -269,6 +281,7 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
     _current_cw(0),
     _current_ecm(0),
     _scrambling(*tsp),
+    _batch(),
     _pzer_pmt(duck)
 {
     // We need to define character sets to specify service names.
@@ -313,6 +326,14 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
          u"Do not scramble video components in the selected service. By default, "
          u"all video components are scrambled.");
 
+    option(u"packet-window", 0, UNSIGNED);
+    help(u"packet-window", u"count",
+         u"Number of packets to process at once. The packets to scramble in this window "
+         u"are scrambled together, using SIMD instructions of the CPU with DVB-CSA2. "
+         u"Larger windows use the CPU more efficiently but increase the latency of the stream. "
+         u"The default is " + UString::Decimal(DEFAULT_PACKET_WINDOW) + u" packets. "
+         u"The value zero means that packets are scrambled one by one.");
+
     option(u"partial-scrambling", 0, POSITIVE);
     help(u"partial-scrambling", u"count",
          u"Do not scramble all packets, only one packet every \"count\" packets. "
@@ -372,6 +393,7 @@ bool ts::ScramblerPlugin::getOptions()
     _scramble_subtitles = present(u"subtitles");
     _ignore_scrambled = present(u"ignore-scrambled");
     getIntValue(_partial_scrambling, u"partial-scrambling", 1);
+    getIntValue(_window_size, u"packet-window", DEFAULT_PACKET_WINDOW);
     getIntValue(_ecm_pid, u"pid-ecm", PID_NULL);
     getValue(_ecm_bitrate, u"bitrate-ecm", DEFAULT_ECM_BITRATE);
     getHexaValue(_ca_desc_private, u"private-data");
@@ -428,6 +450,7 @@ bool ts::ScramblerPlugin::start()
     _delay_start = 0;
     _current_cw = 0;
     _current_ecm = 0;
+    _batch.clear();
 
     // As long as the bitrate is unknown, delay changes to infinite.
     _pkt_insert_ecm = _pkt_change_cw = _pkt_change_ecm = std::numeric_limits<PacketCounter>::max();
@@ -506,6 +529,19 @@ bool ts::ScramblerPlugin::stop()
 }
 
 
+//----------------------------------------------------------------------------
+// Get the packet window size.
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::getPacketWindowSize()
+{
+    if (_window_size > 0) {
+        tsp->debug(u"packet window: %'d packets, DVB-CSA2 batch engine: %s", {_window_size, DVBCSA2::BatchEngineName()});
+    }
+    return _window_size;
+}
+
+
 //----------------------------------------------------------------------------
 // This method processes the PMT of the service.
 //----------------------------------------------------------------------------
@@ -704,6 +740,11 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
 
 bool ts::ScramblerPlugin::changeCW()
 {
+    // Packets which were collected before the transition must be scrambled with the previous key.
+    if (!scrambleBatch()) {
+        return false;
+    }
+
     if (_scrambling.hasFixedCW()) {
         // A list of fixed CW was loaded from a file.
 
@@ -763,10 +804,53 @@ void ts::ScramblerPlugin::changeECM()
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Scramble all collected packets with the current CW.
+//----------------------------------------------------------------------------
+
+bool ts::ScramblerPlugin::scrambleBatch()
+{
+    const bool ok = _batch.empty() || _scrambling.encrypt(_batch.data(), _batch.size());
+    _batch.clear();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processing methods
 //----------------------------------------------------------------------------
 
 ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    const Status status = handlePacket(pkt);
+    return scrambleBatch() ? status : TSP_END;
+}
+
+size_t ts::ScramblerPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    for (size_t i = 0; i < win.size(); ++i) {
+        TSPacket* pkt = nullptr;
+        TSPacketMetadata* pkt_data = nullptr;
+        if (win.get(i, pkt, pkt_data)) {
+            switch (handlePacket(*pkt)) {
+                case TSP_OK:
+                    break;
+                case TSP_NULL:
+                    win.nullify(i);
+                    break;
+                case TSP_DROP:
+                    win.drop(i);
+                    break;
+                case TSP_END:
+                default:
+                    // On scrambling error, some previous packets may be left clear, do not pass any of them.
+                    return scrambleBatch() ? i : 0;
+            }
+        }
+    }
+    return scrambleBatch() ? win.size() : 0;
+}
+
+ts::ProcessorPlugin::Status ts::ScramblerPlugin::handlePacket(TSPacket& pkt)
 {
     // Count packets
     _packet_count++;
@@ -872,10 +956,8 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
         _partial_clear = _partial_scrambling - 1;
     }
 
-    // Scramble the packet payload.
-    if (!_scrambling.encrypt(pkt)) {
-        return TSP_END;
-    }
+    // Scramble the packet payload with the next batch.
+    _batch.push_back(&pkt);
     _scrambled_count++;
 
     return TSP_OK;
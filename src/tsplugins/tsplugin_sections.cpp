@@ -291,6 +291,14 @@ bool ts::SectionsPlugin::start()
     _packetizer.reset();
     _packetizer.setPID(_output_pid);
     _sections.clear();
+
+    // Only the input PID's, the output PID and, when reused, the null PID are processed.
+    // Packets from other PID's are not even submitted to the plugin.
+    setPIDFilter(_input_pids);
+    addPIDFilter(_output_pid);
+    if (_use_null_pid) {
+        addPIDFilter(PID_NULL);
+    }
     return true;
 }
 
@@ -115,16 +115,20 @@ int MainCode(int argc, char *argv[])
     ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE);
     analyzer.setAnalysisOptions(opt.analysis);
 
-    // Open the TS file.
+    // Open the TS file. When possible, map it in memory to analyze the packets in place.
     ts::TSFile file;
+    file.setMemoryMapped(true);
     if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
         return EXIT_FAILURE;
     }
 
-    // Analyze all packets in the file.
-    ts::TSPacket pkt;
-    while (file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        analyzer.feedPacket(pkt);
+    // Analyze all packets in the file. Read them one by one from pipes.
+    const size_t max_packets = file.isMemoryMapped() ? 1024 : 1;
+    ts::TSPacketView view;
+    while (file.readPacketView(view, max_packets, opt) > 0) {
+        for (size_t i = 0; i < view.size(); ++i) {
+            analyzer.feedPacket(view[i]);
+        }
     }
     file.close(opt);
 
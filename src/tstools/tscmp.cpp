@@ -411,8 +411,11 @@ ts::FileToCompare::FileToCompare(TSCompareOptions& opt, const UString& filename)
     _missing_start(NONE),
     _missing_packets(0),
     _missing_chunks(0),
-    _end_of_file(!_file.openRead(filename, 1, _opt.byte_offset, _opt, _opt.format))
+    _end_of_file(false)
 {
+    // When possible, map the file in memory to avoid read operations.
+    _file.setMemoryMapped(true);
+    _end_of_file = !_file.openRead(filename, 1, _opt.byte_offset, _opt, _opt.format);
     fillBuffer();
 }
 
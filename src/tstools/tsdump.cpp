@@ -209,20 +209,26 @@ namespace {
             out << "* File " << filename << std::endl;
         }
 
-        // Open the TS file.
+        // Open the TS file. When possible, map it in memory to dump the packets in place.
         ts::TSFile file;
+        file.setMemoryMapped(true);
         if (!file.openRead(filename, 1, opt.start_offset, opt, opt.format)) {
             return;
         }
 
-        // Read all packets in the file.
-        ts::TSPacket pkt;
-        for (ts::PacketCounter packet_index = 0; packet_index < opt.max_packets && file.readPackets(&pkt, nullptr, 1, opt) > 0; packet_index++) {
-            if (opt.pids.test(pkt.getPID())) {
-                if (!opt.log) {
-                    out << std::endl << "* Packet " << ts::UString::Decimal(packet_index) << std::endl;
+        // Read all packets in the file. Read them one by one from pipes.
+        const size_t max_view = file.isMemoryMapped() ? 1024 : 1;
+        ts::TSPacketView view;
+        ts::PacketCounter packet_index = 0;
+        while (packet_index < opt.max_packets && file.readPacketView(view, size_t(std::min<ts::PacketCounter>(max_view, opt.max_packets - packet_index)), opt) > 0) {
+            for (size_t i = 0; i < view.size(); ++i, ++packet_index) {
+                const ts::TSPacket& pkt(view[i]);
+                if (opt.pids.test(pkt.getPID())) {
+                    if (!opt.log) {
+                        out << std::endl << "* Packet " << ts::UString::Decimal(packet_index) << std::endl;
+                    }
+                    pkt.display(out, opt.dump_flags, opt.log ? 0 : 2, opt.log_size);
                 }
-                pkt.display(out, opt.dump_flags, opt.log ? 0 : 2, opt.log_size);
             }
         }
         file.close(opt);
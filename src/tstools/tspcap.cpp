@@ -406,6 +406,7 @@ FileAnalysis::FileAnalysis(Options& opt) :
 bool FileAnalysis::analyze(std::ostream& out)
 {
     // Open the pcap file.
+    _file.setMemoryMapped(true);
     if (!_file.loadArgs(_opt.duck, _opt) || !_file.open(_opt.input_file, _opt)) {
         return false;
     }
@@ -620,6 +621,7 @@ UDPSimulCryptDump::UDPSimulCryptDump(Options& opt) :
 bool UDPSimulCryptDump::dump(std::ostream& out)
 {
     // Open the pcap file.
+    _file.setMemoryMapped(true);
     if (!_file.loadArgs(_opt.duck, _opt) || !_file.open(_opt.input_file, _opt)) {
         return false;
     }
@@ -672,6 +674,7 @@ TCPSimulCryptDump::TCPSimulCryptDump(Options& opt) :
 bool TCPSimulCryptDump::dump(std::ostream& out)
 {
     // Open the pcap file.
+    _file.setMemoryMapped(true);
     if (!_file.loadArgs(_opt.duck, _opt) || !_file.open(_opt.input_file, _opt)) {
         return false;
     }
@@ -762,6 +765,7 @@ void TCPSessionDump::dumpMessage(std::ostream& out, const ts::ByteBlock& data, c
 bool TCPSessionDump::dump(std::ostream& out)
 {
     // Open the pcap file.
+    _file.setMemoryMapped(true);
     if (!_file.loadArgs(_opt.duck, _opt) || !_file.open(_opt.input_file, _opt)) {
         return false;
     }
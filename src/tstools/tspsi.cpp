@@ -109,19 +109,24 @@ int MainCode(int argc, char *argv[])
     // Redirect display on pager process or stdout only.
     opt.duck.setOutput(&opt.pager.output(opt), false);
 
-    // Open the TS file.
+    // Open the TS file. When possible, map it in memory to analyze the packets in place.
     ts::TSFile file;
+    file.setMemoryMapped(true);
     if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
         return EXIT_FAILURE;
     }
 
-    // Read all packets in the file and pass them to the logger
-    ts::TSPacket pkt;
+    // Read all packets in the file and pass them to the logger.
+    // Read packets one by one from pipes, by chunks from mapped files.
+    const size_t max_packets = file.isMemoryMapped() ? 1024 : 1;
+    ts::TSPacketView view;
     if (!opt.logger.open()) {
         return EXIT_FAILURE;
     }
-    while (!opt.logger.completed() && file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        opt.logger.feedPacket(pkt);
+    while (!opt.logger.completed() && file.readPacketView(view, max_packets, opt) > 0) {
+        for (size_t i = 0; !opt.logger.completed() && i < view.size(); ++i) {
+            opt.logger.feedPacket(view[i]);
+        }
     }
     file.close(opt);
     opt.logger.close();
@@ -447,7 +447,8 @@ void Stuffer::evaluateNextStuffing()
 
 void Stuffer::stuff()
 {
-    // Open input file
+    // Open input file. When the file is mapped in memory, seeking back is not limited by the buffer size.
+    _input.setMemoryMapped(true);
     if (!_input.openRead(_opt.input_file, 1, 0, _opt, _opt.input_format)) {
         fatalError();
     }
@@ -113,16 +113,21 @@ int MainCode(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    // Open the TS file.
+    // Open the TS file. When possible, map it in memory to analyze the packets in place.
     ts::TSFile file;
+    file.setMemoryMapped(true);
     if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
         return EXIT_FAILURE;
     }
 
-    // Read all packets in the file and pass them to the logger
-    ts::TSPacket pkt;
-    while (!opt.logger.completed() && file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        opt.logger.feedPacket(pkt);
+    // Read all packets in the file and pass them to the logger.
+    // Read packets one by one from pipes, by chunks from mapped files.
+    const size_t max_packets = file.isMemoryMapped() ? 1024 : 1;
+    ts::TSPacketView view;
+    while (!opt.logger.completed() && file.readPacketView(view, max_packets, opt) > 0) {
+        for (size_t i = 0; !opt.logger.completed() && i < view.size(); ++i) {
+            opt.logger.feedPacket(view[i]);
+        }
     }
     file.close(opt);
     opt.logger.close();
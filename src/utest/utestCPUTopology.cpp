@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::CPUTopology
+//
+//----------------------------------------------------------------------------
+
+#include "tsCPUTopology.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class CPUTopologyTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testParseCPUList();
+    void testFormatCPUList();
+    void testSystem();
+
+    TSUNIT_TEST_BEGIN(CPUTopologyTest);
+    TSUNIT_TEST(testParseCPUList);
+    TSUNIT_TEST(testFormatCPUList);
+    TSUNIT_TEST(testSystem);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(CPUTopologyTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void CPUTopologyTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void CPUTopologyTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void CPUTopologyTest::testParseCPUList()
+{
+    ts::CPUSet cpus;
+
+    TSUNIT_ASSERT(ts::CPUTopology::ParseCPUList(cpus, u""));
+    TSUNIT_ASSERT(cpus.empty());
+
+    TSUNIT_ASSERT(ts::CPUTopology::ParseCPUList(cpus, u"3"));
+    TSUNIT_ASSERT(cpus == ts::CPUSet({3}));
+
+    TSUNIT_ASSERT(ts::CPUTopology::ParseCPUList(cpus, u"0-3, 8,10-11"));
+    TSUNIT_ASSERT(cpus == ts::CPUSet({0, 1, 2, 3, 8, 10, 11}));
+
+    TSUNIT_ASSERT(!ts::CPUTopology::ParseCPUList(cpus, u"4-2"));
+    TSUNIT_ASSERT(!ts::CPUTopology::ParseCPUList(cpus, u"1,x"));
+    TSUNIT_ASSERT(!ts::CPUTopology::ParseCPUList(cpus, u"1-"));
+
+    // Out-of-range CPU indexes.
+    TSUNIT_ASSERT(!ts::CPUTopology::ParseCPUList(cpus, u"0-4000000000"));
+    TSUNIT_ASSERT(cpus.empty());
+    TSUNIT_ASSERT(!ts::CPUTopology::ParseCPUList(cpus, u"1024"));
+    TSUNIT_ASSERT(ts::CPUTopology::ParseCPUList(cpus, u"1023"));
+    TSUNIT_ASSERT(ts::CPUTopology::ParseCPUList(cpus, u"0-3", 4));
+    TSUNIT_ASSERT(!ts::CPUTopology::ParseCPUList(cpus, u"0-4", 4));
+    TSUNIT_ASSERT(!ts::CPUTopology::ParseCPUList(cpus, u"2,5", 4));
+    TSUNIT_ASSERT(cpus.empty());
+
+    TSUNIT_ASSERT(ts::CPUTopology::ConfiguredCPUCount() >= 1);
+    TSUNIT_ASSERT(ts::CPUTopology::ConfiguredCPUCount() <= ts::CPUTopology::MAX_CPUS);
+}
+
+void CPUTopologyTest::testFormatCPUList()
+{
+    TSUNIT_EQUAL(u"", ts::CPUTopology::FormatCPUList(ts::CPUSet()));
+    TSUNIT_EQUAL(u"5", ts::CPUTopology::FormatCPUList(ts::CPUSet({5})));
+    TSUNIT_EQUAL(u"0-3,8,10-11", ts::CPUTopology::FormatCPUList(ts::CPUSet({0, 1, 2, 3, 8, 10, 11})));
+    TSUNIT_EQUAL(u"1,3,5-6", ts::CPUTopology::FormatCPUList(ts::CPUSet({6, 5, 3, 1})));
+}
+
+void CPUTopologyTest::testSystem()
+{
+    const ts::CPUTopology topo;
+    const std::vector<size_t> order(topo.placementOrder());
+
+    debug() << "CPUTopologyTest: usable CPU's: " << ts::CPUTopology::FormatCPUList(topo.cpus()) << std::endl;
+
+    // The placement order contains each usable CPU exactly once.
+    TSUNIT_ASSERT(!topo.cpus().empty());
+    TSUNIT_EQUAL(topo.cpus().size(), order.size());
+    TSUNIT_ASSERT(ts::CPUSet(order.begin(), order.end()) == topo.cpus());
+
+    // A CPU always shares its own caches.
+    const size_t first = *topo.cpus().begin();
+    TSUNIT_ASSERT(topo.shareCache(first, first, 2));
+    TSUNIT_ASSERT(topo.shareCache(first, first, 3));
+}
@@ -0,0 +1,244 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::CRC32
+//
+//----------------------------------------------------------------------------
+
+#include "tsCRC32.h"
+#include "tsByteBlock.h"
+#include "tsMonotonic.h"
+#include "tsUString.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class CRC32Test: public tsunit::Test
+{
+public:
+    CRC32Test();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testKnownValue();
+    void testReference();
+    void testIncremental();
+    void testMultiple();
+    void testThroughput();
+
+    TSUNIT_TEST_BEGIN(CRC32Test);
+    TSUNIT_TEST(testKnownValue);
+    TSUNIT_TEST(testReference);
+    TSUNIT_TEST(testIncremental);
+    TSUNIT_TEST(testMultiple);
+    TSUNIT_TEST(testThroughput);
+    TSUNIT_TEST_END();
+
+private:
+    ts::ByteBlock _data;
+};
+
+TSUNIT_REGISTER(CRC32Test);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+CRC32Test::CRC32Test() :
+    _data()
+{
+}
+
+// Test suite initialization method.
+void CRC32Test::beforeTest()
+{
+    // Pseudo-random test data, reproducible.
+    if (_data.empty()) {
+        _data.resize(70000);
+        uint32_t x = 0x12345678;
+        for (size_t i = 0; i < _data.size(); ++i) {
+            x = x * 1103515245 + 12345;
+            _data[i] = uint8_t(x >> 24);
+        }
+    }
+}
+
+// Test suite cleanup method.
+void CRC32Test::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Bit by bit reference implementation of the MPEG CRC32.
+    uint32_t ReferenceCRC32(const uint8_t* data, size_t size)
+    {
+        uint32_t fcs = 0xFFFFFFFF;
+        while (size-- > 0) {
+            fcs ^= uint32_t(*data++) << 24;
+            for (int bit = 0; bit < 8; ++bit) {
+                fcs = (fcs & 0x80000000) != 0 ? (fcs << 1) ^ 0x04C11DB7 : fcs << 1;
+            }
+        }
+        return fcs;
+    }
+}
+
+void CRC32Test::testKnownValue()
+{
+    debug() << "CRC32Test: hardware acceleration: " << ts::UString::YesNo(ts::CRC32::IsAccelerated()) << std::endl;
+
+    // Standard check value of CRC-32/MPEG-2.
+    static const char check[] = "123456789";
+    TSUNIT_EQUAL(0x0376E6E7, ts::CRC32(check, 9).value());
+    TSUNIT_EQUAL(0xFFFFFFFF, ts::CRC32(check, 0).value());
+
+    // The CRC32 of a section, including its CRC32 field, is zero.
+    static const uint8_t pat[] = {
+        0x00, 0xB0, 0x0D, 0x00, 0x01, 0xC1, 0x00, 0x00, 0x00, 0x01, 0xE1, 0x00,
+    };
+    uint8_t section[sizeof(pat) + 4];
+    ::memcpy(section, pat, sizeof(pat));
+    const uint32_t crc = ts::CRC32(pat, sizeof(pat)).value();
+    section[sizeof(pat)] = uint8_t(crc >> 24);
+    section[sizeof(pat) + 1] = uint8_t(crc >> 16);
+    section[sizeof(pat) + 2] = uint8_t(crc >> 8);
+    section[sizeof(pat) + 3] = uint8_t(crc);
+    TSUNIT_EQUAL(0, ts::CRC32(section, sizeof(section)).value());
+}
+
+void CRC32Test::testReference()
+{
+    // All sizes around the thresholds of the implementation, all alignments.
+    for (size_t size = 0; size < 1100; ++size) {
+        const size_t offset = size % 16;
+        TSUNIT_EQUAL(ReferenceCRC32(&_data[offset], size), ts::CRC32(&_data[offset], size).value());
+    }
+    for (size_t size = 4000; size < 70000; size += 4099) {
+        TSUNIT_EQUAL(ReferenceCRC32(&_data[3], size), ts::CRC32(&_data[3], size).value());
+    }
+}
+
+void CRC32Test::testIncremental()
+{
+    const size_t size = 5000;
+    const uint32_t expected = ReferenceCRC32(_data.data(), size);
+
+    // Split in two parts, small and large ones.
+    for (size_t split = 0; split <= size; split += 37) {
+        ts::CRC32 crc;
+        crc.add(_data.data(), split);
+        crc.add(_data.data() + split, size - split);
+        TSUNIT_EQUAL(expected, crc.value());
+    }
+
+    // Split in many parts of various sizes.
+    ts::CRC32 crc;
+    for (size_t i = 0, chunk = 1; i < size; i += chunk, chunk = chunk * 3 % 701) {
+        crc.add(_data.data() + i, std::min(chunk, size - i));
+    }
+    TSUNIT_EQUAL(expected, crc.value());
+}
+
+void CRC32Test::testMultiple()
+{
+    // Areas of various sizes, like a list of sections.
+    const size_t count = 23;
+    const void* data[count];
+    size_t sizes[count];
+    uint32_t crcs[count];
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sizes[i] = (i * 389) % 1025;
+        data[i] = &_data[offset];
+        offset += sizes[i] + 1;
+    }
+
+    // Check all numbers of areas, including incomplete groups.
+    for (size_t n = 0; n <= count; ++n) {
+        ts::CRC32::Compute(data, sizes, crcs, n);
+        for (size_t i = 0; i < n; ++i) {
+            TSUNIT_EQUAL(ReferenceCRC32(static_cast<const uint8_t*>(data[i]), sizes[i]), crcs[i]);
+        }
+    }
+}
+
+void CRC32Test::testThroughput()
+{
+    // Not a real benchmark, just an indication in debug mode.
+    const size_t loops = 200;
+    uint32_t sink = 0;
+
+    // Large area.
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < loops; ++i) {
+        sink += ts::CRC32(_data.data(), _data.size()).value();
+    }
+    ts::NanoSecond ns = std::max<ts::NanoSecond>(1, ts::Monotonic(true) - start);
+    debug() << "CRC32Test: large areas: " << (loops * _data.size() * 1000) / ns << " MB/s" << std::endl;
+
+    // Short sections, one by one and interleaved.
+    const size_t count = _data.size() / 200;
+    std::vector<const void*> data(count);
+    std::vector<size_t> sizes(count, 188);
+    std::vector<uint32_t> crcs(count);
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = &_data[i * 200];
+    }
+
+    start.getSystemTime();
+    for (size_t l = 0; l < loops; ++l) {
+        for (size_t i = 0; i < count; ++i) {
+            sink += ts::CRC32(data[i], sizes[i]).value();
+        }
+    }
+    ns = std::max<ts::NanoSecond>(1, ts::Monotonic(true) - start);
+    debug() << "CRC32Test: short sections, one by one: " << (loops * count * 188 * 1000) / ns << " MB/s" << std::endl;
+
+    start.getSystemTime();
+    for (size_t l = 0; l < loops; ++l) {
+        ts::CRC32::Compute(data.data(), sizes.data(), crcs.data(), count);
+        sink += crcs[0];
+    }
+    ns = std::max<ts::NanoSecond>(1, ts::Monotonic(true) - start);
+    debug() << "CRC32Test: short sections, interleaved: " << (loops * count * 188 * 1000) / ns << " MB/s" << std::endl;
+
+    // Use the result to avoid optimizing the computation away.
+    debug() << "CRC32Test: checksum: " << ts::UString::Hexa(sink) << std::endl;
+}
@@ -49,6 +49,8 @@
 #include "tsDVBCISSA.h"
 #include "tsIDSA.h"
 #include "tsTSPacket.h"
+#include "tsTSScrambling.h"
+#include "tsNullReport.h"
 #include "tsSystemRandomGenerator.h"
 #include "tsunit.h"
 
@@ -77,6 +79,7 @@ public:
     virtual void afterTest() override;
 
     void testAES();
+    void testAES_Blocks();
     void testAES_ECB();
     void testAES_CBC();
     void testAES_CTR();
@@ -89,6 +92,8 @@ public:
     void testTDES();
     void testTDES_CBC();
     void testDVBCSA2();
+    void testDVBCSA2Batch();
+    void testTSScramblingBatch();
     void testDVBCISSA();
     void testIDSA();
     void testSCTE52_2003();
@@ -96,9 +101,11 @@ public:
     void testSHA1();
     void testSHA256();
     void testSHA512();
+    void testHashMultiple();
 
     TSUNIT_TEST_BEGIN(CryptoTest);
     TSUNIT_TEST(testAES);
+    TSUNIT_TEST(testAES_Blocks);
     TSUNIT_TEST(testAES_ECB);
     TSUNIT_TEST(testAES_CBC);
     TSUNIT_TEST(testAES_CTR);
@@ -111,6 +118,8 @@ public:
     TSUNIT_TEST(testTDES);
     TSUNIT_TEST(testTDES_CBC);
     TSUNIT_TEST(testDVBCSA2);
+    TSUNIT_TEST(testDVBCSA2Batch);
+    TSUNIT_TEST(testTSScramblingBatch);
     TSUNIT_TEST(testDVBCISSA);
     TSUNIT_TEST(testIDSA);
     TSUNIT_TEST(testSCTE52_2003);
@@ -118,6 +127,7 @@ public:
     TSUNIT_TEST(testSHA1);
     TSUNIT_TEST(testSHA256);
     TSUNIT_TEST(testSHA512);
+    TSUNIT_TEST(testHashMultiple);
     TSUNIT_TEST_END();
 
 private:
@@ -151,6 +161,7 @@ private:
                   const char* message,
                   const void* hash,
                   size_t hash_size);
+    void testHashMultiple(ts::Hash& algo);
 };
 
 TSUNIT_REGISTER(CryptoTest);
@@ -324,6 +335,48 @@ void CryptoTest::testHash(ts::Hash& algo,
     }
 }
 
+void CryptoTest::testHashMultiple(ts::Hash& algo)
+{
+    // Messages of all sizes around the padding limits, in a pseudo-random buffer.
+    ts::ByteBlock buffer(20000);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = uint8_t(i * 7 + (i >> 8));
+    }
+    std::vector<const void*> data;
+    std::vector<size_t> sizes;
+    for (size_t size = 0, offset = 0; offset + size <= buffer.size(); size = (size * 5 + 3) % 1000, offset += size + 1) {
+        data.push_back(&buffer[offset]);
+        sizes.push_back(size);
+    }
+    for (size_t size = 50; size < 140; ++size) {
+        data.push_back(&buffer[size]);
+        sizes.push_back(size);
+    }
+
+    // Reference hashes, one by one, large messages added in several parts.
+    const size_t hsize = algo.hashSize();
+    ts::ByteBlock expected(data.size() * hsize);
+    for (size_t i = 0; i < data.size(); ++i) {
+        const uint8_t* msg = static_cast<const uint8_t*>(data[i]);
+        const size_t part = sizes[i] / 3;
+        TSUNIT_ASSERT(algo.init());
+        TSUNIT_ASSERT(algo.add(msg, part));
+        TSUNIT_ASSERT(algo.add(msg + part, sizes[i] - part));
+        TSUNIT_ASSERT(algo.getHash(&expected[i * hsize], hsize));
+        ts::ByteBlock one;
+        TSUNIT_ASSERT(algo.hash(msg, sizes[i], one));
+        TSUNIT_ASSERT(one == ts::ByteBlock(&expected[i * hsize], hsize));
+    }
+
+    // All hashes at once, for all numbers of messages.
+    ts::ByteBlock hashes(data.size() * hsize);
+    for (size_t count = 0; count <= data.size(); count += count < 10 ? 1 : 7) {
+        TSUNIT_ASSERT(algo.hashMultiple(data.data(), sizes.data(), count, hashes.data(), hashes.size()));
+        TSUNIT_EQUAL(0, ::memcmp(hashes.data(), expected.data(), count * hsize));
+    }
+    TSUNIT_ASSERT(!algo.hashMultiple(data.data(), sizes.data(), data.size(), hashes.data(), hashes.size() - 1));
+}
+
 void CryptoTest::testAES()
 {
     ts::AES aes;
@@ -348,6 +401,75 @@ void CryptoTest::testAES()
     }
 }
 
+void CryptoTest::testAES_Blocks()
+{
+    debug() << "CryptoTest: AES hardware acceleration: " << ts::UString::YesNo(ts::AES::IsAccelerated()) << std::endl;
+
+    ts::SystemRandomGenerator prng;
+    ts::AES aes;
+
+    // Not a multiple of the number of blocks which are processed in parallel.
+    const size_t count = 37;
+    const size_t size = count * ts::AES::BLOCK_SIZE;
+    ts::ByteBlock key(ts::AES::MAX_KEY_SIZE);
+    ts::ByteBlock plain(size);
+    ts::ByteBlock single(size);
+    ts::ByteBlock cipher(size);
+    ts::ByteBlock decipher(size);
+
+    // Compare multi-block operations with block-by-block operations.
+    for (size_t key_size = ts::AES::MIN_KEY_SIZE; key_size <= ts::AES::MAX_KEY_SIZE; key_size += 8) {
+        TSUNIT_ASSERT(prng.read(key.data(), key_size));
+        TSUNIT_ASSERT(prng.read(plain.data(), plain.size()));
+        TSUNIT_ASSERT(aes.setKey(key.data(), key_size));
+        for (size_t i = 0; i < size; i += ts::AES::BLOCK_SIZE) {
+            TSUNIT_ASSERT(aes.encrypt(&plain[i], ts::AES::BLOCK_SIZE, &single[i], ts::AES::BLOCK_SIZE));
+        }
+        TSUNIT_ASSERT(aes.encryptBlocks(plain.data(), cipher.data(), count));
+        TSUNIT_ASSERT(cipher == single);
+        TSUNIT_ASSERT(aes.decryptBlocks(cipher.data(), decipher.data(), count));
+        TSUNIT_ASSERT(decipher == plain);
+
+        // Same operations in place.
+        TSUNIT_ASSERT(aes.encryptBlocks(cipher.data(), cipher.data(), 0));
+        TSUNIT_ASSERT(aes.decryptBlocks(cipher.data(), cipher.data(), count));
+        TSUNIT_ASSERT(cipher == plain);
+        TSUNIT_ASSERT(aes.encryptBlocks(cipher.data(), cipher.data(), count));
+        TSUNIT_ASSERT(cipher == single);
+        TSUNIT_EQUAL(3 * count, aes.encryptionCount());
+        TSUNIT_EQUAL(2 * count, aes.decryptionCount());
+    }
+
+    // CTR mode on several batches of counters, compared with counters which are encrypted one by one.
+    // The 64-bit counter part of the IV wraps during the encryption.
+    ts::CTR<ts::AES> ctr_aes;
+    uint8_t iv[ts::AES::BLOCK_SIZE];
+    TSUNIT_ASSERT(prng.read(iv, sizeof(iv)));
+    ::memset(iv + 8, 0xFF, 8);
+    iv[15] = 0xF3;
+
+    uint8_t counter[ts::AES::BLOCK_SIZE];
+    uint8_t mask[ts::AES::BLOCK_SIZE];
+    ::memcpy(counter, iv, sizeof(counter));
+    for (size_t i = 0; i < size; i += ts::AES::BLOCK_SIZE) {
+        TSUNIT_ASSERT(aes.encrypt(counter, sizeof(counter), mask, sizeof(mask)));
+        for (size_t j = 0; j < ts::AES::BLOCK_SIZE; ++j) {
+            single[i + j] = plain[i + j] ^ mask[j];
+        }
+        for (size_t j = ts::AES::BLOCK_SIZE; j > 8 && ++counter[j - 1] == 0; --j) {
+        }
+    }
+
+    // Residue in last block.
+    const size_t ctr_size = size - 5;
+    TSUNIT_ASSERT(ctr_aes.setKey(key.data(), ts::AES::MAX_KEY_SIZE));
+    TSUNIT_ASSERT(ctr_aes.setIV(iv, sizeof(iv)));
+    TSUNIT_ASSERT(ctr_aes.encrypt(plain.data(), ctr_size, cipher.data(), cipher.size()));
+    TSUNIT_EQUAL(0, ::memcmp(cipher.data(), single.data(), ctr_size));
+    TSUNIT_ASSERT(ctr_aes.decrypt(cipher.data(), ctr_size, decipher.data(), decipher.size()));
+    TSUNIT_EQUAL(0, ::memcmp(decipher.data(), plain.data(), ctr_size));
+}
+
 void CryptoTest::testAES_ECB()
 {
     ts::ECB<ts::AES> ecb_aes;
@@ -356,6 +478,7 @@ void CryptoTest::testAES_ECB()
         const TV_AES_CHAIN* tv = tv_ecb_aes + tvi;
         testChaining(ecb_aes, tvi, tv_count, tv->key, tv->key_size, tv->iv, tv->iv_size, tv->plain, tv->plain_size, tv->cipher, tv->cipher_size);
     }
+    testChainingSizes(ecb_aes, 16, 32, 128, 144, 592, 4096, 0);
 }
 
 void CryptoTest::testAES_CBC()
@@ -366,6 +489,7 @@ void CryptoTest::testAES_CBC()
         const TV_AES_CHAIN* tv = tv_cbc_aes + tvi;
         testChaining(cbc_aes, tvi, tv_count, tv->key, tv->key_size, tv->iv, tv->iv_size, tv->plain, tv->plain_size, tv->cipher, tv->cipher_size);
     }
+    testChainingSizes(cbc_aes, 16, 32, 128, 144, 592, 4096, 0);
 }
 
 void CryptoTest::testAES_CTR()
@@ -488,6 +612,144 @@ void CryptoTest::testDVBCSA2()
     }
 }
 
+void CryptoTest::testDVBCSA2Batch()
+{
+    debug() << "CryptoTest: DVB-CSA2 batch engine: " << ts::DVBCSA2::BatchEngineName() << ", " << ts::DVBCSA2::BatchSize() << " packets" << std::endl;
+    TSUNIT_ASSERT(ts::DVBCSA2::BatchSize() >= 64);
+
+    ts::DVBCSA2 csa;
+
+    // Test vectors, each one replicated in a batch larger than the batch size.
+    const size_t tv_count = sizeof(tv_dvb_csa2) / sizeof(tv_dvb_csa2[0]);
+    const size_t tv_repeat = ts::DVBCSA2::BatchSize() + 3;
+    for (size_t tvi = 0; tvi < tv_count; ++tvi) {
+        const TV_DVB_CSA2* tv = tv_dvb_csa2 + tvi;
+        std::vector<ts::ByteBlock> blocks(tv_repeat, ts::ByteBlock(tv->plain, tv->size));
+        std::vector<uint8_t*> data(tv_repeat);
+        std::vector<size_t> sizes(tv_repeat, tv->size);
+        for (size_t i = 0; i < tv_repeat; ++i) {
+            data[i] = blocks[i].data();
+        }
+        TSUNIT_ASSERT(csa.setKey(tv->key, sizeof(tv->key)));
+        TSUNIT_ASSERT(csa.encryptInPlaceBatch(data.data(), sizes.data(), tv_repeat));
+        for (size_t i = 0; i < tv_repeat; ++i) {
+            TSUNIT_EQUAL(0, ::memcmp(tv->cipher, data[i], tv->size));
+        }
+        TSUNIT_ASSERT(csa.decryptInPlaceBatch(data.data(), sizes.data(), tv_repeat));
+        for (size_t i = 0; i < tv_repeat; ++i) {
+            TSUNIT_EQUAL(0, ::memcmp(tv->plain, data[i], tv->size));
+        }
+    }
+
+    // Random data blocks of various sizes, compared with the block-by-block operations.
+    ts::SystemRandomGenerator prng;
+    uint8_t key[8];
+    TSUNIT_ASSERT(prng.read(key, sizeof(key)));
+    TSUNIT_ASSERT(csa.setKey(key, sizeof(key)));
+
+    const size_t counts[] = {0, 1, 7, 8, 63, 64, 65, 127, 128, 129, 300};
+    for (size_t ci = 0; ci < sizeof(counts) / sizeof(counts[0]); ++ci) {
+        const size_t count = counts[ci];
+        std::vector<ts::ByteBlock> plain(count);
+        std::vector<ts::ByteBlock> batch(count);
+        std::vector<ts::ByteBlock> single(count);
+        std::vector<uint8_t*> data(count);
+        std::vector<size_t> sizes(count);
+        for (size_t i = 0; i < count; ++i) {
+            // Mostly full payloads, with a few short or unaligned ones.
+            sizes[i] = i % 5 == 3 ? (i * 37) % 185 : 184;
+            plain[i].resize(sizes[i]);
+            TSUNIT_ASSERT(prng.read(plain[i].data(), plain[i].size()));
+            batch[i] = single[i] = plain[i];
+            data[i] = batch[i].data();
+            TSUNIT_ASSERT(csa.encryptInPlace(single[i].data(), single[i].size()));
+        }
+        TSUNIT_ASSERT(csa.encryptInPlaceBatch(data.data(), sizes.data(), count));
+        for (size_t i = 0; i < count; ++i) {
+            if (batch[i] != single[i]) {
+                debug() << "CryptoTest: DVB-CSA2 batch encryption failed, count: " << count << ", index: " << i << ", size: " << sizes[i] << std::endl;
+            }
+            TSUNIT_ASSERT(batch[i] == single[i]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_ASSERT(csa.decryptInPlace(single[i].data(), single[i].size()));
+        }
+        TSUNIT_ASSERT(csa.decryptInPlaceBatch(data.data(), sizes.data(), count));
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_ASSERT(batch[i] == single[i]);
+            TSUNIT_ASSERT(batch[i] == plain[i]);
+        }
+    }
+}
+
+void CryptoTest::testTSScramblingBatch()
+{
+    ts::SystemRandomGenerator prng;
+    ts::ByteBlock cw_even, cw_odd;
+    TSUNIT_ASSERT(prng.readByteBlock(cw_even, 8));
+    TSUNIT_ASSERT(prng.readByteBlock(cw_odd, 8));
+
+    ts::TSScrambling single(NULLREP);
+    ts::TSScrambling batch(NULLREP);
+    TSUNIT_ASSERT(single.start());
+    TSUNIT_ASSERT(batch.start());
+    TSUNIT_ASSERT(single.setCW(cw_even, 0));
+    TSUNIT_ASSERT(single.setCW(cw_odd, 1));
+    TSUNIT_ASSERT(batch.setCW(cw_even, 0));
+    TSUNIT_ASSERT(batch.setCW(cw_odd, 1));
+
+    // Random packets, some of them with adaptation field, one clear packet out of 10.
+    const size_t count = 300;
+    ts::TSPacketVector plain(count);
+    for (size_t i = 0; i < count; ++i) {
+        plain[i].init(ts::PID(100 + i % 3), uint8_t(i & 0x0F));
+        const size_t af_size = i % 7 == 2 ? (i * 13) % 150 : 0;
+        if (af_size > 0) {
+            plain[i].b[3] |= 0x20;
+            plain[i].b[4] = uint8_t(af_size - 1);
+            if (af_size > 1) {
+                plain[i].b[5] = 0;
+            }
+        }
+        TSUNIT_ASSERT(prng.read(plain[i].getPayload(), plain[i].getPayloadSize()));
+    }
+
+    // Scramble with interleaved parities, packet by packet.
+    ts::TSPacketVector scrambled(plain);
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 10 != 9) {
+            TSUNIT_ASSERT(single.setEncryptParity(int((i / 3) % 2)));
+            TSUNIT_ASSERT(single.encrypt(scrambled[i]));
+        }
+    }
+
+    // Descramble in one batch, the odd and even packets are grouped.
+    ts::TSPacketVector descrambled(scrambled);
+    std::vector<ts::TSPacket*> pkts(count + 1, nullptr);
+    for (size_t i = 0; i < count; ++i) {
+        pkts[i + 1] = &descrambled[i];
+    }
+    TSUNIT_ASSERT(batch.decrypt(pkts.data(), pkts.size()));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(descrambled[i] == plain[i]);
+    }
+
+    // Scramble in one batch with the odd key, compared with packet by packet.
+    ts::TSPacketVector reference(plain);
+    TSUNIT_ASSERT(single.setEncryptParity(1));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(single.encrypt(reference[i]));
+    }
+    TSUNIT_ASSERT(batch.setEncryptParity(1));
+    TSUNIT_ASSERT(batch.encrypt(pkts.data(), pkts.size()));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(descrambled[i] == reference[i]);
+    }
+
+    // Already scrambled packets are rejected.
+    TSUNIT_ASSERT(!batch.encrypt(pkts.data(), pkts.size()));
+}
+
 void CryptoTest::testDVBCISSA()
 {
     ts::DVBCISSA cissa;
@@ -538,6 +800,8 @@ void CryptoTest::testSCTE52_2008()
 
 void CryptoTest::testSHA1()
 {
+    debug() << "CryptoTest: SHA-1 hardware acceleration: " << ts::UString::YesNo(ts::SHA1::IsAccelerated()) << std::endl;
+
     ts::SHA1 sha1;
     TSUNIT_ASSERT(sha1.hashSize() == 20);
     TSUNIT_ASSERT(sha1.blockSize() == 64);
@@ -550,6 +814,8 @@ void CryptoTest::testSHA1()
 
 void CryptoTest::testSHA256()
 {
+    debug() << "CryptoTest: SHA-256 hardware acceleration: " << ts::UString::YesNo(ts::SHA256::IsAccelerated()) << std::endl;
+
     ts::SHA256 sha256;
     TSUNIT_ASSERT(sha256.hashSize() == 32);
     TSUNIT_ASSERT(sha256.blockSize() == 64);
@@ -571,3 +837,13 @@ void CryptoTest::testSHA512()
         testHash(sha512, tvi, tv_count, tv->message, tv->hash, sizeof(tv->hash));
     }
 }
+
+void CryptoTest::testHashMultiple()
+{
+    ts::SHA1 sha1;
+    testHashMultiple(sha1);
+    ts::SHA256 sha256;
+    testHashMultiple(sha256);
+    ts::SHA512 sha512;
+    testHashMultiple(sha512);
+}
@@ -92,6 +92,7 @@ public:
     void testTDT();
     void testTOT();
     void testHEVC();
+    void testVersions();
 
     TSUNIT_TEST_BEGIN(DemuxTest);
     TSUNIT_TEST(testPAT);
@@ -105,6 +106,7 @@ public:
     TSUNIT_TEST(testTDT);
     TSUNIT_TEST(testTOT);
     TSUNIT_TEST(testHEVC);
+    TSUNIT_TEST(testVersions);
     TSUNIT_TEST_END();
 
 private:
@@ -489,3 +491,141 @@ void DemuxTest::testHEVC()
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+
+//----------------------------------------------------------------------------
+// Many tables on the same PID with successive versions.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Payload byte of a test section.
+    uint8_t PayloadByte(uint16_t tid_ext, uint8_t version, uint8_t section_number, size_t index)
+    {
+        return uint8_t(tid_ext + 3 * version + 11 * section_number + index);
+    }
+
+    // Check the content of a test section.
+    bool CheckSection(const ts::Section& sect, size_t payload_size)
+    {
+        if (!sect.isValid() || !sect.isLongSection() || sect.payloadSize() != payload_size) {
+            return false;
+        }
+        for (size_t i = 0; i < payload_size; ++i) {
+            if (sect.payload()[i] != PayloadByte(sect.tableIdExtension(), sect.version(), sect.sectionNumber(), i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Check all tables and sections, optionally keep the sections of all tables.
+    class VersionsHandler : public ts::TableHandlerInterface, public ts::SectionHandlerInterface
+    {
+        TS_NOCOPY(VersionsHandler);
+    public:
+        VersionsHandler(bool keep_sections, size_t size) : keep(keep_sections), payload_size(size), tables(0), sections(0), errors(0), kept() {}
+        const bool   keep;
+        const size_t payload_size;
+        size_t tables;
+        size_t sections;
+        size_t errors;
+        ts::SectionPtrVector kept;
+
+        virtual void handleTable(ts::SectionDemux&, const ts::BinaryTable& table) override
+        {
+            tables++;
+            for (size_t i = 0; i < table.sectionCount(); ++i) {
+                const ts::SectionPtr& sect(table.sectionAt(i));
+                if (sect->isLongSection() && !CheckSection(*sect, payload_size)) {
+                    errors++;
+                }
+                if (keep) {
+                    kept.push_back(sect);
+                }
+            }
+        }
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& sect) override
+        {
+            sections++;
+            if (sect.isLongSection() && !CheckSection(sect, payload_size)) {
+                errors++;
+            }
+        }
+    };
+}
+
+void DemuxTest::testVersions()
+{
+    constexpr ts::PID pid = 100;
+    constexpr ts::TID tid = 0x80;
+    constexpr size_t rounds = 20;
+    constexpr size_t tables = 40;
+    constexpr uint8_t last_section = 2;
+    constexpr size_t payload_size = 300;
+    constexpr size_t sections = rounds * (tables * (last_section + 1) + 1);
+
+    ts::DuckContext duck;
+    ts::OneShotPacketizer pzer(duck, pid);
+    uint8_t payload[payload_size];
+
+    // All tables of a round are sent, with a new version in each round.
+    // The table id extensions are not in increasing order.
+    for (size_t round = 0; round < rounds; ++round) {
+        const uint8_t version = uint8_t(round % 32);
+        for (size_t t = 0; t < tables; ++t) {
+            const uint16_t tid_ext = uint16_t((t * 37) % 101);
+            for (uint8_t sn = 0; sn <= last_section; ++sn) {
+                for (size_t i = 0; i < payload_size; ++i) {
+                    payload[i] = PayloadByte(tid_ext, version, sn, i);
+                }
+                pzer.addSection(new ts::Section(tid, true, tid_ext, version, true, sn, last_section, payload, payload_size, pid));
+            }
+        }
+        // One short section per round.
+        payload[0] = uint8_t(round);
+        pzer.addSection(new ts::Section(ts::TID_TDT, false, payload, 5, pid));
+    }
+
+    ts::TSPacketVector packets;
+    pzer.getPackets(packets);
+    debug() << "DemuxTest::testVersions: " << packets.size() << " packets" << std::endl;
+
+    // First pass: the sections are not kept by the application and are reused by the demux.
+    VersionsHandler handler1(false, payload_size);
+    ts::SectionDemux demux1(duck, &handler1, &handler1);
+    demux1.addPID(pid);
+    for (const auto& pkt : packets) {
+        demux1.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(rounds * (tables + 1), handler1.tables);
+    TSUNIT_EQUAL(sections, handler1.sections);
+    TSUNIT_EQUAL(0, handler1.errors);
+    TSUNIT_ASSERT(!demux1.hasErrors());
+
+    // Second pass: the sections of all tables are kept by the application.
+    VersionsHandler handler2(true, payload_size);
+    ts::SectionDemux demux2(duck, &handler2, &handler2);
+    demux2.addPID(pid);
+    for (const auto& pkt : packets) {
+        demux2.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(rounds * (tables + 1), handler2.tables);
+    TSUNIT_EQUAL(sections, handler2.sections);
+    TSUNIT_EQUAL(0, handler2.errors);
+    TSUNIT_EQUAL(sections, handler2.kept.size());
+    TSUNIT_ASSERT(!demux2.hasErrors());
+
+    // The kept sections must not have been reused by the demux.
+    size_t round = 0;
+    for (const auto& sect : handler2.kept) {
+        if (sect->isLongSection()) {
+            TSUNIT_EQUAL(tid, sect->tableId());
+            TSUNIT_ASSERT(CheckSection(*sect, payload_size));
+        }
+        else {
+            TSUNIT_EQUAL(ts::TID_TDT, sect->tableId());
+            TSUNIT_EQUAL(round++, sect->payload()[0]);
+        }
+    }
+    TSUNIT_EQUAL(rounds, round);
+}
@@ -0,0 +1,291 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::AbstractDescrambler
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractDescrambler.h"
+#include "tsPluginRepository.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsPluginEventData.h"
+#include "tsTSProcessor.h"
+#include "tsTSScrambling.h"
+#include "tsDuckContext.h"
+#include "tsArgs.h"
+#include "tsCerrReport.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class DescramblerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testWorkerThreads();
+    void testInspectPacket();
+
+    TSUNIT_TEST_BEGIN(DescramblerTest);
+    TSUNIT_TEST(testWorkerThreads);
+    TSUNIT_TEST(testInspectPacket);
+    TSUNIT_TEST_END();
+
+private:
+    // Build clear packets on the specified PID's, with distinct payloads.
+    static void buildPackets(ts::TSPacketVector& packets, size_t count, const std::vector<ts::PID>& pids);
+
+    // Scramble packets using AES-CBC.
+    static void scramble(ts::TSPacketVector& packets, const ts::UStringVector& args);
+
+    // Descramble packets using the test descrambler plugin.
+    static void descramble(const ts::TSPacketVector& input, ts::TSPacketVector& output, const ts::UStringVector& args);
+};
+
+TSUNIT_REGISTER(DescramblerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void DescramblerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void DescramblerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// A descrambler plugin with fixed control words only, without CAS.
+// All packets are counted and the packets from PID DROP_PID are dropped.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TestDescrambler : public ts::AbstractDescrambler
+    {
+        TS_NOBUILD_NOCOPY(TestDescrambler);
+    public:
+        TestDescrambler(ts::TSP* tsp_) : AbstractDescrambler(tsp_, u"Test descrambler", u"[options]") {}
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP* tsp_) { return new TestDescrambler(tsp_); }
+
+        static constexpr ts::PID DROP_PID = 200;
+        static size_t inspected;
+
+    protected:
+        virtual bool checkCADescriptor(uint16_t, const ts::ByteBlock&) override { return false; }
+        virtual bool checkECM(const ts::Section&) override { return false; }
+        virtual bool decipherECM(const ts::Section&, CWData&, CWData&) override { return false; }
+        virtual Status inspectPacket(ts::TSPacket& pkt, ts::TSPacketMetadata&) override
+        {
+            inspected++;
+            return pkt.getPID() == DROP_PID ? TSP_DROP : TSP_OK;
+        }
+    };
+
+    size_t TestDescrambler::inspected = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Event handlers for memory input and output plugins.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Input : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(Input);
+    public:
+        Input(const ts::TSPacketVector& packets) : _packets(packets), _next(0) {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    private:
+        const ts::TSPacketVector& _packets;
+        size_t _next;
+    };
+
+    void Input::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+        if (data != nullptr) {
+            const size_t count = std::min(_packets.size() - _next, data->maxSize() / ts::PKT_SIZE);
+            data->append(&_packets[_next], count * ts::PKT_SIZE);
+            _next += count;
+        }
+    }
+
+    class Output : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(Output);
+    public:
+        Output(ts::TSPacketVector& packets) : _packets(packets) {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    private:
+        ts::TSPacketVector& _packets;
+    };
+
+    void Output::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+        if (data != nullptr) {
+            const size_t count = data->size() / ts::PKT_SIZE;
+            const size_t index = _packets.size();
+            _packets.resize(index + count);
+            ts::TSPacket::Copy(&_packets[index], data->data(), count);
+        }
+    }
+}
+
+void DescramblerTest::buildPackets(ts::TSPacketVector& packets, size_t count, const std::vector<ts::PID>& pids)
+{
+    packets.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        packets[i].init(pids[i % pids.size()], uint8_t(i / pids.size()));
+        for (size_t j = 4; j < ts::PKT_SIZE; ++j) {
+            packets[i].b[j] = uint8_t(i + j);
+        }
+    }
+}
+
+void DescramblerTest::scramble(ts::TSPacketVector& packets, const ts::UStringVector& args_list)
+{
+    ts::DuckContext duck;
+    ts::Args args;
+    ts::TSScrambling scrambler;
+    scrambler.defineArgs(args);
+    TSUNIT_ASSERT(args.analyze(u"DescramblerTest", args_list));
+    TSUNIT_ASSERT(scrambler.loadArgs(duck, args));
+    TSUNIT_ASSERT(scrambler.start());
+    for (auto& pkt : packets) {
+        TSUNIT_ASSERT(scrambler.encrypt(pkt));
+    }
+    TSUNIT_ASSERT(scrambler.stop());
+}
+
+void DescramblerTest::descramble(const ts::TSPacketVector& input, ts::TSPacketVector& output, const ts::UStringVector& args)
+{
+    Input in(input);
+    Output out(output);
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"DescramblerTest";
+    opt.input = {u"memory", {}};
+    opt.plugins = {{u"test_descrambler", args}};
+    opt.output = {u"memory", {}};
+
+    ts::TSProcessor tsproc(CERR);
+    tsproc.registerEventHandler(&in, ts::PluginType::INPUT);
+    tsproc.registerEventHandler(&out, ts::PluginType::OUTPUT);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void DescramblerTest::testWorkerThreads()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"test_descrambler", TestDescrambler::CreateInstance);
+
+    // AES-CBC with a non-default IV, which must be used by all worker threads.
+    const ts::UStringVector scrambling_args {
+        u"--aes-cbc",
+        u"--iv", u"000102030405060708090A0B0C0D0E0F",
+        u"--cw", u"00112233445566778899AABBCCDDEEFF",
+    };
+
+    // Clear packets on 8 PID's, with distinct payloads.
+    constexpr size_t count = 4000;
+    ts::TSPacketVector clear;
+    buildPackets(clear, count, {100, 101, 102, 103, 104, 105, 106, 107});
+
+    // Scramble all packets.
+    ts::TSPacketVector scrambled(clear);
+    scramble(scrambled, scrambling_args);
+
+    // Descramble in the plugin thread, then with a pool of worker threads.
+    ts::UStringVector single_args(scrambling_args);
+    single_args.insert(single_args.end(), {u"--pid", u"100-107"});
+    ts::UStringVector pool_args(single_args);
+    pool_args.insert(pool_args.end(), {u"--worker-threads", u"4"});
+
+    ts::TSPacketVector single;
+    ts::TSPacketVector pool;
+    descramble(scrambled, single, single_args);
+    descramble(scrambled, pool, pool_args);
+
+    TSUNIT_EQUAL(count, single.size());
+    TSUNIT_EQUAL(count, pool.size());
+    TSUNIT_EQUAL(0, ::memcmp(single.data(), clear.data(), count * ts::PKT_SIZE));
+    TSUNIT_EQUAL(0, ::memcmp(pool.data(), single.data(), count * ts::PKT_SIZE));
+}
+
+void DescramblerTest::testInspectPacket()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"test_descrambler", TestDescrambler::CreateInstance);
+
+    const ts::UStringVector scrambling_args {u"--aes-cbc", u"--cw", u"00112233445566778899AABBCCDDEEFF"};
+
+    // Packets on two scrambled PID's and one PID to drop.
+    constexpr size_t count = 3000;
+    ts::TSPacketVector clear;
+    buildPackets(clear, count, {100, 101, TestDescrambler::DROP_PID});
+    ts::TSPacketVector scrambled(clear);
+    scramble(scrambled, scrambling_args);
+
+    // Expected output: clear packets without the dropped PID.
+    ts::TSPacketVector expected;
+    for (const auto& pkt : clear) {
+        if (pkt.getPID() != TestDescrambler::DROP_PID) {
+            expected.push_back(pkt);
+        }
+    }
+
+    // The hook is called for all packets, by window (default) or one by one.
+    for (const auto& window : {u"256", u"0"}) {
+        ts::UStringVector args(scrambling_args);
+        args.insert(args.end(), {u"--pid", u"100-101", u"--packet-window", window});
+        ts::TSPacketVector output;
+        TestDescrambler::inspected = 0;
+        descramble(scrambled, output, args);
+        debug() << "DescramblerTest::testInspectPacket: packet window: " << window << ", inspected: " << TestDescrambler::inspected << std::endl;
+        TSUNIT_EQUAL(count, TestDescrambler::inspected);
+        TSUNIT_EQUAL(expected.size(), output.size());
+        TSUNIT_EQUAL(0, ::memcmp(output.data(), expected.data(), expected.size() * ts::PKT_SIZE));
+    }
+}
@@ -40,10 +40,17 @@
 #include "tsTCPConnection.h"
 #include "tsTCPServer.h"
 #include "tsUDPSocket.h"
+#include "tsPacketRing.h"
+#include "tsUDPStreamSelector.h"
+#include "tsPcapFilter.h"
+#include "tsPcap.h"
+#include "tsFileUtils.h"
 #include "tsThread.h"
 #include "tsSysUtils.h"
 #include "tsIPUtils.h"
 #include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "tsByteBlock.h"
 #include "utestTSUnitThread.h"
 #include "tsunit.h"
 
@@ -70,10 +77,14 @@ public:
     void testIPv6SocketAddress();
     void testTCPSocket();
     void testUDPSocket();
+    void testUDPMultiple();
+    void testPacketRing();
+    void testUDPStreamSelector();
     void testIPHeader();
     void testIPProtocol();
     void testTCPPacket();
     void testUDPPacket();
+    void testPcapIndex();
 
     TSUNIT_TEST_BEGIN(NetworkingTest);
     TSUNIT_TEST(testIPv4AddressConstructors);
@@ -86,10 +97,14 @@ public:
     TSUNIT_TEST(testIPv6SocketAddress);
     TSUNIT_TEST(testTCPSocket);
     TSUNIT_TEST(testUDPSocket);
+    TSUNIT_TEST(testUDPMultiple);
+    TSUNIT_TEST(testPacketRing);
+    TSUNIT_TEST(testUDPStreamSelector);
     TSUNIT_TEST(testIPHeader);
     TSUNIT_TEST(testIPProtocol);
     TSUNIT_TEST(testTCPPacket);
     TSUNIT_TEST(testUDPPacket);
+    TSUNIT_TEST(testPcapIndex);
     TSUNIT_TEST_END();
 
 private:
@@ -746,6 +761,167 @@ void NetworkingTest::testUDPSocket()
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+void NetworkingTest::testUDPMultiple()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12346;
+    const ts::IPv4SocketAddress address(ts::IPv4Address::LocalHost, portNumber);
+
+    // Receiver socket.
+    ts::UDPSocket receiver(true);
+    TSUNIT_ASSERT(receiver.isOpen());
+    TSUNIT_ASSERT(receiver.setReceiveBufferSize(1024 * 1024, CERR));
+    TSUNIT_ASSERT(receiver.reusePort(true, CERR));
+    TSUNIT_ASSERT(receiver.bind(address, CERR));
+
+    // Sender socket, with segmentation offload when available.
+    ts::UDPSocket sender(true);
+    TSUNIT_ASSERT(sender.isOpen());
+    TSUNIT_ASSERT(sender.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, ts::IPv4SocketAddress::AnyPort), CERR));
+    TSUNIT_ASSERT(sender.setDefaultDestination(address, CERR));
+    sender.setSegmentationOffload(true, NULLREP);
+
+    // Send contiguous messages of the same size, the last one is shorter.
+    constexpr size_t msg_count = 10;
+    constexpr size_t msg_size = 1316;
+    constexpr size_t last_size = 188;
+    ts::ByteBlock data((msg_count - 1) * msg_size + last_size);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i / msg_size + i);
+    }
+    ts::UDPSocket::OutgoingMessage out[msg_count];
+    for (size_t i = 0; i < msg_count; ++i) {
+        out[i].data = data.data() + i * msg_size;
+        out[i].size = i < msg_count - 1 ? msg_size : last_size;
+    }
+    TSUNIT_ASSERT(sender.sendMultiple(out, msg_count, CERR));
+
+    // Receive all messages.
+    uint8_t buffers[msg_count][2048];
+    ts::UDPSocket::ReceivedMessage in[msg_count];
+    size_t received = 0;
+    while (received < msg_count) {
+        for (size_t i = received; i < msg_count; ++i) {
+            in[i].data = buffers[i];
+            in[i].max_size = sizeof(buffers[i]);
+        }
+        size_t count = 0;
+        TSUNIT_ASSERT(receiver.receiveMultiple(in + received, msg_count - received, count, nullptr, CERR));
+        TSUNIT_ASSERT(count > 0);
+        TSUNIT_ASSERT(count <= msg_count - received);
+        for (size_t i = received; i < received + count; ++i) {
+            CERR.debug(u"UDPMultipleTest: message %d, %d bytes, sender: %s", {i, in[i].size, in[i].sender});
+            TSUNIT_EQUAL(out[i].size, in[i].size);
+            TSUNIT_ASSERT(::memcmp(out[i].data, in[i].data, in[i].size) == 0);
+            TSUNIT_ASSERT(ts::IPv4Address(in[i].sender) == ts::IPv4Address::LocalHost);
+        }
+        received += count;
+    }
+}
+
+void NetworkingTest::testPacketRing()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12347;
+    const ts::IPv4SocketAddress address(ts::IPv4Address::LocalHost, portNumber);
+
+    // Packet ring on the loopback interface, selecting one destination only.
+    // Requires Linux and the CAP_NET_RAW capability, skip the test otherwise.
+    ts::PacketRing ring;
+    ring.setRingSize(64 * 1024, 4);
+    ring.setReceiveTimeout(5000);
+    ring.setUDPFilter(ts::IPv4SocketAddress(), address);
+    if (!ring.open(u"lo", NULLREP)) {
+        debug() << "NetworkingTest::testPacketRing: cannot open packet ring, skipped" << std::endl;
+        return;
+    }
+
+    // Receiver sockets, to avoid ICMP errors.
+    ts::UDPSocket receiver1(true);
+    ts::UDPSocket receiver2(true);
+    TSUNIT_ASSERT(receiver1.bind(address, CERR));
+    TSUNIT_ASSERT(receiver2.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, portNumber + 1), CERR));
+
+    // Send a datagram to another port, which must be filtered out, then several datagrams to the selected port.
+    ts::UDPSocket sender(true);
+    TSUNIT_ASSERT(sender.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, ts::IPv4SocketAddress::AnyPort), CERR));
+    const uint8_t other[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+    TSUNIT_ASSERT(sender.send(other, sizeof(other), ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, portNumber + 1), CERR));
+
+    constexpr size_t msg_count = 5;
+    ts::ByteBlock data(1316);
+    for (size_t i = 0; i < msg_count; ++i) {
+        data[0] = uint8_t(i);
+        TSUNIT_ASSERT(sender.send(data.data(), data.size() - i, address, CERR));
+    }
+
+    // Receive all datagrams from the ring, first as IPv4 packets, then in place.
+    for (size_t i = 0; i < msg_count / 2; ++i) {
+        ts::IPv4Packet packet;
+        ts::MicroSecond timestamp = -1;
+        TSUNIT_ASSERT(ring.receive(packet, timestamp, nullptr, CERR));
+        CERR.debug(u"PacketRingTest: message %d, %d bytes, from %s to %s", {i, packet.protocolDataSize(), packet.sourceSocketAddress(), packet.destinationSocketAddress()});
+        TSUNIT_ASSERT(packet.isUDP());
+        TSUNIT_ASSERT(packet.destinationSocketAddress() == address);
+        TSUNIT_EQUAL(data.size() - i, packet.protocolDataSize());
+        TSUNIT_EQUAL(i, packet.protocolData()[0]);
+        TSUNIT_ASSERT(timestamp > 0);
+    }
+    for (size_t i = msg_count / 2; i < msg_count; ++i) {
+        const uint8_t* udp_data = nullptr;
+        size_t udp_size = 0;
+        ts::IPv4SocketAddress source;
+        ts::IPv4SocketAddress destination;
+        ts::MicroSecond timestamp = -1;
+        TSUNIT_ASSERT(ring.receiveUDP(udp_data, udp_size, source, destination, timestamp, nullptr, CERR));
+        TSUNIT_ASSERT(udp_data != nullptr);
+        TSUNIT_ASSERT(destination == address);
+        TSUNIT_EQUAL(data.size() - i, udp_size);
+        TSUNIT_EQUAL(i, udp_data[0]);
+        TSUNIT_ASSERT(timestamp > 0);
+    }
+
+    uint64_t received = 0;
+    uint64_t dropped = 0;
+    TSUNIT_ASSERT(ring.getStatistics(received, dropped, CERR));
+    TSUNIT_EQUAL(msg_count, received);
+    TSUNIT_EQUAL(0, dropped);
+    TSUNIT_ASSERT(ring.close(CERR));
+}
+
+void NetworkingTest::testUDPStreamSelector()
+{
+    const ts::IPv4SocketAddress src1(ts::IPv4Address(192, 168, 1, 1), 1000);
+    const ts::IPv4SocketAddress src2(ts::IPv4Address(192, 168, 1, 2), 1000);
+    const ts::IPv4SocketAddress dst1(ts::IPv4Address(239, 1, 1, 1), 1234);
+    const ts::IPv4SocketAddress dst2(ts::IPv4Address(239, 1, 1, 2), 1234);
+    const ts::IPv4SocketAddress dst3(ts::IPv4Address(10, 1, 1, 1), 1234);
+
+    // Destination port only, multicast only.
+    ts::UDPStreamSelector sel(ts::IPv4SocketAddress(), ts::IPv4SocketAddress(ts::IPv4Address(), 1234), true);
+    TSUNIT_ASSERT(!sel.hasDestination());
+    TSUNIT_ASSERT(sel.match(src1, dst1));
+    TSUNIT_ASSERT(sel.match(src2, dst2));
+    TSUNIT_ASSERT(!sel.match(src1, dst3));
+    TSUNIT_ASSERT(!sel.match(src1, ts::IPv4SocketAddress(ts::IPv4Address(239, 1, 1, 1), 1235)));
+
+    // Once the destination is selected, only this destination matches, from any source.
+    sel.setDestination(dst2, NULLREP);
+    TSUNIT_ASSERT(sel.hasDestination());
+    TSUNIT_ASSERT(sel.destination() == dst2);
+    TSUNIT_ASSERT(!sel.match(src1, dst1));
+    TSUNIT_ASSERT(sel.match(src1, dst2));
+    TSUNIT_ASSERT(sel.match(src2, dst2));
+
+    // Source filter, any destination.
+    sel.reset(src1, ts::IPv4SocketAddress(), false);
+    TSUNIT_ASSERT(!sel.hasDestination());
+    TSUNIT_ASSERT(sel.match(src1, dst3));
+    TSUNIT_ASSERT(!sel.match(src2, dst3));
+}
+
 void NetworkingTest::testIPHeader()
 {
     static const uint8_t reference_header[] = {
@@ -922,6 +1098,114 @@ void NetworkingTest::testUDPPacket()
     TSUNIT_EQUAL(u"192.168.56.10:41876", ip.sourceSocketAddress().toString());
     TSUNIT_EQUAL(u"192.168.56.1:5000", ip.destinationSocketAddress().toString());
 
+    ts::IPv4SocketAddress source;
+    ts::IPv4SocketAddress destination;
+    const uint8_t* udp_data = nullptr;
+    size_t udp_size = 0;
+    TSUNIT_ASSERT(ts::IPv4Packet::LocateUDP(data, sizeof(data), source, destination, udp_data, udp_size));
+    TSUNIT_EQUAL(u"192.168.56.10:41876", source.toString());
+    TSUNIT_EQUAL(u"192.168.56.1:5000", destination.toString());
+    TSUNIT_EQUAL(data + 28, udp_data);
+    TSUNIT_EQUAL(376, udp_size);
+
     ip.reset(data, sizeof(data) - 1);
     TSUNIT_ASSERT(!ip.isValid());
+    TSUNIT_ASSERT(!ts::IPv4Packet::LocateUDP(data, sizeof(data) - 1, source, destination, udp_data, udp_size));
+}
+
+void NetworkingTest::testPcapIndex()
+{
+    // Build a pcap file with raw IP packets: UDP datagrams to 3 multicast destinations,
+    // one captured packet out of ten is not IPv4. One packet per millisecond.
+    constexpr size_t count = 3000;
+    constexpr ts::MicroSecond base = 1000 * ts::MicroSecPerSec;
+
+    ts::ByteBlock file;
+    file.appendUInt32(ts::PCAP_MAGIC_BE);
+    file.appendUInt16(2);
+    file.appendUInt16(4);
+    file.appendUInt32(0);
+    file.appendUInt32(0);
+    file.appendUInt32(65535);
+    file.appendUInt32(ts::LINKTYPE_RAW);
+
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t ip[32];
+        TS_ZERO(ip);
+        ip[0] = i % 10 == 9 ? 0x60 : 0x45;
+        ts::PutUInt16(ip + 2, sizeof(ip));
+        ip[8] = 64;
+        ip[9] = ts::IPv4_PROTO_UDP;
+        ts::PutUInt32(ip + 12, 0x0A000001);
+        ts::PutUInt32(ip + 16, 0xEF000001 + uint32_t(i % 3));
+        ts::PutUInt16(ip + 20, 1000);
+        ts::PutUInt16(ip + 22, 2000);
+        ts::PutUInt16(ip + 24, 12);
+        ts::PutUInt32(ip + 28, uint32_t(i));
+        ts::IPv4Packet::UpdateIPHeaderChecksum(ip, sizeof(ip));
+
+        const ts::MicroSecond time = base + ts::MicroSecond(i) * ts::MicroSecPerMilliSec;
+        file.appendUInt32(uint32_t(time / ts::MicroSecPerSec));
+        file.appendUInt32(uint32_t(time % ts::MicroSecPerSec));
+        file.appendUInt32(sizeof(ip));
+        file.appendUInt32(sizeof(ip));
+        file.append(ip, sizeof(ip));
+    }
+
+    const ts::UString pcap_name(ts::TempFile(u".pcap"));
+    const ts::UString index_name(pcap_name + ts::PcapIndex::DEFAULT_SUFFIX);
+    TSUNIT_ASSERT(file.saveToFile(pcap_name));
+
+    // Use the memory-mapped and read modes. The index is built the first time and loaded the second time.
+    for (int mapped = 0; mapped < 2; ++mapped) {
+        debug() << "NetworkingTest::testPcapIndex: mapped: " << mapped << std::endl;
+
+        ts::PcapFilter pcap;
+        pcap.setMemoryMapped(mapped != 0);
+        pcap.setIndexed(true);
+        TSUNIT_ASSERT(pcap.open(pcap_name, CERR));
+        TSUNIT_ASSERT(pcap.isIndexed());
+        TSUNIT_ASSERT(ts::FileExists(index_name));
+        TSUNIT_EQUAL(count, pcap.index().packetCount());
+        TSUNIT_EQUAL(3, pcap.index().flows().size());
+        TSUNIT_EQUAL(base, pcap.index().firstTimestamp());
+        TSUNIT_EQUAL(1, pcap.index().firstPacketAtTime(base));
+        TSUNIT_EQUAL(ts::PcapIndex::TIME_SAMPLE_INTERVAL + 1, pcap.index().firstPacketAtTime(base + 1500 * ts::MicroSecPerMilliSec));
+        TSUNIT_EQUAL(count + 1, pcap.index().firstPacketAtTime(base + count * ts::MicroSecPerMilliSec));
+
+        // Read the packets of one flow, starting at a given time.
+        pcap.setProtocolFilterUDP();
+        pcap.setDestinationFilter(ts::IPv4SocketAddress(239, 0, 0, 2, 2000));
+        pcap.setFirstTimeOffset(1000 * ts::MicroSecPerMilliSec);
+
+        ts::IPv4Packet ip;
+        ts::MicroSecond timestamp = 0;
+        size_t expected = 1000;
+        while (pcap.readIPv4(ip, timestamp, CERR)) {
+            while (expected % 3 != 1 || expected % 10 == 9) {
+                expected++;
+            }
+            TSUNIT_EQUAL(expected + 1, pcap.packetCount());
+            TSUNIT_EQUAL(base + ts::MicroSecond(expected) * ts::MicroSecPerMilliSec, timestamp);
+            TSUNIT_EQUAL(u"239.0.0.2:2000", ip.destinationSocketAddress().toString());
+            TSUNIT_EQUAL(4, ip.protocolDataSize());
+            TSUNIT_EQUAL(expected, ts::GetUInt32(ip.protocolData()));
+            expected++;
+        }
+        TSUNIT_ASSERT(expected > count - 3);
+        TSUNIT_ASSERT(pcap.endOfFile());
+
+        // Directly move to a packet. The destination filter is still active.
+        pcap.clearPacketView();
+        TSUNIT_ASSERT(pcap.seekPacket(2001, CERR));
+        TSUNIT_ASSERT(pcap.readIPv4(ip, timestamp, CERR));
+        TSUNIT_EQUAL(2003, pcap.packetCount());
+        TSUNIT_EQUAL(2002, ts::GetUInt32(ip.protocolData()));
+        TSUNIT_ASSERT(!pcap.seekPacket(count + 1, NULLREP));
+        TSUNIT_ASSERT(!pcap.readIPv4(ip, timestamp, NULLREP));
+        pcap.close();
+    }
+
+    ts::DeleteFile(pcap_name, NULLREP);
+    ts::DeleteFile(index_name, NULLREP);
 }
@@ -46,9 +46,11 @@ public:
     virtual void afterTest() override;
 
     void testResidentBuffer();
+    void testHugePages();
 
     TSUNIT_TEST_BEGIN(ResidentBufferTest);
     TSUNIT_TEST(testResidentBuffer);
+    TSUNIT_TEST(testHugePages);
     TSUNIT_TEST_END();
 };
 
@@ -86,3 +88,22 @@ void ResidentBufferTest::testResidentBuffer()
     TSUNIT_ASSERT(buf.isLocked());
     TSUNIT_ASSERT(buf.count() >= buf_size);
 }
+
+void ResidentBufferTest::testHugePages()
+{
+    // Huge pages and NUMA binding may be unavailable, the allocation shall always succeed.
+    const size_t buf_size = 3 * 1024 * 1024 + 1000;
+
+    ts::ResidentBuffer<uint8_t> buf(buf_size, true, ts::NUMA_NODE_LOCAL);
+
+    debug() << "ResidentBufferTest: isLocked() = " << buf.isLocked() << ", hugePages() = " << buf.hugePages()
+            << ", numaNode() = " << buf.numaNode() << ", count() = " << buf.count() << std::endl;
+
+    TSUNIT_ASSERT(buf.base() != nullptr);
+    TSUNIT_ASSERT(buf.count() >= buf_size);
+
+    // The whole buffer must be usable.
+    ::memset(buf.base(), 0x5A, buf.count());
+    TSUNIT_EQUAL(0x5A, buf.base()[0]);
+    TSUNIT_EQUAL(0x5A, buf.base()[buf.count() - 1]);
+}
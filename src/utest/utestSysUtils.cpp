@@ -724,7 +724,13 @@ void SysUtilsTest::testSysInfo()
             << "    systemVersion = \"" << ts::SysInfo::Instance()->systemVersion() << '"' << std::endl
             << "    systemName = \"" << ts::SysInfo::Instance()->systemName() << '"' << std::endl
             << "    hostName = \"" << ts::SysInfo::Instance()->hostName() << '"' << std::endl
-            << "    memoryPageSize = " << ts::SysInfo::Instance()->memoryPageSize() << std::endl;
+            << "    memoryPageSize = " << ts::SysInfo::Instance()->memoryPageSize() << std::endl
+            << "    sse2Instructions = " << ts::UString::TrueFalse(ts::SysInfo::Instance()->sse2Instructions()) << std::endl
+            << "    avx2Instructions = " << ts::UString::TrueFalse(ts::SysInfo::Instance()->avx2Instructions()) << std::endl
+            << "    neonInstructions = " << ts::UString::TrueFalse(ts::SysInfo::Instance()->neonInstructions()) << std::endl
+            << "    aesInstructions = " << ts::UString::TrueFalse(ts::SysInfo::Instance()->aesInstructions()) << std::endl
+            << "    pclmulInstructions = " << ts::UString::TrueFalse(ts::SysInfo::Instance()->pclmulInstructions()) << std::endl
+            << "    shaInstructions = " << ts::UString::TrueFalse(ts::SysInfo::Instance()->shaInstructions()) << std::endl;
 
 #if defined(TS_WINDOWS)
     TSUNIT_ASSERT(ts::SysInfo::Instance()->isWindows());
@@ -748,6 +754,16 @@ void SysUtilsTest::testSysInfo()
     TSUNIT_ASSERT(ts::SysInfo::Instance()->isFreeBSD());
 #endif
 
+    // SSE2 and NEON are part of the base instruction sets of the 64-bit architectures.
+#if defined(TS_X86_64)
+    TSUNIT_ASSERT(ts::SysInfo::Instance()->sse2Instructions());
+    TSUNIT_ASSERT(!ts::SysInfo::Instance()->neonInstructions());
+#elif defined(TS_ARM64)
+    TSUNIT_ASSERT(!ts::SysInfo::Instance()->sse2Instructions());
+    TSUNIT_ASSERT(!ts::SysInfo::Instance()->avx2Instructions());
+    TSUNIT_ASSERT(ts::SysInfo::Instance()->neonInstructions());
+#endif
+
     // We can't predict the memory page size, except that it must be a multiple of 256.
     TSUNIT_ASSERT(ts::SysInfo::Instance()->memoryPageSize() > 0);
     TSUNIT_ASSERT(ts::SysInfo::Instance()->memoryPageSize() % 256 == 0);
@@ -32,6 +32,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFile.h"
+#include "tsAsyncFileIO.h"
+#include "tsTSFileInputBuffered.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
 #include "tsCerrReport.h"
@@ -57,6 +59,10 @@ public:
     void testDuck();
     void testStuffingRead();
     void testStuffingWrite();
+    void testAsyncIO();
+    void testMemoryMapped();
+    void testMemoryMappedBuffered();
+    void testDirectIO();
 
     TSUNIT_TEST_BEGIN(TSFileTest);
     TSUNIT_TEST(testTS);
@@ -64,6 +70,10 @@ public:
     TSUNIT_TEST(testDuck);
     TSUNIT_TEST(testStuffingRead);
     TSUNIT_TEST(testStuffingWrite);
+    TSUNIT_TEST(testAsyncIO);
+    TSUNIT_TEST(testMemoryMapped);
+    TSUNIT_TEST(testMemoryMappedBuffered);
+    TSUNIT_TEST(testDirectIO);
     TSUNIT_TEST_END();
 
 private:
@@ -395,3 +405,214 @@ void TSFileTest::testStuffingWrite()
     TSUNIT_EQUAL(184, packets[5].getPayloadSize());
     TSUNIT_EQUAL(0xFF, packets[5].getPayload()[0]);
 }
+
+void TSFileTest::testAsyncIO()
+{
+    // Asynchronous I/O silently falls back to synchronous I/O when not supported.
+    debug() << "TSFileTest::testAsyncIO: asynchronous I/O supported: " << ts::UString::YesNo(ts::AsyncFileIO::IsSupported()) << std::endl;
+
+    // Use small buffers to exercise the rotation of buffers.
+    constexpr size_t count = 10000;
+    ts::TSFile file;
+    ts::TSPacket pkt;
+    ts::TSPacketMetadata mdata;
+    file.setAsyncIO(3, 4096);
+
+    // Write a M2TS file, the size of each packet is not a divisor of the buffer size.
+    TSUNIT_ASSERT(!ts::FileExists(_tempFileName));
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR, ts::TSPacketFormat::M2TS));
+    pkt = ts::NullPacket;
+    for (size_t i = 0; i < count; ++i) {
+        pkt.setPID(ts::PID(i % 8000));
+        mdata.setInputTimeStamp(i, ts::SYSTEM_CLOCK_FREQ, ts::TimeSource::UNDEFINED);
+        TSUNIT_ASSERT(file.writePackets(&pkt, &mdata, 1, CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(count * (4 + ts::PKT_SIZE), ts::GetFileSize(_tempFileName));
+
+    // Read it twice, with rewind.
+    ts::TSPacketVector packets(100);
+    ts::TSPacketMetadataVector mdatas(packets.size());
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 2, 0, CERR));
+    size_t index = 0;
+    size_t ret = 0;
+    while ((ret = file.readPackets(packets.data(), mdatas.data(), packets.size(), CERR)) > 0) {
+        for (size_t i = 0; i < ret; ++i) {
+            TSUNIT_EQUAL((index % count) % 8000, packets[i].getPID());
+            TSUNIT_EQUAL(index % count, mdatas[i].getInputTimeStamp());
+            index++;
+        }
+    }
+    TSUNIT_EQUAL(2 * count, index);
+    TSUNIT_EQUAL(2 * count, file.readPacketsCount());
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Seek in the file.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR, ts::TSPacketFormat::M2TS));
+    TSUNIT_ASSERT(file.seek(7777, CERR));
+    TSUNIT_EQUAL(1, file.readPackets(&pkt, &mdata, 1, CERR));
+    TSUNIT_EQUAL(7777, pkt.getPID());
+    TSUNIT_ASSERT(file.seek(12, CERR));
+    TSUNIT_EQUAL(1, file.readPackets(&pkt, &mdata, 1, CERR));
+    TSUNIT_EQUAL(12, pkt.getPID());
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+void TSFileTest::testMemoryMapped()
+{
+    constexpr size_t count = 1000;
+    ts::TSFile file;
+    ts::TSPacket pkt;
+    ts::TSPacketMetadata mdata;
+
+    // Write a M2TS file.
+    TSUNIT_ASSERT(!ts::FileExists(_tempFileName));
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR, ts::TSPacketFormat::M2TS));
+    TSUNIT_ASSERT(!file.isMemoryMapped());
+    pkt = ts::NullPacket;
+    for (size_t i = 0; i < count; ++i) {
+        pkt.setPID(ts::PID(i));
+        mdata.setInputTimeStamp(i, ts::SYSTEM_CLOCK_FREQ, ts::TimeSource::UNDEFINED);
+        TSUNIT_ASSERT(file.writePackets(&pkt, &mdata, 1, CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Read it twice in place, with initial and final stuffing. Memory mapping is not available on Windows.
+    file.setMemoryMapped(true);
+    file.setStuffing(2, 3);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 2, 0, CERR));
+#if !defined(TS_WINDOWS)
+    TSUNIT_ASSERT(file.isMemoryMapped());
+#endif
+
+    ts::TSPacketView view;
+    TSUNIT_EQUAL(2, file.readPacketView(view, 100, CERR));
+    TSUNIT_EQUAL(2, view.size());
+    TSUNIT_EQUAL(ts::PID_NULL, view[1].getPID());
+    view.getMetadata(1, mdata);
+    TSUNIT_ASSERT(mdata.getInputStuffing());
+
+    size_t index = 0;
+    while (index < 2 * count && file.readPacketView(view, 300, CERR) > 0) {
+        TSUNIT_ASSERT(view.size() <= 300);
+#if !defined(TS_WINDOWS)
+        TSUNIT_EQUAL(4 + ts::PKT_SIZE, view.stride());
+#endif
+        for (size_t i = 0; i < view.size(); ++i) {
+            TSUNIT_EQUAL(index % count, view[i].getPID());
+            view.getMetadata(i, mdata);
+            TSUNIT_EQUAL(index % count, mdata.getInputTimeStamp());
+            index++;
+        }
+    }
+    TSUNIT_EQUAL(2 * count, index);
+
+    ts::TSPacketVector packets(10);
+    TSUNIT_EQUAL(3, file.readPackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_EQUAL(ts::PID_NULL, packets[2].getPID());
+    TSUNIT_EQUAL(0, file.readPacketView(view, 100, CERR));
+    TSUNIT_ASSERT(view.empty());
+    TSUNIT_EQUAL(2 * count + 5, file.readPacketsCount());
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(!file.isMemoryMapped());
+
+    // Copy packets from the mapped file and seek in the file.
+    file.setStuffing(0, 0);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+    TSUNIT_EQUAL(10, file.readPackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_EQUAL(9, packets[9].getPID());
+    TSUNIT_ASSERT(file.seek(777, CERR));
+    TSUNIT_EQUAL(1, file.readPackets(&pkt, &mdata, 1, CERR));
+    TSUNIT_EQUAL(777, pkt.getPID());
+    TSUNIT_EQUAL(777, mdata.getInputTimeStamp());
+    TSUNIT_ASSERT(file.seek(count - 2, CERR));
+    TSUNIT_EQUAL(2, file.readPackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_EQUAL(count - 1, packets[1].getPID());
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+void TSFileTest::testMemoryMappedBuffered()
+{
+    constexpr size_t count = 1000;
+    ts::TSFile file;
+    ts::TSPacket pkt;
+
+    // Write a file in RS204 format.
+    TSUNIT_ASSERT(!ts::FileExists(_tempFileName));
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR, ts::TSPacketFormat::RS204));
+    pkt = ts::NullPacket;
+    for (size_t i = 0; i < count; ++i) {
+        pkt.setPID(ts::PID(i));
+        TSUNIT_ASSERT(file.writePackets(&pkt, nullptr, 1, CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(count * ts::PKT_RS_SIZE, ts::GetFileSize(_tempFileName));
+
+    // Read it with a small buffer, seek back further than the buffer size.
+    ts::TSFileInputBuffered input(ts::TSFileInputBuffered::MIN_BUFFER_SIZE);
+    input.setMemoryMapped(true);
+    TSUNIT_ASSERT(input.openRead(_tempFileName, 1, 0, CERR));
+    for (size_t i = 0; i < 500; ++i) {
+        TSUNIT_EQUAL(1, input.read(&pkt, 1, CERR));
+        TSUNIT_EQUAL(i, pkt.getPID());
+    }
+    TSUNIT_EQUAL(ts::TSPacketFormat::RS204, input.packetFormat());
+    TSUNIT_EQUAL(500, input.readPacketsCount());
+
+#if defined(TS_WINDOWS)
+    TSUNIT_ASSERT(!input.canSeek(100));
+#else
+    TSUNIT_ASSERT(input.isMemoryMapped());
+    TSUNIT_ASSERT(input.canSeek(100));
+    TSUNIT_ASSERT(!input.canSeek(501));
+    TSUNIT_EQUAL(500, input.getBackwardSeekableCount());
+    TSUNIT_EQUAL(0, input.getForwardSeekableCount());
+
+    TSUNIT_ASSERT(input.seek(100, CERR));
+    TSUNIT_EQUAL(100, input.readPacketsCount());
+    TSUNIT_EQUAL(400, input.getForwardSeekableCount());
+    TSUNIT_EQUAL(1, input.read(&pkt, 1, CERR));
+    TSUNIT_EQUAL(100, pkt.getPID());
+
+    TSUNIT_ASSERT(input.seekForward(300, CERR));
+    TSUNIT_EQUAL(1, input.read(&pkt, 1, CERR));
+    TSUNIT_EQUAL(401, pkt.getPID());
+    TSUNIT_ASSERT(input.seekBackward(400, CERR));
+    TSUNIT_EQUAL(1, input.read(&pkt, 1, CERR));
+    TSUNIT_EQUAL(2, pkt.getPID());
+#endif
+
+    TSUNIT_ASSERT(input.close(CERR));
+}
+
+void TSFileTest::testDirectIO()
+{
+    // Direct I/O and preallocation silently fall back to the usual write operations when not supported.
+    // The number of packets does not fill an integral number of disk blocks.
+    constexpr size_t count = 5555;
+    ts::TSFile file;
+    ts::TSPacket pkt;
+    file.setDirectIO(true);
+    file.setPreallocation(4 * 1024 * 1024);
+    file.setAsyncIO(2, 64 * 1024);
+
+    TSUNIT_ASSERT(!ts::FileExists(_tempFileName));
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    pkt = ts::NullPacket;
+    for (size_t i = 0; i < count; ++i) {
+        pkt.setPID(ts::PID(i % 8000));
+        TSUNIT_ASSERT(file.writePackets(&pkt, nullptr, 1, CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(count * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+
+    // Read it back.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 1, 0, CERR));
+    size_t index = 0;
+    while (file.readPackets(&pkt, nullptr, 1, CERR) == 1) {
+        TSUNIT_EQUAL(index % 8000, pkt.getPID());
+        index++;
+    }
+    TSUNIT_EQUAL(count, index);
+    TSUNIT_ASSERT(file.close(CERR));
+}
@@ -33,8 +33,13 @@
 
 #include "tsTSProcessor.h"
 #include "tsPluginRepository.h"
+#include "tsPluginEventData.h"
 #include "tsCerrReport.h"
+#include "tsSysUtils.h"
+#include "tsTelnetConnection.h"
+#include "tsIPv4SocketAddress.h"
 #include "tsunit.h"
+#include <functional>
 
 
 //----------------------------------------------------------------------------
@@ -48,10 +53,28 @@ public:
     virtual void afterTest() override;
 
     void testProcessing();
+    void testLockFreeHandoff();
+    void testFusePlugins();
+    void testFusedEnd();
+    void testFusedRestart();
+    void testSharding();
+    void testPIDFilter();
+    void testLatencyTarget();
 
     TSUNIT_TEST_BEGIN(TSProcessorTest);
     TSUNIT_TEST(testProcessing);
+    TSUNIT_TEST(testLockFreeHandoff);
+    TSUNIT_TEST(testFusePlugins);
+    TSUNIT_TEST(testFusedEnd);
+    TSUNIT_TEST(testFusedRestart);
+    TSUNIT_TEST(testSharding);
+    TSUNIT_TEST(testPIDFilter);
+    TSUNIT_TEST(testLatencyTarget);
     TSUNIT_TEST_END();
+
+private:
+    // Run the test chain "null 26 -> test1 --count 10 -> drop" and check the plugin events.
+    void checkTestChain(ts::TSProcessorArgs& opt);
 };
 
 TSUNIT_REGISTER(TSProcessorTest);
@@ -97,6 +120,7 @@ namespace {
 // Internal packet processing plugin class.
 // The start and stop methods signal an event.
 // The packet processing method signals an even every N packets.
+// It can also modify the packets or terminate the processing.
 //----------------------------------------------------------------------------
 
 namespace {
@@ -123,6 +147,8 @@ namespace {
     private:
         // Command line options:
         ts::PacketCounter _count;
+        ts::PacketCounter _end;
+        uint8_t           _xor;
     };
 }
 
@@ -141,15 +167,25 @@ ts::ProcessorPlugin* TestPlugin::CreateInstance(ts::TSP* t)
 // Constructor.
 TestPlugin::TestPlugin(ts::TSP* t) :
     ts::ProcessorPlugin(t, u"Test plugin", u"[options]"),
-    _count(0)
+    _count(0),
+    _end(0),
+    _xor(0)
 {
     option(u"count", 'c', POSITIVE);
     help(u"count", u"Send an event every that number of packets.");
+
+    option(u"end", 'e', POSITIVE);
+    help(u"end", u"Terminate the processing after that number of packets.");
+
+    option(u"xor", 'x', UINT8);
+    help(u"xor", u"Apply that value to the last byte of each packet.");
 }
 
 bool TestPlugin::getOptions()
 {
     _count = intValue<ts::PacketCounter>(u"count", 100);
+    _end = intValue<ts::PacketCounter>(u"end", 0);
+    _xor = intValue<uint8_t>(u"xor", 0);
     return true;
 }
 
@@ -173,6 +209,103 @@ TestPlugin::Status TestPlugin::processPacket(ts::TSPacket& pkt, ts::TSPacketMeta
         TestPluginData data(int(tsp->pluginPackets() / _count));
         tsp->signalPluginEvent(EVENT_PACKET, &data);
     }
+    if (_end > 0 && tsp->pluginPackets() >= _end) {
+        return TSP_END;
+    }
+    pkt.b[ts::PKT_SIZE - 1] ^= _xor;
+    return TSP_OK;
+}
+
+
+//----------------------------------------------------------------------------
+// Internal packet processing plugin class with per-PID state only, which
+// can be processed in parallel. Each packet is numbered in its PID and
+// every tenth packet in a PID is nullified. The stop method signals an
+// event with the number of processed packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    class PIDCounterPlugin : ts::ProcessorPlugin
+    {
+        TS_NOBUILD_NOCOPY(PIDCounterPlugin);
+    public:
+        // Constructor.
+        PIDCounterPlugin(ts::TSP*);
+
+        // Implementation of plugin API.
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual Sharding getSharding() override;
+        virtual Status processPacket(ts::TSPacket&, ts::TSPacketMetadata&) override;
+
+        // A factory static method which creates an instance of that class.
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP*);
+
+        // Plugin-specific event codes.
+        static constexpr uint32_t EVENT_STOP = 0xBEEF0004;
+
+    private:
+        ts::PIDSet _pids;
+        uint32_t   _counters[ts::PID_MAX];
+    };
+}
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr uint32_t PIDCounterPlugin::EVENT_STOP;
+#endif
+
+// Factory method.
+ts::ProcessorPlugin* PIDCounterPlugin::CreateInstance(ts::TSP* t)
+{
+    return new PIDCounterPlugin(t);
+}
+
+// Constructor.
+PIDCounterPlugin::PIDCounterPlugin(ts::TSP* t) :
+    ts::ProcessorPlugin(t, u"Test sharded plugin", u"[options]"),
+    _pids(),
+    _counters()
+{
+    option(u"pid", 'p', PIDVAL, 0, UNLIMITED_COUNT);
+    help(u"pid", u"Process only the packets from these PID's.");
+}
+
+bool PIDCounterPlugin::getOptions()
+{
+    getIntValues(_pids, u"pid", true);
+    return true;
+}
+
+bool PIDCounterPlugin::start()
+{
+    TS_ZERO(_counters);
+    setPIDFilter(_pids);
+    return true;
+}
+
+bool PIDCounterPlugin::stop()
+{
+    TestPluginData data(0);
+    for (size_t pid = 0; pid < ts::PID_MAX; ++pid) {
+        data.data += int(_counters[pid]);
+    }
+    tsp->signalPluginEvent(EVENT_STOP, &data);
+    return true;
+}
+
+PIDCounterPlugin::Sharding PIDCounterPlugin::getSharding()
+{
+    return SHARD_PIDS;
+}
+
+PIDCounterPlugin::Status PIDCounterPlugin::processPacket(ts::TSPacket& pkt, ts::TSPacketMetadata& metadata)
+{
+    const uint32_t count = _counters[pkt.getPID()]++;
+    if (count % 10 == 9) {
+        return TSP_NULL;
+    }
+    ts::PutUInt32(pkt.b + 8, count);
     return TSP_OK;
 }
 
@@ -204,6 +337,9 @@ namespace {
         };
 
         std::vector<LogEntry> logs;
+
+        // Get the events from one plugin, optionally with one event code only.
+        std::vector<LogEntry> pluginLogs(size_t index, uint32_t code = 0) const;
     };
 }
 
@@ -234,12 +370,211 @@ void TestEventHandler::handlePluginEvent(const ts::PluginEventContext& ctx)
     logs.push_back(log);
 }
 
+std::vector<TestEventHandler::LogEntry> TestEventHandler::pluginLogs(size_t index, uint32_t code) const
+{
+    // When plugins run in distinct threads, their events are interleaved in a non-deterministic way.
+    std::vector<LogEntry> result;
+    for (const auto& log : logs) {
+        if (log.index == index && (code == 0 || log.code == code)) {
+            result.push_back(log);
+        }
+    }
+    return result;
+}
+
+
+//----------------------------------------------------------------------------
+// An event handler for memory input plugin: slowly send null packets and
+// record the maximum number of packets which are requested by tsp. The first
+// call is ignored, it fills the initial buffer, regardless of batch sizes.
+//----------------------------------------------------------------------------
+
+namespace {
+    class SlowInputHandler : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(SlowInputHandler);
+    public:
+        SlowInputHandler(size_t calls);
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+
+        size_t max_packets;  // Maximum number of packets requested in one call.
+
+    private:
+        bool   _first;       // Next call is the first one.
+        size_t _calls;       // Remaining number of calls.
+    };
+}
+
+SlowInputHandler::SlowInputHandler(size_t calls) :
+    max_packets(0),
+    _first(true),
+    _calls(calls)
+{
+}
+
+void SlowInputHandler::handlePluginEvent(const ts::PluginEventContext& ctx)
+{
+    ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(ctx.pluginData());
+    if (data != nullptr && _calls > 0) {
+        _calls--;
+        const size_t count = data->maxSize() / ts::PKT_SIZE;
+        if (!_first) {
+            max_packets = std::max(max_packets, count);
+        }
+        _first = false;
+        for (size_t i = 0; i < count; ++i) {
+            data->append(ts::NullPacket.b, ts::PKT_SIZE);
+        }
+        ts::SleepThread(1);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Event handlers for memory input and output plugins: generate a predictable
+// stream on a few PID's and collect the output packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Content of the packet at some index in the generated stream.
+    ts::TSPacket SourcePacket(size_t index)
+    {
+        ts::TSPacket pkt(ts::NullPacket);
+        pkt.setPID(ts::PID(100 + index % 4));
+        pkt.setCC(uint8_t((index / 4) % ts::CC_MAX));
+        ts::PutUInt32(pkt.b + 4, uint32_t(index));
+        pkt.b[ts::PKT_SIZE - 1] = uint8_t(index);
+        return pkt;
+    }
+
+    // Input: generate a fixed number of packets or, when the count is zero, until stopped.
+    class PacketSource : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(PacketSource);
+    public:
+        PacketSource(size_t count, size_t max_per_call = 0, ts::MilliSecond delay = 0);
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+
+        std::atomic<size_t> produced;  // Number of generated packets.
+        std::atomic<bool>   stop;      // When set, no more packets are generated.
+
+    private:
+        size_t          _count;
+        size_t          _max_per_call;
+        ts::MilliSecond _delay;
+    };
+
+    // Output: collect all packets.
+    class PacketSink : public ts::PluginEventHandlerInterface
+    {
+    public:
+        PacketSink();
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+
+        ts::TSPacketVector packets;
+    };
+}
+
+PacketSource::PacketSource(size_t count, size_t max_per_call, ts::MilliSecond delay) :
+    produced(0),
+    stop(false),
+    _count(count),
+    _max_per_call(max_per_call),
+    _delay(delay)
+{
+}
+
+void PacketSource::handlePluginEvent(const ts::PluginEventContext& ctx)
+{
+    ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(ctx.pluginData());
+    if (data != nullptr) {
+        size_t count = data->maxSize() / ts::PKT_SIZE;
+        if (_max_per_call > 0) {
+            count = std::min(count, _max_per_call);
+        }
+        for (size_t i = 0; i < count && !stop && (_count == 0 || produced < _count); ++i) {
+            const ts::TSPacket pkt(SourcePacket(produced));
+            data->append(pkt.b, ts::PKT_SIZE);
+            produced++;
+        }
+        if (_delay > 0) {
+            ts::SleepThread(_delay);
+        }
+    }
+}
+
+PacketSink::PacketSink() :
+    packets()
+{
+}
+
+void PacketSink::handlePluginEvent(const ts::PluginEventContext& ctx)
+{
+    ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(ctx.pluginData());
+    if (data != nullptr) {
+        const ts::TSPacket* pkt = reinterpret_cast<const ts::TSPacket*>(data->data());
+        packets.insert(packets.end(), pkt, pkt + data->size() / ts::PKT_SIZE);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Run a chain from a packet source to a packet sink and check its results.
+//----------------------------------------------------------------------------
+
+namespace {
+    // The events from packet processing plugins are collected in a TestEventHandler.
+    // The action, when specified, is executed while the chain is running.
+    void RunChain(ts::TSProcessorArgs& opt, PacketSource& source, TestEventHandler& events, PacketSink& sink, const std::function<void()>& action = nullptr)
+    {
+        ts::PluginRepository::Instance()->registerProcessor(u"test1", TestPlugin::CreateInstance);
+        opt.input = {u"memory", {}};
+        opt.output = {u"memory", {}};
+
+        ts::TSProcessor tsproc(CERR);
+        tsproc.registerEventHandler(&source, ts::PluginType::INPUT);
+        tsproc.registerEventHandler(&sink, ts::PluginType::OUTPUT);
+        tsproc.registerEventHandler(&events, ts::PluginType::PROCESSOR);
+
+        TSUNIT_ASSERT(tsproc.start(opt));
+        if (action != nullptr) {
+            action();
+        }
+        tsproc.waitForTermination();
+    }
+
+    // Check that two logs of events are identical.
+    void CheckSameLogs(const std::vector<TestEventHandler::LogEntry>& expected, const std::vector<TestEventHandler::LogEntry>& actual)
+    {
+        TSUNIT_EQUAL(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            TSUNIT_EQUAL(expected[i].code, actual[i].code);
+            TSUNIT_EQUAL(expected[i].data, actual[i].data);
+            TSUNIT_EQUAL(expected[i].name, actual[i].name);
+            TSUNIT_EQUAL(expected[i].index, actual[i].index);
+            TSUNIT_EQUAL(expected[i].count, actual[i].count);
+            TSUNIT_EQUAL(expected[i].packets, actual[i].packets);
+        }
+    }
+
+    // Check that the output is the generated stream, with a value applied on the last byte of each packet.
+    void CheckOutput(const ts::TSPacketVector& output, size_t count, uint8_t xor_value)
+    {
+        TSUNIT_EQUAL(count, output.size());
+        for (size_t i = 0; i < output.size(); ++i) {
+            ts::TSPacket pkt(SourcePacket(i));
+            pkt.b[ts::PKT_SIZE - 1] ^= xor_value;
+            TSUNIT_ASSERT(pkt == output[i]);
+        }
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Unitary tests.
 //----------------------------------------------------------------------------
 
-void TSProcessorTest::testProcessing()
+void TSProcessorTest::checkTestChain(ts::TSProcessorArgs& opt)
 {
     // Register our custom plugin with the name "test1".
     ts::PluginRepository::Instance()->registerProcessor(u"test1", TestPlugin::CreateInstance);
@@ -251,8 +586,6 @@ void TSProcessorTest::testProcessing()
             << "  processor names: " << ts::UString::Join(ts::PluginRepository::Instance()->processorNames()) << std::endl;
 
     // Build tsp options.
-    ts::TSProcessorArgs opt;
-    opt.app_name = u"TSProcessorTest::testProcessing";
     opt.input = {u"null", {u"26"}};
     opt.plugins = {
         {u"test1", {u"--count", u"10"}},
@@ -324,3 +657,268 @@ void TSProcessorTest::testProcessing()
     TSUNIT_EQUAL(3,          handler2.logs[0].count);
     TSUNIT_EQUAL(26,         handler2.logs[0].packets);
 }
+
+void TSProcessorTest::testProcessing()
+{
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testProcessing";
+    checkTestChain(opt);
+}
+
+void TSProcessorTest::testLockFreeHandoff()
+{
+    // Same chain, same events, with packets passed between plugins using atomic counters.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testLockFreeHandoff";
+    opt.lockfree_handoff = true;
+
+    // Almost no spinning: the plugin threads immediately wait on their condition variable.
+    opt.handoff_spin = 1;
+    checkTestChain(opt);
+
+    // Default spinning.
+    opt.handoff_spin = ts::TSProcessorArgs::DEFAULT_HANDOFF_SPIN;
+    checkTestChain(opt);
+}
+
+void TSProcessorTest::testFusePlugins()
+{
+    // The reference chain, with one plugin, gives the same events when fused.
+    ts::TSProcessorArgs opt1;
+    opt1.app_name = u"TSProcessorTest::testFusePlugins";
+    opt1.fuse_plugins = true;
+    checkTestChain(opt1);
+
+    // Two consecutive plugins are executed in the same thread.
+    ts::TSProcessorArgs opt2;
+    opt2.app_name = u"TSProcessorTest::testFusePlugins";
+    opt2.plugins = {
+        {u"test1", {u"--count", u"10", u"--xor", u"0x0F"}},
+        {u"test1", {u"--count", u"20", u"--xor", u"0xF0"}},
+    };
+
+    PacketSource source_ref(1000);
+    TestEventHandler events_ref;
+    PacketSink sink_ref;
+    RunChain(opt2, source_ref, events_ref, sink_ref);
+
+    opt2.fuse_plugins = true;
+    PacketSource source_fused(1000);
+    TestEventHandler events_fused;
+    PacketSink sink_fused;
+    RunChain(opt2, source_fused, events_fused, sink_fused);
+
+    CheckOutput(sink_ref.packets, 1000, 0xFF);
+    CheckOutput(sink_fused.packets, 1000, 0xFF);
+    TSUNIT_EQUAL(102, events_ref.pluginLogs(1).size());
+    TSUNIT_EQUAL(52, events_ref.pluginLogs(2).size());
+    CheckSameLogs(events_ref.pluginLogs(1), events_fused.pluginLogs(1));
+    CheckSameLogs(events_ref.pluginLogs(2), events_fused.pluginLogs(2));
+}
+
+void TSProcessorTest::testFusedEnd()
+{
+    // The second plugin terminates the processing, all three plugins are fused.
+    // Depending on thread scheduling, the first plugin may process more packets when not fused.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testFusedEnd";
+    opt.plugins = {
+        {u"test1", {u"--count", u"10", u"--xor", u"0x0F"}},
+        {u"test1", {u"--count", u"10", u"--end", u"100"}},
+        {u"test1", {u"--count", u"10", u"--xor", u"0xF0"}},
+    };
+
+    PacketSource source_ref(1000);
+    TestEventHandler events_ref;
+    PacketSink sink_ref;
+    RunChain(opt, source_ref, events_ref, sink_ref);
+
+    opt.fuse_plugins = true;
+    PacketSource source_fused(1000);
+    TestEventHandler events_fused;
+    PacketSink sink_fused;
+    RunChain(opt, source_fused, events_fused, sink_fused);
+
+    CheckOutput(sink_ref.packets, 100, 0xFF);
+    CheckOutput(sink_fused.packets, 100, 0xFF);
+    CheckSameLogs(events_ref.pluginLogs(2), events_fused.pluginLogs(2));
+    CheckSameLogs(events_ref.pluginLogs(3), events_fused.pluginLogs(3));
+
+    const auto stop = events_fused.pluginLogs(3, TestPlugin::EVENT_STOP);
+    TSUNIT_EQUAL(1, stop.size());
+    TSUNIT_EQUAL(100, stop[0].packets);
+}
+
+void TSProcessorTest::testFusedRestart()
+{
+    // The second plugin is restarted using the control port, all packets are still processed by both plugins.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testFusedRestart";
+    opt.control_port = 28437;
+    opt.control_reuse = true;
+    opt.control_sources = {ts::IPv4Address::LocalHost};
+    opt.plugins = {
+        {u"test1", {u"--count", u"1000", u"--xor", u"0x0F"}},
+        {u"test1", {u"--count", u"1000", u"--xor", u"0xF0"}},
+    };
+
+    for (bool fused : {false, true}) {
+        debug() << "TSProcessorTest::testFusedRestart: fused: " << ts::UString::TrueFalse(fused) << std::endl;
+        opt.fuse_plugins = fused;
+
+        // Generate packets slowly until stopped.
+        PacketSource source(0, 10, 1);
+        TestEventHandler events;
+        PacketSink sink;
+
+        RunChain(opt, source, events, sink, [&]() {
+            while (source.produced < 100) {
+                ts::SleepThread(1);
+            }
+            // The response is complete when the control server closes the connection, after the restart.
+            ts::TelnetConnection conn;
+            ts::UString line;
+            TSUNIT_ASSERT(conn.open(CERR));
+            TSUNIT_ASSERT(conn.connect(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, opt.control_port), CERR));
+            TSUNIT_ASSERT(conn.sendLine(u"restart --same 2", CERR));
+            TSUNIT_ASSERT(conn.closeWriter(CERR));
+            while (conn.receiveLine(line, nullptr, NULLREP)) {
+                debug() << "TSProcessorTest::testFusedRestart: " << line << std::endl;
+            }
+            conn.close(CERR);
+            const size_t restart_count = source.produced;
+            while (source.produced < restart_count + 100) {
+                ts::SleepThread(1);
+            }
+            source.stop = true;
+        });
+
+        const size_t produced = source.produced;
+        CheckOutput(sink.packets, produced, 0xFF);
+
+        const auto start1 = events.pluginLogs(1, TestPlugin::EVENT_START);
+        const auto start2 = events.pluginLogs(2, TestPlugin::EVENT_START);
+        const auto stop1 = events.pluginLogs(1, TestPlugin::EVENT_STOP);
+        const auto stop2 = events.pluginLogs(2, TestPlugin::EVENT_STOP);
+        TSUNIT_EQUAL(1, start1.size());
+        TSUNIT_EQUAL(2, start2.size());
+        TSUNIT_EQUAL(1, stop1.size());
+        TSUNIT_EQUAL(2, stop2.size());
+
+        // The plugin session accounting restarts after the restart.
+        TSUNIT_EQUAL(produced, stop1[0].packets);
+        TSUNIT_EQUAL(produced, stop2[0].packets + stop2[1].packets);
+    }
+}
+
+void TSProcessorTest::testSharding()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"test2", PIDCounterPlugin::CreateInstance);
+
+    // The sharded plugin is preceded by a plugin which is executed in sequence.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testSharding";
+    opt.plugins = {
+        {u"test1", {u"--count", u"100", u"--xor", u"0x0F"}},
+        {u"test2", {}},
+    };
+
+    PacketSource source_ref(2000);
+    TestEventHandler events_ref;
+    PacketSink sink_ref;
+    RunChain(opt, source_ref, events_ref, sink_ref);
+
+    opt.shard_threads = 4;
+    PacketSource source_shard(2000);
+    TestEventHandler events_shard;
+    PacketSink sink_shard;
+    RunChain(opt, source_shard, events_shard, sink_shard);
+
+    // Check the content of the reference output.
+    TSUNIT_EQUAL(2000, sink_ref.packets.size());
+    for (size_t i = 0; i < sink_ref.packets.size(); ++i) {
+        const ts::TSPacket& pkt(sink_ref.packets[i]);
+        if ((i / 4) % 10 == 9) {
+            TSUNIT_EQUAL(ts::PID_NULL, pkt.getPID());
+        }
+        else {
+            TSUNIT_EQUAL(100 + i % 4, pkt.getPID());
+            TSUNIT_EQUAL(i, ts::GetUInt32(pkt.b + 4));
+            TSUNIT_EQUAL(i / 4, ts::GetUInt32(pkt.b + 8));
+            TSUNIT_EQUAL(uint8_t(i) ^ 0x0F, pkt.b[ts::PKT_SIZE - 1]);
+        }
+    }
+
+    // Same packets, in the same order, with sharding.
+    TSUNIT_EQUAL(sink_ref.packets.size(), sink_shard.packets.size());
+    for (size_t i = 0; i < sink_ref.packets.size(); ++i) {
+        TSUNIT_ASSERT(sink_ref.packets[i] == sink_shard.packets[i]);
+    }
+    CheckSameLogs(events_ref.logs, events_shard.logs);
+}
+
+void TSProcessorTest::testPIDFilter()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"test2", PIDCounterPlugin::CreateInstance);
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testPIDFilter";
+    opt.plugins = {
+        {u"test2", {u"--pid", u"101", u"--pid", u"103"}},
+    };
+
+    PacketSource source(2000);
+    TestEventHandler events;
+    PacketSink sink;
+    RunChain(opt, source, events, sink);
+
+    // The plugin was called for the filtered PID's only.
+    const auto stop = events.pluginLogs(1, PIDCounterPlugin::EVENT_STOP);
+    TSUNIT_EQUAL(1, stop.size());
+    TSUNIT_EQUAL(1000, stop[0].data);
+    TSUNIT_EQUAL(1000, stop[0].packets);
+
+    // Packets from other PID's are passed unmodified.
+    TSUNIT_EQUAL(2000, sink.packets.size());
+    for (size_t i = 0; i < sink.packets.size(); ++i) {
+        const ts::TSPacket& pkt(sink.packets[i]);
+        if (i % 2 == 0) {
+            TSUNIT_ASSERT(SourcePacket(i) == pkt);
+        }
+        else if ((i / 4) % 10 == 9) {
+            TSUNIT_EQUAL(ts::PID_NULL, pkt.getPID());
+        }
+        else {
+            TSUNIT_EQUAL(100 + i % 4, pkt.getPID());
+            TSUNIT_EQUAL(i / 4, ts::GetUInt32(pkt.b + 8));
+        }
+    }
+}
+
+void TSProcessorTest::testLatencyTarget()
+{
+    // At 2000 packets/second, with a latency target of 100 ms, the batch size
+    // must never exceed the number of packets in a quarter of the target (50).
+    constexpr size_t CAP = 50;
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testLatencyTarget";
+    opt.input = {u"memory", {}};
+    opt.output = {u"drop"};
+    opt.fixed_bitrate = 2000 * ts::PKT_SIZE_BITS;
+    opt.latency_target = 100;
+    opt.max_input_pkt = 1000;
+    opt.max_flush_pkt = 1000;
+
+    // Run long enough for the batch size to grow beyond the cap when it is not applied.
+    SlowInputHandler input(1500);
+    ts::TSProcessor tsproc(CERR);
+    tsproc.registerEventHandler(&input, ts::PluginType::INPUT);
+
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    debug() << "TSProcessorTest::testLatencyTarget: max input packets: " << input.max_packets << std::endl;
+    TSUNIT_ASSERT(input.max_packets > 0);
+    TSUNIT_ASSERT(input.max_packets <= CAP);
+}
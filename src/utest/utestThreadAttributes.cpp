@@ -60,11 +60,15 @@ public:
     void testStackSize();
     void testDeleteWhenTerminated();
     void testPriority();
+    void testSchedulingPolicy();
+    void testCPUAffinity();
 
     TSUNIT_TEST_BEGIN(ThreadAttributesTest);
     TSUNIT_TEST(testStackSize);
     TSUNIT_TEST(testDeleteWhenTerminated);
     TSUNIT_TEST(testPriority);
+    TSUNIT_TEST(testSchedulingPolicy);
+    TSUNIT_TEST(testCPUAffinity);
     TSUNIT_TEST_END();
 };
 
@@ -133,3 +137,32 @@ void ThreadAttributesTest::testPriority()
     attr.setPriority (ts::ThreadAttributes::GetNormalPriority());
     TSUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetNormalPriority());
 }
+
+void ThreadAttributesTest::testSchedulingPolicy()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::DEFAULT); // default value
+    TSUNIT_EQUAL(0, attr.getSchedulingPolicyPriority());
+
+    attr.setSchedulingPolicy(ts::ThreadAttributes::SchedulingPolicy::FIFO, 20);
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::FIFO);
+    TSUNIT_EQUAL(20, attr.getSchedulingPolicyPriority());
+
+    attr.setSchedulingPolicy(ts::ThreadAttributes::SchedulingPolicy::ROUND_ROBIN);
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::ROUND_ROBIN);
+    TSUNIT_EQUAL(0, attr.getSchedulingPolicyPriority());
+}
+
+void ThreadAttributesTest::testCPUAffinity()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getCPUAffinity().empty()); // default value
+
+    attr.setCPUAffinity(ts::CPUSet({1, 3}));
+    TSUNIT_EQUAL(2, attr.getCPUAffinity().size());
+    TSUNIT_ASSERT(attr.getCPUAffinity().count(1) == 1);
+    TSUNIT_ASSERT(attr.getCPUAffinity().count(3) == 1);
+
+    attr.setCPUAffinity(ts::CPUSet());
+    TSUNIT_ASSERT(attr.getCPUAffinity().empty());
+}
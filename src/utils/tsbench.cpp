@@ -0,0 +1,599 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Throughput benchmark of the transport stream processor.
+//
+//  A synthetic transport stream is generated in memory and is run through
+//  predefined or user-specified chains of plugins, using the same TSProcessor
+//  as tsp, with the "memory" input plugin and the "drop" or "memory" output
+//  plugin. For each chain, the benchmark reports the number of packets per
+//  second, the time per packet in each plugin and the number of memory
+//  allocations per packet, as text or JSON.
+//
+//  Rationale: the results shall be reproducible from one build or one version
+//  to another, without depending on file or network I/O. This is a test
+//  program, it is not installed.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMain.h"
+#include "tsTSProcessor.h"
+#include "tsArgsWithPlugins.h"
+#include "tsDuckContext.h"
+#include "tsAsyncReport.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsPluginEventContext.h"
+#include "tsPluginEventData.h"
+#include "tsOneShotPacketizer.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsPES.h"
+#include "tsMonotonic.h"
+#include "tsjsonOutputArgs.h"
+#include "tsjsonObject.h"
+#include "tsTextFormatter.h"
+TS_MAIN(MainCode);
+
+
+//----------------------------------------------------------------------------
+// Count all memory allocations in the application, including the plugins.
+//----------------------------------------------------------------------------
+
+namespace {
+    std::atomic<uint64_t> allocations(0);
+}
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+
+//----------------------------------------------------------------------------
+// Predefined chains of plugins.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Chain
+    {
+    public:
+        ts::UString             name;
+        ts::PluginOptionsVector plugins;
+    };
+
+    // The PID's in the synthetic stream are 0x0100, 0x0101, etc.
+    const std::vector<Chain> PredefinedChains {
+        {u"none", {}},
+        {u"count", {{u"count", {}}}},
+        {u"continuity", {{u"continuity", {}}}},
+        {u"pcrverify", {{u"pcrverify", {}}}},
+        {u"filter", {{u"filter", {u"--negate", u"--pid", u"0x0101"}}}},
+        {u"remap", {{u"remap", {u"0x0101=0x0201"}}}},
+        {u"pattern", {{u"pattern", {u"--pid", u"0x0101", u"DEADBEEF"}}}},
+        {u"zap", {{u"zap", {u"1"}}}},
+        {u"typical", {{u"continuity", {}}, {u"pcrverify", {}}, {u"remap", {u"0x0101=0x0201"}}, {u"zap", {u"1"}}, {u"count", {}}}},
+    };
+
+    // Description of a chain on the tsp command line.
+    ts::UString ChainCommand(const ts::PluginOptionsVector& plugins)
+    {
+        ts::UString cmd;
+        for (const auto& pl : plugins) {
+            cmd.append(pl.toString(ts::PluginType::PROCESSOR));
+        }
+        return cmd.empty() ? cmd : cmd.substr(1);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options
+//----------------------------------------------------------------------------
+
+namespace {
+    class Options: public ts::ArgsWithPlugins
+    {
+        TS_NOBUILD_NOCOPY(Options);
+    public:
+        Options(int argc, char *argv[]);
+
+        ts::DuckContext      duck;           // TSDuck context
+        ts::TSProcessorArgs  tsp_args;       // TS processing arguments, as in tsp.
+        ts::json::OutputArgs json;           // JSON output options.
+        ts::UString          output_file;    // Output file, standard output if empty.
+        size_t               packets;        // Number of packets in the synthetic stream.
+        size_t               pid_count;      // Number of elementary stream PID's.
+        size_t               pes_size;       // Size of PES packets.
+        size_t               pcr_interval;   // Packets between PCR's.
+        size_t               psi_interval;   // Packets between PAT/PMT's.
+        ts::BitRate          bitrate;        // Bitrate of the synthetic stream.
+        size_t               repeat;         // Number of runs per chain.
+        bool                 memory_output;  // Use memory output instead of drop.
+        std::vector<Chain>   chains;         // Chains to run.
+    };
+}
+
+Options::Options(int argc, char *argv[]) :
+    ts::ArgsWithPlugins(0, 0, 0, UNLIMITED_COUNT, 0, 0, u"Throughput benchmark of the transport stream processor", u"[options] [-P processor-name ...]"),
+    duck(this),
+    tsp_args(),
+    json(),
+    output_file(),
+    packets(0),
+    pid_count(0),
+    pes_size(0),
+    pcr_interval(0),
+    psi_interval(0),
+    bitrate(0),
+    repeat(0),
+    memory_output(false),
+    chains()
+{
+    duck.defineArgsForCAS(*this);
+    duck.defineArgsForCharset(*this);
+    duck.defineArgsForStandards(*this);
+    tsp_args.defineArgs(*this);
+    json.defineArgs(*this, false, u"Report the results in JSON format.");
+
+    setIntro(u"A synthetic transport stream is generated in memory and is run through predefined "
+             u"or user-specified chains of packet processing plugins (options -P). "
+             u"The input plugin is always \"memory\", the output plugin is \"drop\" or \"memory\". "
+             u"All tsp options can be used to tune the transport stream processor.");
+
+    option(u"chain", 'c', STRING, 0, UNLIMITED_COUNT);
+    help(u"chain", u"name",
+         u"Name of a predefined chain of plugins to run. Several --chain options can be specified. "
+         u"Use --list-chains to get the list of predefined chains. "
+         u"When plugins are specified using -P options, they are run as one additional chain named \"user\". "
+         u"When neither --chain nor -P are specified, all predefined chains are run.");
+
+    option(u"list-chains", 'l');
+    help(u"list-chains", u"List the predefined chains of plugins and exit.");
+
+    option(u"output-file", 'o', FILENAME);
+    help(u"output-file", u"Write the results in the specified file. By default, use the standard output.");
+
+    option(u"packets", 'n', POSITIVE);
+    help(u"packets", u"Number of packets in the synthetic transport stream. The default is 200,000 packets.");
+
+    option(u"pids", 0, INTEGER, 0, 1, 1, 1000);
+    help(u"pids",
+         u"Number of elementary streams in the synthetic transport stream, "
+         u"starting at PID 0x0100. The first one is a video stream, carrying the PCR's. "
+         u"The default is 4.");
+
+    option(u"pes-size", 0, INTEGER, 0, 1, 1, 0xFFFF - 8);
+    help(u"pes-size", u"Payload size in bytes of the PES packets. The default is 8,000 bytes.");
+
+    option(u"pcr-interval", 0, POSITIVE);
+    help(u"pcr-interval", u"Insert a PCR every N packets in the PID 0x0100. The default is 10.");
+
+    option(u"psi-interval", 0, POSITIVE);
+    help(u"psi-interval", u"Insert a PAT and a PMT every N packets. The default is 1,000.");
+
+    option<ts::BitRate>(u"stream-bitrate", 0);
+    help(u"stream-bitrate",
+         u"Nominal bitrate of the synthetic transport stream, used to compute the PCR and PTS. "
+         u"This is also the input bitrate of tsp, unless --bitrate is specified. "
+         u"The default is 20,000,000 b/s.");
+
+    option(u"repeat", 'r', POSITIVE);
+    help(u"repeat", u"Run each chain the specified number of times and report the fastest run. The default is 1.");
+
+    option(u"memory-output");
+    help(u"memory-output", u"Use the \"memory\" output plugin instead of \"drop\".");
+
+    // Analyze the command.
+    analyze(argc, argv);
+
+    // Load option values.
+    duck.loadArgs(*this);
+    tsp_args.loadArgs(duck, *this);
+    json.loadArgs(duck, *this);
+    getValue(output_file, u"output-file");
+    getIntValue(packets, u"packets", 200000);
+    getIntValue(pid_count, u"pids", 4);
+    getIntValue(pes_size, u"pes-size", 8000);
+    getIntValue(pcr_interval, u"pcr-interval", 10);
+    getIntValue(psi_interval, u"psi-interval", 1000);
+    getValue(bitrate, u"stream-bitrate", 20000000);
+    getIntValue(repeat, u"repeat", 1);
+    memory_output = present(u"memory-output");
+
+    if (present(u"list-chains")) {
+        for (const auto& chain : PredefinedChains) {
+            std::cout << chain.name.toJustifiedLeft(12) << ChainCommand(chain.plugins) << std::endl;
+        }
+        ::exit(EXIT_SUCCESS);
+    }
+
+    // Build the list of chains to run.
+    ts::UStringVector names;
+    getValues(names, u"chain");
+    for (const auto& name : names) {
+        bool found = false;
+        for (size_t i = 0; !found && i < PredefinedChains.size(); ++i) {
+            found = name.similar(PredefinedChains[i].name);
+            if (found) {
+                chains.push_back(PredefinedChains[i]);
+            }
+        }
+        if (!found) {
+            error(u"unknown chain \"%s\", use --list-chains", {name});
+        }
+    }
+    if (!tsp_args.plugins.empty()) {
+        chains.push_back(Chain{u"user", tsp_args.plugins});
+    }
+    if (chains.empty()) {
+        chains = PredefinedChains;
+    }
+
+    // Final checking
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+// Generate the synthetic transport stream.
+//----------------------------------------------------------------------------
+
+namespace {
+    constexpr ts::PID PMT_PID = 0x1000;
+    constexpr ts::PID FIRST_ES_PID = 0x0100;
+    constexpr uint16_t SERVICE_ID = 1;
+
+    // Time of a packet in the stream, in units of a given frequency.
+    uint64_t PacketTime(uint64_t index, uint64_t bitrate, uint64_t frequency)
+    {
+        const uint64_t bits = index * ts::PKT_SIZE_BITS;
+        return (bits / bitrate) * frequency + ((bits % bitrate) * frequency) / bitrate;
+    }
+
+    // Generate the stream. Return false on error.
+    bool GenerateStream(Options& opt, ts::TSPacketVector& packets)
+    {
+        const uint64_t bitrate = opt.bitrate.toInt();
+        if (bitrate == 0) {
+            opt.error(u"invalid stream bitrate");
+            return false;
+        }
+
+        // Packetize the PAT and the PMT once. The continuity counters are set later.
+        ts::PAT pat(0, true, 1);
+        pat.pmts[SERVICE_ID] = PMT_PID;
+        ts::PMT pmt(0, true, SERVICE_ID, FIRST_ES_PID);
+        for (size_t i = 0; i < opt.pid_count; ++i) {
+            pmt.streams[ts::PID(FIRST_ES_PID + i)].stream_type = i == 0 ? ts::ST_AVC_VIDEO : ts::ST_MPEG2_AUDIO;
+        }
+        ts::TSPacketVector psi;
+        ts::TSPacketVector pkts;
+        ts::OneShotPacketizer pzer(opt.duck, ts::PID_PAT);
+        pzer.addTable(opt.duck, pat);
+        pzer.getPackets(psi);
+        pzer.removeAll();
+        pzer.setPID(PMT_PID);
+        pzer.addTable(opt.duck, pmt);
+        pzer.getPackets(pkts);
+        psi.insert(psi.end(), pkts.begin(), pkts.end());
+
+        // Remaining bytes in the current PES packet of each elementary stream.
+        std::vector<size_t> pes_remain(opt.pid_count, 0);
+        std::array<uint8_t, ts::PID_MAX> cc;
+        cc.fill(0);
+        size_t es_index = 0;
+        size_t pcr_count = 0;
+
+        packets.resize(opt.packets);
+        for (size_t index = 0; index < packets.size(); ) {
+            // Insert PSI at regular intervals.
+            if (index % opt.psi_interval == 0) {
+                for (size_t i = 0; i < psi.size() && index < packets.size(); ++i) {
+                    ts::TSPacket& pkt(packets[index++]);
+                    pkt = psi[i];
+                    pkt.setCC(cc[pkt.getPID()]++ & ts::CC_MASK);
+                }
+                continue;
+            }
+
+            // Elementary stream packets, in turn.
+            const ts::PID pid = ts::PID(FIRST_ES_PID + es_index);
+            ts::TSPacket& pkt(packets[index]);
+            pkt.init(pid, cc[pid]++ & ts::CC_MASK, uint8_t(index));
+
+            // Insert PCR's in the first elementary stream.
+            if (es_index == 0 && pcr_count++ % opt.pcr_interval == 0) {
+                pkt.setPCR(PacketTime(index, bitrate, ts::SYSTEM_CLOCK_FREQ), true);
+            }
+
+            // Start a new PES packet when the previous one is complete.
+            size_t header_size = 0;
+            if (pes_remain[es_index] == 0) {
+                pes_remain[es_index] = opt.pes_size;
+                const uint64_t pts = PacketTime(index, bitrate, ts::SYSTEM_CLOCK_SUBFREQ) & ts::PTS_DTS_MASK;
+                uint8_t* const pes = pkt.getPayload();
+                pkt.setPUSI();
+                pes[0] = 0x00;
+                pes[1] = 0x00;
+                pes[2] = 0x01;
+                pes[3] = es_index == 0 ? ts::SID_VIDEO : ts::SID_AUDIO;
+                ts::PutUInt16(pes + 4, es_index == 0 ? 0 : uint16_t(opt.pes_size + 8));
+                pes[6] = 0x80;
+                pes[7] = 0x80;  // PTS only
+                pes[8] = 0x05;  // PES header data length
+                pes[9] = uint8_t(0x21 | ((pts >> 29) & 0x0E));
+                ts::PutUInt16(pes + 10, uint16_t(((pts >> 14) & 0xFFFE) | 0x0001));
+                ts::PutUInt16(pes + 12, uint16_t(((pts << 1) & 0xFFFE) | 0x0001));
+                header_size = 14;
+            }
+
+            // Reduce the last packet of the PES packet using stuffing in the adaptation field.
+            const size_t data_size = pkt.getPayloadSize() - header_size;
+            if (pes_remain[es_index] < data_size) {
+                pkt.setPayloadSize(header_size + pes_remain[es_index], true);
+                pes_remain[es_index] = 0;
+            }
+            else {
+                pes_remain[es_index] -= data_size;
+            }
+
+            es_index = (es_index + 1) % opt.pid_count;
+            index++;
+        }
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Event handlers for the memory input and output plugins.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Input: return the packets of the synthetic stream.
+    class InputHandler: public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(InputHandler);
+    public:
+        InputHandler(const ts::TSPacketVector& packets) : _packets(packets), _next(0) {}
+        void reset() { _next = 0; }
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    private:
+        const ts::TSPacketVector& _packets;
+        size_t _next;
+    };
+
+    void InputHandler::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+        if (data != nullptr) {
+            const size_t count = std::min(_packets.size() - _next, data->remainingSize() / ts::PKT_SIZE);
+            data->append(&_packets[_next], count * ts::PKT_SIZE);
+            _next += count;
+        }
+    }
+
+    // Output: count the packets only.
+    class OutputHandler: public ts::PluginEventHandlerInterface
+    {
+        TS_NOCOPY(OutputHandler);
+    public:
+        OutputHandler() : _count(0) {}
+        void reset() { _count = 0; }
+        ts::PacketCounter count() const { return _count; }
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    private:
+        ts::PacketCounter _count;
+    };
+
+    void OutputHandler::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+        if (data != nullptr) {
+            _count += data->size() / ts::PKT_SIZE;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Result of the run of a chain.
+//----------------------------------------------------------------------------
+
+namespace {
+    class RunResult
+    {
+    public:
+        RunResult() : duration(0), allocations(0), statistics() {}
+        ts::NanoSecond     duration;     // Total processing time.
+        uint64_t           allocations;  // Number of memory allocations.
+        ts::json::ValuePtr statistics;   // Statistics of all plugins.
+    };
+
+    // Run a chain once. Return false on error.
+    bool RunChain(Options& opt, ts::Report& report, const Chain& chain, InputHandler& input, OutputHandler& output, RunResult& result)
+    {
+        ts::TSProcessorArgs args(opt.tsp_args);
+        args.app_name = u"tsbench";
+        args.input = ts::PluginOptions(u"memory");
+        args.plugins = chain.plugins;
+        args.output = ts::PluginOptions(opt.memory_output ? u"memory" : u"drop");
+        args.plugin_stats = true;
+        if (args.fixed_bitrate == 0) {
+            args.fixed_bitrate = opt.bitrate;
+        }
+
+        input.reset();
+        output.reset();
+        ts::TSProcessor tsproc(report);
+        tsproc.registerEventHandler(&input, ts::PluginType::INPUT);
+        tsproc.registerEventHandler(&output, ts::PluginType::OUTPUT);
+
+        // Measure the complete processing time, including the plugins startup.
+        const uint64_t alloc_start = allocations.load();
+        const ts::Monotonic start(true);
+        if (!tsproc.start(args)) {
+            return false;
+        }
+        tsproc.waitForTermination();
+        result.duration = ts::Monotonic(true) - start;
+        result.allocations = allocations.load() - alloc_start;
+        result.statistics = tsproc.pluginStatistics();
+        return !result.statistics.isNull();
+    }
+
+    // Add the result of a chain in a JSON object.
+    void ResultToJSON(const Options& opt, const Chain& chain, const RunResult& result, ts::json::Value& obj)
+    {
+        const uint64_t duration = std::max<uint64_t>(1, uint64_t(result.duration));
+        obj.add(u"name", chain.name);
+        obj.add(u"command", ChainCommand(chain.plugins));
+        obj.add(u"packets", opt.packets);
+        obj.add(u"duration-ns", duration);
+        obj.add(u"packets-per-second", (uint64_t(opt.packets) * ts::NanoSecPerSec) / duration);
+        obj.add(u"ns-per-packet", duration / opt.packets);
+        obj.add(u"allocations", result.allocations);
+        obj.add(u"allocations-per-kpacket", (result.allocations * 1000) / opt.packets);
+
+        // Time per packet in each plugin.
+        const ts::json::Value& stats(result.statistics->value(u"plugins"));
+        for (size_t i = 0; i < stats.size(); ++i) {
+            const ts::json::Value& st(stats.at(i));
+            ts::json::Value& jv(obj.query(u"plugins[]", true));
+            const int64_t packets = st.value(u"packets").toInteger();
+            const int64_t call_ns = st.value(u"call-ns").toInteger();
+            jv.add(u"index", st.value(u"index").toInteger());
+            jv.add(u"type", st.value(u"type").toString());
+            jv.add(u"name", st.value(u"name").toString());
+            jv.add(u"packets", packets);
+            jv.add(u"calls", st.value(u"calls").toInteger());
+            jv.add(u"call-ns", call_ns);
+            jv.add(u"ns-per-packet", packets == 0 ? 0 : call_ns / packets);
+        }
+    }
+
+    // Display the result of a chain in text form.
+    void ResultToText(const ts::json::Value& res, std::ostream& strm)
+    {
+        strm << ts::UString::Format(u"%-12s %'12d packets/s, %'6d ns/packet, %'6d allocations/kpacket",
+                                    {res.value(u"name").toString(),
+                                     res.value(u"packets-per-second").toInteger(),
+                                     res.value(u"ns-per-packet").toInteger(),
+                                     res.value(u"allocations-per-kpacket").toInteger()})
+             << std::endl;
+        const ts::json::Value& plugins(res.value(u"plugins"));
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            const ts::json::Value& pl(plugins.at(i));
+            strm << ts::UString::Format(u"    %-12s %'6d ns/packet, %'12d packets, %'9d calls",
+                                        {pl.value(u"name").toString(),
+                                         pl.value(u"ns-per-packet").toInteger(),
+                                         pl.value(u"packets").toInteger(),
+                                         pl.value(u"calls").toInteger()})
+                 << std::endl;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Program entry point
+//----------------------------------------------------------------------------
+
+int MainCode(int argc, char *argv[])
+{
+    // Get command line options.
+    Options opt(argc, argv);
+    CERR.setMaxSeverity(opt.maxSeverity());
+
+    // Generate the synthetic stream.
+    ts::TSPacketVector packets;
+    if (!GenerateStream(opt, packets)) {
+        return EXIT_FAILURE;
+    }
+    opt.verbose(u"generated %'d packets, %d PID's, %'d b/s", {packets.size(), opt.pid_count, opt.bitrate});
+
+    // Open the output file.
+    std::ofstream outfile;
+    if (!opt.output_file.empty()) {
+        outfile.open(opt.output_file.toUTF8().c_str(), std::ios::out);
+        if (!outfile) {
+            opt.error(u"cannot create %s", {opt.output_file});
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& out(opt.output_file.empty() ? std::cout : outfile);
+
+    // Plugins messages are reported only in verbose mode, to avoid interfering with the measures.
+    ts::AsyncReport report(opt.verbose() ? opt.maxSeverity() : int(ts::Severity::Warning));
+    InputHandler input(packets);
+    OutputHandler output;
+
+    ts::json::Object root;
+    root.add(u"packets", opt.packets);
+    root.add(u"pids", opt.pid_count);
+    root.add(u"pes-size", opt.pes_size);
+    root.add(u"bitrate", opt.bitrate.toInt());
+
+    // Run all chains.
+    for (const auto& chain : opt.chains) {
+        RunResult best;
+        for (size_t run = 0; run < opt.repeat; ++run) {
+            RunResult result;
+            if (!RunChain(opt, report, chain, input, output, result)) {
+                opt.error(u"error running chain %s", {chain.name});
+                return EXIT_FAILURE;
+            }
+            opt.debug(u"chain %s, run %d: %'d ns", {chain.name, run + 1, result.duration});
+            if (run == 0 || result.duration < best.duration) {
+                best = result;
+            }
+        }
+        ts::json::Value& jv(root.query(u"chains[]", true));
+        ResultToJSON(opt, chain, best, jv);
+        if (!opt.json.useJSON()) {
+            ResultToText(jv, out);
+        }
+    }
+    report.terminate();
+
+    if (opt.json.useJSON()) {
+        opt.json.report(root, out, opt);
+    }
+    return EXIT_SUCCESS;
+}